@@ -0,0 +1,53 @@
+#version 450
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+struct ObjectData {
+    mat4 model;
+    ivec4 textureIndices;
+};
+
+layout(std430, binding = 2) readonly buffer ObjectBuffer {
+    ObjectData objects[];
+} objectBuffer;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in vec3 normal;
+layout(location = 4) in vec3 tangent;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec3 fragNormal;
+layout(location = 3) out vec3 fragTangent;
+layout(location = 4) out vec3 cameraPosition;
+layout(location = 5) out vec3 worldPosition;
+layout(location = 6) flat out ivec4 textureIndices;
+
+// Must match the depth pre-pass exactly, the depth is tested with equal after it
+invariant gl_Position;
+
+void main()
+{
+    ObjectData object = objectBuffer.objects[gl_InstanceIndex];
+
+    gl_Position = ubo.proj * ubo.view * object.model * vec4(inPosition, 1.0);
+    fragColor = inColor;
+	fragTexCoord = inTexCoord;
+	
+	mat3 transposeMat = mat3(transpose(inverse(object.model)));
+	
+	fragNormal = normalize(transposeMat * normal);
+    fragTangent = normalize(transposeMat * tangent);
+
+    mat4 invView = inverse(ubo.view);
+    cameraPosition = vec3(invView[3]);
+    worldPosition = (object.model * vec4(inPosition, 1.0)).xyz;
+
+    textureIndices = object.textureIndices;
+}
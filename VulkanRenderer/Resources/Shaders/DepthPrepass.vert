@@ -0,0 +1,21 @@
+#version 450
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+} pushConstants;
+
+layout(location = 0) in vec3 inPosition;
+
+// The main pass tests against this depth with equal, so the position has to be calculated exactly the same way
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = ubo.proj * ubo.view * pushConstants.model * vec4(inPosition, 1.0);
+}
@@ -17,6 +17,9 @@ layout(location = 1) out vec2 fragTexCoord;
 layout(location = 2) out vec3 fragNormal;
 layout(location = 3) out vec3 fragTangent;
 
+// Must match the depth pre-pass exactly, the depth is tested with equal after it
+invariant gl_Position;
+
 void main()
 {
     gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
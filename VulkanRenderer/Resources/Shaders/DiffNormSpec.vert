@@ -19,6 +19,9 @@ layout(location = 3) out vec3 fragTangent;
 layout(location = 4) out vec3 cameraPosition;
 layout(location = 5) out vec3 worldPosition;
 
+// Must match the depth pre-pass exactly, the depth is tested with equal after it
+invariant gl_Position;
+
 void main()
 {
     gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
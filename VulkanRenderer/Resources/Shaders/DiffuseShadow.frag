@@ -8,12 +8,13 @@ layout(binding = 2) uniform UniformLightObject {
 
 layout(binding = 3) uniform sampler2D texSampler;
 
-layout(binding = 4) uniform sampler2D shadowSampler;
+layout(binding = 4) uniform sampler2DArray shadowSampler;
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 fragTexCoord;
 layout(location = 2) in vec3 fragNormal;
-layout(location = 3) in vec4 lightPos;
+layout(location = 3) in vec4 lightPos[4];
+layout(location = 7) flat in int cascadeCount;
 
 layout(location = 0) out vec4 outColor;
 
@@ -52,24 +53,30 @@ float GetObservedArea(vec3 normal)
 
 float CalculateShadowAmount()
 {
-    //re-homogenize position after interpolation
-    vec3 lpos = lightPos.xyz / lightPos.w;
- 
-    //if position is not visible to the light - dont illuminate it
-    //results in hard light frustum
-    if( lpos.x < -1.0f || lpos.x > 1.0f ||
-        lpos.y < -1.0f || lpos.y > 1.0f ||
-        lpos.z < 0.0f  || lpos.z > 1.0f ) return 1;
- 
-    //transform clip space coords to texture space coords (-1:1 to 0:1)
-    lpos.x = lpos.x/2 + 0.5;
-    lpos.y = lpos.y/2 + 0.5;
- 
-    //sample shadow map - point sampler
-    float shadowMapDepth = texture(shadowSampler, lpos.xy).r;
- 
-    //if clip space z value greater than shadow map value then pixel is in shadow
-    if ( shadowMapDepth < lpos.z - tolerance) return shadowConstant;
- 
+    //use the first cascade the position lies in, the nearest cascades have the most detail
+    for(int i = 0; i < cascadeCount; ++i)
+    {
+        //re-homogenize position after interpolation
+        vec3 lpos = lightPos[i].xyz / lightPos[i].w;
+
+        //if position is not inside this cascade - try the next one
+        if( lpos.x < -1.0f || lpos.x > 1.0f ||
+            lpos.y < -1.0f || lpos.y > 1.0f ||
+            lpos.z < 0.0f  || lpos.z > 1.0f ) continue;
+
+        //transform clip space coords to texture space coords (-1:1 to 0:1)
+        lpos.x = lpos.x/2 + 0.5;
+        lpos.y = lpos.y/2 + 0.5;
+
+        //sample the layer of this cascade - point sampler
+        float shadowMapDepth = texture(shadowSampler, vec3(lpos.xy, i)).r;
+
+        //if clip space z value greater than shadow map value then pixel is in shadow
+        if ( shadowMapDepth < lpos.z - tolerance) return shadowConstant;
+
+        return 1;
+    }
+
+    //if position is not visible to any cascade - dont shadow it
     return 1;
-}
\ No newline at end of file
+}
@@ -6,9 +6,10 @@ layout(binding = 0) uniform UniformBufferObject {
     mat4 proj;
 } ubo;
 
-layout(binding = 1) uniform LightTransform {
-    mat4 transform;
-} lightTransform;
+layout(binding = 1) uniform ShadowCascades {
+    mat4 transforms[4];
+    int cascadeCount;
+} cascades;
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
@@ -19,7 +20,11 @@ layout(location = 4) in vec3 tanget;
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
 layout(location = 2) out vec3 fragNormal;
-layout(location = 3) out vec4 lightPos;
+layout(location = 3) out vec4 lightPos[4];
+layout(location = 7) flat out int cascadeCount;
+
+// Must match the depth pre-pass exactly, the depth is tested with equal after it
+invariant gl_Position;
 
 void main()
 {
@@ -27,5 +32,11 @@ void main()
     fragColor = inColor;
 	fragTexCoord = inTexCoord;
 	fragNormal = mat3(transpose(inverse(ubo.model))) * normal;
-    lightPos = lightTransform.transform * ubo.model * vec4(inPosition, 1.0);
+
+    vec4 worldPos = ubo.model * vec4(inPosition, 1.0);
+    for (int i = 0; i < cascades.cascadeCount; ++i)
+    {
+        lightPos[i] = cascades.transforms[i] * worldPos;
+    }
+    cascadeCount = cascades.cascadeCount;
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#version 450
+
+layout(std430, binding = 0) readonly buffer InstanceBuffer {
+    mat4 view;
+    mat4 proj;
+    mat4 models[];
+} instances;
+
+layout(binding = 1) uniform ShadowCascades {
+    mat4 transforms[4];
+    int cascadeCount;
+} cascades;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in vec3 normal;
+layout(location = 4) in vec3 tanget;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec3 fragNormal;
+layout(location = 3) out vec4 lightPos[4];
+layout(location = 7) flat out int cascadeCount;
+
+// Must match the depth pre-pass exactly, the depth is tested with equal after it
+invariant gl_Position;
+
+void main()
+{
+    mat4 model = instances.models[gl_InstanceIndex];
+
+    gl_Position = instances.proj * instances.view * model * vec4(inPosition, 1.0);
+    fragColor = inColor;
+	fragTexCoord = inTexCoord;
+	fragNormal = mat3(transpose(inverse(model))) * normal;
+
+    vec4 worldPos = model * vec4(inPosition, 1.0);
+    for (int i = 0; i < cascades.cascadeCount; ++i)
+    {
+        lightPos[i] = cascades.transforms[i] * worldPos;
+    }
+    cascadeCount = cascades.cascadeCount;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#version 450
+
+layout(std430, binding = 0) readonly buffer InstanceBuffer {
+    mat4 view;
+    mat4 proj;
+    mat4 models[];
+} instances;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in vec3 normal;
+layout(location = 4) in vec3 tangent;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec3 fragNormal;
+layout(location = 3) out vec3 fragTangent;
+
+// Must match the depth pre-pass exactly, the depth is tested with equal after it
+invariant gl_Position;
+
+void main()
+{
+    mat4 model = instances.models[gl_InstanceIndex];
+
+    gl_Position = instances.proj * instances.view * model * vec4(inPosition, 1.0);
+    fragColor = inColor;
+	fragTexCoord = inTexCoord;
+	
+	mat3 transposeMat = mat3(transpose(inverse(model)));
+	
+	fragNormal = normalize(transposeMat * normal);
+    fragTangent = normalize(transposeMat * tangent);
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#version 450
+
+layout(binding = 0) uniform ShadowCascades {
+    mat4 transforms[4];
+    int cascadeCount;
+} cascades;
+
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    int cascade;
+} pushConstants;
+
+layout(location = 0) in vec3 inPosition;
+
+void main()
+{
+    gl_Position = cascades.transforms[pushConstants.cascade] * pushConstants.model * vec4(inPosition, 1.0);
+}
@@ -1,22 +1,18 @@
 #version 450
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec2 inTexCoord;
-layout(location = 3) in vec3 normal;
-layout(location = 4) in vec3 tanget;
-
-layout(binding = 0) uniform UniformBufferObject {
-    mat4 model;
-    mat4 view;
-    mat4 proj;
-} ubo;
+layout(push_constant) uniform PushConstants {
+    mat4 inverseViewProjection;
+} pushConstants;
 
 layout (location = 0) out vec3 outUVW;
 
 void main()
 {
-    outUVW = inPosition;
-    mat4 viewMat = mat4(mat3(ubo.view));
-    gl_Position = ubo.proj * viewMat * vec4(inPosition.xyz, 1.0);
+    // Generate a triangle that covers the whole screen on the far plane, only pixels nothing was drawn to pass the depth test
+    vec2 uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(uv * 2.0 - 1.0, 1.0, 1.0);
+
+    // The view projection has no translation, so the point on the far plane is the view direction
+    vec4 farPoint = pushConstants.inverseViewProjection * gl_Position;
+    outUVW = farPoint.xyz / farPoint.w;
 }
\ No newline at end of file
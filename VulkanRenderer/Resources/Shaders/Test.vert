@@ -16,6 +16,9 @@ layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
 layout(location = 2) out vec3 fragNormal;
 
+// Must match the depth pre-pass exactly, the depth is tested with equal after it
+invariant gl_Position;
+
 void main()
 {
     gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
@@ -0,0 +1,21 @@
+#version 450
+
+layout(binding = 0) uniform sampler2D sceneSampler;
+
+layout(push_constant) uniform PushConstants {
+    vec2 uvScale;
+} pushConstants;
+
+layout(location = 0) in vec2 inUV;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    // Only the top left part of the scene image is rendered to, don't filter in texels outside of it
+    vec2 maxUV = pushConstants.uvScale - 0.5 / vec2(textureSize(sceneSampler, 0));
+    vec2 uv = min(inUV * pushConstants.uvScale, maxUV);
+
+    // Bilinear filtering upscales the scene to the size of the swapchain
+    outColor = texture(sceneSampler, uv);
+}
@@ -4,12 +4,11 @@
 #include "Camera.h"
 
 // File includes
-#include "Includes/ImGuiIncludes.h"
-
 #include "Utils/Utils.h"
 
 #include "Engine/Window.h"
 #include "Engine/TimeManager.h"
+#include "Engine/CPUProfiler.h"
 
 #include "Vulkan/Vulkan3D.h"
 
@@ -22,31 +21,31 @@ DDM3::Camera::~Camera()
 {
 }
 
-void DDM3::Camera::Update()
+void DDM3::Camera::Update(const InputState& input)
 {
-	glm::vec3 direction{};
+	DDM3_PROFILE_SCOPE("Camera::Update");
 
-	auto window = Window::GetInstance().GetWindowStruct().pWindow;
+	glm::vec3 direction{};
 
 	auto deltaTime = TimeManager::GetInstance().GetDeltaTime();
 
 	// Determine movement direction based on key presses
-	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+	if (input.forward)
 	{
 		//direction += transform->GetForward() * m_Speed * deltaTime;
 		direction += GetForward();
 	}
-	if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+	if (input.backward)
 	{
 		//direction -= transform->GetForward() * m_Speed * deltaTime;
 		direction -= GetForward();
 	}
-	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+	if (input.left)
 	{
 		//direction -= transform->GetRight() * m_Speed * deltaTime;
 		direction -= GetRight();
 	}
-	if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+	if (input.right)
 	{
 		//direction += transform->GetRight() * m_Speed * deltaTime;
 		direction += GetRight();
@@ -56,7 +55,7 @@ void DDM3::Camera::Update()
 
 	direction *= m_Speed * deltaTime;
 
-	if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
+	if (input.sprint)
 	{
 		direction *= 2;
 	}
@@ -65,16 +64,10 @@ void DDM3::Camera::Update()
 	// Translate the object based on the rotated movement direction
 	SetPosition(GetPosition() + direction);
 
-	double xpos, ypos;
-	glfwGetCursorPos(window, &xpos, &ypos);
-
-	if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) &&
-		!ImGui::IsAnyItemActive() &&
-		!ImGui::IsAnyItemHovered() &&
-		!ImGui::IsWindowHovered(ImGuiHoveredFlags_AnyWindow))
+	if (input.rotate)
 	{
-		double deltaX = xpos - m_PrevXPos;
-		double deltaY = ypos - m_PrevYPos;
+		double deltaX = input.cursorX - m_PrevXPos;
+		double deltaY = input.cursorY - m_PrevYPos;
 
 		m_TotalPitch += static_cast<float>(deltaY * deltaTime * m_AngularSpeed);
 		m_TotalYaw += static_cast<float>(deltaX * deltaTime * m_AngularSpeed);
@@ -83,8 +76,8 @@ void DDM3::Camera::Update()
 		SetRotation(m_TotalPitch, m_TotalYaw, 0);
 	}
 
-	m_PrevXPos = xpos;
-	m_PrevYPos = ypos;
+	m_PrevXPos = input.cursorX;
+	m_PrevYPos = input.cursorY;
 }
 
 void DDM3::Camera::SetDirection(glm::vec3& direction)
@@ -96,22 +89,42 @@ void DDM3::Camera::SetDirection(glm::vec3& direction)
 
 void DDM3::Camera::UpdateUniformBuffer(UniformBufferObject& buffer)
 {
-	VkExtent2D extent{Vulkan3D::GetInstance().GetRenderer().GetSwapchainExtent()};
+	GetState().UpdateUniformBuffer(buffer);
+}
+
+DDM3::CameraState DDM3::Camera::GetState()
+{
 	// If the camera transform has changed, update matrix
 	if (m_HasChanged)
 		UpdateMatrix();
 
+	CameraState state{};
+	state.view = m_Matrix;
+	state.position = m_Position;
+	state.type = m_Type;
+	state.fovAngle = m_FovAngle;
+	state.nearPlane = m_NearPlane;
+	state.farPlane = m_FarPlane;
+	state.orthoBorders = m_OrthoBorders;
+
+	return state;
+}
+
+void DDM3::CameraState::UpdateUniformBuffer(UniformBufferObject& buffer) const
+{
+	VkExtent2D extent{Vulkan3D::GetInstance().GetRenderer().GetSwapchainExtent()};
+
 	// Set buffer view matrix
-	buffer.view = m_Matrix;
+	buffer.view = view;
 
-	switch (m_Type)
+	switch (type)
 	{
 	case DDM3::CameraType::Perspective:
 		// Set the projection matrix
-		buffer.proj = glm::perspective(m_FovAngle, extent.width / static_cast<float>(extent.height), 0.1f, 100.0f);
+		buffer.proj = glm::perspective(fovAngle, extent.width / static_cast<float>(extent.height), nearPlane, farPlane);
 		break;
 	case DDM3::CameraType::Ortographic:
-		buffer.proj = glm::ortho( m_OrthoBorders.x, m_OrthoBorders.y, m_OrthoBorders.z, m_OrthoBorders.w, 0.1f, 100.f);
+		buffer.proj = glm::ortho( orthoBorders.x, orthoBorders.y, orthoBorders.z, orthoBorders.w, nearPlane, farPlane);
 		break;
 	default:
 		break;
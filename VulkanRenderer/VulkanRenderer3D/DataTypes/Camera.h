@@ -17,6 +17,33 @@ namespace DDM3
 		Ortographic
 	};
 
+	// Struct forward declarations
+	struct InputState;
+
+	// The values of a camera needed to render a frame
+	// A copy is stored in the frame packet, so the camera can move while the previous frame is rendered
+	struct CameraState
+	{
+		// The view matrix
+		glm::mat4 view{};
+		// The position of the camera
+		glm::vec3 position{};
+		// The type of projection
+		CameraType type{ CameraType::Perspective };
+		// The fov angle in radians
+		float fovAngle{};
+		// The distance of the near and far plane
+		float nearPlane{};
+		float farPlane{};
+		// The borders of the orthographic projection
+		glm::vec4 orthoBorders{};
+
+		// Update uniform buffer with the view and projection matrix, the aspect ratio is taken from the swapchain
+		// Parameters:
+		//     buffer: reference to the uniform buffer object that needs updating
+		void UpdateUniformBuffer(UniformBufferObject& buffer) const;
+	};
+
 	class Camera
 	{
 	public:
@@ -32,7 +59,10 @@ namespace DDM3
 		Camera& operator=(Camera& other) = delete;
 		Camera& operator=(Camera&& other) = delete;
 
-		void Update();
+		// Move and rotate the camera with the input of this frame
+		// Parameters:
+		//     input: the state of the keyboard and mouse
+		void Update(const InputState& input);
 
 		// Set position
 		// Parameters:
@@ -104,11 +134,19 @@ namespace DDM3
 		// Get the scale of the camera
 		const glm::vec3& GetScale() const { return m_Scale; }
 
+		// Get the distance of the near plane
+		float GetNearPlane() const { return m_NearPlane; }
+		// Get the distance of the far plane
+		float GetFarPlane() const { return m_FarPlane; }
+
 		// Update uniform buffer with camera transform
 		// Parameters:
 		//     buffer: reference to the uniform buffer object that needs updating
 		void UpdateUniformBuffer(UniformBufferObject& buffer);
 
+		// Get the values needed to render a frame with this camera
+		CameraState GetState();
+
 		glm::vec3 GetForward();
 
 		glm::vec3 GetRight();
@@ -143,6 +181,11 @@ namespace DDM3
 		
 		glm::vec4 m_OrthoBorders{ -25, 25, -25, 25 };
 
+		// Distance of the near plane
+		const float m_NearPlane{ 0.1f };
+		// Distance of the far plane
+		const float m_FarPlane{ 100.f };
+
 		// Vector 3 for the position
 		glm::vec3 m_Position{0, 0, 0};
 
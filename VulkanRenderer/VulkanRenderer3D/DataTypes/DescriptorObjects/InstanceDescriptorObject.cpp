@@ -0,0 +1,194 @@
+// InstanceDescriptorObject.cpp
+
+// Header include
+#include "InstanceDescriptorObject.h"
+
+// File includes
+#include "Vulkan/Vulkan3D.h"
+
+// Standard library includes
+#include <cstring>
+
+DDM3::InstanceDescriptorObject::InstanceDescriptorObject()
+	:DescriptorObject(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+{
+	// Set up the buffers and buffer infos
+	SetupBuffers();
+	SetupBufferInfos();
+}
+
+DDM3::InstanceDescriptorObject::~InstanceDescriptorObject()
+{
+	// Clean up
+	Cleanup(Vulkan3D::GetInstance().GetDevice());
+}
+
+void DDM3::InstanceDescriptorObject::AddDescriptorWrite(VkDescriptorSet descriptorSet, std::vector<VkWriteDescriptorSet>& descriptorWrites, int& binding, int index)
+{
+	// Resize the descriptor writes so that the current descriptor write fits
+	descriptorWrites.resize(binding + 1);
+
+	// Set the type to WriteDescriptorSet
+	descriptorWrites[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	// Set the binding used in the shader
+	descriptorWrites[binding].dstBinding = binding;
+	// Set array index
+	descriptorWrites[binding].dstArrayElement = 0;
+	// Set descriptor type
+	descriptorWrites[binding].descriptorType = m_Type;
+	// Set descriptor amount
+	descriptorWrites[binding].descriptorCount = 1;
+	// Set the correct bufferInfo
+	descriptorWrites[binding].pBufferInfo = &m_BufferInfos[index];
+	// Give the correct descriptorset
+	descriptorWrites[binding].dstSet = descriptorSet;
+
+	binding++;
+}
+
+bool DDM3::InstanceDescriptorObject::UpdateInstanceBuffer(const UniformBufferObject& ubo, const std::vector<glm::mat4>& transforms, uint32_t frame)
+{
+	// Get handle of device
+	auto device{ Vulkan3D::GetInstance().GetDevice() };
+
+	// Destroy the buffers that were replaced before the frames in flight started
+	ReleaseRetiredBuffers(device);
+
+	// Check if the buffers have to grow
+	bool resized{ false };
+
+	if (transforms.size() > m_Capacity)
+	{
+		// Double the capacity until all the instances fit
+		while (transforms.size() > m_Capacity)
+		{
+			m_Capacity *= 2;
+		}
+
+		// Retire the old buffers, frames in flight might still read them
+		m_RetiredBuffers.push_back(RetiredBuffers{ std::move(m_Buffers), std::move(m_BuffersMemory), Vulkan3D::GetFrameCount() });
+		m_Buffers.clear();
+		m_BuffersMemory.clear();
+		m_BuffersMapped.clear();
+
+		// Recreate the buffers and buffer infos with the new capacity
+		SetupBuffers();
+		SetupBufferInfos();
+
+		resized = true;
+	}
+
+	// Get pointer to the mapped memory of the current frame
+	char* pData{ reinterpret_cast<char*>(m_BuffersMapped[frame]) };
+
+	// Copy the view matrix
+	memcpy(pData, &ubo.view, sizeof(glm::mat4));
+	// Copy the projection matrix
+	memcpy(pData + sizeof(glm::mat4), &ubo.proj, sizeof(glm::mat4));
+	// Copy the model matrices of every instance
+	memcpy(pData + 2 * sizeof(glm::mat4), transforms.data(), transforms.size() * sizeof(glm::mat4));
+
+	return resized;
+}
+
+VkDeviceSize DDM3::InstanceDescriptorObject::GetBufferSize() const
+{
+	// View and projection matrix followed by a model matrix per instance
+	return static_cast<VkDeviceSize>(sizeof(glm::mat4)) * (2 + m_Capacity);
+}
+
+void DDM3::InstanceDescriptorObject::SetupBuffers()
+{
+	// Get reference to renderer
+	auto& renderer = Vulkan3D::GetInstance().GetRenderer();
+	// Get amount of frames
+	auto frames = Vulkan3D::GetMaxFrames();
+
+	// Get size of the buffer
+	VkDeviceSize bufferSize = GetBufferSize();
+
+	// Resize buffers to amount of frames
+	m_Buffers.resize(frames);
+	// Resize memory to amount of frames
+	m_BuffersMemory.resize(frames);
+	// Resize mapped memory to amount of frames
+	m_BuffersMapped.resize(frames);
+
+	// Loop for the amount of frames there are
+	for (size_t i = 0; i < frames; ++i)
+	{
+		// Create memory
+		renderer.CreateBuffer(bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			m_Buffers[i], m_BuffersMemory[i]);
+
+		// Map memory from buffer memory to buffers mapped
+		vkMapMemory(Vulkan3D::GetInstance().GetDevice(), m_BuffersMemory[i], 0, bufferSize, 0, &m_BuffersMapped[i]);
+	}
+}
+
+void DDM3::InstanceDescriptorObject::SetupBufferInfos()
+{
+	// Resize the buffer infos
+	m_BufferInfos.resize(m_Buffers.size());
+
+	for (size_t i{}; i < m_BufferInfos.size(); i++)
+	{
+		// Set the correct buffer
+		m_BufferInfos[i].buffer = m_Buffers[i];
+		// Offset should be 0
+		m_BufferInfos[i].offset = 0;
+		// Give the size of the entire buffer
+		m_BufferInfos[i].range = GetBufferSize();
+	}
+}
+
+void DDM3::InstanceDescriptorObject::ReleaseRetiredBuffers(VkDevice device)
+{
+	// Get the amount of frames in flight
+	auto frames{ Vulkan3D::GetMaxFrames() };
+	// Get the amount of frames that have been rendered
+	auto frameCount{ Vulkan3D::GetFrameCount() };
+
+	// Once as many frames as there are frames in flight have been rendered since retiring, the buffers are no longer in use
+	while (!m_RetiredBuffers.empty() && m_RetiredBuffers.front().frame + frames <= frameCount)
+	{
+		// Destroy the buffers and free their memory
+		auto& retired{ m_RetiredBuffers.front() };
+		for (size_t i{}; i < retired.buffers.size(); ++i)
+		{
+			vkDestroyBuffer(device, retired.buffers[i], nullptr);
+			vkFreeMemory(device, retired.buffersMemory[i], nullptr);
+		}
+
+		// Remove them from the retired buffers
+		m_RetiredBuffers.pop_front();
+	}
+}
+
+void DDM3::InstanceDescriptorObject::Cleanup(VkDevice device)
+{
+	// Destroy the retired buffers, the owner makes sure they are no longer in use
+	for (auto& retired : m_RetiredBuffers)
+	{
+		for (size_t i{}; i < retired.buffers.size(); ++i)
+		{
+			vkDestroyBuffer(device, retired.buffers[i], nullptr);
+			vkFreeMemory(device, retired.buffersMemory[i], nullptr);
+		}
+	}
+	m_RetiredBuffers.clear();
+
+	// Loop for the amount of frames
+	for (size_t i = 0; i < m_Buffers.size(); ++i)
+	{
+		// Destroy storage buffer
+		vkDestroyBuffer(device, m_Buffers[i], nullptr);
+		// Free storage buffer memory
+		vkFreeMemory(device, m_BuffersMemory[i], nullptr);
+	}
+
+	// Clear the vectors
+	m_Buffers.clear();
+	m_BuffersMemory.clear();
+	m_BuffersMapped.clear();
+}
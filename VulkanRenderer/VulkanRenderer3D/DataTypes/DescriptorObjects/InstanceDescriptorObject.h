@@ -0,0 +1,94 @@
+// InstanceDescriptorObject.h
+// This class will handle the storage buffers that hold the per instance transforms of an instanced draw
+// The buffer holds the view and projection matrix followed by one model matrix per instance
+
+#ifndef InstanceDescriptorObjectIncluded
+#define InstanceDescriptorObjectIncluded
+
+// Parent class include
+#include "DescriptorObject.h"
+
+// File includes
+#include "Includes/GLMIncludes.h"
+#include "DataTypes/Structs.h"
+
+// Standard library includes
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace DDM3
+{
+	class InstanceDescriptorObject final : public DescriptorObject
+	{
+	public:
+		// Constructor
+		InstanceDescriptorObject();
+
+		// Destructor
+		virtual ~InstanceDescriptorObject();
+
+		// Add the descriptor write objects to the list of descriptorWrites
+		// Parameters:
+		//     descriptorSet: the current descriptorset connected to this descriptor object
+		//     descriptorWrites: the list of descriptorWrites this function will add to
+		//     binding: the current binding in the shader files
+		//     index: the current frame index of the renderer
+		virtual void AddDescriptorWrite(VkDescriptorSet descriptorSet, std::vector<VkWriteDescriptorSet>& descriptorWrites, int& binding, int index) override;
+
+		// Update the buffer of the current frame
+		// Returns true if the buffers had to be recreated, the descriptorsets will have to be replaced in that case
+		// The old buffers are retired, frames in flight might still use them
+		// Parameters:
+		//     ubo: the uniform buffer object holding the view and projection matrix
+		//     transforms: the model matrices of every instance
+		//     frame: the index of the current frame
+		bool UpdateInstanceBuffer(const UniformBufferObject& ubo, const std::vector<glm::mat4>& transforms, uint32_t frame);
+
+	private:
+		// The amount of instances the buffers can currently hold
+		uint32_t m_Capacity{ 16 };
+
+		// Vector of storage buffers
+		std::vector<VkBuffer> m_Buffers{};
+		// Vector of memories for the storage buffers
+		std::vector<VkDeviceMemory> m_BuffersMemory{};
+		// Pointers to mapped storage buffers
+		std::vector<void*> m_BuffersMapped{};
+
+		// BufferInfos
+		std::vector<VkDescriptorBufferInfo> m_BufferInfos{};
+
+		// Buffers that were replaced, together with the frame they were replaced in
+		struct RetiredBuffers
+		{
+			std::vector<VkBuffer> buffers{};
+			std::vector<VkDeviceMemory> buffersMemory{};
+			uint64_t frame{};
+		};
+
+		// Buffers that were replaced but might still be used by frames in flight, ordered by the frame they were replaced in
+		std::deque<RetiredBuffers> m_RetiredBuffers{};
+
+		// Get the size of a buffer that can hold the current capacity
+		VkDeviceSize GetBufferSize() const;
+
+		// Set up the buffers
+		void SetupBuffers();
+
+		// Set up the buffer infos
+		void SetupBufferInfos();
+
+		// Destroy the retired buffers that are no longer in use
+		// Parameters:
+		//     device: handle of the VkDevice
+		void ReleaseRetiredBuffers(VkDevice device);
+
+		// Clean up
+		// Parameters:
+		//     device: handle of the VkDevice
+		void Cleanup(VkDevice device);
+	};
+}
+
+#endif // !InstanceDescriptorObjectIncluded
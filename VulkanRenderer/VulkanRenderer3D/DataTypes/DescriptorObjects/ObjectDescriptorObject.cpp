@@ -0,0 +1,150 @@
+// ObjectDescriptorObject.cpp
+
+// Header include
+#include "ObjectDescriptorObject.h"
+
+// File includes
+#include "Vulkan/Vulkan3D.h"
+
+// Standard library includes
+#include <cstring>
+
+DDM3::ObjectDescriptorObject::ObjectDescriptorObject()
+	:DescriptorObject(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+{
+	// Set up the buffers and buffer infos
+	SetupBuffers();
+	SetupBufferInfos();
+}
+
+DDM3::ObjectDescriptorObject::~ObjectDescriptorObject()
+{
+	// Clean up
+	Cleanup(Vulkan3D::GetInstance().GetDevice());
+}
+
+void DDM3::ObjectDescriptorObject::AddDescriptorWrite(VkDescriptorSet descriptorSet, std::vector<VkWriteDescriptorSet>& descriptorWrites, int& binding, int index)
+{
+	// Resize the descriptor writes so that the current descriptor write fits
+	descriptorWrites.resize(binding + 1);
+
+	// Set the type to WriteDescriptorSet
+	descriptorWrites[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	// Set the binding used in the shader
+	descriptorWrites[binding].dstBinding = binding;
+	// Set array index
+	descriptorWrites[binding].dstArrayElement = 0;
+	// Set descriptor type
+	descriptorWrites[binding].descriptorType = m_Type;
+	// Set descriptor amount
+	descriptorWrites[binding].descriptorCount = 1;
+	// Set the correct bufferInfo
+	descriptorWrites[binding].pBufferInfo = &m_BufferInfos[index];
+	// Give the correct descriptorset
+	descriptorWrites[binding].dstSet = descriptorSet;
+
+	binding++;
+}
+
+bool DDM3::ObjectDescriptorObject::Reserve(uint32_t objectCount)
+{
+	// If the objects already fit, nothing has to happen
+	if (objectCount <= m_Capacity)
+		return false;
+
+	// Double the capacity until all the objects fit
+	while (objectCount > m_Capacity)
+	{
+		m_Capacity *= 2;
+	}
+
+	// Get handle of device
+	auto device{ Vulkan3D::GetInstance().GetDevice() };
+
+	// Wait until device is idle, the old buffers might still be in use
+	vkDeviceWaitIdle(device);
+
+	// Recreate the buffers and buffer infos with the new capacity
+	Cleanup(device);
+	SetupBuffers();
+	SetupBufferInfos();
+
+	return true;
+}
+
+void DDM3::ObjectDescriptorObject::SetObject(uint32_t objectIndex, const ObjectData& objectData, uint32_t frame)
+{
+	// Get pointer to the mapped memory of the current frame
+	ObjectData* pData{ reinterpret_cast<ObjectData*>(m_BuffersMapped[frame]) };
+
+	// Copy the object data to its spot in the buffer
+	memcpy(pData + objectIndex, &objectData, sizeof(ObjectData));
+}
+
+VkDeviceSize DDM3::ObjectDescriptorObject::GetBufferSize() const
+{
+	// One object data struct per object
+	return static_cast<VkDeviceSize>(sizeof(ObjectData)) * m_Capacity;
+}
+
+void DDM3::ObjectDescriptorObject::SetupBuffers()
+{
+	// Get reference to renderer
+	auto& renderer = Vulkan3D::GetInstance().GetRenderer();
+	// Get amount of frames
+	auto frames = Vulkan3D::GetMaxFrames();
+
+	// Get size of the buffer
+	VkDeviceSize bufferSize = GetBufferSize();
+
+	// Resize buffers to amount of frames
+	m_Buffers.resize(frames);
+	// Resize memory to amount of frames
+	m_BuffersMemory.resize(frames);
+	// Resize mapped memory to amount of frames
+	m_BuffersMapped.resize(frames);
+
+	// Loop for the amount of frames there are
+	for (size_t i = 0; i < frames; ++i)
+	{
+		// Create memory
+		renderer.CreateBuffer(bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			m_Buffers[i], m_BuffersMemory[i]);
+
+		// Map memory from buffer memory to buffers mapped
+		vkMapMemory(Vulkan3D::GetInstance().GetDevice(), m_BuffersMemory[i], 0, bufferSize, 0, &m_BuffersMapped[i]);
+	}
+}
+
+void DDM3::ObjectDescriptorObject::SetupBufferInfos()
+{
+	// Resize the buffer infos
+	m_BufferInfos.resize(m_Buffers.size());
+
+	for (size_t i{}; i < m_BufferInfos.size(); i++)
+	{
+		// Set the correct buffer
+		m_BufferInfos[i].buffer = m_Buffers[i];
+		// Offset should be 0
+		m_BufferInfos[i].offset = 0;
+		// Give the size of the entire buffer
+		m_BufferInfos[i].range = GetBufferSize();
+	}
+}
+
+void DDM3::ObjectDescriptorObject::Cleanup(VkDevice device)
+{
+	// Loop for the amount of frames
+	for (size_t i = 0; i < m_Buffers.size(); ++i)
+	{
+		// Destroy storage buffer
+		vkDestroyBuffer(device, m_Buffers[i], nullptr);
+		// Free storage buffer memory
+		vkFreeMemory(device, m_BuffersMemory[i], nullptr);
+	}
+
+	// Clear the vectors
+	m_Buffers.clear();
+	m_BuffersMemory.clear();
+	m_BuffersMapped.clear();
+}
@@ -0,0 +1,79 @@
+// ObjectDescriptorObject.h
+// This class will handle the storage buffers that hold the object data used when rendering with bindless descriptors
+// The buffer holds one ObjectData struct per model, indexed in the shaders with gl_InstanceIndex
+
+#ifndef ObjectDescriptorObjectIncluded
+#define ObjectDescriptorObjectIncluded
+
+// Parent class include
+#include "DescriptorObject.h"
+
+// File includes
+#include "DataTypes/Structs.h"
+
+// Standard library includes
+#include <vector>
+
+namespace DDM3
+{
+	class ObjectDescriptorObject final : public DescriptorObject
+	{
+	public:
+		// Constructor
+		ObjectDescriptorObject();
+
+		// Destructor
+		virtual ~ObjectDescriptorObject();
+
+		// Add the descriptor write objects to the list of descriptorWrites
+		// Parameters:
+		//     descriptorSet: the current descriptorset connected to this descriptor object
+		//     descriptorWrites: the list of descriptorWrites this function will add to
+		//     binding: the current binding in the shader files
+		//     index: the current frame index of the renderer
+		virtual void AddDescriptorWrite(VkDescriptorSet descriptorSet, std::vector<VkWriteDescriptorSet>& descriptorWrites, int& binding, int index) override;
+
+		// Make sure the buffers can hold the given amount of objects
+		// Returns true if the buffers had to be recreated, the descriptorsets will have to be updated in that case
+		// Parameters:
+		//     objectCount: the amount of objects the buffers should be able to hold
+		bool Reserve(uint32_t objectCount);
+
+		// Write the data of an object to the buffer of the given frame
+		// Parameters:
+		//     objectIndex: the index of the object in the buffer
+		//     objectData: the data of the object
+		//     frame: the index of the current frame
+		void SetObject(uint32_t objectIndex, const ObjectData& objectData, uint32_t frame);
+
+	private:
+		// The amount of objects the buffers can currently hold
+		uint32_t m_Capacity{ 64 };
+
+		// Vector of storage buffers
+		std::vector<VkBuffer> m_Buffers{};
+		// Vector of memories for the storage buffers
+		std::vector<VkDeviceMemory> m_BuffersMemory{};
+		// Pointers to mapped storage buffers
+		std::vector<void*> m_BuffersMapped{};
+
+		// BufferInfos
+		std::vector<VkDescriptorBufferInfo> m_BufferInfos{};
+
+		// Get the size of a buffer that can hold the current capacity
+		VkDeviceSize GetBufferSize() const;
+
+		// Set up the buffers
+		void SetupBuffers();
+
+		// Set up the buffer infos
+		void SetupBufferInfos();
+
+		// Clean up
+		// Parameters:
+		//     device: handle of the VkDevice
+		void Cleanup(VkDevice device);
+	};
+}
+
+#endif // !ObjectDescriptorObjectIncluded
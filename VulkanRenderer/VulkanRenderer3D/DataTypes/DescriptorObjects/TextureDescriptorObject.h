@@ -46,6 +46,9 @@ namespace DDM3
 
         Texture& GetTexture(int index = 0);
 
+        // Get the amount of textures in this object
+        size_t GetTextureCount() const { return m_Textures.size(); }
+
     private:
         // List of the textures
         std::vector<Texture> m_Textures{};
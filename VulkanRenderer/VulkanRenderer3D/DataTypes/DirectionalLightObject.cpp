@@ -8,13 +8,29 @@
 
 #include "Camera.h"
 
+#include "Engine/ConfigManager.h"
+
 #include "Utils/Utils.h"
 
 // Standard library includes
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 
 DDM3::DirectionalLightObject::DirectionalLightObject()
 {
+	// Get config manager
+	auto& configManager{ ConfigManager::GetInstance() };
+
+	// Get the amount of cascades, at least 1 and at most the amount the shaders support
+	m_Cascades.cascadeCount = std::clamp(configManager.GetInt("ShadowCascadeCount"), 1, static_cast<int>(ShadowCascadesStruct::maxCascades));
+
+	// Get the split blend factor
+	m_SplitLambda = std::clamp(configManager.GetFloat("ShadowCascadeSplitLambda"), 0.f, 1.f);
+
+	// Get the size of the shadow map
+	m_ShadowMapSize = static_cast<float>(configManager.GetInt("ShadowMapSize"));
+
 	// Create light buffer
 	CreateLightBuffer();
 }
@@ -29,20 +45,18 @@ void DDM3::DirectionalLightObject::CreateLightBuffer()
 	// Get the amount of frames in flight
 	int frames = static_cast<int>(Vulkan3D::GetMaxFrames());
 
-	// Resize dirty flags to amount of frames
-	m_LightChanged.resize(frames);
-	
-
-	// Set all dirty flags to true
-	SetDirtyFlags();
+	// Resize the uploaded lights and dirty flags to amount of frames
+	m_UploadedLights.resize(frames, m_BufferObject);
+	m_CascadesChanged.resize(frames);
 
 	m_DescriptorObject = std::make_unique<UboDescriptorObject<DirectionalLightStruct>>();
 
-	m_LightMatrixDescriptorObject = std::make_unique<UboDescriptorObject<glm::mat4>>();
+	m_CascadesDescriptorObject = std::make_unique<UboDescriptorObject<ShadowCascadesStruct>>();
 
+	// Upload the light, the cascades are calculated once the first frame is rendered
 	for (int i{}; i < frames; i++)
 	{
-		CalculateLightTransform(i);
+		m_DescriptorObject->UpdateUboBuffer(m_BufferObject, i);
 	}
 }
 
@@ -51,104 +65,171 @@ void DDM3::DirectionalLightObject::Cleanup(VkDevice /*device*/)
 	
 }
 
-void DDM3::DirectionalLightObject::SetDirtyFlags()
+void DDM3::DirectionalLightObject::CalculateCascades(const UniformBufferObject& cameraUbo, const FramePacket& packet)
 {
-	// Fill dirty flag with true values
-	std::fill(m_LightChanged.begin(), m_LightChanged.end(), true);
-}
+	// Get the direction of the light
+	const glm::vec3& lightDirection{ packet.light.direction };
 
-void DDM3::DirectionalLightObject::CalculateLightTransform(int frame)
-{
-	auto cameraPos = Vulkan3D::GetInstance().GetCurrentCamera()->GetPosition();
-	//cameraPos = glm::vec3{};
+	// Transformation from normalized device coordinates back to world space
+	glm::mat4 inverseViewProjection{ glm::inverse(cameraUbo.proj * cameraUbo.view) };
 
-	// Define a virtual light position far away in the opposite direction of the light relative to the camera position
-	glm::vec3 lightPos = cameraPos - m_BufferObject.direction * (m_ClippingDistance * 0.5f); // Move the light far away from the camera position
+	// Get the corners of the view frustum, the near corners first and the far corners in the same order
+	std::array<glm::vec3, 8> frustumCorners{};
+	for (int i{}; i < 8; ++i)
+	{
+		glm::vec4 corner{ inverseViewProjection * glm::vec4{ (i & 1) ? 1.f : -1.f, (i & 2) ? 1.f : -1.f, (i & 4) ? 1.f : 0.f, 1.f } };
+		frustumCorners[i] = glm::vec3{ corner } / corner.w;
+	}
 
-	// Create rotation matrix
-	glm::mat4 rotationMatrix = glm::mat4_cast(glm::conjugate(Utils::RotationFromDirection(m_BufferObject.direction)));
+	// Get the near and far plane
+	const float nearPlane{ packet.camera.nearPlane };
+	const float farPlane{ packet.camera.farPlane };
 
-	// Create translation matrix
-	glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), -lightPos);
+	// Rotation from world space to light space, the light shines along the z axis
+	glm::mat4 rotationMatrix = glm::mat4_cast(glm::conjugate(Utils::RotationFromDirection(lightDirection)));
 
-	// Multiply matrices (apply rotation first, then translation)
-	glm::mat4 viewMatrix = rotationMatrix * translationMatrix;
+	// Start of the current slice
+	float sliceStart{ nearPlane };
 
-	// Create orthographic projection matrix
-	glm::mat4 projectionMatrix = glm::ortho(m_OrthoBorders.x, m_OrthoBorders.y, m_OrthoBorders.z, m_OrthoBorders.w, 0.1f, m_ClippingDistance);
+	for (int cascade{}; cascade < m_Cascades.cascadeCount; ++cascade)
+	{
+		// Blend between a logarithmic and a uniform split, logarithmic splits give the near cascades more detail
+		float splitFactor{ static_cast<float>(cascade + 1) / m_Cascades.cascadeCount };
+		float logarithmicSplit{ nearPlane * std::pow(farPlane / nearPlane, splitFactor) };
+		float uniformSplit{ nearPlane + (farPlane - nearPlane) * splitFactor };
+		float sliceEnd{ m_SplitLambda * logarithmicSplit + (1.f - m_SplitLambda) * uniformSplit };
+
+		// Get the corners of the slice by moving along the edges of the frustum
+		std::array<glm::vec3, 8> sliceCorners{};
+		for (int i{}; i < 4; ++i)
+		{
+			glm::vec3 edge{ frustumCorners[i + 4] - frustumCorners[i] };
+			sliceCorners[i] = frustumCorners[i] + edge * ((sliceStart - nearPlane) / (farPlane - nearPlane));
+			sliceCorners[i + 4] = frustumCorners[i] + edge * ((sliceEnd - nearPlane) / (farPlane - nearPlane));
+		}
+
+		// Get the center of the slice
+		glm::vec3 center{};
+		for (auto& corner : sliceCorners)
+		{
+			center += corner / 8.f;
+		}
+
+		// Fit a sphere around the slice, unlike a box its size doesn't change when the camera rotates
+		float radius{};
+		for (auto& corner : sliceCorners)
+		{
+			radius = std::max(radius, glm::length(corner - center));
+		}
+
+		// Round the radius up so small precision differences don't change the size of the cascade
+		radius = std::ceil(radius * 16.f) / 16.f;
+
+		// Snap the center to whole texels in light space, so the shadow edges don't shimmer when the camera moves
+		float texelSize{ 2.f * radius / m_ShadowMapSize };
+		glm::vec3 lightSpaceCenter{ rotationMatrix * glm::vec4{ center, 1.f } };
+		lightSpaceCenter.x = std::floor(lightSpaceCenter.x / texelSize) * texelSize;
+		lightSpaceCenter.y = std::floor(lightSpaceCenter.y / texelSize) * texelSize;
+		center = glm::vec3{ glm::transpose(rotationMatrix) * glm::vec4{ lightSpaceCenter, 1.f } };
+
+		// Place the light behind the slice in the opposite direction of the light
+		glm::vec3 lightPos{ center - lightDirection * (radius + m_ClippingDistance) };
+
+		// Create translation matrix
+		glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), -lightPos);
+
+		// Multiply matrices (apply rotation first, then translation)
+		glm::mat4 viewMatrix = rotationMatrix * translationMatrix;
+
+		// Create orthographic projection matrix around the slice
+		glm::mat4 projectionMatrix = glm::ortho(-radius, radius, -radius, radius, 0.f, 2.f * radius + m_ClippingDistance);
+
+		// Adjust the projection matrix for Vulkan
+		// Negate the Y-axis to flip it for Vulkan's coordinate system
+		projectionMatrix[1][1] *= -1;
+		projectionMatrix[2][2] *= -1;
+		projectionMatrix[2][3] *= -1;
+
+		// Calculate the light transform matrix of this cascade
+		m_Cascades.transforms[cascade] = projectionMatrix * viewMatrix;
+
+		// The next slice starts where this one ends
+		sliceStart = sliceEnd;
+	}
+}
 
-	// Adjust the projection matrix for Vulkan
-	// Negate the Y-axis to flip it for Vulkan's coordinate system
-	projectionMatrix[1][1] *= -1;
-	projectionMatrix[2][2] *= -1;
-	projectionMatrix[2][3] *= -1;
+void DDM3::DirectionalLightObject::UpdateBuffer(int frame)
+{
+	// Get the frame packet that is being rendered
+	auto& packet{ Vulkan3D::GetInstance().GetFramePacket() };
 
-	// Calculate the light transform matrix
-	m_LightTransform = projectionMatrix * viewMatrix;
+	// Get the view and projection matrix from the camera
+	UniformBufferObject ubo{};
+	packet.camera.UpdateUniformBuffer(ubo);
 
-	// Update the UBO with the new light transform matrix
-	m_LightMatrixDescriptorObject->UpdateUboBuffer(m_LightTransform, frame);
+	// Hash everything the cascades depend on
+	size_t cascadesHash{ std::hash<glm::mat4>()(ubo.proj * ubo.view) };
+	cascadesHash = Utils::HashCombine(cascadesHash, std::hash<glm::vec3>()(packet.light.direction));
 
+	// Only calculate the cascades again if the camera or the light direction changed
+	if (!m_CascadesCalculated || cascadesHash != m_CascadesHash)
+	{
+		CalculateCascades(ubo, packet);
 
-	//VulkanRenderer3D::GetInstance().GetCamera()->SetPosition(lightPos);
-	//VulkanRenderer3D::GetInstance().GetCamera()->SetDirection(m_BufferObject.direction);
-}
+		m_CascadesHash = cascadesHash;
+		m_CascadesCalculated = true;
 
-void DDM3::DirectionalLightObject::UpdateBuffer(int frame)
-{
-	CalculateLightTransform(frame);
-	// Check if dirty flag is set, if not, return
-	if (!m_LightChanged[frame])
+		// Every frame in flight has to upload the new cascades
+		std::fill(m_CascadesChanged.begin(), m_CascadesChanged.end(), true);
+	}
+
+	// Update the UBO of this frame if it doesn't hold the latest cascades yet
+	if (m_CascadesChanged[frame])
+	{
+		m_CascadesDescriptorObject->UpdateUboBuffer(m_Cascades, frame);
+
+		m_CascadesChanged[frame] = false;
+	}
+
+	// Check if the light of the packet differs from the one in the buffer of this frame, if not, return
+	auto& uploadedLight{ m_UploadedLights[frame] };
+	if (uploadedLight.direction == packet.light.direction && uploadedLight.color == packet.light.color &&
+		uploadedLight.intensity == packet.light.intensity)
 		return;
 
-	m_DescriptorObject->UpdateUboBuffer(m_BufferObject, frame);
+	uploadedLight = packet.light;
 
-	m_LightChanged[frame] = false;
+	m_DescriptorObject->UpdateUboBuffer(uploadedLight, frame);
 }
 
 void DDM3::DirectionalLightObject::SetDirection(glm::vec3& direction)
 {
 	// Set new direction after normalizing it
 	m_BufferObject.direction = glm::normalize(direction);
-
-	// Set dirty flags
-	SetDirtyFlags();
 }
 
 void DDM3::DirectionalLightObject::SetDirection(glm::vec3&& direction)
 {
 	// Set new direction after normalizing it
 	m_BufferObject.direction = glm::normalize(direction);
-
-	// Set dirty flags
-	SetDirtyFlags();
 }
 
 void DDM3::DirectionalLightObject::SetColor(glm::vec3& color)
 {
 	// Set new color
 	m_BufferObject.color = color;
-
-	// Set dirty flags
-	SetDirtyFlags();
 }
 
 void DDM3::DirectionalLightObject::SetColor(glm::vec3&& color)
 {
 	// Set new color
 	m_BufferObject.color = color;
-
-	// Set dirty flags
-	SetDirtyFlags();
 }
 
 void DDM3::DirectionalLightObject::SetIntensity(float intensity)
 {
 	// Set new intensity
 	m_BufferObject.intensity = intensity;
-
-	// Set dirty flags
-	SetDirtyFlags();
 }
 
 DDM3::DescriptorObject* DDM3::DirectionalLightObject::GetDescriptorObject()
@@ -158,10 +239,5 @@ DDM3::DescriptorObject* DDM3::DirectionalLightObject::GetDescriptorObject()
 
 DDM3::DescriptorObject* DDM3::DirectionalLightObject::GetTransformDescriptorObject()
 {
-	return static_cast<DescriptorObject*>(m_LightMatrixDescriptorObject.get());
+	return static_cast<DescriptorObject*>(m_CascadesDescriptorObject.get());
 }
-
-glm::mat4& DDM3::DirectionalLightObject::GetLightMatrix()
-{
-	return m_LightTransform;
-}
\ No newline at end of file
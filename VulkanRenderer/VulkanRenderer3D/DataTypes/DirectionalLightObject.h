@@ -1,5 +1,6 @@
 // DirectionalLightObject.h
 // This class will hold all the info, buffers and memory for a single directional light
+// The view frustum of the camera is split into slices, every slice gets its own shadow cascade
 
 #ifndef DirectionalLightObjectIncluded
 #define DirectionalLightObjectIncluded
@@ -17,6 +18,9 @@ namespace DDM3
 	// Class declaration for vulkan renderer
 	class VulkanRenderer3D;
 
+	// Struct forward declarations
+	struct FramePacket;
+
 	class DirectionalLightObject
 	{
 	public:
@@ -32,7 +36,7 @@ namespace DDM3
 		DirectionalLightObject& operator=(DirectionalLightObject& other) = delete;
 		DirectionalLightObject& operator=(DirectionalLightObject&& other) = delete;
 		
-		// Function for updating the vulkan buffers
+		// Function for updating the vulkan buffers with the light and camera of the frame packet that is being rendered
 		// Parameters:
 		//     frame: which frame in flight it currently is
 		void UpdateBuffer(int frame);
@@ -65,36 +69,54 @@ namespace DDM3
 		// Public getter for the vulkan buffers needed for the shader
 		DescriptorObject* GetDescriptorObject();
 
-		// Public getter for the vulkan buffers needed for the shader
+		// Public getter for the vulkan buffers holding the light transforms of the shadow cascades
 		DescriptorObject* GetTransformDescriptorObject();
 
 
-		// Public getter to get the struct that holds the values
+		// Public getter to get the struct that holds the values, copied into the frame packet by the simulation
 		const DirectionalLightStruct& GetLight() const { return m_BufferObject; }
 
-		glm::mat4& GetLightMatrix();
+		// Get the light transforms of the shadow cascades
+		const ShadowCascadesStruct& GetCascades() const { return m_Cascades; }
 	private:
+		// Distance behind every cascade that is still included, so casters outside of the view frustum still cast shadows into it
 		float m_ClippingDistance{ 100.f };
 		// Sttruct that holds the values of the light
 		DirectionalLightStruct m_BufferObject{};
 		
-		// Vector for dirty flags
-		std::vector<bool> m_LightChanged{};
+		// The values last uploaded to the buffer of every frame in flight
+		// The values are compared instead of using dirty flags, because the setters are called on the simulation thread
+		std::vector<DirectionalLightStruct> m_UploadedLights{};
+
+		// Vector for dirty flags of the cascades
+		std::vector<bool> m_CascadesChanged{};
+
+		// Hash of the camera matrices and the light direction the cascades were calculated with
+		size_t m_CascadesHash{};
+
+		// Indicates if the cascades have been calculated at least once
+		bool m_CascadesCalculated{ false };
 		
 		std::unique_ptr<UboDescriptorObject<DirectionalLightStruct>> m_DescriptorObject{};
-		std::unique_ptr<UboDescriptorObject<glm::mat4>> m_LightMatrixDescriptorObject{};
+		std::unique_ptr<UboDescriptorObject<ShadowCascadesStruct>> m_CascadesDescriptorObject{};
 		
-		glm::mat4 m_LightTransform{};
+		// The light transforms of the shadow cascades
+		ShadowCascadesStruct m_Cascades{};
+
+		// Blend between logarithmic and uniform splits, 1 is fully logarithmic
+		float m_SplitLambda{};
 
-		glm::vec4 m_OrthoBorders{ -25, 25, -25, 25 };
+		// Size of a single cascade of the shadow map in texels, used to snap the cascades to whole texels
+		float m_ShadowMapSize{};
 
 		// Function for creating the buffers
 		void CreateLightBuffer();
 		
-		// Function to set all dirty flags
-		void SetDirtyFlags();
-
-		void CalculateLightTransform(int frame);
+		// Split the view frustum of the camera and fit a cascade around every slice
+		// Parameters:
+		//     cameraUbo: the view and projection matrix of the camera
+		//     packet: the frame packet that is being rendered
+		void CalculateCascades(const UniformBufferObject& cameraUbo, const FramePacket& packet);
 
 		// Function for cleaning up allocated memory
 		// Parameters:
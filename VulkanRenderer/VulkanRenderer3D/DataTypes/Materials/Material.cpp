@@ -17,8 +17,29 @@
 
 DDM3::Material::Material(const std::string& pipelineName)
 {
+	// Get reference to the renderer
+	auto& renderer{ Vulkan3D::GetInstance().GetRenderer() };
+
 	// Get the requested pipeline from the renderer
-	m_Pipeline = Vulkan3D::GetInstance().GetRenderer().GetPipeline(pipelineName);
+	m_Pipeline = renderer.GetPipeline(pipelineName);
+
+	// Get the name of the instanced variant
+	const std::string instancedPipelineName{ pipelineName + "Instanced" };
+
+	// If the instanced variant exists, get it from the renderer
+	if (renderer.HasPipeline(instancedPipelineName))
+	{
+		m_pInstancedPipeline = renderer.GetPipeline(instancedPipelineName);
+	}
+
+	// Get the name of the bindless variant
+	const std::string bindlessPipelineName{ pipelineName + "Bindless" };
+
+	// If bindless descriptors are used and the bindless variant exists, get it from the renderer
+	if (renderer.GetBindlessManager() != nullptr && renderer.HasPipeline(bindlessPipelineName))
+	{
+		m_pBindlessPipeline = renderer.GetPipeline(bindlessPipelineName);
+	}
 }
 
 DDM3::Material::~Material()
@@ -31,16 +52,38 @@ DDM3::PipelineWrapper* DDM3::Material::GetPipeline()
 	return m_Pipeline;
 }
 
-void DDM3::Material::CreateDescriptorSets(Model* pModel, std::vector<VkDescriptorSet>& descriptorSets)
+DDM3::PipelineWrapper* DDM3::Material::GetInstancedPipeline()
+{
+	// Return the instanced pipeline
+	return m_pInstancedPipeline;
+}
+
+DDM3::PipelineWrapper* DDM3::Material::GetBindlessPipeline()
+{
+	// Return the bindless pipeline
+	return m_pBindlessPipeline;
+}
+
+bool DDM3::Material::UsesDepthPrepass() const
+{
+	// Alpha tested materials can't rely on the depth of the pre-pass, since it doesn't know which fragments are discarded
+	return !m_AlphaTested && Vulkan3D::GetInstance().GetRenderer().GetDepthPrepassRenderer() != nullptr;
+}
+
+void DDM3::Material::CreateDescriptorSets(std::vector<VkDescriptorSet>& descriptorSets)
 {
 	// Get pointer to the descriptorpool wrapper
 	auto descriptorPool = GetDescriptorPool();
-	// Add model to descriptorpool wrapper
-	descriptorPool->AddModel(pModel);
 	// Create descriptorpools
 	descriptorPool->CreateDescriptorSets(GetDescriptorLayout(), descriptorSets);
 }
 
+void DDM3::Material::FreeDescriptorSets(std::vector<VkDescriptorSet>& descriptorSets)
+{
+	// Give the descriptorsets back to the descriptorpool wrapper
+	GetDescriptorPool()->FreeDescriptorSets(GetDescriptorLayout(), descriptorSets);
+}
+
 void DDM3::Material::UpdateDescriptorSets(std::vector<VkDescriptorSet>& descriptorSets, std::vector<DescriptorObject*>& descriptorObjects)
 {
 	// Get pointer to the descriptorpool wrapper
@@ -15,7 +15,6 @@ namespace DDM3
 {
 	// Class forward declarations
 	class DescriptorPoolWrapper;
-	class Model;
 	class PipelineWrapper;
 	class DescriptorObject;
 
@@ -38,11 +37,39 @@ namespace DDM3
 		// Get the pipeline that is used by this material
 		PipelineWrapper* GetPipeline();
 
+		// Get the pipeline that is used when this material is rendered instanced
+		// Returns nullptr if no instanced variant of the pipeline exists
+		PipelineWrapper* GetInstancedPipeline();
+
+		// Get the pipeline that is used when this material is rendered with bindless descriptors
+		// Returns nullptr if bindless descriptors aren't used or no bindless variant of the pipeline exists
+		PipelineWrapper* GetBindlessPipeline();
+
+		// Set if the fragment shader of this material discards fragments
+		// Alpha tested materials are left out of the depth pre-pass and keep testing and writing depth themselves
+		// Parameters:
+		//     alphaTested: true if the material discards fragments
+		void SetAlphaTested(bool alphaTested) { m_AlphaTested = alphaTested; }
+
+		// Check if the fragment shader of this material discards fragments
+		bool IsAlphaTested() const { return m_AlphaTested; }
+
+		// Check if models with this material are drawn in the depth pre-pass
+		// If true, the depth equal variant of the pipelines has to be bound in the main pass
+		bool UsesDepthPrepass() const;
+
+		// Get the indices of the textures of this material in the bindless texture array, -1 if unused
+		const glm::ivec4& GetBindlessTextureIndices() const { return m_BindlessTextureIndices; }
+
 		// Create the descriptorsets
 		// Parameters:
-		//     pModel: the model that the descriptorsets belong to
 		//     descriptorSets: vector of descriptorsets that have to be created
-		virtual void CreateDescriptorSets(Model* pModel, std::vector<VkDescriptorSet>& descriptorSets);
+		virtual void CreateDescriptorSets(std::vector<VkDescriptorSet>& descriptorSets);
+
+		// Free the descriptorsets, they will be reused once they are no longer in use by any frame in flight
+		// Parameters:
+		//     descriptorSets: the descriptorsets that have to be freed, will be empty afterwards
+		void FreeDescriptorSets(std::vector<VkDescriptorSet>& descriptorSets);
 
 		// Update the descriptorsets
 		// Parameters:
@@ -59,6 +86,18 @@ namespace DDM3
 	protected:
 		// The pipeline pair that is used for this material
 		PipelineWrapper* m_Pipeline{};
+
+		// The instanced variant of the pipeline, named after the pipeline with "Instanced" appended
+		PipelineWrapper* m_pInstancedPipeline{};
+
+		// The bindless variant of the pipeline, named after the pipeline with "Bindless" appended
+		PipelineWrapper* m_pBindlessPipeline{};
+
+		// The indices of the textures of this material in the bindless texture array
+		glm::ivec4 m_BindlessTextureIndices{ -1, -1, -1, -1 };
+
+		// Indicates if the fragment shader of this material discards fragments
+		bool m_AlphaTested{ false };
 	};
 }
 #endif // !MaterialIncluded
\ No newline at end of file
@@ -28,12 +28,10 @@ DDM3::ShadowMaterial::~ShadowMaterial()
 {
 }
 
-void DDM3::ShadowMaterial::CreateDescriptorSets(Model* pModel, std::vector<VkDescriptorSet>& descriptorSets)
+void DDM3::ShadowMaterial::CreateDescriptorSets(std::vector<VkDescriptorSet>& descriptorSets)
 {
 	// Get descriptorpool associated with this material
 	auto descriptorPool = GetDescriptorPool();
-	// Add model to descriptorpool
-	descriptorPool->AddModel(pModel);
 	// Create descriptorpool
 	descriptorPool->CreateDescriptorSets(GetDescriptorLayout(), descriptorSets);
 }
@@ -30,9 +30,8 @@ namespace DDM3
 
 		// Create the descriptorsets
 		// Parameters:
-		//     pModel: the model the descriptorsets are bound to
 		//     descriptorSets: the descriptorsets that have to be created
-		virtual void CreateDescriptorSets(Model* pModel, std::vector<VkDescriptorSet>& descriptorSets) override;
+		virtual void CreateDescriptorSets(std::vector<VkDescriptorSet>& descriptorSets) override;
 
 		// Update the descriptorsets
 		// Parameters:
@@ -8,6 +8,10 @@
 #include "Includes/STBIncludes.h"
 #include "DataTypes/DescriptorObjects/TextureDescriptorObject.h"
 #include "DataTypes/DirectionalLightObject.h"
+#include "Vulkan/Managers/BindlessManager.h"
+
+// Standard library includes
+#include <algorithm>
 
 DDM3::TexturedMaterial::TexturedMaterial(std::initializer_list<const std::string>&& filePaths, const std::string& pipelineName)
 	:Material(pipelineName)
@@ -17,18 +21,27 @@ DDM3::TexturedMaterial::TexturedMaterial(std::initializer_list<const std::string
 
 	// Create sampler
 	CreateTextureSampler();
+
+	// If this material is rendered bindless, add the textures to the texture array
+	if (m_pBindlessPipeline != nullptr)
+	{
+		AddBindlessTextures();
+	}
 }
 
 DDM3::TexturedMaterial::~TexturedMaterial()
 {
+	// If this material is rendered bindless, remove the textures from the texture array
+	if (m_pBindlessPipeline != nullptr)
+	{
+		RemoveBindlessTextures();
+	}
 }
 
-void DDM3::TexturedMaterial::CreateDescriptorSets(Model* pModel, std::vector<VkDescriptorSet>& descriptorSets)
+void DDM3::TexturedMaterial::CreateDescriptorSets(std::vector<VkDescriptorSet>& descriptorSets)
 {
 	// Get descriptorpool associated with this material
 	auto descriptorPool = GetDescriptorPool();
-	// Add model to descriptorpool
-	descriptorPool->AddModel(pModel);
 	// Create descriptorpool
 	descriptorPool->CreateDescriptorSets(GetDescriptorLayout(), descriptorSets);
 }
@@ -61,3 +74,33 @@ void DDM3::TexturedMaterial::CreateTextureSampler()
 	// Get sampler
 	m_TextureSampler = Vulkan3D::GetInstance().GetRenderer().GetSampler();
 }
+
+void DDM3::TexturedMaterial::AddBindlessTextures()
+{
+	// Get the bindless manager
+	auto pBindlessManager{ Vulkan3D::GetInstance().GetRenderer().GetBindlessManager() };
+
+	// The object data holds up to 4 texture indices
+	auto textureCount{ std::min(m_pDescriptorObject->GetTextureCount(), static_cast<size_t>(4)) };
+
+	// Add the textures and store their indices
+	for (size_t i{}; i < textureCount; ++i)
+	{
+		m_BindlessTextureIndices[static_cast<int>(i)] = static_cast<int>(pBindlessManager->AddTexture(m_pDescriptorObject->GetTexture(static_cast<int>(i)).imageView));
+	}
+}
+
+void DDM3::TexturedMaterial::RemoveBindlessTextures()
+{
+	// Get the bindless manager
+	auto pBindlessManager{ Vulkan3D::GetInstance().GetRenderer().GetBindlessManager() };
+
+	// Remove every texture that was added
+	for (int i{}; i < 4; ++i)
+	{
+		if (m_BindlessTextureIndices[i] >= 0)
+		{
+			pBindlessManager->RemoveTexture(static_cast<uint32_t>(m_BindlessTextureIndices[i]));
+		}
+	}
+}
@@ -0,0 +1,103 @@
+// InstanceBatch.cpp
+
+// Header include
+#include "InstanceBatch.h"
+
+// File includes
+#include "Model.h"
+#include "Mesh.h"
+
+#include "DataTypes/Materials/Material.h"
+#include "DataTypes/DescriptorObjects/InstanceDescriptorObject.h"
+
+#include "Vulkan/Vulkan3D.h"
+#include "Vulkan/Wrappers/DescriptorPoolWrapper.h"
+#include "Vulkan/Wrappers/PipelineWrapper.h"
+
+DDM3::InstanceBatch::InstanceBatch(std::shared_ptr<Mesh> pMesh, std::shared_ptr<Material> pMaterial)
+	:m_pMesh{ pMesh },
+	m_pMaterial{ pMaterial }
+{
+	// Create the storage buffers for the transforms
+	m_pInstanceDescriptorObject = std::make_unique<InstanceDescriptorObject>();
+
+	// Create descriptorsets
+	CreateDescriptorSets();
+}
+
+DDM3::InstanceBatch::~InstanceBatch()
+{
+	// The owner only destroys the batch once the frames in flight that used it finished
+	// Give the descriptorsets back to the descriptorpool of the instanced pipeline
+	GetPipeline()->GetDescriptorPool()->FreeDescriptorSets(GetPipeline()->GetDescriptorSetLayout(), m_DescriptorSets);
+}
+
+void DDM3::InstanceBatch::Clear()
+{
+	// Remove all models
+	m_pModels.clear();
+}
+
+void DDM3::InstanceBatch::AddModel(Model* pModel)
+{
+	// Add model to the batch
+	m_pModels.push_back(pModel);
+}
+
+void DDM3::InstanceBatch::Render(VkCommandBuffer commandBuffer)
+{
+	// Get index of current frame
+	auto frame{ Vulkan3D::GetCurrentFrame() };
+
+	// Gather the model matrices of all models
+	m_Transforms.clear();
+	for (auto& pModel : m_pModels)
+	{
+		m_Transforms.push_back(pModel->GetTransform());
+	}
+
+	// Get the view and projection matrix from the camera
+	UniformBufferObject ubo{};
+	Vulkan3D::GetInstance().GetFramePacket().camera.UpdateUniformBuffer(ubo);
+
+	// Update the storage buffer, if it had to grow, replace the descriptorsets
+	// The descriptorsets of the other frames might still be in use, so they are retired instead of updated
+	if (m_pInstanceDescriptorObject->UpdateInstanceBuffer(ubo, m_Transforms, frame))
+	{
+		GetPipeline()->GetDescriptorPool()->FreeDescriptorSets(GetPipeline()->GetDescriptorSetLayout(), m_DescriptorSets);
+		CreateDescriptorSets();
+	}
+
+	// Bind pipeline, if the depth was written in the pre-pass only fragments with equal depth are shaded
+	GetPipeline()->BindPipeline(commandBuffer, m_pMaterial->UsesDepthPrepass());
+
+	// Bind descriptor sets
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, GetPipeline()->GetPipelineLayout(), 0, 1, &m_DescriptorSets[frame], 0, nullptr);
+
+	// Draw all instances
+	m_pMesh->Render(commandBuffer, static_cast<uint32_t>(m_Transforms.size()));
+}
+
+void DDM3::InstanceBatch::CreateDescriptorSets()
+{
+	// Create descriptorsets from the descriptorpool of the instanced pipeline
+	GetPipeline()->GetDescriptorPool()->CreateDescriptorSets(GetPipeline()->GetDescriptorSetLayout(), m_DescriptorSets);
+
+	// Update descriptors
+	UpdateDescriptorSets();
+}
+
+void DDM3::InstanceBatch::UpdateDescriptorSets()
+{
+	// The storage buffer replaces the uniform buffer of the model at binding 0
+	std::vector<DescriptorObject*> descriptors{ m_pInstanceDescriptorObject.get() };
+
+	// Let the material add the rest of the descriptors
+	m_pMaterial->UpdateDescriptorSets(m_DescriptorSets, descriptors);
+}
+
+DDM3::PipelineWrapper* DDM3::InstanceBatch::GetPipeline()
+{
+	// Return the instanced pipeline of the material
+	return m_pMaterial->GetInstancedPipeline();
+}
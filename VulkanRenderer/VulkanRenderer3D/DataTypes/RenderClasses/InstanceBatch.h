@@ -0,0 +1,94 @@
+// InstanceBatch.h
+// This class groups models that share a mesh and a material so they can be rendered with a single instanced draw
+
+#ifndef InstanceBatchIncluded
+#define InstanceBatchIncluded
+
+// File includes
+#include "Includes/VulkanIncludes.h"
+#include "Includes/GLMIncludes.h"
+
+// Standard library includes
+#include <memory>
+#include <vector>
+
+namespace DDM3
+{
+	// Class forward declarations
+	class Model;
+	class Mesh;
+	class Material;
+	class PipelineWrapper;
+	class InstanceDescriptorObject;
+
+	class InstanceBatch final
+	{
+	public:
+		// Constructor
+		// Parameters:
+		//     pMesh: the mesh shared by all models in this batch
+		//     pMaterial: the material shared by all models in this batch
+		InstanceBatch(std::shared_ptr<Mesh> pMesh, std::shared_ptr<Material> pMaterial);
+
+		// Delete default constructor
+		InstanceBatch() = delete;
+
+		// Destructor
+		~InstanceBatch();
+
+		// Delete copy and move functions
+		InstanceBatch(InstanceBatch& other) = delete;
+		InstanceBatch(InstanceBatch&& other) = delete;
+		InstanceBatch& operator=(InstanceBatch& other) = delete;
+		InstanceBatch& operator=(InstanceBatch&& other) = delete;
+
+		// Remove all models from the batch
+		void Clear();
+
+		// Add a model to the batch
+		// Parameters:
+		//     pModel: the model to add
+		void AddModel(Model* pModel);
+
+		// Get the amount of models in the batch
+		size_t GetModelCount() const { return m_pModels.size(); }
+
+		// Get the first model in the batch
+		Model* GetFirstModel() const { return m_pModels.front(); }
+
+		// Render all models in the batch with a single draw call
+		// Parameters:
+		//     commandBuffer: the commandbuffer used in this renderpass
+		void Render(VkCommandBuffer commandBuffer);
+
+	private:
+		// The mesh shared by all models
+		std::shared_ptr<Mesh> m_pMesh{};
+
+		// The material shared by all models
+		std::shared_ptr<Material> m_pMaterial{};
+
+		// The models that will be drawn this frame
+		std::vector<Model*> m_pModels{};
+
+		// The model matrices of the models, in the same order as m_pModels
+		std::vector<glm::mat4> m_Transforms{};
+
+		// The storage buffers holding the transforms
+		std::unique_ptr<InstanceDescriptorObject> m_pInstanceDescriptorObject{};
+
+		// Vector of descriptorsets
+		std::vector<VkDescriptorSet> m_DescriptorSets{};
+
+		// Create the descriptorsets
+		void CreateDescriptorSets();
+
+		// Update the descriptorsets
+		void UpdateDescriptorSets();
+
+		// Get the instanced pipeline of the material
+		PipelineWrapper* GetPipeline();
+	};
+}
+
+#endif // !InstanceBatchIncluded
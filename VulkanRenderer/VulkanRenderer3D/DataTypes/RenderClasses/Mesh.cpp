@@ -14,6 +14,9 @@ DDM3::Mesh::Mesh(const std::string& filePath)
 	// Load the vertices and indices
 	Utils::LoadModel(filePath, m_Vertices, m_Indices);
 
+	// Calculate the bounding box
+	CalculateBounds();
+
 	// Get reference to the renderer
 	auto& renderer{ Vulkan3D::GetInstance().GetRenderer()};
 
@@ -28,7 +31,7 @@ DDM3::Mesh::~Mesh()
 	Cleanup();
 }
 
-void DDM3::Mesh::Render(VkCommandBuffer commandBuffer)
+void DDM3::Mesh::Render(VkCommandBuffer commandBuffer, uint32_t instanceCount, uint32_t firstInstance)
 {
 	// Set and bind vertex buffer
 	VkBuffer vertexBuffers[] = { m_VertexBuffer };
@@ -39,8 +42,26 @@ void DDM3::Mesh::Render(VkCommandBuffer commandBuffer)
 	vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
 	
-	// Draw
-	vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(m_Indices.size()), 1, 0, 0, 0);
+	// Draw, gl_InstanceIndex will go from firstInstance to firstInstance + instanceCount - 1
+	vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(m_Indices.size()), instanceCount, 0, 0, firstInstance);
+}
+
+void DDM3::Mesh::CalculateBounds()
+{
+	// If there are no vertices, leave the bounds at 0
+	if (m_Vertices.empty())
+		return;
+
+	// Start from the first vertex
+	m_BoundsMin = m_Vertices[0].pos;
+	m_BoundsMax = m_Vertices[0].pos;
+
+	// Grow the bounds to fit every vertex
+	for (auto& vertex : m_Vertices)
+	{
+		m_BoundsMin = glm::min(m_BoundsMin, vertex.pos);
+		m_BoundsMax = glm::max(m_BoundsMax, vertex.pos);
+	}
 }
 
 void DDM3::Mesh::Cleanup()
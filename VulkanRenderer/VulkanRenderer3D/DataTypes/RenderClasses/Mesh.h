@@ -33,7 +33,21 @@ namespace DDM3
 		// Render the model
 		// Parameters:
 		//     -commandBuffer: the commandbuffer used in this renderpass
-		void Render(VkCommandBuffer commandBuffer);
+		//     -instanceCount: the amount of instances that should be drawn, standard set to 1
+		//     -firstInstance: the index of the first instance, standard set to 0
+		void Render(VkCommandBuffer commandBuffer, uint32_t instanceCount = 1, uint32_t firstInstance = 0);
+
+		// Get the vertices
+		const std::vector<Vertex>& GetVertices() const { return m_Vertices; }
+
+		// Get the indices
+		const std::vector<uint32_t>& GetIndices() const { return m_Indices; }
+
+		// Get the minimum corner of the axis aligned bounding box in local space
+		const glm::vec3& GetBoundsMin() const { return m_BoundsMin; }
+
+		// Get the maximum corner of the axis aligned bounding box in local space
+		const glm::vec3& GetBoundsMax() const { return m_BoundsMax; }
 	private:
 		// Vector of vertices
 		std::vector<Vertex> m_Vertices{};
@@ -53,6 +67,14 @@ namespace DDM3
 		// Index buffer memory
 		VkDeviceMemory m_IndexBufferMemory{};
 
+		// Minimum corner of the bounding box
+		glm::vec3 m_BoundsMin{};
+		// Maximum corner of the bounding box
+		glm::vec3 m_BoundsMax{};
+
+		// Calculate the bounding box from the vertices
+		void CalculateBounds();
+
 		// Clean up all allocated objects
 		void Cleanup();
 	};
@@ -5,6 +5,7 @@
 
 // File includes
 #include "Engine/TimeManager.h"
+#include "Engine/TransformManager.h"
 
 #include "Utils/Utils.h"
 
@@ -13,11 +14,13 @@
 #include "Mesh.h"
 
 #include "Vulkan/Vulkan3D.h"
+#include "Vulkan/Managers/ModelManager.h"
 #include "Vulkan/Wrappers/DescriptorPoolWrapper.h"
 #include "Vulkan/Wrappers/PipelineWrapper.h"
 
 // Standard library includes
 #include <memory>
+#include <stdexcept>
 
 DDM3::Model::Model()
 {
@@ -34,6 +37,38 @@ DDM3::Model::~Model()
 	{
 		Cleanup();
 	}
+
+	// Remove the transform of this model if it was created
+	if (m_HasTransform)
+	{
+		TransformManager::GetInstance().RemoveTransform(m_TransformId);
+	}
+}
+
+void DDM3::Model::CreateTransform()
+{
+	// The transform only has to be created once
+	if (m_HasTransform)
+		return;
+
+	// Get the transform manager
+	auto& transformManager{ TransformManager::GetInstance() };
+
+	// Add a transform for this model and give it the values that were set before
+	m_TransformId = transformManager.AddTransform();
+	m_HasTransform = true;
+
+	transformManager.SetPosition(m_TransformId, m_PendingPosition);
+	transformManager.SetRotation(m_TransformId, m_PendingRotation);
+	transformManager.SetScale(m_TransformId, m_PendingScale);
+
+	// Attach to the parent, its transform is created first if it was added later
+	if (m_pPendingParent != nullptr)
+	{
+		m_pPendingParent->CreateTransform();
+		transformManager.SetParent(m_TransformId, m_pPendingParent->m_TransformId);
+		m_pPendingParent = nullptr;
+	}
 }
 
 void DDM3::Model::LoadModel(const std::string& textPath)
@@ -44,7 +79,8 @@ void DDM3::Model::LoadModel(const std::string& textPath)
 		Cleanup();
 	}
 
-	m_pMesh = std::make_unique<Mesh>(textPath);
+	// Get the mesh trough the model manager so models loaded from the same file share it
+	m_pMesh = Vulkan3D::GetInstance().GetModelManager()->LoadMesh(textPath);
 
 	// Create uniform buffer
 	CreateUniformBuffers();
@@ -57,11 +93,11 @@ void DDM3::Model::LoadModel(const std::string& textPath)
 
 void DDM3::Model::SetMaterial(std::shared_ptr<Material> pMaterial)
 {
-	// Remove model from old descriptorpool
-	m_pMaterial->GetDescriptorPool()->RemoveModel(this);
+	// Give the descriptorsets back to the old material so they can be reused
+	m_pMaterial->FreeDescriptorSets(m_DescriptorSets);
 	// Set new material
 	m_pMaterial = pMaterial;
-	// Create new descriptorpool
+	// Create new descriptorsets
 	CreateDescriptorSets();
 }
 
@@ -75,8 +111,11 @@ void DDM3::Model::Update()
 		// Calculate amount of rotation
 		float rotAmount{ rotSpeed * TimeManager::GetInstance().GetDeltaTime() };
 
+		// Get current rotation
+		auto& rotation{ TransformManager::GetInstance().GetRotation(m_TransformId) };
+
 		// Set new rotation
-		SetRotation(m_Rotation.x, m_Rotation.y + rotAmount, m_Rotation.z);
+		SetRotation(rotation.x, rotation.y + rotAmount, rotation.z);
 	}
 }
 
@@ -85,10 +124,21 @@ void DDM3::Model::RenderShadow(VkCommandBuffer commandBuffer, VkPipelineLayout p
 	if (!m_CastsShadow)
 		return;
 
-	auto frame{ Vulkan3D::GetCurrentFrame()};
+	vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &GetTransform());
+
+	m_pMesh->Render(commandBuffer);
+}
+
+void DDM3::Model::RenderDepth(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout)
+{
+	// If model isn't initialize, return
+	if (!m_Initialized)
+		return;
 
-	vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &m_Ubos[frame].model);
+	// Push the transform of the model
+	vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &GetTransform());
 
+	// Draw the mesh
 	m_pMesh->Render(commandBuffer);
 }
 
@@ -110,8 +160,8 @@ void DDM3::Model::Render()
 	// Get current commandbuffer
 	auto commandBuffer{ renderer.GetCurrentCommandBuffer() };
 
-	// Bind pipeline
-	GetPipeline()->BindPipeline(commandBuffer);
+	// Bind pipeline, if the depth was written in the pre-pass only fragments with equal depth are shaded
+	GetPipeline()->BindPipeline(commandBuffer, m_pMaterial->UsesDepthPrepass());
 
 	// Bind descriptor sets
 	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, GetPipeline()->GetPipelineLayout(), 0, 1, &m_DescriptorSets[frame], 0, nullptr);
@@ -121,28 +171,66 @@ void DDM3::Model::Render()
 
 }
 
+void DDM3::Model::SetParent(Model* pParent)
+{
+	// Without a transform, remember the parent until the transform is created
+	if (!m_HasTransform)
+	{
+		m_pPendingParent = pParent;
+		return;
+	}
+
+	// If there is no parent, remove the current parent
+	if (pParent == nullptr)
+	{
+		TransformManager::GetInstance().RemoveParent(m_TransformId);
+		return;
+	}
+
+	// Make sure the parent has a transform
+	pParent->CreateTransform();
+
+	// Set the transform of the parent as parent of this transform
+	TransformManager::GetInstance().SetParent(m_TransformId, pParent->m_TransformId);
+}
+
 void DDM3::Model::SetPosition(float x, float y, float z)
 {
-	// Set new position
-	m_Position = { x, y, z };
-	// Set dirty flags
-	SetDirtyFlags();
+	// Without a transform, remember the position until the transform is created
+	if (!m_HasTransform)
+	{
+		m_PendingPosition = glm::vec3{ x, y, z };
+		return;
+	}
+
+	// Set new position in the transform manager
+	TransformManager::GetInstance().SetPosition(m_TransformId, { x, y, z });
 }
 
 void DDM3::Model::SetRotation(float x, float y, float z)
 {
-	// Set new rotation
-	m_Rotation = { x, y, z };
-	// Set dirty flags
-	SetDirtyFlags();
+	// Without a transform, remember the rotation until the transform is created
+	if (!m_HasTransform)
+	{
+		m_PendingRotation = glm::vec3{ x, y, z };
+		return;
+	}
+
+	// Set new rotation in the transform manager
+	TransformManager::GetInstance().SetRotation(m_TransformId, { x, y, z });
 }
 
 void DDM3::Model::SetScale(float x, float y, float z)
 {
-	// Set new scale
-	m_Scale = { x, y, z };
-	// Set dirty flags
-	SetDirtyFlags();
+	// Without a transform, remember the scale until the transform is created
+	if (!m_HasTransform)
+	{
+		m_PendingScale = glm::vec3{ x, y, z };
+		return;
+	}
+
+	// Set new scale in the transform manager
+	TransformManager::GetInstance().SetScale(m_TransformId, { x, y, z });
 }
 
 void DDM3::Model::CreateUniformBuffers()
@@ -152,17 +240,16 @@ void DDM3::Model::CreateUniformBuffers()
 
 	// Resize ubos to amount of frames
 	m_Ubos.resize(frames);
-	// Resize dirty flages to amount of frames
-	m_UboChanged.resize(frames);
-
-	// Set dirty flag
-	SetDirtyFlags();
 }
 
 void DDM3::Model::CreateDescriptorSets()
 {
+	// Materials rendered with bindless descriptors use the global descriptorsets, no descriptorsets are needed per model
+	if (m_pMaterial->GetBindlessPipeline() != nullptr)
+		return;
+
 	// Create descriptorsets
-	m_pMaterial->CreateDescriptorSets(this, m_DescriptorSets);
+	m_pMaterial->CreateDescriptorSets(m_DescriptorSets);
 	// Update descriptors
 	UpdateDescriptorSets();
 }
@@ -175,32 +262,45 @@ void DDM3::Model::UpdateDescriptorSets()
 	m_pMaterial->UpdateDescriptorSets(m_DescriptorSets, descriptors);
 }
 
-void DDM3::Model::UpdateUniformBuffer(uint32_t frame)
+const glm::mat4& DDM3::Model::GetTransform() const
 {
+	// Get the world matrices of the frame packet that is being rendered
+	auto& worldMatrices{ Vulkan3D::GetInstance().GetFramePacket().worldMatrices };
 
-	if (m_UboChanged[frame])
+	// The transform has to be simulated before it can be rendered
+	if (m_TransformId >= worldMatrices.size())
 	{
-		// Get translation matrix
-		glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), m_Position);
-
-		// Convert rotation to quaternion
-		glm::quat quaternion = glm::quat(m_Rotation);
-		// Get rotation matrix
-		glm::mat4 rotationMatrix = glm::mat4_cast(quaternion);
+		throw std::runtime_error("failed to get transform, the model isn't in the frame packet!");
+	}
 
-		// Get scaling matrix
-		glm::mat4 scalingMatrix = glm::scale(glm::mat4(1.0f), m_Scale);
+	// Return the model matrix
+	return worldMatrices[m_TransformId];
+}
 
-		// Set Ubo
-		m_Ubos[frame].model = translationMatrix * rotationMatrix * scalingMatrix;
+bool DDM3::Model::HasTransformChanged() const
+{
+	// Get the changed flags of the frame packet that is being rendered
+	auto& transformsChanged{ Vulkan3D::GetInstance().GetFramePacket().transformsChanged };
 
-		// Reset dirty flag
-		m_UboChanged[frame] = false;
+	// The transform has to be simulated before it can be rendered
+	if (m_TransformId >= transformsChanged.size())
+	{
+		throw std::runtime_error("failed to check transform, the model isn't in the frame packet!");
 	}
 
+	// Check if the world matrix was rebuilt for this frame
+	return transformsChanged[m_TransformId] != 0;
+}
+
+void DDM3::Model::UpdateUniformBuffer(uint32_t frame)
+{
+	// Copy the prebuilt model matrix, the non-bindless shaders read it from the per-model ubo together with the camera matrices
+	// Bindless and instanced models read their matrix from a shared storage buffer instead
+	m_Ubos[frame].model = GetTransform();
+
 	// Update ubo
 	// Send to renderer to update camera matrix
-	Vulkan3D::GetInstance().GetCurrentCamera()->UpdateUniformBuffer(m_Ubos[frame]);
+	Vulkan3D::GetInstance().GetFramePacket().camera.UpdateUniformBuffer(m_Ubos[frame]);
 
 	m_pUboDescriptorObject->UpdateUboBuffer(m_Ubos[frame], frame);
 }
@@ -218,17 +318,10 @@ DDM3::PipelineWrapper* DDM3::Model::GetPipeline()
 
 void DDM3::Model::Cleanup()
 {
-	// Get reference to device
-	auto device = DDM3::Vulkan3D::GetInstance().GetDevice();
+	// Give the descriptorsets back to the material, the pool only reuses them once the frames in flight finished
+	m_pMaterial->FreeDescriptorSets(m_DescriptorSets);
 
-	// Wait until device is idle
-	vkDeviceWaitIdle(device);
+	// The uniform buffers are kept until the model is destroyed, which only happens after the device is idle at shutdown
 
 	m_pMesh = nullptr;
 }
-
-void DDM3::Model::SetDirtyFlags()
-{
-	// Set all dirty flags
-	std::fill(m_UboChanged.begin(), m_UboChanged.end(), true);
-}
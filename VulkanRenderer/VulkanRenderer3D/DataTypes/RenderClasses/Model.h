@@ -51,9 +51,20 @@ namespace DDM3
 
 		void RenderShadow(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout);
 
+		// Render only the depth of the model, used in the depth pre-pass
+		// Parameters:
+		//     commandBuffer: the commandbuffer used in the depth pre-pass
+		//     pipelineLayout: the layout of the depth pre-pass pipeline, the transform is pushed as push constant
+		void RenderDepth(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout);
+
 		// Render model
 		void Render();
 
+		// Set the parent, the position, rotation and scale will be relative to the parent
+		// Parameters:
+		//     pParent: the parent model, nullptr to make the transform relative to the world
+		void SetParent(Model* pParent);
+
 		// Set position
 		// Parameters:
 		//     x: x-position
@@ -80,24 +91,61 @@ namespace DDM3
 
 		void SetRotate(bool rotate) { m_Rotate = rotate; }
 		void SetCastsShadow(bool shouldCast) { m_CastsShadow = shouldCast; }
+
+		// Does the model cast a shadow
+		bool CastsShadow() const { return m_CastsShadow; }
+
+		// Set if the model hides other models in the software occlusion test, meant for large and simple meshes
+		// Parameters:
+		//     isOccluder: true if the model is an occluder
+		void SetOccluder(bool isOccluder) { m_IsOccluder = isOccluder; }
+
+		// Is the model an occluder
+		bool IsOccluder() const { return m_IsOccluder; }
+
+		// Is the model initialized
+		bool IsInitialized() const { return m_Initialized; }
+
+		// Get the mesh, meshes loaded from the same file are shared between models
+		const std::shared_ptr<Mesh>& GetMesh() const { return m_pMesh; }
+
+		// Get the material
+		const std::shared_ptr<Material>& GetMaterial() const { return m_pMaterial; }
+
+		// Get the model matrix from the frame packet that is being rendered
+		const glm::mat4& GetTransform() const;
+
+		// Check if the model matrix changed in the frame packet that is being rendered
+		bool HasTransformChanged() const;
+
+		// Get the id of the transform of this model in the transform manager
+		uint32_t GetTransformId() const { return m_TransformId; }
+
+		// Add the transform of this model to the transform manager, called by the model manager on the simulation thread
+		// The position, rotation, scale and parent that were set before are applied to the new transform
+		void CreateTransform();
 	private:
 		bool m_Rotate{true};
 		bool m_CastsShadow{ true };
+		bool m_IsOccluder{ false };
 
 		//Is model initialized
 		bool m_Initialized{ false };
 
-		// Rotation vector
-		glm::vec3 m_Rotation{};
-		// Position vector
-		glm::vec3 m_Position{};
-		// Scale vector
-		glm::vec3 m_Scale{ 1, 1, 1 };
+		// Id of the position, rotation and scale in the transform manager
+		uint32_t m_TransformId{};
+
+		// Indicates if the transform was created in the transform manager
+		bool m_HasTransform{ false };
+
+		// The position, rotation, scale and parent set before the transform was created
+		glm::vec3 m_PendingPosition{ 0, 0, 0 };
+		glm::vec3 m_PendingRotation{ 0, 0, 0 };
+		glm::vec3 m_PendingScale{ 1, 1, 1 };
+		Model* m_pPendingParent{};
 
 		// Vector for Uniform Buffer Objects
 		std::vector<UniformBufferObject> m_Ubos{};
-		// Vector of dirty flags for UBOs
-		std::vector<bool> m_UboChanged{};
 
 		std::unique_ptr<DDM3::UboDescriptorObject<UniformBufferObject>> m_pUboDescriptorObject{};
 
@@ -105,7 +153,7 @@ namespace DDM3
 		std::vector<VkDescriptorSet> m_DescriptorSets{};
 
 		//Mesh
-		std::unique_ptr<DDM3::Mesh> m_pMesh{};
+		std::shared_ptr<DDM3::Mesh> m_pMesh{};
 
 		//Material
 		std::shared_ptr<Material> m_pMaterial{};
@@ -126,9 +174,6 @@ namespace DDM3
 
 		// CLeanup
 		void Cleanup();
-
-		// Set dirty flags for UBOs
-		void SetDirtyFlags();
 	};
 }
 
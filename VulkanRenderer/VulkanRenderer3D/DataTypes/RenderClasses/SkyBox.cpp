@@ -4,30 +4,40 @@
 #include "SkyBox.h"
 
 // File includes
-#include "Utils/Utils.h"
+#include "Includes/GLMIncludes.h"
 
+#include "Vulkan/Vulkan3D.h"
 #include "Vulkan/Renderers/VulkanRenderer3D.h"
+#include "Vulkan/Wrappers/PipelineWrapper.h"
+#include "Vulkan/Wrappers/DescriptorPoolWrapper.h"
 
-#include "Model.h"
-
-#include "DataTypes/Materials/CubeMapMaterial.h"
+#include "DataTypes/Camera.h"
 #include "DataTypes/DescriptorObjects/TextureDescriptorObject.h"
 
 // Standard library includes
 
 DDM3::SkyBox::SkyBox(std::initializer_list<const std::string>&& filePaths)
 {
-	// Create cubemap material
-	auto pMaterial = std::make_shared<CubeMapMaterial>(filePaths);
+	// Get a reference to the renderer
+	auto& renderer{ Vulkan3D::GetInstance().GetRenderer() };
+
+	// Create the cube texture
+	Texture cubeTexture{};
+	renderer.CreateCubeTexture(cubeTexture, filePaths);
+
+	// Create the descriptor object and give the cube texture by value
+	m_pCubeMapDescriptorObject = std::make_unique<TextureDescriptorObject>(cubeTexture);
 
-	// Create the model
-	m_pModel = std::make_unique<Model>();
+	// Get the skybox pipeline and its descriptorpool
+	auto pPipeline{ renderer.GetPipeline("Skybox") };
+	auto descriptorPool{ pPipeline->GetDescriptorPool() };
 
-	// Load a cube model
-	m_pModel->LoadModel("Resources/Models/cube.obj");
+	// Create the descriptorsets
+	descriptorPool->CreateDescriptorSets(pPipeline->GetDescriptorSetLayout(), m_DescriptorSets);
 
-	// Set the material
-	m_pModel->SetMaterial(pMaterial);
+	// The cube texture is the only descriptor, it never changes
+	std::vector<DescriptorObject*> descriptorObjectList{ m_pCubeMapDescriptorObject.get() };
+	descriptorPool->UpdateDescriptorSets(m_DescriptorSets, descriptorObjectList);
 }
 
 DDM3::SkyBox::~SkyBox()
@@ -36,6 +46,33 @@ DDM3::SkyBox::~SkyBox()
 
 void DDM3::SkyBox::Render()
 {
-	// Render the model
-	m_pModel->Render();
+	// Get a reference to the renderer
+	auto& renderer{ Vulkan3D::GetInstance().GetRenderer() };
+
+	// Get the current command buffer
+	auto commandBuffer{ renderer.GetCurrentCommandBuffer() };
+
+	// Get the skybox pipeline, it tests against the far plane without writing depth
+	auto pPipeline{ renderer.GetPipeline("Skybox") };
+
+	// Get the view and projection matrix from the camera
+	UniformBufferObject ubo{};
+	Vulkan3D::GetInstance().GetFramePacket().camera.UpdateUniformBuffer(ubo);
+
+	// Remove the translation from the view matrix, the skybox is infinitely far away
+	// The inverse of the view projection turns a point on the far plane into a view direction
+	glm::mat4 inverseViewProjection{ glm::inverse(ubo.proj * glm::mat4(glm::mat3(ubo.view))) };
+
+	// Bind pipeline
+	pPipeline->BindPipeline(commandBuffer);
+
+	// Bind the descriptorset of this frame
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pPipeline->GetPipelineLayout(), 0, 1,
+		&m_DescriptorSets[Vulkan3D::GetCurrentFrame()], 0, nullptr);
+
+	// Give the inverse view projection to the vertex shader
+	vkCmdPushConstants(commandBuffer, pPipeline->GetPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(inverseViewProjection), &inverseViewProjection);
+
+	// Draw the fullscreen triangle
+	vkCmdDraw(commandBuffer, 3, 1, 0, 0);
 }
@@ -1,20 +1,23 @@
 // SkyBox.h
 // This class will hold all nesesarry object to create and render a skybox
+// The skybox is a fullscreen triangle on the far plane, drawn after the models so only pixels nothing was drawn to are shaded
 
 #ifndef SkyBoxIncluded
 #define SkyBoxIncluded
 
 // File includes
+#include "Includes/VulkanIncludes.h"
 
 // Standard libraryincludes
 #include <memory>
 #include <string>
 #include <initializer_list>
+#include <vector>
 
 namespace DDM3
 {
 	// Class forward declarations
-	class Model;
+	class TextureDescriptorObject;
 
 	class SkyBox
 	{
@@ -36,13 +39,16 @@ namespace DDM3
 		SkyBox& operator=(SkyBox& other) = delete;
 		SkyBox& operator=(SkyBox&& other) = delete;
 
-		// Render the skybox
+		// Render the skybox, must be called inside the main renderpass after the models are rendered
 		void Render();
 
 
 	private:
-		// A unique pointer for the model of the skybox
-		std::unique_ptr<Model> m_pModel{};
+		// Descriptor object holding the cube texture
+		std::unique_ptr<TextureDescriptorObject> m_pCubeMapDescriptorObject{};
+
+		// Vector of descriptorsets, one per frame in flight
+		std::vector<VkDescriptorSet> m_DescriptorSets{};
 	};
 }
 
@@ -12,6 +12,8 @@
 #include <optional>
 #include <array>
 #include <tuple>
+#include <string>
+#include <vector>
 
 
 namespace DDM3
@@ -191,6 +193,107 @@ namespace DDM3
 		glm::mat4 proj{};
 	};
 
+	// Object data used when rendering with bindless descriptors
+	// One object is stored per model in the object storage buffer
+	struct ObjectData
+	{
+		// Transformation of model
+		glm::mat4 model{};
+		// Indices of the textures of the material in the bindless texture array, -1 if unused
+		glm::ivec4 textureIndices{ -1, -1, -1, -1 };
+	};
+
+	// Statistics of the occlusion tests of a single frame
+	struct OcclusionStats
+	{
+		// The amount of models that were tested
+		uint32_t testedCount{};
+		// The amount of models that were found to be occluded
+		uint32_t occludedCount{};
+		// The time spent on the CPU in milliseconds
+		float cpuTime{};
+	};
+
+	// The vertex input of a graphics pipeline
+	enum class VertexLayout
+	{
+		// The vertex buffer holds Vertex objects
+		Vertex,
+		// No vertex buffer is used, the vertices are generated in the vertex shader
+		None
+	};
+
+	// All state a graphics pipeline is created with
+	// Pipelines are created once per key, every pipeline name with the same key uses the same pipeline
+	struct PipelineStateKey
+	{
+		// The file paths of the shaders
+		std::vector<std::string> shaders{};
+		// The vertex input
+		VertexLayout vertexLayout{ VertexLayout::Vertex };
+		// Indicates if alpha blending is enabled
+		bool blendEnable{ true };
+		// Indicates if color is written, disabled for depth only pipelines
+		bool colorWrite{ true };
+		// Indicates if depth is tested, dynamic if extended dynamic state is supported
+		bool depthTest{ true };
+		// Indicates if depth is written, dynamic if extended dynamic state is supported
+		bool depthWrite{ true };
+		// The depth compare operation, dynamic if extended dynamic state is supported
+		VkCompareOp depthCompareOp{ VK_COMPARE_OP_LESS };
+		// The faces that are culled, dynamic if extended dynamic state is supported
+		VkCullModeFlags cullMode{ VK_CULL_MODE_NONE };
+		// The amount of samples per pixel
+		VkSampleCountFlagBits sampleCount{ VK_SAMPLE_COUNT_1_BIT };
+		// The renderpass the pipeline is used in
+		VkRenderPass renderPass{ VK_NULL_HANDLE };
+		// An externally owned descriptor set layout, if null handle the layout is reflected from the shaders
+		VkDescriptorSetLayout descriptorSetLayout{ VK_NULL_HANDLE };
+
+		// Compare every member
+		bool operator==(const PipelineStateKey& other) const = default;
+	};
+
+	// Functions of VK_EXT_extended_dynamic_state, loaded from the device if the extension is enabled
+	struct ExtendedDynamicStateFunctions
+	{
+		// Set the cull mode
+		PFN_vkCmdSetCullModeEXT vkCmdSetCullMode{};
+		// Enable or disable the depth test
+		PFN_vkCmdSetDepthTestEnableEXT vkCmdSetDepthTestEnable{};
+		// Enable or disable depth writes
+		PFN_vkCmdSetDepthWriteEnableEXT vkCmdSetDepthWriteEnable{};
+		// Set the depth compare operation
+		PFN_vkCmdSetDepthCompareOpEXT vkCmdSetDepthCompareOp{};
+	};
+
+	// Description of a graphics pipeline, used to create multiple pipelines at once
+	struct PipelineDescription
+	{
+		// The name of the pipeline
+		std::string name{};
+		// The file paths of the shaders
+		std::vector<std::string> filePaths{};
+		// Indicates if the pipeline uses the depth buffer
+		bool hasDepthStencil{ true };
+		// Indicates if the pipeline uses the bindless descriptor set layout, bindless pipelines are skipped if bindless descriptors aren't used
+		bool bindless{ false };
+		// An externally owned descriptor set layout, set by the renderer for bindless pipelines
+		VkDescriptorSetLayout descriptorSetLayout{ VK_NULL_HANDLE };
+	};
+
+	// Light transforms of the shadow cascades, ordered from the nearest to the farthest slice of the view frustum
+	struct ShadowCascadesStruct
+	{
+		// The maximum amount of cascades
+		static constexpr uint32_t maxCascades{ 4 };
+
+		// Transformation from world space to the clip space of every cascade
+		std::array<glm::mat4, maxCascades> transforms{};
+		// The amount of cascades in use
+		int cascadeCount{};
+	};
+
 #pragma warning(push)
 	// Disable warning C4324
 #pragma warning(disable : 4324)
@@ -0,0 +1,249 @@
+// BenchmarkManager.cpp
+
+// Header include
+#include "BenchmarkManager.h"
+
+// File includes
+#include "ConfigManager.h"
+
+#include "Includes/RapidJSONIncludes.h"
+
+#include "DataTypes/Camera.h"
+
+#include <glm/gtx/spline.hpp>
+
+// Standard library includes
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+
+DDM3::BenchmarkManager::BenchmarkManager()
+{
+	// Get config manager
+	auto& configManager{ ConfigManager::GetInstance() };
+
+	// Read the settings
+	m_Path = configManager.GetVec3Array("BenchmarkPath");
+	m_Target = configManager.GetVec3("BenchmarkTarget");
+	m_PathDuration = std::max(configManager.GetFloat("BenchmarkPathDuration"), 0.01f);
+	m_Timestep = 1.0f / static_cast<float>(std::max(configManager.GetInt("BenchmarkFramerate"), 1));
+	m_WarmupFrames = static_cast<uint32_t>(std::max(configManager.GetInt("BenchmarkWarmupFrames"), 0));
+	m_RecordedFrameCount = static_cast<uint32_t>(std::max(configManager.GetInt("BenchmarkFrameCount"), 1));
+	m_OutputPath = configManager.GetString("BenchmarkOutput");
+
+	// Without a path the camera stays where it is
+	if (m_Path.empty())
+	{
+		std::cout << "Benchmark has no camera path, the camera won't move\n";
+	}
+
+	// Reserve the recorded frames
+	m_CpuTimes.reserve(m_RecordedFrameCount);
+}
+
+void DDM3::BenchmarkManager::UpdateCamera(Camera* pCamera)
+{
+	// The time only depends on the frame number, so every run renders exactly the same frames
+	float time{ static_cast<float>(m_SimulatedFrame++) * m_Timestep };
+
+	if (m_Path.empty())
+		return;
+
+	// Place the camera and look at the target
+	auto position{ GetPathPosition(time) };
+	pCamera->SetPosition(position);
+
+	if (glm::length(m_Target - position) > 0.0f)
+	{
+		pCamera->SetDirection(m_Target - position);
+	}
+}
+
+void DDM3::BenchmarkManager::EndFrame(float cpuFrameTime, const std::vector<GPUProfiler::ScopeResult>& gpuTimes, float renderScale, uint32_t msaaSamples)
+{
+	if (m_IsFinished)
+		return;
+
+	// Skip the warm-up frames, the GPU times are read back a few frames late so they are also warmed up by then
+	if (m_CurrentFrame++ < m_WarmupFrames)
+		return;
+
+	// Remember the settings the frames were rendered with
+	m_RenderScale = renderScale;
+	m_MsaaSamples = msaaSamples;
+
+	// Record the CPU time
+	m_CpuTimes.push_back(cpuFrameTime);
+	size_t sample{ m_CpuTimes.size() - 1 };
+
+	// Record the GPU time of every pass, a pass that wasn't measured this frame is NaN
+	for (auto& passTimes : m_GpuTimes)
+	{
+		passTimes.push_back(std::numeric_limits<float>::quiet_NaN());
+	}
+
+	for (auto& result : gpuTimes)
+	{
+		auto it{ std::find(m_PassNames.begin(), m_PassNames.end(), result.name) };
+
+		// Add a column for passes that weren't measured before
+		if (it == m_PassNames.end())
+		{
+			m_PassNames.push_back(result.name);
+			m_GpuTimes.emplace_back(sample + 1, std::numeric_limits<float>::quiet_NaN());
+			it = m_PassNames.end() - 1;
+		}
+
+		m_GpuTimes[it - m_PassNames.begin()][sample] = result.time;
+	}
+
+	// Write the results once all frames are recorded
+	if (m_CpuTimes.size() >= m_RecordedFrameCount)
+	{
+		WriteResults();
+		m_IsFinished = true;
+	}
+}
+
+glm::vec3 DDM3::BenchmarkManager::GetPathPosition(float time) const
+{
+	// A single point doesn't form a spline
+	if (m_Path.size() == 1)
+		return m_Path[0];
+
+	// Get the position on the closed spline between 0 and the amount of points
+	auto pointCount{ static_cast<int>(m_Path.size()) };
+	float pathTime{ std::fmod(time / m_PathDuration, 1.0f) * static_cast<float>(pointCount) };
+	int segment{ static_cast<int>(pathTime) };
+
+	// Get the 4 control points around the segment, wrapping around the end
+	auto getPoint = [&](int index) -> const glm::vec3& { return m_Path[(index + pointCount) % pointCount]; };
+
+	return glm::catmullRom(getPoint(segment - 1), getPoint(segment), getPoint(segment + 1), getPoint(segment + 2), pathTime - static_cast<float>(segment));
+}
+
+void DDM3::BenchmarkManager::WriteResults() const
+{
+	// Write the times of every frame to the CSV file
+	std::ofstream csvFile{ m_OutputPath + ".csv" };
+	if (!csvFile)
+	{
+		std::cout << "Failed to write benchmark results to " << m_OutputPath << ".csv\n";
+		return;
+	}
+
+	csvFile << "Frame,CPU";
+	for (auto& name : m_PassNames)
+	{
+		csvFile << ",GPU " << name;
+	}
+	csvFile << "\n";
+
+	for (size_t i{}; i < m_CpuTimes.size(); ++i)
+	{
+		csvFile << i << "," << m_CpuTimes[i];
+		for (auto& passTimes : m_GpuTimes)
+		{
+			// Leave passes that weren't measured empty
+			csvFile << ",";
+			if (!std::isnan(passTimes[i]))
+			{
+				csvFile << passTimes[i];
+			}
+		}
+		csvFile << "\n";
+	}
+
+	// Write the statistics to the JSON file
+	rapidjson::StringBuffer buffer{};
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> writer{ buffer };
+
+	// Write the average, minimum, maximum and percentiles of the given times
+	auto writeStatistics = [&writer](const std::string& name, const std::vector<float>& times)
+		{
+			// Sort the measured times, NaN is left out
+			std::vector<float> sortedTimes{};
+			std::copy_if(times.begin(), times.end(), std::back_inserter(sortedTimes), [](float time) { return !std::isnan(time); });
+			std::sort(sortedTimes.begin(), sortedTimes.end());
+
+			if (sortedTimes.empty())
+				return;
+
+			// Get the percentile with the nearest rank method
+			auto percentile = [&sortedTimes](float percent)
+				{
+					auto rank{ static_cast<size_t>(std::ceil(percent / 100.0f * static_cast<float>(sortedTimes.size()))) };
+					return sortedTimes[std::clamp(rank, size_t{ 1 }, sortedTimes.size()) - 1];
+				};
+
+			double total{};
+			for (auto time : sortedTimes)
+			{
+				total += time;
+			}
+			double average{ total / static_cast<double>(sortedTimes.size()) };
+
+			// The standard deviation shows how smooth the frames are
+			double variance{};
+			for (auto time : sortedTimes)
+			{
+				variance += (time - average) * (time - average);
+			}
+			double standardDeviation{ std::sqrt(variance / static_cast<double>(sortedTimes.size())) };
+
+			writer.Key(name.c_str());
+			writer.StartObject();
+			writer.Key("Samples");
+			writer.Uint64(sortedTimes.size());
+			writer.Key("Average");
+			writer.Double(average);
+			writer.Key("Min");
+			writer.Double(sortedTimes.front());
+			writer.Key("Max");
+			writer.Double(sortedTimes.back());
+			writer.Key("StdDev");
+			writer.Double(standardDeviation);
+			writer.Key("P50");
+			writer.Double(percentile(50.0f));
+			writer.Key("P95");
+			writer.Double(percentile(95.0f));
+			writer.Key("P99");
+			writer.Double(percentile(99.0f));
+			writer.EndObject();
+		};
+
+	writer.StartObject();
+	writer.Key("Frames");
+	writer.Uint64(m_CpuTimes.size());
+	writer.Key("Timestep");
+	writer.Double(m_Timestep);
+	writer.Key("RenderScale");
+	writer.Double(m_RenderScale);
+	writer.Key("MSAA");
+	writer.Uint(m_MsaaSamples);
+	writer.Key("CPU");
+	writer.StartObject();
+	writeStatistics("Frame", m_CpuTimes);
+	writer.EndObject();
+	writer.Key("GPU");
+	writer.StartObject();
+	for (size_t i{}; i < m_PassNames.size(); ++i)
+	{
+		writeStatistics(m_PassNames[i], m_GpuTimes[i]);
+	}
+	writer.EndObject();
+	writer.EndObject();
+
+	std::ofstream jsonFile{ m_OutputPath + ".json" };
+	if (!jsonFile)
+	{
+		std::cout << "Failed to write benchmark results to " << m_OutputPath << ".json\n";
+		return;
+	}
+	jsonFile << buffer.GetString() << "\n";
+
+	std::cout << "Benchmark results written to " << m_OutputPath << ".csv and " << m_OutputPath << ".json\n";
+}
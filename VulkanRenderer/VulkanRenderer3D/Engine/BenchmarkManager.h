@@ -0,0 +1,112 @@
+// BenchmarkManager.h
+// This class runs a deterministic benchmark: the camera flies along a scripted spline with a fixed timestep
+// After a number of warm-up frames the CPU frame time and the GPU time of every pass are recorded and written to a CSV and a JSON file
+
+#ifndef BenchmarkManagerIncluded
+#define BenchmarkManagerIncluded
+
+// File includes
+#include "Includes/GLMIncludes.h"
+
+#include "Vulkan/Managers/GPUProfiler.h"
+
+// Standard library includes
+#include <string>
+#include <vector>
+
+namespace DDM3
+{
+	// Class forward declarations
+	class Camera;
+
+	class BenchmarkManager final
+	{
+	public:
+		// Constructor, reads the settings from the config file
+		BenchmarkManager();
+
+		// Destructor
+		~BenchmarkManager() = default;
+
+		// Delete copy and move functions
+		BenchmarkManager(BenchmarkManager& other) = delete;
+		BenchmarkManager(BenchmarkManager&& other) = delete;
+		BenchmarkManager& operator=(BenchmarkManager& other) = delete;
+		BenchmarkManager& operator=(BenchmarkManager&& other) = delete;
+
+		// Get the fixed timestep every frame simulates in seconds
+		float GetTimestep() const { return m_Timestep; }
+
+		// Check if all frames were recorded and the results were written
+		bool IsFinished() const { return m_IsFinished; }
+
+		// Place the camera on the spline for the next simulated frame, looking at the target
+		// Called on the simulation thread, it doesn't share any members with EndFrame
+		// Parameters:
+		//     pCamera: the camera that is moved
+		void UpdateCamera(Camera* pCamera);
+
+		// Record the times of a frame, the results are written after the last frame
+		// Called on the render thread
+		// Parameters:
+		//     cpuFrameTime: the CPU time of the frame in milliseconds
+		//     gpuTimes: the last GPU times read back from the profiler
+		//     renderScale: the factor the width and height of the scene were scaled with
+		//     msaaSamples: the amount of samples per pixel the scene was rendered with
+		void EndFrame(float cpuFrameTime, const std::vector<GPUProfiler::ScopeResult>& gpuTimes, float renderScale, uint32_t msaaSamples);
+
+	private:
+		// The control points of the camera spline, the spline is closed
+		std::vector<glm::vec3> m_Path{};
+
+		// The point the camera looks at
+		glm::vec3 m_Target{};
+
+		// The time it takes to fly the whole spline once in seconds
+		float m_PathDuration{ 10.0f };
+
+		// The time every frame simulates in seconds
+		float m_Timestep{ 1.0f / 60.0f };
+
+		// The amount of frames that are rendered before recording starts
+		uint32_t m_WarmupFrames{};
+
+		// The amount of frames that are recorded
+		uint32_t m_RecordedFrameCount{};
+
+		// The file the results are written to, without extension
+		std::string m_OutputPath{};
+
+		// The amount of frames that were rendered
+		uint32_t m_CurrentFrame{};
+
+		// The amount of frames that were simulated, the simulation runs a frame ahead of the rendering
+		uint32_t m_SimulatedFrame{};
+
+		// Indicates if the results were written
+		bool m_IsFinished{ false };
+
+		// The render scale and the amount of samples per pixel of the recorded frames, written to the results so runs can be compared
+		float m_RenderScale{ 1.0f };
+		uint32_t m_MsaaSamples{ 1 };
+
+		// The CPU frame time of every recorded frame in milliseconds
+		std::vector<float> m_CpuTimes{};
+
+		// The names of the measured passes
+		std::vector<std::string> m_PassNames{};
+
+		// The GPU time of every pass for every recorded frame in milliseconds, NaN if the pass wasn't measured
+		std::vector<std::vector<float>> m_GpuTimes{};
+
+		// Get the position on the spline
+		// Parameters:
+		//     time: the time since the start of the benchmark in seconds
+		glm::vec3 GetPathPosition(float time) const;
+
+		// Write the times of every frame to a CSV file and the statistics to a JSON file
+		void WriteResults() const;
+	};
+}
+
+#endif // !BenchmarkManagerIncluded
@@ -0,0 +1,226 @@
+// CPUProfiler.cpp
+
+// Header include
+#include "CPUProfiler.h"
+
+#ifdef DDM3_CPU_PROFILER
+
+// File includes
+#include "ConfigManager.h"
+
+#include "Includes/ImGuiIncludes.h"
+#include "Includes/RapidJSONIncludes.h"
+
+// Standard library includes
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+thread_local DDM3::CPUProfiler::ThreadBuffer* DDM3::CPUProfiler::m_spThreadBuffer{ nullptr };
+
+DDM3::CPUProfiler::ScopedMarker::ScopedMarker(const char* name)
+	:m_Name{ name },
+	m_Start{ GetTime() }
+{
+}
+
+DDM3::CPUProfiler::ScopedMarker::~ScopedMarker()
+{
+	// Write the scope to the buffer of this thread
+	CPUProfiler::GetInstance().AddEvent(m_Name, m_Start, GetTime());
+}
+
+DDM3::CPUProfiler::CPUProfiler()
+{
+	// Get config manager
+	auto& configManager{ ConfigManager::GetInstance() };
+
+	// Read the settings
+	m_CaptureStartFrame = static_cast<uint64_t>(std::max(configManager.GetInt("CPUProfilerCaptureStart"), 0));
+	m_CaptureFrameCount = static_cast<uint64_t>(std::max(configManager.GetInt("CPUProfilerCaptureFrames"), 0));
+	m_OutputPath = configManager.GetString("CPUProfilerOutput");
+}
+
+void DDM3::CPUProfiler::SetThreadName(const char* name)
+{
+	GetThreadBuffer().name = name;
+}
+
+void DDM3::CPUProfiler::BeginFrame(uint64_t frame)
+{
+	// If no frames are configured, captures are only started from the ImGui window
+	if (m_CaptureFrameCount == 0)
+		return;
+
+	// Start capturing at the first frame of the range and stop after the last one
+	if (frame == m_CaptureStartFrame && !m_IsCapturing)
+	{
+		StartCapture();
+	}
+	else if (frame == m_CaptureStartFrame + m_CaptureFrameCount && m_IsCapturing)
+	{
+		StopCapture();
+	}
+}
+
+void DDM3::CPUProfiler::StartCapture()
+{
+	// Only scopes that start after this moment are captured
+	m_CaptureStart = GetTime();
+	m_IsCapturing = true;
+}
+
+void DDM3::CPUProfiler::StopCapture()
+{
+	if (!m_IsCapturing)
+		return;
+
+	m_IsCapturing = false;
+
+	// Only scopes that ended before this moment are captured
+	uint64_t captureEnd{ GetTime() };
+
+	// Write the trace in the Chrome trace event format
+	rapidjson::StringBuffer buffer{};
+	rapidjson::Writer<rapidjson::StringBuffer> writer{ buffer };
+
+	writer.StartObject();
+	writer.Key("displayTimeUnit");
+	writer.String("ms");
+	writer.Key("traceEvents");
+	writer.StartArray();
+
+	// Indicates if scopes of the capture were overwritten before it ended
+	bool eventsLost{ false };
+
+	{
+		std::lock_guard<std::mutex> lock{ m_ThreadBuffersMutex };
+
+		for (auto& pThreadBuffer : m_ThreadBuffers)
+		{
+			// Name the thread
+			writer.StartObject();
+			writer.Key("name");
+			writer.String("thread_name");
+			writer.Key("ph");
+			writer.String("M");
+			writer.Key("pid");
+			writer.Uint(0);
+			writer.Key("tid");
+			writer.Uint(pThreadBuffer->threadId);
+			writer.Key("args");
+			writer.StartObject();
+			writer.Key("name");
+			writer.String(pThreadBuffer->name);
+			writer.EndObject();
+			writer.EndObject();
+
+			// Only the last scopes are still in the ring buffer
+			uint64_t writeIndex{ pThreadBuffer->writeIndex.load(std::memory_order_acquire) };
+			uint64_t firstIndex{ writeIndex > m_sBufferSize ? writeIndex - m_sBufferSize : 0 };
+
+			// If the oldest scope in the buffer started after the capture, scopes of the capture were overwritten
+			if (firstIndex > 0 && pThreadBuffer->events[firstIndex % m_sBufferSize].start > m_CaptureStart)
+			{
+				eventsLost = true;
+			}
+
+			for (uint64_t i{ firstIndex }; i < writeIndex; ++i)
+			{
+				auto& event{ pThreadBuffer->events[i % m_sBufferSize] };
+				if (event.start < m_CaptureStart || event.end > captureEnd)
+					continue;
+
+				// Add a complete event, the times are in microseconds relative to the start of the capture
+				writer.StartObject();
+				writer.Key("name");
+				writer.String(event.name);
+				writer.Key("cat");
+				writer.String("CPU");
+				writer.Key("ph");
+				writer.String("X");
+				writer.Key("ts");
+				writer.Double(static_cast<double>(event.start - m_CaptureStart) / 1000.0);
+				writer.Key("dur");
+				writer.Double(static_cast<double>(event.end - event.start) / 1000.0);
+				writer.Key("pid");
+				writer.Uint(0);
+				writer.Key("tid");
+				writer.Uint(pThreadBuffer->threadId);
+				writer.EndObject();
+			}
+		}
+	}
+
+	writer.EndArray();
+	writer.EndObject();
+
+	if (eventsLost)
+	{
+		std::cout << "CPU profiler capture was too long, the oldest scopes were overwritten\n";
+	}
+
+	// Every capture gets its own file
+	std::string filePath{ m_OutputPath + "_" + std::to_string(m_CaptureCount++) + ".json" };
+	std::ofstream file{ filePath };
+	if (!file)
+	{
+		std::cout << "Failed to write CPU trace to " << filePath << "\n";
+		return;
+	}
+	file << buffer.GetString();
+
+	std::cout << "CPU trace written to " << filePath << "\n";
+}
+
+void DDM3::CPUProfiler::RenderStats()
+{
+	// Start or stop a capture
+	ImGui::Begin("CPU profiler");
+	if (ImGui::Button(m_IsCapturing ? "Stop capture" : "Start capture"))
+	{
+		if (m_IsCapturing)
+		{
+			StopCapture();
+		}
+		else
+		{
+			StartCapture();
+		}
+	}
+	ImGui::Text("Captures written: %u", m_CaptureCount);
+	ImGui::End();
+}
+
+uint64_t DDM3::CPUProfiler::GetTime()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+DDM3::CPUProfiler::ThreadBuffer& DDM3::CPUProfiler::GetThreadBuffer()
+{
+	// Create the buffer the first time this thread records a scope
+	if (m_spThreadBuffer == nullptr)
+	{
+		std::lock_guard<std::mutex> lock{ m_ThreadBuffersMutex };
+
+		auto& pThreadBuffer{ m_ThreadBuffers.emplace_back(std::make_unique<ThreadBuffer>()) };
+		pThreadBuffer->threadId = static_cast<uint32_t>(m_ThreadBuffers.size() - 1);
+		m_spThreadBuffer = pThreadBuffer.get();
+	}
+
+	return *m_spThreadBuffer;
+}
+
+void DDM3::CPUProfiler::AddEvent(const char* name, uint64_t start, uint64_t end)
+{
+	auto& threadBuffer{ GetThreadBuffer() };
+
+	// Only this thread writes the index, the release makes the scope visible to a capture that reads the index
+	uint64_t writeIndex{ threadBuffer.writeIndex.load(std::memory_order_relaxed) };
+	threadBuffer.events[writeIndex % m_sBufferSize] = Event{ name, start, end };
+	threadBuffer.writeIndex.store(writeIndex + 1, std::memory_order_release);
+}
+
+#endif // DDM3_CPU_PROFILER
@@ -0,0 +1,170 @@
+// CPUProfiler.h
+// This singleton records named scopes of CPU work and exports them as a Chrome trace, viewable in chrome://tracing or Perfetto
+// Every thread writes its scopes to its own ring buffer without locks, a capture collects the scopes of all threads between its start and end
+// The markers are only compiled when DDM3_CPU_PROFILER is defined, otherwise the macros below are empty
+
+#ifndef CPUProfilerIncluded
+#define CPUProfilerIncluded
+
+// Helper macros to give every marker a unique name
+#define DDM3_PROFILE_CONCAT_INNER(a, b) a##b
+#define DDM3_PROFILE_CONCAT(a, b) DDM3_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef DDM3_CPU_PROFILER
+
+// Measure the CPU time until the end of the current scope, the name must be a string literal
+#define DDM3_PROFILE_SCOPE(name) DDM3::CPUProfiler::ScopedMarker DDM3_PROFILE_CONCAT(cpuMarker, __LINE__){ name }
+
+// Give the current thread a name in the trace, the name must be a string literal
+#define DDM3_PROFILE_THREAD(name) DDM3::CPUProfiler::GetInstance().SetThreadName(name)
+
+// Mark the start of a frame, starts and stops captures of the configured frame range
+#define DDM3_PROFILE_FRAME(frame) DDM3::CPUProfiler::GetInstance().BeginFrame(frame)
+
+// Parent class include
+#include "Singleton.h"
+
+// Standard library includes
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace DDM3
+{
+	class CPUProfiler final : public Singleton<CPUProfiler>
+	{
+	public:
+		// Measures a scope from its construction until it goes out of scope
+		class ScopedMarker final
+		{
+		public:
+			// Constructor
+			// Parameters:
+			//     name: the name of the scope, must be a string literal
+			ScopedMarker(const char* name);
+
+			// Delete default constructor
+			ScopedMarker() = delete;
+
+			// Destructor
+			~ScopedMarker();
+
+			// Delete copy and move functions
+			ScopedMarker(ScopedMarker& other) = delete;
+			ScopedMarker(ScopedMarker&& other) = delete;
+			ScopedMarker& operator=(ScopedMarker& other) = delete;
+			ScopedMarker& operator=(ScopedMarker&& other) = delete;
+
+		private:
+			// The name of the scope
+			const char* m_Name{};
+
+			// The time the scope started in nanoseconds
+			uint64_t m_Start{};
+		};
+
+		// Constructor, reads the settings from the config file
+		CPUProfiler();
+
+		// Give the current thread a name in the trace
+		// Parameters:
+		//     name: the name of the thread, must be a string literal
+		void SetThreadName(const char* name);
+
+		// Mark the start of a frame, starts and stops the capture of the frame range in the config file
+		// Parameters:
+		//     frame: the number of the frame that starts
+		void BeginFrame(uint64_t frame);
+
+		// Start collecting scopes
+		void StartCapture();
+
+		// Stop collecting scopes and write them to a trace file
+		void StopCapture();
+
+		// Check if scopes are being collected
+		bool IsCapturing() const { return m_IsCapturing; }
+
+		// Show the capture button in the CPU profiler window
+		void RenderStats();
+
+	private:
+		// The amount of scopes every thread remembers, older scopes are overwritten
+		static constexpr uint32_t m_sBufferSize{ 1 << 16 };
+
+		// A measured scope
+		struct Event
+		{
+			// The name of the scope
+			const char* name{};
+			// The start and end time in nanoseconds
+			uint64_t start{};
+			uint64_t end{};
+		};
+
+		// The ring buffer of a thread
+		struct ThreadBuffer
+		{
+			// The scopes of the thread
+			std::array<Event, m_sBufferSize> events{};
+			// The amount of scopes that were written, only the owning thread writes it
+			std::atomic<uint64_t> writeIndex{};
+			// The id of the thread in the trace
+			uint32_t threadId{};
+			// The name of the thread in the trace
+			const char* name{ "Thread" };
+		};
+
+		// The buffer of the current thread, nullptr until the thread records its first scope
+		static thread_local ThreadBuffer* m_spThreadBuffer;
+
+		// The buffers of all threads, they are kept until the profiler is destroyed so threads can end at any time
+		std::vector<std::unique_ptr<ThreadBuffer>> m_ThreadBuffers{};
+
+		// Protects the list of buffers, only locked when a thread records its first scope and when a capture ends
+		std::mutex m_ThreadBuffersMutex{};
+
+		// Indicates if scopes are being collected
+		bool m_IsCapturing{ false };
+
+		// The time the current capture started in nanoseconds
+		uint64_t m_CaptureStart{};
+
+		// The amount of captures that were written
+		uint32_t m_CaptureCount{};
+
+		// The first frame and amount of frames captured from the config file, no frames are captured if the amount is 0
+		uint64_t m_CaptureStartFrame{};
+		uint64_t m_CaptureFrameCount{};
+
+		// The file the traces are written to, without extension
+		std::string m_OutputPath{};
+
+		// Get the current time in nanoseconds
+		static uint64_t GetTime();
+
+		// Get the buffer of the current thread, creates it the first time
+		ThreadBuffer& GetThreadBuffer();
+
+		// Add a scope to the buffer of the current thread
+		// Parameters:
+		//     name: the name of the scope
+		//     start: the start time in nanoseconds
+		//     end: the end time in nanoseconds
+		void AddEvent(const char* name, uint64_t start, uint64_t end);
+	};
+}
+
+#else
+
+#define DDM3_PROFILE_SCOPE(name)
+#define DDM3_PROFILE_THREAD(name)
+#define DDM3_PROFILE_FRAME(frame)
+
+#endif // DDM3_CPU_PROFILER
+
+#endif // !CPUProfilerIncluded
@@ -84,6 +84,58 @@ float DDM3::ConfigManager::GetFloat(const std::string&& propertyName)
 	return GetFloat(propertyName);
 }
 
+glm::vec3 DDM3::ConfigManager::GetVec3(const std::string& propertyName)
+{
+	// Check if file contains property, if not, return 0
+	if (m_JsonFile.HasMember(propertyName.c_str()))
+	{
+		auto& value{ m_JsonFile[propertyName.c_str()] };
+		if (value.IsArray() && value.Size() == 3 && value[0].IsNumber() && value[1].IsNumber() && value[2].IsNumber())
+		{
+			return glm::vec3{ value[0].GetFloat(), value[1].GetFloat(), value[2].GetFloat() };
+		}
+	}
+
+	std::cout << "Vec3 property " << propertyName << " is not availabel\n";
+	return glm::vec3{};
+}
+
+glm::vec3 DDM3::ConfigManager::GetVec3(const std::string&& propertyName)
+{
+	return GetVec3(propertyName);
+}
+
+std::vector<glm::vec3> DDM3::ConfigManager::GetVec3Array(const std::string& propertyName)
+{
+	std::vector<glm::vec3> vectors{};
+
+	// Check if file contains property, if not, return empty array
+	if (!m_JsonFile.HasMember(propertyName.c_str()) || !m_JsonFile[propertyName.c_str()].IsArray())
+	{
+		std::cout << "Vec3 array property " << propertyName << " is not availabel\n";
+		return vectors;
+	}
+
+	// Add every element that is an array of 3 numbers
+	for (auto& element : m_JsonFile[propertyName.c_str()].GetArray())
+	{
+		if (!element.IsArray() || element.Size() != 3 || !element[0].IsNumber() || !element[1].IsNumber() || !element[2].IsNumber())
+		{
+			std::cout << "Element of vec3 array property " << propertyName << " is not a vec3\n";
+			continue;
+		}
+
+		vectors.emplace_back(element[0].GetFloat(), element[1].GetFloat(), element[2].GetFloat());
+	}
+
+	return vectors;
+}
+
+std::vector<glm::vec3> DDM3::ConfigManager::GetVec3Array(const std::string&& propertyName)
+{
+	return GetVec3Array(propertyName);
+}
+
 void DDM3::ConfigManager::ReadFile()
 {
 	FILE* pFile{};
@@ -9,9 +9,11 @@
 
 // File includes
 #include "Includes/RapidJSONIncludes.h"
+#include "Includes/GLMIncludes.h"
 
 // Standard library includes
 #include <string>
+#include <vector>
 
 
 namespace DDM3
@@ -62,6 +64,26 @@ namespace DDM3
 		//     propertyName: name of the property
 		float GetFloat(const std::string&& propertyName);
 
+		// Get vec3 object from json, stored as an array of 3 numbers
+		// Parameters:
+		//     propertyName: name of the property
+		glm::vec3 GetVec3(const std::string& propertyName);
+
+		// Get vec3 object from json, stored as an array of 3 numbers
+		// Parameters:
+		//     propertyName: name of the property
+		glm::vec3 GetVec3(const std::string&& propertyName);
+
+		// Get array of vec3 objects from json, every vec3 is an array of 3 numbers
+		// Parameters:
+		//     propertyName: name of the property
+		std::vector<glm::vec3> GetVec3Array(const std::string& propertyName);
+
+		// Get array of vec3 objects from json, every vec3 is an array of 3 numbers
+		// Parameters:
+		//     propertyName: name of the property
+		std::vector<glm::vec3> GetVec3Array(const std::string&& propertyName);
+
 	private:
 		// File name of the config file
 		const std::string m_FileName { "Config.json" };
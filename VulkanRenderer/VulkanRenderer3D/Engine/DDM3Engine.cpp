@@ -4,8 +4,13 @@
 #include "DDM3Engine.h"
 
 // File includes
-#include "TimeManager.h"
 #include "ConfigManager.h"
+#include "BenchmarkManager.h"
+#include "CPUProfiler.h"
+#include "FramePacer.h"
+#include "JobSystem.h"
+#include "JobSystemBenchmark.h"
+#include "SimulationThread.h"
 
 #include "Window.h"
 
@@ -14,12 +19,18 @@
 
 // Standard library includes
 #include <chrono>
-#include <thread>
+#include <memory>
 
 DDM3::DDM3Engine::DDM3Engine()
 {
-	// Create the window with the given width and height
-	DDM3::Window::GetInstance();
+	// Create the window with the given width and height, in headless mode no window is needed
+	if (!ConfigManager::GetInstance().GetBool("Headless"))
+	{
+		DDM3::Window::GetInstance();
+	}
+
+	// Start the worker threads of the job system, loading can already use them
+	DDM3::JobSystem::GetInstance();
 	
 	DDM3::Vulkan3D::GetInstance().Init();
 }
@@ -27,17 +38,39 @@ DDM3::DDM3Engine::DDM3Engine()
 DDM3::DDM3Engine::~DDM3Engine()
 {
 	DDM3::Vulkan3D::GetInstance().Terminate();	
+
+	// Stop the worker threads, no more jobs are scheduled after the renderer is terminated
+	DDM3::JobSystem::GetInstance().Shutdown();
 }
 
 // This function will run the gameloop for the duration of the app
 void DDM3::DDM3Engine::Run(const std::function<void()>& load)
 {
+	// Measure the overhead of the job system before anything else runs
+	if (ConfigManager::GetInstance().GetBool("JobSystemBenchmark"))
+	{
+		JobSystemBenchmark{}.Run();
+	}
+
 	// Run the load function
 	load();
 
 	auto& vulkan{ Vulkan3D::GetInstance() };
 	auto& renderer{ vulkan.GetRenderer() };
-	auto& window{ Window::GetInstance() };
+
+	// All pipelines are created by now, log how long it took
+	renderer.LogPipelineStatistics();
+
+	// In headless mode there is no window or input, the loop stops after a fixed amount of frames
+	bool headless{ Vulkan3D::IsHeadless() };
+	uint64_t headlessFrameCount{ static_cast<uint64_t>(ConfigManager::GetInstance().GetInt("HeadlessFrameCount")) };
+
+	// In benchmark mode the camera follows a scripted path with a fixed timestep and the loop stops once all frames are recorded
+	std::unique_ptr<BenchmarkManager> pBenchmark{};
+	if (ConfigManager::GetInstance().GetBool("Benchmark"))
+	{
+		pBenchmark = std::make_unique<BenchmarkManager>();
+	}
 
 	auto pCamera = vulkan.GetCurrentCamera();
 	pCamera->SetPosition(0, 5, -15);
@@ -45,70 +78,65 @@ void DDM3::DDM3Engine::Run(const std::function<void()>& load)
 	//pCamera->SetRotation(glm::eulerAngles(rot));
 	
 
-	// Get the timemanager locally to prevent calling it every frame
-	auto& time{ TimeManager::GetInstance() };
-
-	// Get current time for later use
-	auto lastTime = std::chrono::high_resolution_clock::now();
-
-	// Variable that will indicate if framerate should be capped or or not
-	bool capFrameRate{ false };
-
-	// Set desired framerate
-	const int desiredFramerate = 60;
-
-	// Calculate the duratinno of a single frame in milliseconds
-	const std::chrono::milliseconds millisecondsPerFrame(1000 / desiredFramerate);
+	// Get the frame pacer, it limits the framerate to the target framerate in the config file
+	auto& framePacer{ FramePacer::GetInstance() };
 
 	// Variable that will indicate when the gameloop should stop running
 	bool shouldQuit{false};
 
+	// Name the thread the frames are rendered on in the CPU traces
+	DDM3_PROFILE_THREAD("Render");
+
+	// Start the simulation, it runs a frame ahead of the rendering and stops when it goes out of scope
+	SimulationThread simulation{ pCamera, pBenchmark.get(), !headless };
+
 	// As long as the app shouldn't quit, the gameloop will run
 	while (!shouldQuit)
 	{
+		// Start or stop a CPU capture if the configured frame range starts or ends, then measure the frame
+		DDM3_PROFILE_FRAME(Vulkan3D::GetFrameCount());
+		DDM3_PROFILE_SCOPE("Frame");
+
 		// Get the current time
 		const auto frameStart = std::chrono::high_resolution_clock::now();
 
-		// Calculate the duration of last frame by subtracting the time start time from last frame from the starting time from this frame
-		auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(frameStart - lastTime);
-
-		// Calculate in seconds how long last frame lasted
-		float deltaTime = static_cast<float>(duration.count());
-
-		// Set lastTime to start of current frame for next iteration
-		lastTime = frameStart;
-
-		// Set current deltaTime in the timeManager
-		time.SetDeltaTime(deltaTime);
-
-		// Print FPS
-		//std::cout << "FPS: " << time.GetFps() << std::endl;
-
-		// Poll input for the window
-		glfwPollEvents();
-
-		pCamera->Update();
-		
-		Vulkan3D::GetInstance().GetModelManager()->Update();
-
-
-		// Render all models
-		Vulkan3D::GetInstance().Render();
+		// Poll input for the window and pass it to the simulation, GLFW can only be used on the main thread
+		if (!headless)
+		{
+			glfwPollEvents();
+			simulation.SetInput(Window::GetInstance().GetInputState());
+		}
 
-		// Check if aplication should quit
-		shouldQuit = glfwWindowShouldClose(window.GetWindowStruct().pWindow);
+		// Render the packet of the next simulated frame, the simulation of the frame after it runs meanwhile
+		Vulkan3D::GetInstance().Render(simulation.BeginRender());
+		simulation.EndRender();
 
-		// If cap framerate, sleep the appropriate amount of time
-		if (capFrameRate)
+		// Record the CPU time of this frame and the last GPU times of the passes
+		if (pBenchmark != nullptr)
 		{
-			// Calculate duration of the current frame
-			auto frameTime = std::chrono::high_resolution_clock::now() - frameStart;
+			std::chrono::duration<float, std::milli> cpuFrameTime{ std::chrono::high_resolution_clock::now() - frameStart };
+			pBenchmark->EndFrame(cpuFrameTime.count(), renderer.GetGPUProfiler()->GetResults(), renderer.GetRenderScale(),
+				static_cast<uint32_t>(renderer.GetMsaaSamples()));
+		}
 
-			// Calculate how long the thread should sleep
-			auto sleepTime = millisecondsPerFrame - std::chrono::duration_cast<std::chrono::milliseconds>(frameTime);
+		// Check if aplication should quit, a benchmark runs until all frames are recorded
+		if (pBenchmark != nullptr && pBenchmark->IsFinished())
+		{
+			shouldQuit = true;
+		}
+		else if (headless)
+		{
+			shouldQuit = pBenchmark == nullptr && Vulkan3D::GetFrameCount() >= headlessFrameCount;
+		}
+		else
+		{
+			shouldQuit = glfwWindowShouldClose(Window::GetInstance().GetWindowStruct().pWindow);
+		}
 
-			// Make the thread sleep for the right amount of time
-			std::this_thread::sleep_for(sleepTime);
+		// Wait until the deadline of this frame
+		{
+			DDM3_PROFILE_SCOPE("Frame pacing");
+			framePacer.Wait();
 		}
 	}
 }
@@ -0,0 +1,124 @@
+// FramePacer.cpp
+
+// Header include
+#include "FramePacer.h"
+
+// File includes
+#include "ConfigManager.h"
+
+#include "Includes/ImGuiIncludes.h"
+
+// Standard library includes
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+DDM3::FramePacer::FramePacer()
+{
+	// Read the target framerate
+	SetTargetFramerate(ConfigManager::GetInstance().GetInt("TargetFramerate"));
+
+	// Reserve the frame times
+	m_FrameTimes.reserve(m_sFrameTimeCount);
+
+	// The first frame starts now
+	m_LastFrameEnd = Clock::now();
+	m_Deadline = m_LastFrameEnd + m_FramePeriod;
+}
+
+void DDM3::FramePacer::Wait()
+{
+	if (m_TargetFramerate > 0)
+	{
+		// Sleep while the deadline is far away, a sleep can take longer than requested so it stops well before the deadline
+		auto now{ Clock::now() };
+		while (m_Deadline - now > m_sSpinTime)
+		{
+			std::this_thread::sleep_for(m_Deadline - now - m_sSpinTime);
+			now = Clock::now();
+		}
+
+		// Spin for the last part
+		while (Clock::now() < m_Deadline)
+		{
+			std::this_thread::yield();
+		}
+
+		// The next deadline is one period later, this keeps the average framerate exact even if a single wait overshoots
+		m_Deadline += m_FramePeriod;
+
+		// If the frame took longer than a whole period, don't try to catch up with shorter frames
+		now = Clock::now();
+		if (m_Deadline < now)
+		{
+			m_Deadline = now + m_FramePeriod;
+		}
+	}
+
+	RecordFrameTime(Clock::now());
+}
+
+void DDM3::FramePacer::SetTargetFramerate(int framerate)
+{
+	m_TargetFramerate = std::max(framerate, 0);
+
+	// Calculate the time a frame should take, the deadlines start from now
+	if (m_TargetFramerate > 0)
+	{
+		m_FramePeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_TargetFramerate));
+		m_Deadline = Clock::now() + m_FramePeriod;
+	}
+}
+
+void DDM3::FramePacer::RenderStats()
+{
+	// Add the frame pacing to the stats window
+	ImGui::Begin("Stats");
+
+	int targetFramerate{ m_TargetFramerate };
+	if (ImGui::InputInt("Target framerate", &targetFramerate) && targetFramerate != m_TargetFramerate)
+	{
+		SetTargetFramerate(targetFramerate);
+	}
+
+	ImGui::Text("Frame time: %.2f ms (+- %.2f ms)", m_AverageFrameTime, m_FrameTimeDeviation);
+	ImGui::Text("Frame time min/max: %.2f / %.2f ms", m_MinFrameTime, m_MaxFrameTime);
+	ImGui::End();
+}
+
+void DDM3::FramePacer::RecordFrameTime(Clock::time_point frameEnd)
+{
+	// Get the time since the last frame in milliseconds
+	float frameTime{ std::chrono::duration<float, std::milli>(frameEnd - m_LastFrameEnd).count() };
+	m_LastFrameEnd = frameEnd;
+
+	// Write the frame time in the ring buffer
+	if (m_FrameTimes.size() < m_sFrameTimeCount)
+	{
+		m_FrameTimes.push_back(frameTime);
+	}
+	else
+	{
+		m_FrameTimes[m_FrameTimeIndex] = frameTime;
+	}
+	m_FrameTimeIndex = (m_FrameTimeIndex + 1) % m_sFrameTimeCount;
+
+	// Calculate the average, deviation, minimum and maximum
+	float total{};
+	for (auto time : m_FrameTimes)
+	{
+		total += time;
+	}
+	m_AverageFrameTime = total / static_cast<float>(m_FrameTimes.size());
+
+	float variance{};
+	for (auto time : m_FrameTimes)
+	{
+		variance += (time - m_AverageFrameTime) * (time - m_AverageFrameTime);
+	}
+	m_FrameTimeDeviation = std::sqrt(variance / static_cast<float>(m_FrameTimes.size()));
+
+	auto [minTime, maxTime] { std::minmax_element(m_FrameTimes.begin(), m_FrameTimes.end()) };
+	m_MinFrameTime = *minTime;
+	m_MaxFrameTime = *maxTime;
+}
@@ -0,0 +1,83 @@
+// FramePacer.h
+// This singleton limits the framerate by waiting until an absolute deadline at the end of every frame
+// It sleeps while the deadline is far away and spins for the last part, because sleeping isn't precise enough to hit the deadline
+// It also keeps the time between the last frames to show how smooth the framerate is
+
+#ifndef FramePacerIncluded
+#define FramePacerIncluded
+
+// Parent class include
+#include "Singleton.h"
+
+// Standard library includes
+#include <chrono>
+#include <vector>
+
+namespace DDM3
+{
+	class FramePacer final : public Singleton<FramePacer>
+	{
+	public:
+		// Constructor, reads the target framerate from the config file
+		FramePacer();
+
+		// Wait until the deadline of the current frame and record the time of the frame
+		// Without a target framerate it only records the time
+		void Wait();
+
+		// Set the amount of frames per second, 0 doesn't limit the framerate
+		// Parameters:
+		//     framerate: the target framerate
+		void SetTargetFramerate(int framerate);
+
+		// Get the average time between frames in milliseconds
+		float GetAverageFrameTime() const { return m_AverageFrameTime; }
+
+		// Get the standard deviation of the time between frames in milliseconds
+		float GetFrameTimeDeviation() const { return m_FrameTimeDeviation; }
+
+		// Show the target framerate and the frame time statistics in the stats window
+		void RenderStats();
+
+	private:
+		// The clock used for the deadlines
+		using Clock = std::chrono::steady_clock;
+
+		// The amount of frames the statistics are calculated over
+		static constexpr size_t m_sFrameTimeCount{ 240 };
+
+		// The time before the deadline at which sleeping stops and spinning starts
+		static constexpr std::chrono::microseconds m_sSpinTime{ 2000 };
+
+		// The amount of frames per second, 0 if the framerate isn't limited
+		int m_TargetFramerate{};
+
+		// The time a frame should take
+		Clock::duration m_FramePeriod{};
+
+		// The time the current frame should end
+		Clock::time_point m_Deadline{};
+
+		// The time the last frame ended
+		Clock::time_point m_LastFrameEnd{};
+
+		// The time between the last frames in milliseconds, used as a ring buffer
+		std::vector<float> m_FrameTimes{};
+
+		// The index in the ring buffer the next frame time is written to
+		size_t m_FrameTimeIndex{};
+
+		// The statistics of the frame times in milliseconds
+		float m_AverageFrameTime{};
+		float m_FrameTimeDeviation{};
+		float m_MinFrameTime{};
+		float m_MaxFrameTime{};
+
+		// Record the time between the last frame and this one and update the statistics
+		// Parameters:
+		//     frameEnd: the time this frame ended
+		void RecordFrameTime(Clock::time_point frameEnd);
+	};
+}
+
+#endif // !FramePacerIncluded
@@ -0,0 +1,42 @@
+// FramePacket.h
+// This struct holds everything the simulation produced for a single frame
+// The render thread only reads the packet, so the simulation of the next frame can change the scene while this frame is recorded
+
+#ifndef FramePacketIncluded
+#define FramePacketIncluded
+
+// File includes
+#include "Includes/GLMIncludes.h"
+
+#include "DataTypes/Structs.h"
+#include "DataTypes/Camera.h"
+
+// Standard library includes
+#include <vector>
+#include <cstdint>
+
+namespace DDM3
+{
+	struct FramePacket
+	{
+		// The number of the simulated frame
+		uint64_t frame{};
+
+		// The camera the frame is rendered with
+		CameraState camera{};
+
+		// The world matrix of every transform, indexed by the id of the transform
+		std::vector<glm::mat4> worldMatrices{};
+
+		// Indicates for every transform if its world matrix changed since the previous packet
+		std::vector<uint8_t> transformsChanged{};
+
+		// Indicates if any world matrix changed since the previous packet
+		bool anyTransformChanged{};
+
+		// The values of the global light
+		DirectionalLightStruct light{};
+	};
+}
+
+#endif // !FramePacketIncluded
@@ -0,0 +1,262 @@
+// JobSystem.cpp
+
+// Header include
+#include "JobSystem.h"
+
+// File includes
+#include "ConfigManager.h"
+#include "CPUProfiler.h"
+
+// Standard library includes
+#include <algorithm>
+
+thread_local int DDM3::JobSystem::m_sWorkerIndex{ -1 };
+
+DDM3::JobSystem::JobSystem()
+{
+	// Read the amount of workers, by default every core but the one of the main thread gets a worker
+	int workerCount{ ConfigManager::GetInstance().GetInt("JobWorkerCount") };
+	if (workerCount <= 0)
+	{
+		workerCount = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0);
+	}
+
+	// Create a queue for every worker and the shared queue
+	for (int i{}; i <= workerCount; ++i)
+	{
+		m_pQueues.push_back(std::make_unique<JobQueue>());
+	}
+
+	// Start the workers
+	for (int i{}; i < workerCount; ++i)
+	{
+		m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+}
+
+DDM3::JobSystem::~JobSystem()
+{
+	Shutdown();
+}
+
+void DDM3::JobSystem::Schedule(std::function<void()> function, JobCounter* pCounter)
+{
+	// Count the job before it can run
+	if (pCounter != nullptr)
+	{
+		pCounter->m_Count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	Push(Job{ std::move(function), pCounter });
+}
+
+void DDM3::JobSystem::Schedule(std::function<void()> function, JobCounter* pCounter, JobCounter& dependency)
+{
+	// Count the job now, so waiting for the counter also waits for the dependency
+	if (pCounter != nullptr)
+	{
+		pCounter->m_Count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// The count is checked while holding the lock, the last job of the dependency takes the same lock before it schedules the dependent jobs
+	{
+		std::lock_guard<std::mutex> lock{ dependency.m_Mutex };
+		if (!dependency.IsDone())
+		{
+			dependency.m_DependentJobs.push_back(Job{ std::move(function), pCounter });
+			return;
+		}
+	}
+
+	// The dependency already finished, the job can run right away
+	Push(Job{ std::move(function), pCounter });
+}
+
+void DDM3::JobSystem::Wait(JobCounter& counter)
+{
+	DDM3_PROFILE_SCOPE("Wait for jobs");
+
+	// Help with the jobs instead of sleeping, the jobs of the counter might not have started yet
+	while (!counter.IsDone())
+	{
+		if (!RunJob())
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	// The last job decrements the counter while holding its lock, once the lock is free the counter can be destroyed
+	std::lock_guard<std::mutex> lock{ counter.m_Mutex };
+}
+
+void DDM3::JobSystem::ParallelFor(uint32_t count, uint32_t minBatchSize, const std::function<void(uint32_t begin, uint32_t end)>& function)
+{
+	if (count == 0)
+		return;
+
+	// Aim for a few batches per thread so stealing can even out uneven batches, but never smaller than the minimum
+	uint32_t threadCount{ GetWorkerCount() + 1 };
+	uint32_t batchSize{ std::max({ minBatchSize, (count + 4 * threadCount - 1) / (4 * threadCount), 1u }) };
+
+	// If there is only one batch, run it on this thread
+	if (batchSize >= count)
+	{
+		function(0, count);
+		return;
+	}
+
+	// Schedule every batch but the first, the function outlives the jobs because this function waits for them
+	JobCounter counter{};
+	for (uint32_t begin{ batchSize }; begin < count; begin += batchSize)
+	{
+		uint32_t end{ std::min(begin + batchSize, count) };
+		Schedule([&function, begin, end]() { function(begin, end); }, &counter);
+	}
+
+	// Run the first batch on this thread and help with the rest
+	function(0, batchSize);
+	Wait(counter);
+}
+
+void DDM3::JobSystem::Shutdown()
+{
+	// Only stop the workers once
+	if (!m_Running.exchange(false))
+		return;
+
+	// Wake every sleeping worker so it sees the flag
+	{
+		std::lock_guard<std::mutex> lock{ m_SleepMutex };
+	}
+	m_SleepCondition.notify_all();
+
+	// Wait until every worker finished its current job
+	for (auto& worker : m_Workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+	m_Workers.clear();
+}
+
+void DDM3::JobSystem::WorkerLoop(int workerIndex)
+{
+	// Remember which queue belongs to this thread
+	m_sWorkerIndex = workerIndex;
+
+	// Name the thread in the CPU traces
+	DDM3_PROFILE_THREAD("Job worker");
+
+	while (m_Running.load(std::memory_order_acquire))
+	{
+		// Run jobs as long as there are any
+		if (RunJob())
+			continue;
+
+		// Sleep until a job is added, the count is checked under the lock so a job added meanwhile isn't missed
+		std::unique_lock<std::mutex> lock{ m_SleepMutex };
+		m_SleepCondition.wait(lock, [this]()
+			{
+				return m_PendingJobs.load(std::memory_order_acquire) > 0 || !m_Running.load(std::memory_order_acquire);
+			});
+	}
+}
+
+void DDM3::JobSystem::Push(Job&& job)
+{
+	// Workers add to their own queue, other threads to the shared queue at the end
+	auto& queue{ m_sWorkerIndex >= 0 ? *m_pQueues[m_sWorkerIndex] : *m_pQueues.back() };
+	{
+		std::lock_guard<std::mutex> lock{ queue.mutex };
+		queue.jobs.push_back(std::move(job));
+	}
+	m_PendingJobs.fetch_add(1, std::memory_order_release);
+
+	// Wake a sleeping worker, taking the lock makes sure it isn't between checking the count and going to sleep
+	{
+		std::lock_guard<std::mutex> lock{ m_SleepMutex };
+	}
+	m_SleepCondition.notify_one();
+}
+
+bool DDM3::JobSystem::Pop(Job& job)
+{
+	// Quick check, so idle threads don't lock every queue
+	if (m_PendingJobs.load(std::memory_order_acquire) == 0)
+		return false;
+
+	// Workers take the newest job of their own queue first, its data is most likely still in the cache
+	if (m_sWorkerIndex >= 0)
+	{
+		auto& queue{ *m_pQueues[m_sWorkerIndex] };
+		std::lock_guard<std::mutex> lock{ queue.mutex };
+		if (!queue.jobs.empty())
+		{
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+			m_PendingJobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	// Steal the oldest job of the other queues, starting after the own queue so thieves spread over the queues
+	auto queueCount{ static_cast<int>(m_pQueues.size()) };
+	int start{ m_sWorkerIndex >= 0 ? m_sWorkerIndex + 1 : queueCount - 1 };
+	for (int i{}; i < queueCount; ++i)
+	{
+		int index{ (start + i) % queueCount };
+		if (index == m_sWorkerIndex)
+			continue;
+
+		auto& queue{ *m_pQueues[index] };
+		std::lock_guard<std::mutex> lock{ queue.mutex };
+		if (!queue.jobs.empty())
+		{
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			m_PendingJobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool DDM3::JobSystem::RunJob()
+{
+	Job job{};
+	if (!Pop(job))
+		return false;
+
+	Execute(job);
+	return true;
+}
+
+void DDM3::JobSystem::Execute(Job& job)
+{
+	// Run the job
+	job.function();
+
+	// Without a counter nothing waits for the job
+	if (job.pCounter == nullptr)
+		return;
+
+	// Only the last job of the counter schedules the dependent jobs
+	auto pCounter{ job.pCounter };
+	std::vector<Job> dependentJobs{};
+	{
+		std::lock_guard<std::mutex> lock{ pCounter->m_Mutex };
+		if (pCounter->m_Count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+
+		dependentJobs.swap(pCounter->m_DependentJobs);
+	}
+
+	// The counter can be destroyed by a waiting thread from here on, only the moved jobs are used
+	for (auto& dependentJob : dependentJobs)
+	{
+		Push(std::move(dependentJob));
+	}
+}
@@ -0,0 +1,168 @@
+// JobSystem.h
+// This singleton runs small jobs on a fixed pool of worker threads
+// Every worker has its own queue: it takes the newest job from its own queue and steals the oldest job from the others when it runs out
+// Jobs scheduled from other threads, like the main and simulation thread, go to a shared queue
+// A thread that waits for a counter runs jobs itself until the counter reaches zero, so waiting never leaves a core idle
+// Jobs must not throw, an exception on a worker thread ends the application
+
+#ifndef JobSystemIncluded
+#define JobSystemIncluded
+
+// Parent class include
+#include "Singleton.h"
+
+// Standard library includes
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DDM3
+{
+	// Class forward declarations
+	class JobCounter;
+
+	// A scheduled job
+	struct Job
+	{
+		// The function that is run
+		std::function<void()> function{};
+		// The counter that is decremented once the function finished, can be nullptr
+		JobCounter* pCounter{};
+	};
+
+	// Counts the unfinished jobs scheduled with it, used to wait for jobs and to start jobs once others finished
+	// The counter has to stay alive until all its jobs finished, so call JobSystem::Wait before destroying it
+	class JobCounter final
+	{
+	public:
+		// Default constructor
+		JobCounter() = default;
+
+		// Default destructor
+		~JobCounter() = default;
+
+		// Delete copy and move functions
+		JobCounter(JobCounter& other) = delete;
+		JobCounter(JobCounter&& other) = delete;
+		JobCounter& operator=(JobCounter& other) = delete;
+		JobCounter& operator=(JobCounter&& other) = delete;
+
+		// Check if all jobs scheduled with this counter finished
+		bool IsDone() const { return m_Count.load(std::memory_order_acquire) == 0; }
+
+	private:
+		friend class JobSystem;
+
+		// The amount of unfinished jobs
+		std::atomic<uint32_t> m_Count{};
+
+		// Protects the dependent jobs
+		std::mutex m_Mutex{};
+
+		// The jobs that are scheduled once the counter reaches zero
+		std::vector<Job> m_DependentJobs{};
+	};
+
+	class JobSystem final : public Singleton<JobSystem>
+	{
+	public:
+		// Constructor, starts the worker threads, the amount is read from the config file
+		JobSystem();
+
+		// Destructor, stops the worker threads
+		~JobSystem();
+
+		// Schedule a job
+		// Parameters:
+		//     function: the function that is run
+		//     pCounter: the counter that is incremented now and decremented once the job finished, can be nullptr
+		void Schedule(std::function<void()> function, JobCounter* pCounter = nullptr);
+
+		// Schedule a job that only starts once all jobs of another counter finished
+		// Parameters:
+		//     function: the function that is run
+		//     pCounter: the counter that is incremented now and decremented once the job finished, can be nullptr
+		//     dependency: the counter that has to reach zero before the job starts
+		void Schedule(std::function<void()> function, JobCounter* pCounter, JobCounter& dependency);
+
+		// Wait until all jobs of a counter finished, runs other jobs while waiting
+		// Parameters:
+		//     counter: the counter to wait for
+		void Wait(JobCounter& counter);
+
+		// Split a range into batches and run them in parallel, the calling thread runs the first batch and waits for the rest
+		// Parameters:
+		//     count: the amount of elements in the range
+		//     minBatchSize: the minimum amount of elements per batch, a batch should be worth scheduling
+		//     function: the function that is run for every batch with the first element and the element after the last one
+		void ParallelFor(uint32_t count, uint32_t minBatchSize, const std::function<void(uint32_t begin, uint32_t end)>& function);
+
+		// Get the amount of worker threads, the thread that waits for jobs helps as well
+		uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+		// Stop the worker threads, jobs that didn't start yet are dropped
+		void Shutdown();
+
+	private:
+		// The queue of a worker, or the shared queue for threads that aren't workers
+		struct JobQueue
+		{
+			// Protects the jobs, only held while adding or taking a single job
+			std::mutex mutex{};
+			// The jobs, the owner works at the back and thieves take from the front
+			std::deque<Job> jobs{};
+		};
+
+		// The index of the queue of the current thread, -1 if the thread isn't a worker
+		static thread_local int m_sWorkerIndex;
+
+		// The worker threads
+		std::vector<std::thread> m_Workers{};
+
+		// The queue of every worker, followed by the shared queue
+		std::vector<std::unique_ptr<JobQueue>> m_pQueues{};
+
+		// The amount of jobs in all queues
+		std::atomic<uint32_t> m_PendingJobs{};
+
+		// Indicates if the workers should keep running
+		std::atomic<bool> m_Running{ true };
+
+		// Wakes sleeping workers when jobs are added
+		std::mutex m_SleepMutex{};
+		std::condition_variable m_SleepCondition{};
+
+		// The loop of a worker thread
+		// Parameters:
+		//     workerIndex: the index of the queue of the worker
+		void WorkerLoop(int workerIndex);
+
+		// Add a job to the queue of the current thread and wake a worker
+		// Parameters:
+		//     job: the job to add
+		void Push(Job&& job);
+
+		// Take a job from the queue of the current thread, or steal one from another queue
+		// Parameters:
+		//     job: the job that was taken
+		// Returns true if a job was taken
+		bool Pop(Job& job);
+
+		// Take a job and run it
+		// Returns true if a job was run
+		bool RunJob();
+
+		// Run a job and decrement its counter, schedules the dependent jobs once the counter reaches zero
+		// Parameters:
+		//     job: the job to run
+		void Execute(Job& job);
+	};
+}
+
+#endif // !JobSystemIncluded
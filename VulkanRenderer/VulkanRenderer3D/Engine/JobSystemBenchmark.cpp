@@ -0,0 +1,111 @@
+// JobSystemBenchmark.cpp
+
+// Header include
+#include "JobSystemBenchmark.h"
+
+// File includes
+#include "JobSystem.h"
+
+// Standard library includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+void DDM3::JobSystemBenchmark::Run()
+{
+	// Get the job system
+	auto& jobSystem{ JobSystem::GetInstance() };
+
+	std::cout << "Job system benchmark with " << jobSystem.GetWorkerCount() << " workers\n";
+
+	// Schedule empty jobs from this thread, they all go through the shared queue and are stolen by the workers
+	Measure("Empty jobs", m_sEmptyJobCount, [&jobSystem]()
+		{
+			JobCounter counter{};
+			for (uint32_t i{}; i < m_sEmptyJobCount; ++i)
+			{
+				jobSystem.Schedule([]() {}, &counter);
+			}
+			jobSystem.Wait(counter);
+		});
+
+	// Schedule jobs from the workers, they go to the queue of the worker and the others have to steal them
+	Measure("Nested jobs", m_sParentJobCount * m_sChildJobCount, [&jobSystem]()
+		{
+			JobCounter counter{};
+			for (uint32_t i{}; i < m_sParentJobCount; ++i)
+			{
+				jobSystem.Schedule([&jobSystem, &counter]()
+					{
+						for (uint32_t j{}; j < m_sChildJobCount; ++j)
+						{
+							jobSystem.Schedule([]() {}, &counter);
+						}
+					}, &counter);
+			}
+			jobSystem.Wait(counter);
+		});
+
+	// Compare a parallel for with the same loop on this thread
+	std::vector<float> values(m_sElementCount);
+	auto work{ [&values](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i{ begin }; i < end; ++i)
+			{
+				values[i] = std::sqrt(static_cast<float>(i)) * std::sin(static_cast<float>(i));
+			}
+		} };
+
+	float serialTime{ Measure("Serial loop", m_sElementCount, [&work]()
+		{
+			work(0, m_sElementCount);
+		}) };
+
+	float parallelTime{ Measure("Parallel for", m_sElementCount, [&jobSystem, &work]()
+		{
+			jobSystem.ParallelFor(m_sElementCount, 1024, work);
+		}) };
+
+	std::cout << "    Parallel for speedup: " << serialTime / parallelTime << "x\n";
+
+	// Every job only starts once the previous one finished, measures the latency of a dependency
+	Measure("Dependency chain", m_sChainLength, [&jobSystem]()
+		{
+			std::vector<JobCounter> counters(m_sChainLength);
+
+			jobSystem.Schedule([]() {}, &counters[0]);
+			for (uint32_t i{ 1 }; i < m_sChainLength; ++i)
+			{
+				jobSystem.Schedule([]() {}, &counters[i], counters[i - 1]);
+			}
+
+			// The last counter reaches zero after all others
+			jobSystem.Wait(counters.back());
+		});
+}
+
+float DDM3::JobSystemBenchmark::Measure(const char* name, uint32_t operationCount, const std::function<void()>& test) const
+{
+	float minTime{ std::numeric_limits<float>::max() };
+	float totalTime{};
+
+	for (uint32_t i{}; i < m_sRepetitions; ++i)
+	{
+		// Run the test once and measure how long it took in milliseconds
+		auto start{ std::chrono::high_resolution_clock::now() };
+		test();
+		float time{ std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count() };
+
+		minTime = std::min(minTime, time);
+		totalTime += time;
+	}
+
+	// Print the fastest and average time, and the fastest time per operation in nanoseconds
+	std::cout << "    " << name << ": " << minTime << " ms (average " << totalTime / m_sRepetitions << " ms, "
+		<< minTime * 1'000'000.0f / static_cast<float>(operationCount) << " ns per operation)\n";
+
+	return minTime;
+}
@@ -0,0 +1,59 @@
+// JobSystemBenchmark.h
+// This class measures the overhead of the job system: scheduling empty jobs, jobs that schedule jobs, parallel for and dependency chains
+// Every test is repeated a few times and the fastest and average time are printed to the console
+
+#ifndef JobSystemBenchmarkIncluded
+#define JobSystemBenchmarkIncluded
+
+// Standard library includes
+#include <cstdint>
+#include <functional>
+
+namespace DDM3
+{
+	class JobSystemBenchmark final
+	{
+	public:
+		// Default constructor
+		JobSystemBenchmark() = default;
+
+		// Default destructor
+		~JobSystemBenchmark() = default;
+
+		// Delete copy and move functions
+		JobSystemBenchmark(JobSystemBenchmark& other) = delete;
+		JobSystemBenchmark(JobSystemBenchmark&& other) = delete;
+		JobSystemBenchmark& operator=(JobSystemBenchmark& other) = delete;
+		JobSystemBenchmark& operator=(JobSystemBenchmark&& other) = delete;
+
+		// Run every test and print the results
+		void Run();
+
+	private:
+		// The amount of times every test is repeated
+		static constexpr uint32_t m_sRepetitions{ 10 };
+
+		// The amount of empty jobs scheduled from the calling thread
+		static constexpr uint32_t m_sEmptyJobCount{ 100'000 };
+
+		// The amount of jobs that each schedule m_sChildJobCount jobs from a worker
+		static constexpr uint32_t m_sParentJobCount{ 64 };
+		static constexpr uint32_t m_sChildJobCount{ 1024 };
+
+		// The amount of elements of the parallel for
+		static constexpr uint32_t m_sElementCount{ 1 << 22 };
+
+		// The amount of jobs in the dependency chain
+		static constexpr uint32_t m_sChainLength{ 1000 };
+
+		// Run a test a few times and print the fastest and average time
+		// Parameters:
+		//     name: the name of the test
+		//     operationCount: the amount of jobs or elements in the test, used to print the time per operation
+		//     test: the function that runs the test once
+		// Returns the fastest time in milliseconds
+		float Measure(const char* name, uint32_t operationCount, const std::function<void()>& test) const;
+	};
+}
+
+#endif // !JobSystemBenchmarkIncluded
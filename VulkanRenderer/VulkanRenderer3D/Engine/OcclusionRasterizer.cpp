@@ -0,0 +1,287 @@
+// OcclusionRasterizer.cpp
+
+// Header include
+#include "OcclusionRasterizer.h"
+
+// File includes
+#include "Includes/ImGuiIncludes.h"
+
+#include "DataTypes/RenderClasses/Model.h"
+#include "DataTypes/RenderClasses/Mesh.h"
+
+#include "JobSystem.h"
+
+// Standard library includes
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+
+DDM3::OcclusionRasterizer::OcclusionRasterizer(uint32_t width, uint32_t height)
+	:m_Width{ std::max(width, 1u) },
+	m_Height{ std::max(height, 1u) }
+{
+	// Allocate the depth buffer
+	m_DepthBuffer.resize(static_cast<size_t>(m_Width) * m_Height);
+}
+
+void DDM3::OcclusionRasterizer::Render(const std::vector<std::unique_ptr<Model>>& pModels, const glm::mat4& viewProjection)
+{
+	// Get the start time
+	auto start{ std::chrono::high_resolution_clock::now() };
+
+	// Reset the statistics
+	m_Stats = OcclusionStats{};
+
+	// Save the view projection matrix for the tests
+	m_ViewProjection = viewProjection;
+
+	// Clear the depth buffer to the far plane
+	std::fill(m_DepthBuffer.begin(), m_DepthBuffer.end(), 1.0f);
+
+	// Gather the triangles of all occluders
+	m_Triangles.clear();
+	for (auto& pModel : pModels)
+	{
+		if (pModel->IsInitialized() && pModel->IsOccluder())
+		{
+			AddTriangles(pModel.get());
+		}
+	}
+
+	// Only rasterize if there is something to rasterize
+	if (!m_Triangles.empty())
+	{
+		// Every job gets a band of rows so no pixel is written by two jobs, small buffers are rasterized on this thread
+		JobSystem::GetInstance().ParallelFor(m_Height, m_MinRowsPerJob, [this](uint32_t begin, uint32_t end)
+			{
+				RasterizeRows(begin, end);
+			});
+	}
+
+	// Add the time spent rasterizing
+	m_Stats.cpuTime += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+bool DDM3::OcclusionRasterizer::IsOccluded(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& transform)
+{
+	// Get the start time
+	auto start{ std::chrono::high_resolution_clock::now() };
+
+	// Count the test
+	++m_Stats.testedCount;
+
+	// Run the test
+	bool occluded{ [&]()
+		{
+			// Transform from local space to clip space
+			glm::mat4 modelViewProjection{ m_ViewProjection * transform };
+
+			// Initialize the screen bounds
+			glm::vec2 screenMin{ FLT_MAX, FLT_MAX };
+			glm::vec2 screenMax{ -FLT_MAX, -FLT_MAX };
+			float nearestDepth{ FLT_MAX };
+
+			// Project all 8 corners of the bounding box
+			for (int i{}; i < 8; ++i)
+			{
+				// Pick the minimum or maximum for every axis
+				glm::vec3 corner{ (i & 1) ? boundsMax.x : boundsMin.x, (i & 2) ? boundsMax.y : boundsMin.y, (i & 4) ? boundsMax.z : boundsMin.z };
+
+				glm::vec4 clip{ modelViewProjection * glm::vec4(corner, 1.0f) };
+
+				// If a corner is in front of the near plane, the box is treated as visible
+				if (clip.z < 0.0f || clip.w <= FLT_EPSILON)
+					return false;
+
+				// Get normalized device coordinates
+				glm::vec3 ndc{ glm::vec3(clip) / clip.w };
+
+				// Convert to pixels
+				glm::vec2 screen{ (ndc.x * 0.5f + 0.5f) * m_Width, (ndc.y * 0.5f + 0.5f) * m_Height };
+
+				screenMin = glm::min(screenMin, screen);
+				screenMax = glm::max(screenMax, screen);
+				nearestDepth = std::min(nearestDepth, ndc.z);
+			}
+
+			// Boxes outside of the screen are left to the rasterizer of the GPU
+			if (screenMax.x < 0.0f || screenMin.x > m_Width || screenMax.y < 0.0f || screenMin.y > m_Height)
+				return false;
+
+			// Get the pixels covered by the box
+			int minX{ std::clamp(static_cast<int>(std::floor(screenMin.x)), 0, static_cast<int>(m_Width) - 1) };
+			int maxX{ std::clamp(static_cast<int>(std::floor(screenMax.x)), 0, static_cast<int>(m_Width) - 1) };
+			int minY{ std::clamp(static_cast<int>(std::floor(screenMin.y)), 0, static_cast<int>(m_Height) - 1) };
+			int maxY{ std::clamp(static_cast<int>(std::floor(screenMax.y)), 0, static_cast<int>(m_Height) - 1) };
+
+			// If any covered pixel is farther away than the box, the box can be seen trough it
+			for (int y{ minY }; y <= maxY; ++y)
+			{
+				const float* pRow{ m_DepthBuffer.data() + static_cast<size_t>(y) * m_Width };
+
+				for (int x{ minX }; x <= maxX; ++x)
+				{
+					if (pRow[x] >= nearestDepth)
+						return false;
+				}
+			}
+
+			// Every covered pixel has an occluder in front of the box
+			return true;
+		}() };
+
+	// Count occluded models
+	if (occluded)
+	{
+		++m_Stats.occludedCount;
+	}
+
+	// Add the time spent testing
+	m_Stats.cpuTime += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	return occluded;
+}
+
+void DDM3::OcclusionRasterizer::RenderStats() const
+{
+	// Add the software occlusion counters to the stats window
+	ImGui::Begin("Stats");
+	ImGui::Text("Software occlusion tested: %u", m_Stats.testedCount);
+	ImGui::Text("Software occlusion culled: %u", m_Stats.occludedCount);
+	ImGui::Text("Software occlusion time: %.3f ms", m_Stats.cpuTime);
+	ImGui::End();
+}
+
+void DDM3::OcclusionRasterizer::AddTriangles(Model* pModel)
+{
+	// Get the mesh of the model
+	auto& pMesh{ pModel->GetMesh() };
+	const auto& vertices{ pMesh->GetVertices() };
+	const auto& indices{ pMesh->GetIndices() };
+
+	// Transform from local space to clip space
+	glm::mat4 modelViewProjection{ m_ViewProjection * pModel->GetTransform() };
+
+	// Convert a clip space position on the visible side of the near plane to screen space
+	auto toScreen = [this](const glm::vec4& clip)
+		{
+			return glm::vec3{ (clip.x / clip.w * 0.5f + 0.5f) * m_Width, (clip.y / clip.w * 0.5f + 0.5f) * m_Height, clip.z / clip.w };
+		};
+
+	for (size_t i{}; i + 2 < indices.size(); i += 3)
+	{
+		// Transform the corners to clip space
+		std::array<glm::vec4, 3> corners{
+			modelViewProjection * glm::vec4(vertices[indices[i]].pos, 1.0f),
+			modelViewProjection * glm::vec4(vertices[indices[i + 1]].pos, 1.0f),
+			modelViewProjection * glm::vec4(vertices[indices[i + 2]].pos, 1.0f) };
+
+		// Clip the triangle against the near plane, a triangle becomes a polygon with at most 4 corners
+		std::array<glm::vec4, 4> polygon{};
+		size_t cornerCount{};
+
+		for (size_t current{}; current < corners.size(); ++current)
+		{
+			const auto& a{ corners[current] };
+			const auto& b{ corners[(current + 1) % corners.size()] };
+
+			// Keep corners on the visible side of the near plane
+			if (a.z >= 0.0f)
+			{
+				polygon[cornerCount++] = a;
+			}
+
+			// If the edge crosses the near plane, add the intersection
+			if ((a.z >= 0.0f) != (b.z >= 0.0f))
+			{
+				float t{ a.z / (a.z - b.z) };
+				polygon[cornerCount++] = a + (b - a) * t;
+			}
+		}
+
+		// Add the polygon as a fan of triangles
+		for (size_t corner{ 2 }; corner < cornerCount; ++corner)
+		{
+			m_Triangles.push_back(ScreenTriangle{ toScreen(polygon[0]), toScreen(polygon[corner - 1]), toScreen(polygon[corner]) });
+		}
+	}
+}
+
+void DDM3::OcclusionRasterizer::RasterizeRows(uint32_t beginRow, uint32_t endRow)
+{
+	// Edge function, positive if p lies to the left of the edge from a to b
+	auto edge = [](const glm::vec3& a, const glm::vec3& b, float px, float py)
+		{
+			return (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+		};
+
+	for (const auto& triangle : m_Triangles)
+	{
+		// Occluders are rasterized from both sides, so flip clockwise triangles
+		glm::vec3 v0{ triangle.v0 };
+		glm::vec3 v1{ triangle.v1 };
+		glm::vec3 v2{ triangle.v2 };
+
+		float area{ edge(v0, v1, v2.x, v2.y) };
+		if (area < 0.0f)
+		{
+			std::swap(v1, v2);
+			area = -area;
+		}
+
+		// Skip degenerate triangles
+		if (area <= FLT_EPSILON)
+			continue;
+
+		// Get the pixels covered by the triangle within the rows of this job
+		int minX{ std::max(static_cast<int>(std::floor(std::min({ v0.x, v1.x, v2.x }))), 0) };
+		int maxX{ std::min(static_cast<int>(std::ceil(std::max({ v0.x, v1.x, v2.x }))), static_cast<int>(m_Width) - 1) };
+		int minY{ std::max(static_cast<int>(std::floor(std::min({ v0.y, v1.y, v2.y }))), static_cast<int>(beginRow)) };
+		int maxY{ std::min(static_cast<int>(std::ceil(std::max({ v0.y, v1.y, v2.y }))), static_cast<int>(endRow) - 1) };
+
+		if (minX > maxX || minY > maxY)
+			continue;
+
+		// Divide the depths by the area once, so the weights don't have to be normalized per pixel
+		const float invArea{ 1.0f / area };
+		const float z0{ v0.z * invArea };
+		const float z1{ v1.z * invArea };
+		const float z2{ v2.z * invArea };
+
+		// Change of the edge functions per pixel in x
+		const float step0{ -(v2.y - v1.y) };
+		const float step1{ -(v0.y - v2.y) };
+		const float step2{ -(v1.y - v0.y) };
+
+		for (int y{ minY }; y <= maxY; ++y)
+		{
+			// Sample at the center of the pixel
+			const float py{ y + 0.5f };
+			const float px{ minX + 0.5f };
+
+			// Edge functions at the first pixel of the row
+			const float rowW0{ edge(v1, v2, px, py) };
+			const float rowW1{ edge(v2, v0, px, py) };
+			const float rowW2{ edge(v0, v1, px, py) };
+
+			float* pRow{ m_DepthBuffer.data() + static_cast<size_t>(y) * m_Width };
+
+			// The loop has no branches or dependencies between pixels, so the compiler can vectorize it
+			for (int x{ minX }; x <= maxX; ++x)
+			{
+				const float offset{ static_cast<float>(x - minX) };
+				const float w0{ rowW0 + step0 * offset };
+				const float w1{ rowW1 + step1 * offset };
+				const float w2{ rowW2 + step2 * offset };
+
+				// Interpolate the depth and keep the nearest value for covered pixels, the bitwise and keeps the loop free of branches
+				const bool inside{ static_cast<bool>((w0 >= 0.0f) & (w1 >= 0.0f) & (w2 >= 0.0f)) };
+				const float depth{ w0 * z0 + w1 * z1 + w2 * z2 };
+
+				pRow[x] = inside ? std::min(pRow[x], depth) : pRow[x];
+			}
+		}
+	}
+}
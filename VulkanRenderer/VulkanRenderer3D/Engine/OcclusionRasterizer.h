@@ -0,0 +1,105 @@
+// OcclusionRasterizer.h
+// This class rasterizes the depth of occluder models into a small depth buffer on the CPU
+// Bounding boxes of other models are tested against it in the same frame, so unlike the Hi-Z renderer there is no latency
+
+#ifndef OcclusionRasterizerIncluded
+#define OcclusionRasterizerIncluded
+
+// File includes
+#include "Includes/GLMIncludes.h"
+#include "DataTypes/Structs.h"
+
+// Standard library includes
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace DDM3
+{
+	// Class forward declarations
+	class Model;
+
+	class OcclusionRasterizer final
+	{
+	public:
+		// Constructor
+		// Parameters:
+		//     width: the width of the depth buffer
+		//     height: the height of the depth buffer
+		OcclusionRasterizer(uint32_t width, uint32_t height);
+
+		// Delete default constructor
+		OcclusionRasterizer() = delete;
+
+		// Default destructor
+		~OcclusionRasterizer() = default;
+
+		// Delete copy and move functions
+		OcclusionRasterizer(OcclusionRasterizer& other) = delete;
+		OcclusionRasterizer(OcclusionRasterizer&& other) = delete;
+		OcclusionRasterizer& operator=(OcclusionRasterizer& other) = delete;
+		OcclusionRasterizer& operator=(OcclusionRasterizer&& other) = delete;
+
+		// Clear the depth buffer and rasterize all occluder models into it
+		// Parameters:
+		//     pModels: all models, only initialized occluders are rasterized
+		//     viewProjection: the view projection matrix of the current camera
+		void Render(const std::vector<std::unique_ptr<Model>>& pModels, const glm::mat4& viewProjection);
+
+		// Test if a bounding box is hidden behind the occluders
+		// Returns false if the bounding box crosses the near plane
+		// Parameters:
+		//     boundsMin: minimum corner of the bounding box in local space
+		//     boundsMax: maximum corner of the bounding box in local space
+		//     transform: the model matrix
+		bool IsOccluded(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& transform);
+
+		// Get the occlusion statistics of the current frame
+		const OcclusionStats& GetStats() const { return m_Stats; }
+
+		// Show the occlusion statistics in the stats window
+		void RenderStats() const;
+
+	private:
+		// Triangle in screen space, x and y in pixels and z as depth
+		struct ScreenTriangle
+		{
+			glm::vec3 v0{};
+			glm::vec3 v1{};
+			glm::vec3 v2{};
+		};
+
+		// Width of the depth buffer
+		const uint32_t m_Width{};
+		// Height of the depth buffer
+		const uint32_t m_Height{};
+
+		// The depth buffer, stores the nearest depth per pixel
+		std::vector<float> m_DepthBuffer{};
+
+		// The occluder triangles of the current frame
+		std::vector<ScreenTriangle> m_Triangles{};
+
+		// The view projection matrix of the current frame
+		glm::mat4 m_ViewProjection{};
+
+		// The minimum amount of rows per job
+		const uint32_t m_MinRowsPerJob{ 16 };
+
+		// Occlusion statistics of the current frame
+		OcclusionStats m_Stats{};
+
+		// Transform the triangles of an occluder to screen space and add them to the triangle list
+		// Parameters:
+		//     pModel: the occluder model
+		void AddTriangles(Model* pModel);
+
+		// Rasterize all triangles into a range of rows, rows are never shared between threads
+		// Parameters:
+		//     beginRow: the first row of the range
+		//     endRow: the row after the last row of the range
+		void RasterizeRows(uint32_t beginRow, uint32_t endRow);
+	};
+}
+
+#endif // !OcclusionRasterizerIncluded
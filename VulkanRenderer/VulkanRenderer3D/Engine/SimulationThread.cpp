@@ -0,0 +1,185 @@
+// SimulationThread.cpp
+
+// Header include
+#include "SimulationThread.h"
+
+// File includes
+#include "TimeManager.h"
+#include "TransformManager.h"
+#include "BenchmarkManager.h"
+#include "CPUProfiler.h"
+
+#include "DataTypes/Camera.h"
+
+#include "Vulkan/Vulkan3D.h"
+#include "Vulkan/Managers/ModelManager.h"
+
+// Standard library includes
+#include <chrono>
+
+DDM3::SimulationThread::SimulationThread(Camera* pCamera, BenchmarkManager* pBenchmark, bool useInput)
+	:m_pCamera{ pCamera },
+	m_pBenchmark{ pBenchmark },
+	m_UseInput{ useInput }
+{
+	// Start simulating the first frame
+	m_Thread = std::thread{ &SimulationThread::Run, this };
+}
+
+DDM3::SimulationThread::~SimulationThread()
+{
+	// Tell the simulation to stop, it might be waiting for a packet
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		m_Running = false;
+	}
+	m_Condition.notify_all();
+
+	// Wait until the current frame is finished
+	if (m_Thread.joinable())
+	{
+		m_Thread.join();
+	}
+}
+
+void DDM3::SimulationThread::SetInput(const InputState& input)
+{
+	std::lock_guard<std::mutex> lock{ m_Mutex };
+	m_Input = input;
+}
+
+const DDM3::FramePacket& DDM3::SimulationThread::BeginRender()
+{
+	DDM3_PROFILE_SCOPE("Wait for simulation");
+
+	// Wait until the next packet is simulated
+	std::unique_lock<std::mutex> lock{ m_Mutex };
+	m_Condition.wait(lock, [this]() { return m_PacketReady[m_ReadIndex] || m_pException != nullptr; });
+
+	// If the simulation failed, throw its exception on this thread
+	if (m_pException != nullptr)
+	{
+		std::rethrow_exception(m_pException);
+	}
+
+	return m_Packets[m_ReadIndex];
+}
+
+void DDM3::SimulationThread::EndRender()
+{
+	// The packet can be written again, the next frame is in the other packet
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		m_PacketReady[m_ReadIndex] = false;
+		m_ReadIndex = (m_ReadIndex + 1) % m_sPacketCount;
+	}
+	m_Condition.notify_all();
+}
+
+void DDM3::SimulationThread::Run()
+{
+	// Name the thread in the CPU traces
+	DDM3_PROFILE_THREAD("Simulation");
+
+	// Get current time for later use
+	auto lastTime = std::chrono::high_resolution_clock::now();
+
+	try
+	{
+		while (true)
+		{
+			// The packet and the input of this frame
+			uint32_t packetIndex{};
+			InputState input{};
+
+			// Wait until the render thread finished the packet that is written next
+			{
+				DDM3_PROFILE_SCOPE("Wait for render");
+
+				std::unique_lock<std::mutex> lock{ m_Mutex };
+				m_Condition.wait(lock, [this]() { return !m_Running || !m_PacketReady[m_WriteIndex]; });
+
+				if (!m_Running)
+					return;
+
+				packetIndex = m_WriteIndex;
+				input = m_Input;
+			}
+
+			// Calculate how long the previous simulated frame lasted in seconds
+			const auto frameStart = std::chrono::high_resolution_clock::now();
+			float deltaTime{ std::chrono::duration<float>(frameStart - lastTime).count() };
+			lastTime = frameStart;
+
+			// Write the frame to the packet, the render thread doesn't read it until it is marked as ready
+			Simulate(m_Packets[packetIndex], input, deltaTime);
+
+			// Hand the packet to the render thread
+			{
+				std::lock_guard<std::mutex> lock{ m_Mutex };
+				m_PacketReady[packetIndex] = true;
+				m_WriteIndex = (m_WriteIndex + 1) % m_sPacketCount;
+			}
+			m_Condition.notify_all();
+		}
+	}
+	catch (...)
+	{
+		// Store the exception so the render thread can throw it
+		{
+			std::lock_guard<std::mutex> lock{ m_Mutex };
+			m_pException = std::current_exception();
+			m_Running = false;
+		}
+		m_Condition.notify_all();
+	}
+}
+
+void DDM3::SimulationThread::Simulate(FramePacket& packet, const InputState& input, float deltaTime)
+{
+	DDM3_PROFILE_SCOPE("Simulate");
+
+	// Set current deltaTime in the timeManager, a benchmark always simulates the same timestep
+	TimeManager::GetInstance().SetDeltaTime(m_pBenchmark != nullptr ? m_pBenchmark->GetTimestep() : deltaTime);
+
+	// Move the camera along the benchmark path or with the input
+	if (m_pBenchmark != nullptr)
+	{
+		m_pBenchmark->UpdateCamera(m_pCamera);
+	}
+	else if (m_UseInput)
+	{
+		m_pCamera->Update(input);
+	}
+
+	// Get the model manager
+	auto pModelManager{ Vulkan3D::GetInstance().GetModelManager() };
+
+	// Create the transforms of the models that were queued since the previous frame, they are part of this packet
+	pModelManager->AddQueuedModels(m_SimulatedFrameCount);
+
+	// Update all models
+	pModelManager->Update();
+
+	// Get the transform manager
+	auto& transformManager{ TransformManager::GetInstance() };
+
+	// Build the world matrices of all changed transforms
+	{
+		DDM3_PROFILE_SCOPE("Update world matrices");
+		transformManager.UpdateWorldMatrices();
+	}
+
+	// Copy everything the render thread needs into the packet
+	{
+		DDM3_PROFILE_SCOPE("Fill frame packet");
+
+		packet.frame = m_SimulatedFrameCount++;
+		packet.camera = m_pCamera->GetState();
+
+		transformManager.CopyWorldMatrices(packet.worldMatrices, packet.transformsChanged);
+		packet.anyTransformChanged = transformManager.HasChanged();
+
+		packet.light = Vulkan3D::GetInstance().GetRenderer().GetGlobalLightStruct();
+	}
+}
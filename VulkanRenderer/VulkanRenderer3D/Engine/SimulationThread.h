@@ -0,0 +1,115 @@
+// SimulationThread.h
+// This class runs the simulation on its own thread: the camera, the models and the world matrices
+// Every simulated frame is written to one of two frame packets while the render thread renders the other one
+// This way the simulation of frame N+1 overlaps the recording and submitting of frame N
+
+#ifndef SimulationThreadIncluded
+#define SimulationThreadIncluded
+
+// File includes
+#include "FramePacket.h"
+#include "Window.h"
+
+// Standard library includes
+#include <array>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace DDM3
+{
+	// Class forward declarations
+	class Camera;
+	class BenchmarkManager;
+
+	class SimulationThread final
+	{
+	public:
+		// Constructor, starts the thread
+		// Parameters:
+		//     pCamera: the camera that is moved every frame
+		//     pBenchmark: the benchmark that moves the camera along its path, nullptr if no benchmark runs
+		//     useInput: indicates if the camera is moved with the input, false in headless mode
+		SimulationThread(Camera* pCamera, BenchmarkManager* pBenchmark, bool useInput);
+
+		// Destructor, stops the thread and waits until it finished
+		~SimulationThread();
+
+		// Delete copy and move functions
+		SimulationThread(SimulationThread& other) = delete;
+		SimulationThread(SimulationThread&& other) = delete;
+		SimulationThread& operator=(SimulationThread& other) = delete;
+		SimulationThread& operator=(SimulationThread&& other) = delete;
+
+		// Store the input the next simulated frame uses, must be called on the main thread
+		// Parameters:
+		//     input: the state of the keyboard and mouse
+		void SetInput(const InputState& input);
+
+		// Wait until the next frame is simulated and get its packet, the packet doesn't change until EndRender is called
+		// If the simulation threw an exception, it is thrown again on the calling thread
+		const FramePacket& BeginRender();
+
+		// Give the packet back, so the simulation can write the frame after the next one in it
+		void EndRender();
+
+	private:
+		// The amount of frame packets
+		static constexpr uint32_t m_sPacketCount{ 2 };
+
+		// The frame packets
+		std::array<FramePacket, m_sPacketCount> m_Packets{};
+
+		// Indicates for every packet if it holds a simulated frame that wasn't rendered yet
+		std::array<bool, m_sPacketCount> m_PacketReady{};
+
+		// The index of the packet the simulation writes next
+		uint32_t m_WriteIndex{};
+
+		// The index of the packet the render thread reads next
+		uint32_t m_ReadIndex{};
+
+		// Protects the packet states, the input and the running flag
+		std::mutex m_Mutex{};
+
+		// Wakes the threads when a packet is simulated or rendered
+		std::condition_variable m_Condition{};
+
+		// Indicates if the simulation should keep running
+		bool m_Running{ true };
+
+		// The exception thrown by the simulation, rethrown on the render thread
+		std::exception_ptr m_pException{};
+
+		// The input for the next simulated frame
+		InputState m_Input{};
+
+		// The camera that is moved every frame
+		Camera* m_pCamera{};
+
+		// The benchmark that moves the camera, nullptr if no benchmark runs
+		BenchmarkManager* m_pBenchmark{};
+
+		// Indicates if the camera is moved with the input
+		bool m_UseInput{};
+
+		// The amount of simulated frames
+		uint64_t m_SimulatedFrameCount{};
+
+		// The thread, started last so every other member is initialized
+		std::thread m_Thread{};
+
+		// The loop of the simulation thread
+		void Run();
+
+		// Simulate a single frame and write it to a packet
+		// Parameters:
+		//     packet: the packet the frame is written to
+		//     input: the state of the keyboard and mouse
+		//     deltaTime: the time since the previous simulated frame in seconds
+		void Simulate(FramePacket& packet, const InputState& input, float deltaTime);
+	};
+}
+
+#endif // !SimulationThreadIncluded
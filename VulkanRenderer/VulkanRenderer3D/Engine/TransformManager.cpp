@@ -0,0 +1,301 @@
+// TransformManager.cpp
+
+// Header include
+#include "TransformManager.h"
+
+// File includes
+#include "JobSystem.h"
+
+// Standard library includes
+#include <algorithm>
+#include <stdexcept>
+
+uint32_t DDM3::TransformManager::AddTransform()
+{
+	// Initialize the id
+	uint32_t id{};
+
+	// If there is a removed transform, reuse its id
+	if (!m_FreeIds.empty())
+	{
+		id = m_FreeIds.back();
+		m_FreeIds.pop_back();
+	}
+	// Otherwise add a new transform at the end of the arrays
+	else
+	{
+		id = static_cast<uint32_t>(m_Positions.size());
+
+		m_Positions.emplace_back();
+		m_Rotations.emplace_back();
+		m_Scales.emplace_back();
+		m_LocalMatrices.emplace_back();
+		m_WorldMatrices.emplace_back();
+		m_Parents.emplace_back();
+		m_Children.emplace_back();
+		m_Alive.emplace_back(uint8_t{ 0 });
+		m_Dirty.emplace_back(uint8_t{ 0 });
+	}
+
+	// Reset the transform
+	m_Positions[id] = glm::vec3{ 0, 0, 0 };
+	m_Rotations[id] = glm::vec3{ 0, 0, 0 };
+	m_Scales[id] = glm::vec3{ 1, 1, 1 };
+	m_LocalMatrices[id] = glm::mat4{ 1.0f };
+	m_WorldMatrices[id] = glm::mat4{ 1.0f };
+	m_Parents[id] = m_sInvalidId;
+	m_Children[id].clear();
+	m_Alive[id] = 1;
+
+	// The identity matrix is already correct, the transform doesn't have to be rebuilt
+	if (m_Dirty[id])
+	{
+		m_Dirty[id] = 0;
+		--m_DirtyCount;
+	}
+
+	// The new transform has to be added to the update order
+	m_HierarchyChanged = true;
+
+	// Return the id
+	return id;
+}
+
+void DDM3::TransformManager::RemoveTransform(uint32_t id)
+{
+	// Detach from the parent
+	RemoveParent(id);
+
+	// Detach all children, they will be relative to the world from now on
+	for (auto childId : m_Children[id])
+	{
+		m_Parents[childId] = m_sInvalidId;
+		SetDirty(childId);
+	}
+	m_Children[id].clear();
+
+	// Mark the transform as unused
+	m_Alive[id] = 0;
+	m_HierarchyChanged = true;
+
+	// Make the id available for new transforms
+	m_FreeIds.push_back(id);
+}
+
+void DDM3::TransformManager::SetParent(uint32_t id, uint32_t parentId)
+{
+	// Walk up the ancestors of the new parent, if the transform is one of them the hierarchy would contain a cycle
+	for (auto ancestorId{ parentId }; ancestorId != m_sInvalidId; ancestorId = m_Parents[ancestorId])
+	{
+		if (ancestorId == id)
+		{
+			throw std::runtime_error("failed to set parent, a transform can't be parented to itself or one of its descendants!");
+		}
+	}
+
+	// Detach from the current parent
+	RemoveParent(id);
+
+	// Set the new parent
+	m_Parents[id] = parentId;
+	// Add the transform to the children of the parent
+	m_Children[parentId].push_back(id);
+
+	// The update order and the world matrix have to be rebuilt
+	m_HierarchyChanged = true;
+	SetDirty(id);
+}
+
+void DDM3::TransformManager::RemoveParent(uint32_t id)
+{
+	// Get the id of the parent
+	auto parentId{ m_Parents[id] };
+
+	// If there is no parent, there is nothing to do
+	if (parentId == m_sInvalidId)
+		return;
+
+	// Remove the transform from the children of the parent
+	auto& children{ m_Children[parentId] };
+	children.erase(std::remove(children.begin(), children.end(), id), children.end());
+
+	// Remove the parent
+	m_Parents[id] = m_sInvalidId;
+
+	// The update order and the world matrix have to be rebuilt
+	m_HierarchyChanged = true;
+	SetDirty(id);
+}
+
+void DDM3::TransformManager::SetPosition(uint32_t id, const glm::vec3& position)
+{
+	// Set new position
+	m_Positions[id] = position;
+	// Set dirty flag
+	SetDirty(id);
+}
+
+void DDM3::TransformManager::SetRotation(uint32_t id, const glm::vec3& rotation)
+{
+	// Set new rotation
+	m_Rotations[id] = rotation;
+	// Set dirty flag
+	SetDirty(id);
+}
+
+void DDM3::TransformManager::SetScale(uint32_t id, const glm::vec3& scale)
+{
+	// Set new scale
+	m_Scales[id] = scale;
+	// Set dirty flag
+	SetDirty(id);
+}
+
+void DDM3::TransformManager::UpdateWorldMatrices()
+{
+	// Remember if anything changed this update
+	m_Changed = m_DirtyCount != 0;
+
+	// If nothing changed, there is nothing to do
+	if (!m_Changed)
+		return;
+
+	// If transforms were added, removed or reparented, sort them again
+	if (m_HierarchyChanged)
+	{
+		RebuildUpdateOrder();
+	}
+
+	// Get the amount of transforms
+	auto transformCount{ static_cast<uint32_t>(m_Positions.size()) };
+
+	// If there is too little work, update the local matrices on this thread
+	if (m_DirtyCount < 2 * m_MinTransformsPerJob)
+	{
+		UpdateLocalMatrices(0, transformCount);
+	}
+	else
+	{
+		// Split the transforms over the job system, the ranges are large enough that scanning the clean transforms is cheap
+		JobSystem::GetInstance().ParallelFor(transformCount, m_MinTransformsPerJob, [this](uint32_t begin, uint32_t end)
+			{
+				UpdateLocalMatrices(begin, end);
+			});
+	}
+
+	// Build the world matrices breadth first, parents are always finished before their children
+	for (auto id : m_UpdateOrder)
+	{
+		// Get the id of the parent
+		auto parentId{ m_Parents[id] };
+
+		// If the transform has a parent that changed, the transform changed as well
+		if (parentId != m_sInvalidId && m_Dirty[parentId])
+		{
+			m_Dirty[id] = 1;
+		}
+
+		// Skip transforms that didn't change
+		if (!m_Dirty[id])
+			continue;
+
+		// Root transforms are relative to the world, others are relative to their parent
+		if (parentId == m_sInvalidId)
+		{
+			m_WorldMatrices[id] = m_LocalMatrices[id];
+		}
+		else
+		{
+			m_WorldMatrices[id] = m_WorldMatrices[parentId] * m_LocalMatrices[id];
+		}
+	}
+
+	// Keep the flags so other systems can check which transforms changed
+	m_Updated = m_Dirty;
+
+	// All transforms are up to date
+	std::fill(m_Dirty.begin(), m_Dirty.end(), uint8_t{ 0 });
+	m_DirtyCount = 0;
+}
+
+void DDM3::TransformManager::CopyWorldMatrices(std::vector<glm::mat4>& worldMatrices, std::vector<uint8_t>& changed) const
+{
+	// Copy the world matrices
+	worldMatrices.assign(m_WorldMatrices.begin(), m_WorldMatrices.end());
+
+	// Copy the flags of the last update, transforms added after it didn't change
+	if (m_Changed)
+	{
+		changed.assign(m_Updated.begin(), m_Updated.end());
+		changed.resize(m_WorldMatrices.size(), uint8_t{ 0 });
+	}
+	else
+	{
+		changed.assign(m_WorldMatrices.size(), uint8_t{ 0 });
+	}
+}
+
+void DDM3::TransformManager::SetDirty(uint32_t id)
+{
+	// If the transform wasn't dirty yet, count it
+	if (!m_Dirty[id])
+	{
+		m_Dirty[id] = 1;
+		++m_DirtyCount;
+	}
+}
+
+void DDM3::TransformManager::UpdateLocalMatrices(uint32_t begin, uint32_t end)
+{
+	// Get pointers to the arrays so the loop only works on contiguous memory
+	const glm::vec3* pPositions{ m_Positions.data() };
+	const glm::vec3* pRotations{ m_Rotations.data() };
+	const glm::vec3* pScales{ m_Scales.data() };
+	glm::mat4* pLocalMatrices{ m_LocalMatrices.data() };
+	const uint8_t* pDirty{ m_Dirty.data() };
+
+	for (uint32_t i{ begin }; i < end; ++i)
+	{
+		// Skip transforms that didn't change
+		if (!pDirty[i])
+			continue;
+
+		// Get the rotation matrix from the euler angles
+		const glm::mat3 rotation{ glm::mat3_cast(glm::quat(pRotations[i])) };
+
+		// Get the scale
+		const glm::vec3& scale{ pScales[i] };
+
+		// Build translation * rotation * scale directly, scaling the rotation columns and adding the position as the last column
+		glm::mat4& local{ pLocalMatrices[i] };
+		local[0] = glm::vec4(rotation[0] * scale.x, 0.0f);
+		local[1] = glm::vec4(rotation[1] * scale.y, 0.0f);
+		local[2] = glm::vec4(rotation[2] * scale.z, 0.0f);
+		local[3] = glm::vec4(pPositions[i], 1.0f);
+	}
+}
+
+void DDM3::TransformManager::RebuildUpdateOrder()
+{
+	// Clear the current order
+	m_UpdateOrder.clear();
+
+	// Add all root transforms first
+	for (uint32_t id{}; id < static_cast<uint32_t>(m_Parents.size()); ++id)
+	{
+		if (m_Alive[id] && m_Parents[id] == m_sInvalidId)
+		{
+			m_UpdateOrder.push_back(id);
+		}
+	}
+
+	// Walk trough the order and append the children of every transform, the vector is used as the queue of the breadth first search
+	for (size_t i{}; i < m_UpdateOrder.size(); ++i)
+	{
+		auto& children{ m_Children[m_UpdateOrder[i]] };
+		m_UpdateOrder.insert(m_UpdateOrder.end(), children.begin(), children.end());
+	}
+
+	// The order is up to date
+	m_HierarchyChanged = false;
+}
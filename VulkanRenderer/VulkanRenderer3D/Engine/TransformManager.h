@@ -0,0 +1,170 @@
+// TransformManager.h
+// This singleton will store the position, rotation and scale of every object in separate arrays
+// Transforms can have a parent, the position, rotation and scale are then relative to the parent
+// World matrices are only rebuilt for transforms that changed and their children, all at once before the frame is recorded
+
+#ifndef TransformManagerIncluded
+#define TransformManagerIncluded
+
+// Parent class include
+#include "Singleton.h"
+
+// File includes
+#include "Includes/GLMIncludes.h"
+
+// Standard library includes
+#include <vector>
+#include <cstdint>
+
+namespace DDM3
+{
+	class TransformManager final : public Singleton<TransformManager>
+	{
+	public:
+		// Add a transform with position 0, no rotation and scale 1
+		// Returns the id of the new transform
+		uint32_t AddTransform();
+
+		// Remove a transform, the id can be reused by a new transform afterwards
+		// The children of the transform lose their parent
+		// Parameters:
+		//     id: the id of the transform
+		void RemoveTransform(uint32_t id);
+
+		// Set the parent, the position, rotation and scale will be relative to the parent
+		// Throws if the parent is the transform itself or one of its descendants
+		// Parameters:
+		//     id: the id of the transform
+		//     parentId: the id of the parent transform
+		void SetParent(uint32_t id, uint32_t parentId);
+
+		// Remove the parent, the position, rotation and scale will be relative to the world
+		// Parameters:
+		//     id: the id of the transform
+		void RemoveParent(uint32_t id);
+
+		// Set the position
+		// Parameters:
+		//     id: the id of the transform
+		//     position: the new position
+		void SetPosition(uint32_t id, const glm::vec3& position);
+
+		// Set the rotation
+		// Parameters:
+		//     id: the id of the transform
+		//     rotation: the new rotation as euler angles in radians
+		void SetRotation(uint32_t id, const glm::vec3& rotation);
+
+		// Set the scale
+		// Parameters:
+		//     id: the id of the transform
+		//     scale: the new scale
+		void SetScale(uint32_t id, const glm::vec3& scale);
+
+		// Check if a transform has a parent
+		// Parameters:
+		//     id: the id of the transform
+		bool HasParent(uint32_t id) const { return m_Parents[id] != m_sInvalidId; }
+
+		// Get the position relative to the parent
+		// Parameters:
+		//     id: the id of the transform
+		const glm::vec3& GetPosition(uint32_t id) const { return m_Positions[id]; }
+
+		// Get the rotation relative to the parent as euler angles in radians
+		// Parameters:
+		//     id: the id of the transform
+		const glm::vec3& GetRotation(uint32_t id) const { return m_Rotations[id]; }
+
+		// Get the scale relative to the parent
+		// Parameters:
+		//     id: the id of the transform
+		const glm::vec3& GetScale(uint32_t id) const { return m_Scales[id]; }
+
+		// Get the world matrix, only up to date after UpdateWorldMatrices has been called
+		// Parameters:
+		//     id: the id of the transform
+		const glm::mat4& GetWorldMatrix(uint32_t id) const { return m_WorldMatrices[id]; }
+
+		// Rebuild the world matrices of all transforms that changed and their children
+		// Local matrices are built first, large amounts are split over the job system
+		// World matrices are then built breadth first so parents are always done before their children
+		void UpdateWorldMatrices();
+
+		// Check if any world matrix changed in the last call to UpdateWorldMatrices
+		bool HasChanged() const { return m_Changed; }
+
+		// Check if the world matrix of a transform changed in the last call to UpdateWorldMatrices
+		// Parameters:
+		//     id: the id of the transform
+		bool HasChanged(uint32_t id) const { return m_Changed && id < m_Updated.size() && m_Updated[id]; }
+
+		// Copy the world matrices and the flags of the last call to UpdateWorldMatrices, used to fill the frame packet
+		// The vectors keep their memory, so copying every frame doesn't allocate
+		// Parameters:
+		//     worldMatrices: the vector the world matrices are copied to
+		//     changed: the vector the changed flags are copied to, one per transform
+		void CopyWorldMatrices(std::vector<glm::mat4>& worldMatrices, std::vector<uint8_t>& changed) const;
+
+	private:
+		// Id used for transforms without a parent
+		static constexpr uint32_t m_sInvalidId{ UINT32_MAX };
+
+		// Positions
+		std::vector<glm::vec3> m_Positions{};
+		// Rotations as euler angles
+		std::vector<glm::vec3> m_Rotations{};
+		// Scales
+		std::vector<glm::vec3> m_Scales{};
+		// Matrices relative to the parent
+		std::vector<glm::mat4> m_LocalMatrices{};
+		// World matrices
+		std::vector<glm::mat4> m_WorldMatrices{};
+
+		// Parent ids, m_sInvalidId if the transform has no parent
+		std::vector<uint32_t> m_Parents{};
+		// Child ids
+		std::vector<std::vector<uint32_t>> m_Children{};
+		// Flags indicating if a transform is in use
+		std::vector<uint8_t> m_Alive{};
+
+		// Dirty flags, a byte per transform so threads never write to the same element
+		std::vector<uint8_t> m_Dirty{};
+
+		// Ids of all transforms in use, sorted breadth first so every parent comes before its children
+		std::vector<uint32_t> m_UpdateOrder{};
+		// Indicates if the update order has to be rebuilt
+		bool m_HierarchyChanged{ false };
+
+		// Ids of removed transforms that can be reused
+		std::vector<uint32_t> m_FreeIds{};
+
+		// Amount of transforms that changed since the last update
+		uint32_t m_DirtyCount{};
+
+		// Indicates if any world matrix changed in the last update
+		bool m_Changed{ true };
+
+		// The dirty flags of the last update, including children of changed parents
+		std::vector<uint8_t> m_Updated{};
+
+		// The minimum amount of transforms per job
+		const uint32_t m_MinTransformsPerJob{ 1024 };
+
+		// Mark a transform as changed
+		// Parameters:
+		//     id: the id of the transform
+		void SetDirty(uint32_t id);
+
+		// Rebuild the local matrices of the changed transforms in a range
+		// Parameters:
+		//     begin: the first id of the range
+		//     end: the id after the last id of the range
+		void UpdateLocalMatrices(uint32_t begin, uint32_t end);
+
+		// Sort the ids of all transforms in use breadth first
+		void RebuildUpdateOrder();
+	};
+}
+
+#endif // !TransformManagerIncluded
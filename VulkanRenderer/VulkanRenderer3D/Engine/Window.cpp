@@ -6,6 +6,8 @@
 // File includes
 #include "ConfigManager.h"
 
+#include "Includes/ImGuiIncludes.h"
+
 // Static library includes
 #include <functional>
 
@@ -35,6 +37,29 @@ void DDM3::Window::SetFrameBufferResized(bool value)
 	m_Window.FrameBufferResized = value;
 }
 
+DDM3::InputState DDM3::Window::GetInputState() const
+{
+	InputState input{};
+
+	// Read the movement keys
+	input.forward = glfwGetKey(m_Window.pWindow, GLFW_KEY_W) == GLFW_PRESS;
+	input.backward = glfwGetKey(m_Window.pWindow, GLFW_KEY_S) == GLFW_PRESS;
+	input.left = glfwGetKey(m_Window.pWindow, GLFW_KEY_A) == GLFW_PRESS;
+	input.right = glfwGetKey(m_Window.pWindow, GLFW_KEY_D) == GLFW_PRESS;
+	input.sprint = glfwGetKey(m_Window.pWindow, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS;
+
+	// The camera only rotates if the mouse isn't used by an ImGui window
+	input.rotate = glfwGetMouseButton(m_Window.pWindow, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS &&
+		!ImGui::IsAnyItemActive() &&
+		!ImGui::IsAnyItemHovered() &&
+		!ImGui::IsWindowHovered(ImGuiHoveredFlags_AnyWindow);
+
+	// Read the cursor position
+	glfwGetCursorPos(m_Window.pWindow, &input.cursorX, &input.cursorY);
+
+	return input;
+}
+
 void DDM3::Window::InitWindow()
 {
 	// Initialize glfw
@@ -26,6 +26,25 @@ namespace DDM3
 		bool FrameBufferResized = false;
 	};
 
+	// The state of the keyboard and mouse at the start of a frame
+	// GLFW and ImGui may only be used on the main thread, so the input is copied for the simulation thread
+	struct InputState
+	{
+		// Movement keys
+		bool forward{};
+		bool backward{};
+		bool left{};
+		bool right{};
+		bool sprint{};
+
+		// Indicates if the left mouse button is pressed outside of the ImGui windows
+		bool rotate{};
+
+		// Position of the cursor
+		double cursorX{};
+		double cursorY{};
+	};
+
 	class Window : public Singleton<Window>
 	{
 	public:
@@ -41,6 +60,9 @@ namespace DDM3
 		// Set the FrameBufferResized variable
 		void SetFrameBufferResized(bool value);
 
+		// Read the current state of the keyboard and mouse, must be called on the main thread
+		InputState GetInputState() const;
+
 	private:
 
 		// Function that will initialize the glfw window
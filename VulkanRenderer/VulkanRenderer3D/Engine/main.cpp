@@ -17,20 +17,38 @@ void SetupPipelines()
 {
 	auto& renderer{ DDM3::Vulkan3D::GetInstance().GetRenderer() };
 
-	renderer.AddGraphicsPipeline("Diffuse", { "Resources/Shaders/Diffuse.Vert.spv", "Resources/Shaders/Diffuse.Frag.spv" });
-	renderer.AddGraphicsPipeline("NormalMap", { "Resources/Shaders/NormalMap.Vert.spv", "Resources/Shaders/NormalMap.Frag.spv" });
-	renderer.AddGraphicsPipeline("DiffNorm", { "Resources/Shaders/DiffNorm.Vert.spv", "Resources/Shaders/DiffNorm.Frag.spv" });
+	// All pipelines are created at once on worker threads, a pipeline is only waited on when a material first uses it
+	renderer.AddGraphicsPipelines({
+		{ "Diffuse", { "Resources/Shaders/Diffuse.Vert.spv", "Resources/Shaders/Diffuse.Frag.spv" } },
+		{ "NormalMap", { "Resources/Shaders/NormalMap.Vert.spv", "Resources/Shaders/NormalMap.Frag.spv" } },
+		{ "DiffNorm", { "Resources/Shaders/DiffNorm.Vert.spv", "Resources/Shaders/DiffNorm.Frag.spv" } },
 
-	renderer.AddGraphicsPipeline("Test", { "Resources/Shaders/Test.Vert.spv", "Resources/Shaders/Test.Frag.spv" });
+		{ "Test", { "Resources/Shaders/Test.Vert.spv", "Resources/Shaders/Test.Frag.spv" } },
 
-	renderer.AddGraphicsPipeline("DiffuseUnshaded", { "Resources/Shaders/DiffuseUnshaded.Vert.spv", "Resources/Shaders/DiffuseUnshaded.Frag.spv" });
+		{ "DiffuseUnshaded", { "Resources/Shaders/DiffuseUnshaded.Vert.spv", "Resources/Shaders/DiffuseUnshaded.Frag.spv" } },
 
-	renderer.AddGraphicsPipeline("Specular", { "Resources/Shaders/Specular.Vert.spv", "Resources/Shaders/Specular.Frag.spv" });
+		{ "Specular", { "Resources/Shaders/Specular.Vert.spv", "Resources/Shaders/Specular.Frag.spv" } },
 
-	renderer.AddGraphicsPipeline("DiffNormSpec", { "Resources/Shaders/DiffNormSpec.Vert.spv", "Resources/Shaders/DiffNormSpec.Frag.spv" });
+		{ "DiffNormSpec", { "Resources/Shaders/DiffNormSpec.Vert.spv", "Resources/Shaders/DiffNormSpec.Frag.spv" } },
 
 
-	renderer.AddGraphicsPipeline("DiffuseShadow", { "Resources/Shaders/DiffuseShadow.Vert.spv", "Resources/Shaders/DiffuseShadow.Frag.spv" });
+		{ "DiffuseShadow", { "Resources/Shaders/DiffuseShadow.Vert.spv", "Resources/Shaders/DiffuseShadow.Frag.spv" } },
+
+		// Instanced variants, materials using the pipeline without the "Instanced" suffix will be batched automatically
+		{ "DiffuseInstanced", { "Resources/Shaders/DiffuseInstanced.Vert.spv", "Resources/Shaders/Diffuse.Frag.spv" } },
+		{ "NormalMapInstanced", { "Resources/Shaders/NormalMapInstanced.Vert.spv", "Resources/Shaders/NormalMap.Frag.spv" } },
+		{ "DiffNormInstanced", { "Resources/Shaders/DiffNormInstanced.Vert.spv", "Resources/Shaders/DiffNorm.Frag.spv" } },
+		{ "TestInstanced", { "Resources/Shaders/TestInstanced.Vert.spv", "Resources/Shaders/Test.Frag.spv" } },
+		{ "DiffuseUnshadedInstanced", { "Resources/Shaders/DiffuseUnshadedInstanced.Vert.spv", "Resources/Shaders/DiffuseUnshaded.Frag.spv" } },
+		{ "SpecularInstanced", { "Resources/Shaders/SpecularInstanced.Vert.spv", "Resources/Shaders/Specular.Frag.spv" } },
+		{ "DiffNormSpecInstanced", { "Resources/Shaders/DiffNormSpecInstanced.Vert.spv", "Resources/Shaders/DiffNormSpec.Frag.spv" } },
+		{ "DiffuseShadowInstanced", { "Resources/Shaders/DiffuseShadowInstanced.Vert.spv", "Resources/Shaders/DiffuseShadow.Frag.spv" } },
+
+		// Bindless variants, only created when bindless descriptors are enabled in the config and supported by the GPU
+		{ "DiffuseBindless", { "Resources/Shaders/Bindless.Vert.spv", "Resources/Shaders/DiffuseBindless.Frag.spv" }, true, true },
+		{ "DiffNormBindless", { "Resources/Shaders/Bindless.Vert.spv", "Resources/Shaders/DiffNormBindless.Frag.spv" }, true, true },
+		{ "DiffuseUnshadedBindless", { "Resources/Shaders/Bindless.Vert.spv", "Resources/Shaders/DiffuseUnshadedBindless.Frag.spv" }, true, true },
+		{ "DiffNormSpecBindless", { "Resources/Shaders/Bindless.Vert.spv", "Resources/Shaders/DiffNormSpecBindless.Frag.spv" }, true, true } });
 }
 
 void load()
@@ -45,6 +63,8 @@ void load()
 	std::shared_ptr<DDM3::TexturedMaterial> pVikingMaterial{ std::make_shared<DDM3::TexturedMaterial>(std::initializer_list<const std::string>{"resources/images/viking_room.png"}, "Diffuse") };
 	std::shared_ptr<DDM3::TexturedMaterial> pVehicleMaterial{ std::make_shared<DDM3::TexturedMaterial>(std::initializer_list<const std::string>{"resources/images/vehicle_diffuse.png"}, "Diffuse") };
 	std::shared_ptr<DDM3::TexturedMaterial> pFireMaterial{ std::make_shared<DDM3::TexturedMaterial>(std::initializer_list<const std::string>{"resources/images/fireFX_diffuse.png"}, "DiffuseUnshaded") };
+	// The fire texture is cut out in the fragment shader, so it can't use the depth of the pre-pass
+	pFireMaterial->SetAlphaTested(true);
 
 	std::shared_ptr<DDM3::Material> pVehicle2Material{ std::make_shared<DDM3::TexturedMaterial>
 		(std::initializer_list<const std::string>{"resources/images/vehicle_diffuse.png", "resources/images/vehicle_normal.png"}, "DiffNorm") };
@@ -70,6 +90,8 @@ void load()
 	pCurrModel->LoadModel("Resources/Models/Plane.obj");
 	pCurrModel->SetMaterial(pGroundPlaneMaterial2);
 	pCurrModel->SetRotate(false);
+	// The ground plane hides everything below it
+	pCurrModel->SetOccluder(true);
 	pModelManager->AddModel(std::move(pCurrModel));
 
 
@@ -84,6 +106,9 @@ void load()
 	pCurrModel->SetRotation(0.f, glm::radians(75.0f), 0.f);
 	pCurrModel->SetScale(0.25f, 0.25f, 0.25f);
 
+	// Keep a pointer to the vehicle so the fire vfx can be attached to it
+	auto pVehicle{ pCurrModel.get() };
+
 	pModelManager->AddModel(std::move(pCurrModel));
 
 
@@ -93,9 +118,9 @@ void load()
 	pCurrModel->LoadModel("Resources/Models/fireFX.obj");
 	pCurrModel->SetCastsShadow(false);
 	pCurrModel->SetMaterial(pFireMaterial);
-	pCurrModel->SetPosition(0.f, 5, 0.f);
-	pCurrModel->SetRotation(0.f, glm::radians(75.0f), 0.f);
-	pCurrModel->SetScale(0.25f, 0.25f, 0.25f);
+	// Attach to the vehicle, the fire follows its position, rotation and scale
+	pCurrModel->SetParent(pVehicle);
+	pCurrModel->SetRotate(false);
 
 	pModelManager->AddModel(std::move(pCurrModel));
 
@@ -4,4 +4,8 @@
 #define STB_IMAGE_IMPLEMENTATION
 #endif
 
+#ifndef STB_IMAGE_WRITE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#endif
+
 #include "STBIncludes.h"
\ No newline at end of file
@@ -203,3 +203,9 @@ glm::quat Utils::RotationFromDirection(const glm::vec3&& direction)
 {
 	return RotationFromDirection(direction);
 }
+
+size_t Utils::HashCombine(size_t seed, size_t value)
+{
+	// Mix the new value into the seed, the shifts make the result depend on the order of the values
+	return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
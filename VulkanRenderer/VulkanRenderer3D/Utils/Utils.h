@@ -41,6 +41,12 @@ namespace Utils
 	glm::quat RotationFromDirection(const glm::vec3& direction);
 
 	glm::quat RotationFromDirection(const glm::vec3&& direction);
+
+	// Combine a hash with the hash of another value
+	// Parameters:
+	//     - seed: The hash so far
+	//     - value: The hash of the value to add
+	size_t HashCombine(size_t seed, size_t value);
 }
 
 #endif // !UtilsIncluded
\ No newline at end of file
@@ -0,0 +1,336 @@
+// BindlessManager.cpp
+
+// Header include
+#include "BindlessManager.h"
+
+// File includes
+#include "Vulkan/Vulkan3D.h"
+
+#include "DataTypes/DirectionalLightObject.h"
+#include "DataTypes/DescriptorObjects/ObjectDescriptorObject.h"
+
+// Standard library includes
+#include <stdexcept>
+#include <array>
+
+DDM3::BindlessManager::BindlessManager(VkDevice device, uint32_t maxTextures)
+	:m_MaxTextures{ maxTextures }
+{
+	// Create the camera buffers
+	m_pCameraDescriptorObject = std::make_unique<UboDescriptorObject<UniformBufferObject>>();
+	// Create the object buffers
+	m_pObjectDescriptorObject = std::make_unique<ObjectDescriptorObject>();
+
+	// Resize the retired texture indices to the amount of frames
+	m_RetiredTextureIndices.resize(Vulkan3D::GetMaxFrames());
+
+	// Create the descriptor set layout
+	CreateDescriptorSetLayout(device);
+	// Create the descriptor pool
+	CreateDescriptorPool(device);
+	// Allocate the descriptorsets
+	CreateDescriptorSets(device);
+	// Write the buffers to the descriptorsets
+	UpdateDescriptorSets();
+}
+
+DDM3::BindlessManager::~BindlessManager()
+{
+	// Clean up allocated objects
+	Cleanup(Vulkan3D::GetInstance().GetDevice());
+}
+
+void DDM3::BindlessManager::Cleanup(VkDevice device)
+{
+	// Destroy the descriptor pool, this also frees the descriptorsets
+	vkDestroyDescriptorPool(device, m_DescriptorPool, nullptr);
+	// Destroy the descriptor set layout
+	vkDestroyDescriptorSetLayout(device, m_DescriptorSetLayout, nullptr);
+}
+
+uint32_t DDM3::BindlessManager::AddTexture(VkImageView imageView)
+{
+	// Initialize index
+	uint32_t index{};
+
+	// Reuse a free index if there is one
+	if (!m_FreeTextureIndices.empty())
+	{
+		index = m_FreeTextureIndices.back();
+		m_FreeTextureIndices.pop_back();
+	}
+	// Otherwise hand out a new index
+	else if (m_TextureCount < m_MaxTextures)
+	{
+		index = m_TextureCount++;
+	}
+	else
+	{
+		// If the texture array is full, throw runtime error
+		throw std::runtime_error("bindless texture array is full!");
+	}
+
+	// Create image info
+	VkDescriptorImageInfo imageInfo{};
+	// Set layout to shader read only optimal
+	imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	// Give the image view
+	imageInfo.imageView = imageView;
+	// Give the default sampler
+	imageInfo.sampler = Vulkan3D::GetInstance().GetRenderer().GetSampler();
+
+	// Create a descriptor write for every frame
+	std::vector<VkWriteDescriptorSet> descriptorWrites(m_DescriptorSets.size());
+
+	for (size_t i{}; i < descriptorWrites.size(); ++i)
+	{
+		// Set type to write descriptor set
+		descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		// Set the binding of the texture array
+		descriptorWrites[i].dstBinding = m_sTextureBinding;
+		// Set the index in the texture array
+		descriptorWrites[i].dstArrayElement = index;
+		// Set descriptor type
+		descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		// Set descriptor amount
+		descriptorWrites[i].descriptorCount = 1;
+		// Give the image info
+		descriptorWrites[i].pImageInfo = &imageInfo;
+		// Give the correct descriptorset
+		descriptorWrites[i].dstSet = m_DescriptorSets[i];
+	}
+
+	// Update the descriptorsets, the texture array is update after bind so this is allowed while the sets are in use
+	vkUpdateDescriptorSets(Vulkan3D::GetInstance().GetDevice(), static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+
+	return index;
+}
+
+void DDM3::BindlessManager::RemoveTexture(uint32_t index)
+{
+	// Retire the index, frames in flight might still sample the texture
+	m_RetiredTextureIndices[Vulkan3D::GetCurrentFrame()].push_back(index);
+}
+
+void DDM3::BindlessManager::BeginFrame(uint32_t objectCount)
+{
+	// Get index of current frame
+	auto frame{ Vulkan3D::GetCurrentFrame() };
+
+	// The previous use of this frame is finished, so the indices retired during it can be reused
+	auto& retiredIndices{ m_RetiredTextureIndices[frame] };
+	m_FreeTextureIndices.insert(m_FreeTextureIndices.end(), retiredIndices.begin(), retiredIndices.end());
+	retiredIndices.clear();
+
+	// Make sure all objects fit, if the buffers had to grow, update the descriptorsets
+	if (m_pObjectDescriptorObject->Reserve(objectCount))
+	{
+		UpdateDescriptorSets();
+	}
+
+	// Get the view and projection matrix from the camera
+	UniformBufferObject ubo{};
+	Vulkan3D::GetInstance().GetFramePacket().camera.UpdateUniformBuffer(ubo);
+
+	// Update the camera buffer
+	m_pCameraDescriptorObject->UpdateUboBuffer(ubo, frame);
+
+	// Reset the amount of objects
+	m_ObjectCount = 0;
+}
+
+uint32_t DDM3::BindlessManager::AddObject(const glm::mat4& transform, const glm::ivec4& textureIndices)
+{
+	// Create the object data
+	ObjectData objectData{};
+	objectData.model = transform;
+	objectData.textureIndices = textureIndices;
+
+	// Write the object data to the buffer of the current frame
+	m_pObjectDescriptorObject->SetObject(m_ObjectCount, objectData, Vulkan3D::GetCurrentFrame());
+
+	// Return the index of the object and increase the object count
+	return m_ObjectCount++;
+}
+
+void DDM3::BindlessManager::BindDescriptorSet(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout)
+{
+	// Bind the descriptorset of the current frame
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &m_DescriptorSets[Vulkan3D::GetCurrentFrame()], 0, nullptr);
+}
+
+void DDM3::BindlessManager::CreateDescriptorSetLayout(VkDevice device)
+{
+	// Create the bindings
+	std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+
+	// Camera uniform buffer
+	bindings[0].binding = 0;
+	bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	bindings[0].descriptorCount = 1;
+	bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+	// Global light uniform buffer
+	bindings[1].binding = 1;
+	bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	bindings[1].descriptorCount = 1;
+	bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	// Object storage buffer
+	bindings[2].binding = 2;
+	bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	bindings[2].descriptorCount = 1;
+	bindings[2].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+	// Texture array
+	bindings[m_sTextureBinding].binding = m_sTextureBinding;
+	bindings[m_sTextureBinding].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	bindings[m_sTextureBinding].descriptorCount = m_MaxTextures;
+	bindings[m_sTextureBinding].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	// Create the binding flags, only the texture array is partially bound, update after bind and variable sized
+	std::array<VkDescriptorBindingFlags, 4> bindingFlags{};
+	bindingFlags[m_sTextureBinding] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+		| VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT | VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT;
+
+	// Create binding flags create info
+	VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+	// Set type to descriptor set layout binding flags create info
+	bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+	// Set binding count to the amount of bindings
+	bindingFlagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+	// Give the binding flags
+	bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+	// Create layout info
+	VkDescriptorSetLayoutCreateInfo layoutInfo{};
+	// Set type to descriptor set layout create info
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	// Chain the binding flags
+	layoutInfo.pNext = &bindingFlagsInfo;
+	// Sets with this layout must be allocated from an update after bind pool
+	layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+	// Set bindingcount to the amount of bindings
+	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+	// Set bindings to the data of bindings array
+	layoutInfo.pBindings = bindings.data();
+
+	// Create descriptorset layout
+	if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_DescriptorSetLayout) != VK_SUCCESS)
+	{
+		// If not successfull, throw runtime error
+		throw std::runtime_error("failed to create bindless descriptor set layout!");
+	}
+}
+
+void DDM3::BindlessManager::CreateDescriptorPool(VkDevice device)
+{
+	// Get amount of frames
+	auto frames{ Vulkan3D::GetMaxFrames() };
+
+	// Create the pool sizes
+	std::array<VkDescriptorPoolSize, 3> poolSizes{};
+
+	// Camera and light uniform buffers
+	poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	poolSizes[0].descriptorCount = 2 * frames;
+
+	// Object storage buffer
+	poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	poolSizes[1].descriptorCount = frames;
+
+	// Texture array
+	poolSizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	poolSizes[2].descriptorCount = m_MaxTextures * frames;
+
+	// Create pool info
+	VkDescriptorPoolCreateInfo poolInfo{};
+	// Set type to descriptor pool create info
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	// Allow sets allocated from this pool to be updated after they are bound
+	poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+	// Set pool size count
+	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+	// Give the pool sizes
+	poolInfo.pPoolSizes = poolSizes.data();
+	// Set max sets to the amount of frames
+	poolInfo.maxSets = frames;
+
+	// Create the descriptor pool
+	if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_DescriptorPool) != VK_SUCCESS)
+	{
+		// If unsuccessful, throw runtime error
+		throw std::runtime_error("failed to create bindless descriptor pool!");
+	}
+}
+
+void DDM3::BindlessManager::CreateDescriptorSets(VkDevice device)
+{
+	// Get amount of frames
+	auto frames{ Vulkan3D::GetMaxFrames() };
+
+	// Create a vector of layouts, one per frame
+	std::vector<VkDescriptorSetLayout> layouts(frames, m_DescriptorSetLayout);
+
+	// Create a vector of texture array sizes, one per frame
+	std::vector<uint32_t> textureCounts(frames, m_MaxTextures);
+
+	// Create variable descriptor count allocate info
+	VkDescriptorSetVariableDescriptorCountAllocateInfo variableCountInfo{};
+	// Set type to variable descriptor count allocate info
+	variableCountInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
+	// Set descriptorset count to the amount of frames
+	variableCountInfo.descriptorSetCount = frames;
+	// Give the sizes of the texture arrays
+	variableCountInfo.pDescriptorCounts = textureCounts.data();
+
+	// Create allocate info
+	VkDescriptorSetAllocateInfo allocInfo{};
+	// Set type to descriptor set allocate info
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	// Chain the variable descriptor count allocate info
+	allocInfo.pNext = &variableCountInfo;
+	// Give the descriptor pool
+	allocInfo.descriptorPool = m_DescriptorPool;
+	// Set descriptorset count to the amount of frames
+	allocInfo.descriptorSetCount = frames;
+	// Give the layouts
+	allocInfo.pSetLayouts = layouts.data();
+
+	// Resize descriptorsets to the amount of frames
+	m_DescriptorSets.resize(frames);
+
+	// Allocate the descriptorsets
+	if (vkAllocateDescriptorSets(device, &allocInfo, m_DescriptorSets.data()) != VK_SUCCESS)
+	{
+		// If unsuccessful, throw runtime error
+		throw std::runtime_error("failed to allocate bindless descriptor sets!");
+	}
+}
+
+void DDM3::BindlessManager::UpdateDescriptorSets()
+{
+	// Create the list of buffer descriptor objects in the same order as the shader code
+	std::vector<DescriptorObject*> descriptorObjects{ m_pCameraDescriptorObject.get(),
+		Vulkan3D::GetInstance().GetRenderer().GetGlobalLight()->GetDescriptorObject(),
+		m_pObjectDescriptorObject.get() };
+
+	// Loop trough the descriptorsets
+	for (size_t i{}; i < m_DescriptorSets.size(); ++i)
+	{
+		// Create vector of descriptor writes
+		std::vector<VkWriteDescriptorSet> descriptorWrites{};
+
+		// Initialize binding
+		int binding{};
+
+		// Add the descriptor writes of every descriptor object
+		for (auto& descriptorObject : descriptorObjects)
+		{
+			descriptorObject->AddDescriptorWrite(m_DescriptorSets[i], descriptorWrites, binding, static_cast<int>(i));
+		}
+
+		// Update the descriptorset
+		vkUpdateDescriptorSets(Vulkan3D::GetInstance().GetDevice(), static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+	}
+}
@@ -0,0 +1,135 @@
+// BindlessManager.h
+// This class will hold and manage the global descriptorset used when rendering with bindless descriptors
+// The descriptorset holds the camera, the global light, a storage buffer with the data of every object and one large texture array
+// Materials reference their textures by index in the texture array, so no descriptorsets are needed per model
+
+#ifndef BindlessManagerIncluded
+#define BindlessManagerIncluded
+
+// File includes
+#include "Includes/VulkanIncludes.h"
+#include "Includes/GLMIncludes.h"
+#include "DataTypes/Structs.h"
+#include "DataTypes/DescriptorObjects/UboDescriptorObject.h"
+
+// Standard library includes
+#include <vector>
+#include <memory>
+
+namespace DDM3
+{
+	// Class forward declarations
+	class ObjectDescriptorObject;
+
+	class BindlessManager final
+	{
+	public:
+		// Delete default constructor
+		BindlessManager() = delete;
+
+		// Constructor
+		// Parameters:
+		//     device: handle of the VkDevice
+		//     maxTextures: the size of the bindless texture array
+		BindlessManager(VkDevice device, uint32_t maxTextures);
+
+		// Destructor
+		~BindlessManager();
+
+		// Delete copy and move functions
+		BindlessManager(BindlessManager& other) = delete;
+		BindlessManager(BindlessManager&& other) = delete;
+		BindlessManager& operator=(BindlessManager& other) = delete;
+		BindlessManager& operator=(BindlessManager&& other) = delete;
+
+		// Get the handle of the descriptor set layout shared by all bindless pipelines
+		VkDescriptorSetLayout GetDescriptorSetLayout() const { return m_DescriptorSetLayout; }
+
+		// Add a texture to the texture array and return its index
+		// Parameters:
+		//     imageView: the image view of the texture
+		uint32_t AddTexture(VkImageView imageView);
+
+		// Remove a texture from the texture array
+		// The index will only be reused once the frames currently in flight are finished
+		// Parameters:
+		//     index: the index of the texture in the texture array
+		void RemoveTexture(uint32_t index);
+
+		// Prepare the buffers of the current frame, must be called before any objects are added
+		// Parameters:
+		//     objectCount: the amount of objects that will be added this frame
+		void BeginFrame(uint32_t objectCount);
+
+		// Add the data of an object to the object buffer of the current frame and return its index
+		// Parameters:
+		//     transform: the model matrix of the object
+		//     textureIndices: the indices of the textures of the object in the texture array
+		uint32_t AddObject(const glm::mat4& transform, const glm::ivec4& textureIndices);
+
+		// Bind the descriptorset of the current frame
+		// Parameters:
+		//     commandBuffer: the commandbuffer used in this renderpass
+		//     pipelineLayout: the layout of the currently bound bindless pipeline
+		void BindDescriptorSet(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout);
+
+	private:
+		// The binding of the texture array in the shaders
+		static constexpr uint32_t m_sTextureBinding{ 3 };
+
+		// The size of the texture array
+		uint32_t m_MaxTextures{};
+
+		// Descriptor set layout
+		VkDescriptorSetLayout m_DescriptorSetLayout{};
+
+		// Descriptor pool
+		VkDescriptorPool m_DescriptorPool{};
+
+		// Vector of descriptorsets, one per frame
+		std::vector<VkDescriptorSet> m_DescriptorSets{};
+
+		// The uniform buffers holding the view and projection matrix of the camera
+		std::unique_ptr<UboDescriptorObject<UniformBufferObject>> m_pCameraDescriptorObject{};
+
+		// The storage buffers holding the object data
+		std::unique_ptr<ObjectDescriptorObject> m_pObjectDescriptorObject{};
+
+		// The amount of objects added in the current frame
+		uint32_t m_ObjectCount{};
+
+		// The amount of texture indices that have been handed out
+		uint32_t m_TextureCount{};
+
+		// Texture indices that can be reused
+		std::vector<uint32_t> m_FreeTextureIndices{};
+
+		// Texture indices removed during each frame, they are freed once that frame is rendered again
+		std::vector<std::vector<uint32_t>> m_RetiredTextureIndices{};
+
+		// Clean up all allocated objects
+		// Parameters:
+		//     device: handle of the VkDevice
+		void Cleanup(VkDevice device);
+
+		// Create the descriptor set layout
+		// Parameters:
+		//     device: handle of the VkDevice
+		void CreateDescriptorSetLayout(VkDevice device);
+
+		// Create the descriptor pool
+		// Parameters:
+		//     device: handle of the VkDevice
+		void CreateDescriptorPool(VkDevice device);
+
+		// Allocate the descriptorsets
+		// Parameters:
+		//     device: handle of the VkDevice
+		void CreateDescriptorSets(VkDevice device);
+
+		// Write the buffers to the descriptorsets
+		void UpdateDescriptorSets();
+	};
+}
+
+#endif // !BindlessManagerIncluded
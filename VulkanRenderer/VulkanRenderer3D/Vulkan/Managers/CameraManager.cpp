@@ -6,6 +6,8 @@
 // File includes
 #include "DataTypes/Camera.h"
 
+#include "Vulkan/Vulkan3D.h"
+
 DDM3::CameraManager::CameraManager()
 {
 	m_pDefaultCamera = std::make_unique<Camera>();
@@ -40,7 +42,7 @@ void DDM3::CameraManager::SetSkybox(std::unique_ptr<SkyBox> pSkybox)
 
 void DDM3::CameraManager::RenderSkybox()
 {
-	if (m_pSkyBox != nullptr && GetCamera()->GetCameraType() == CameraType::Perspective)
+	if (m_pSkyBox != nullptr && Vulkan3D::GetInstance().GetFramePacket().camera.type == CameraType::Perspective)
 	{
 		m_pSkyBox->Render();
 	}
@@ -6,19 +6,27 @@
 #include "Vulkan/Wrappers/InstanceWrapper.h"
 #include "Vulkan/Wrappers/SurfaceWrapper.h"
 #include "Vulkan/Wrappers/GPUObject.h"
+#include "Vulkan/Vulkan3D.h"
 
 DDM3::DispatchableManager::DispatchableManager()
 {
 	m_pInstanceWrapper = std::make_unique<InstanceWrapper>();
 
-	m_pSurfaceWrapper = std::make_unique<SurfaceWrapper>(m_pInstanceWrapper->GetInstance());
+	// Headless mode has no window to create a surface for
+	if (!Vulkan3D::IsHeadless())
+	{
+		m_pSurfaceWrapper = std::make_unique<SurfaceWrapper>(m_pInstanceWrapper->GetInstance());
+	}
 
-	m_pGPUObject = std::make_unique<GPUObject>(m_pInstanceWrapper.get(), m_pSurfaceWrapper->GetSurface());
+	m_pGPUObject = std::make_unique<GPUObject>(m_pInstanceWrapper.get(), GetSurface());
 }
 
 DDM3::DispatchableManager::~DispatchableManager()
 {
-	m_pSurfaceWrapper->Cleanup(m_pInstanceWrapper->GetInstance());
+	if (m_pSurfaceWrapper != nullptr)
+	{
+		m_pSurfaceWrapper->Cleanup(m_pInstanceWrapper->GetInstance());
+	}
 }
 
 VkInstance DDM3::DispatchableManager::GetInstance() const
@@ -33,7 +41,8 @@ DDM3::InstanceWrapper* DDM3::DispatchableManager::GetInstanceWrapper() const
 
 VkSurfaceKHR DDM3::DispatchableManager::GetSurface() const
 {
-	return m_pSurfaceWrapper->GetSurface();
+	// Without a surface, return null handle
+	return m_pSurfaceWrapper != nullptr ? m_pSurfaceWrapper->GetSurface() : VK_NULL_HANDLE;
 }
 
 VkDevice DDM3::DispatchableManager::GetDevice() const
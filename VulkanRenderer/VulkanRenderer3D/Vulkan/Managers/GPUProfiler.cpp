@@ -0,0 +1,234 @@
+// GPUProfiler.cpp
+
+// Header include
+#include "GPUProfiler.h"
+
+// File includes
+#include "Includes/ImGuiIncludes.h"
+
+#include "Vulkan/Vulkan3D.h"
+#include "Vulkan/Wrappers/GPUObject.h"
+
+// Standard library includes
+#include <array>
+#include <stdexcept>
+
+DDM3::GPUProfiler::ScopedMarker::ScopedMarker(GPUProfiler* pProfiler, VkCommandBuffer commandBuffer, const std::string& name)
+	:m_pProfiler{ pProfiler },
+	m_CommandBuffer{ commandBuffer }
+{
+	// Write the first timestamp
+	if (m_pProfiler != nullptr)
+	{
+		m_Scope = m_pProfiler->BeginScope(m_CommandBuffer, name);
+	}
+}
+
+DDM3::GPUProfiler::ScopedMarker::~ScopedMarker()
+{
+	// Write the last timestamp
+	if (m_pProfiler != nullptr)
+	{
+		m_pProfiler->EndScope(m_CommandBuffer, m_Scope);
+	}
+}
+
+DDM3::GPUProfiler::GPUProfiler(GPUObject* pGPUObject)
+{
+	// Get the physical device properties
+	VkPhysicalDeviceProperties properties{};
+	vkGetPhysicalDeviceProperties(pGPUObject->GetPhysicalDevice(), &properties);
+
+	// Get the amount of frames
+	auto frames{ Vulkan3D::GetMaxFrames() };
+
+	// No scopes were recorded yet
+	m_Scopes.resize(frames);
+	m_StatisticsWritten.assign(frames, false);
+
+	// Without timestamps on the graphics queue no time can be measured
+	if (properties.limits.timestampComputeAndGraphics)
+	{
+		// Remember how long a tick takes
+		m_TimestampPeriod = properties.limits.timestampPeriod;
+
+		// Create query pool create info with a begin and end timestamp per scope per frame
+		VkQueryPoolCreateInfo queryPoolInfo{};
+		queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		queryPoolInfo.queryCount = 2 * m_sMaxScopes * frames;
+
+		// Create the query pool, if unsuccessful, throw runtime error
+		if (vkCreateQueryPool(pGPUObject->GetDevice(), &queryPoolInfo, nullptr, &m_QueryPool) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create profiler query pool!");
+		}
+	}
+
+	// Pipeline statistics are optional
+	if (pGPUObject->IsPipelineStatisticsSupported())
+	{
+		// Create query pool create info with a pipeline statistics query per frame that counts the shader invocations
+		VkQueryPoolCreateInfo queryPoolInfo{};
+		queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+		queryPoolInfo.queryCount = frames;
+		queryPoolInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+			VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+		// Create the query pool, if unsuccessful, throw runtime error
+		if (vkCreateQueryPool(pGPUObject->GetDevice(), &queryPoolInfo, nullptr, &m_StatisticsQueryPool) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create pipeline statistics query pool!");
+		}
+	}
+}
+
+DDM3::GPUProfiler::~GPUProfiler()
+{
+	// Get handle of device
+	auto device{ Vulkan3D::GetInstance().GetDevice() };
+
+	// Destroy the query pools
+	vkDestroyQueryPool(device, m_QueryPool, nullptr);
+	vkDestroyQueryPool(device, m_StatisticsQueryPool, nullptr);
+}
+
+void DDM3::GPUProfiler::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frame)
+{
+	m_CurrentFrame = frame;
+	m_CurrentDepth = 0;
+
+	// The fence of this frame was waited on, so the queries of the last time this frame index was rendered are available
+	ReadResults(frame);
+
+	// Reset the timestamps of this frame
+	if (m_QueryPool != VK_NULL_HANDLE)
+	{
+		vkCmdResetQueryPool(commandBuffer, m_QueryPool, 2 * m_sMaxScopes * frame, 2 * m_sMaxScopes);
+	}
+
+	// Reset the pipeline statistics of this frame and start counting
+	if (m_StatisticsQueryPool != VK_NULL_HANDLE)
+	{
+		vkCmdResetQueryPool(commandBuffer, m_StatisticsQueryPool, frame, 1);
+		vkCmdBeginQuery(commandBuffer, m_StatisticsQueryPool, frame, 0);
+	}
+}
+
+void DDM3::GPUProfiler::EndFrame(VkCommandBuffer commandBuffer)
+{
+	// Stop counting the shader invocations
+	if (m_StatisticsQueryPool != VK_NULL_HANDLE)
+	{
+		vkCmdEndQuery(commandBuffer, m_StatisticsQueryPool, m_CurrentFrame);
+		m_StatisticsWritten[m_CurrentFrame] = true;
+	}
+}
+
+uint32_t DDM3::GPUProfiler::BeginScope(VkCommandBuffer commandBuffer, const std::string& name)
+{
+	// If timestamps aren't supported, the scope isn't measured
+	if (m_QueryPool == VK_NULL_HANDLE)
+		return UINT32_MAX;
+
+	// If all queries of this frame are used, the scope isn't measured
+	auto& scopes{ m_Scopes[m_CurrentFrame] };
+	if (scopes.size() >= m_sMaxScopes)
+		return UINT32_MAX;
+
+	// Add the scope and write its first timestamp
+	uint32_t scope{ static_cast<uint32_t>(scopes.size()) };
+	scopes.emplace_back(name, m_CurrentDepth++);
+
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_QueryPool, 2 * (m_sMaxScopes * m_CurrentFrame + scope));
+
+	return scope;
+}
+
+void DDM3::GPUProfiler::EndScope(VkCommandBuffer commandBuffer, uint32_t scope)
+{
+	// If the scope isn't measured, there is nothing to write
+	if (scope == UINT32_MAX)
+		return;
+
+	// Write the last timestamp once all commands of the scope are finished
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_QueryPool, 2 * (m_sMaxScopes * m_CurrentFrame + scope) + 1);
+	--m_CurrentDepth;
+}
+
+void DDM3::GPUProfiler::RenderStats() const
+{
+	// Show every scope indented by its depth
+	ImGui::Begin("GPU profiler");
+
+	if (m_QueryPool == VK_NULL_HANDLE)
+	{
+		ImGui::Text("Timestamps are not supported by this GPU");
+	}
+
+	for (auto& result : m_Results)
+	{
+		ImGui::Text("%*s%s: %.3f ms", static_cast<int>(2 * result.depth), "", result.name.c_str(), result.smoothedTime);
+	}
+
+	// Show the shader invocations
+	if (m_StatisticsQueryPool != VK_NULL_HANDLE)
+	{
+		ImGui::Separator();
+		ImGui::Text("Vertex invocations: %llu", static_cast<unsigned long long>(m_VertexInvocations));
+		ImGui::Text("Fragment invocations: %llu", static_cast<unsigned long long>(m_FragmentInvocations));
+	}
+
+	ImGui::End();
+}
+
+void DDM3::GPUProfiler::ReadResults(uint32_t frame)
+{
+	// Get handle of device
+	auto device{ Vulkan3D::GetInstance().GetDevice() };
+
+	// Read the timestamps of the scopes
+	auto& scopes{ m_Scopes[frame] };
+	if (!scopes.empty())
+	{
+		std::vector<uint64_t> timestamps(2 * scopes.size());
+		if (vkGetQueryPoolResults(device, m_QueryPool, 2 * m_sMaxScopes * frame, static_cast<uint32_t>(timestamps.size()),
+			timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+		{
+			m_Results.resize(scopes.size());
+			for (size_t i{}; i < scopes.size(); ++i)
+			{
+				auto& result{ m_Results[i] };
+				result.name = scopes[i].first;
+				result.depth = scopes[i].second;
+
+				// Convert the ticks to milliseconds
+				result.time = static_cast<float>(timestamps[2 * i + 1] - timestamps[2 * i]) * m_TimestampPeriod / 1'000'000.0f;
+
+				// Smooth the time so the numbers are readable, a new scope starts at its first time
+				auto [it, isNew] { m_SmoothedTimes.try_emplace(result.name, result.time) };
+				if (!isNew)
+				{
+					it->second += (result.time - it->second) * m_sSmoothing;
+				}
+				result.smoothedTime = it->second;
+			}
+		}
+
+		// The scopes of this frame are recorded again
+		scopes.clear();
+	}
+
+	// Read the shader invocations, the statistics are written in the order of the bits
+	if (m_StatisticsQueryPool != VK_NULL_HANDLE && m_StatisticsWritten[frame])
+	{
+		std::array<uint64_t, 2> statistics{};
+		if (vkGetQueryPoolResults(device, m_StatisticsQueryPool, frame, 1, sizeof(statistics), statistics.data(),
+			sizeof(statistics), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+		{
+			m_VertexInvocations = statistics[0];
+			m_FragmentInvocations = statistics[1];
+		}
+	}
+}
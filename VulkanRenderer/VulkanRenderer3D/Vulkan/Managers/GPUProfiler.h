@@ -0,0 +1,166 @@
+// GPUProfiler.h
+// This class measures how long the GPU spends on named scopes of the commandbuffer with timestamp queries
+// Every frame in flight has its own queries, they are read back the next time the same frame index is recorded so the CPU never waits on the GPU
+// If requested and supported, the vertex and fragment shader invocations of the whole frame are counted with a pipeline statistics query
+
+#ifndef GPUProfilerIncluded
+#define GPUProfilerIncluded
+
+// File includes
+#include "Includes/VulkanIncludes.h"
+
+// Standard library includes
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace DDM3
+{
+	// Class forward declarations
+	class GPUObject;
+
+	class GPUProfiler final
+	{
+	public:
+		// The measured time of a scope
+		struct ScopeResult
+		{
+			// The name of the scope
+			std::string name{};
+			// The amount of scopes this scope is nested in
+			uint32_t depth{};
+			// The GPU time of the scope in milliseconds
+			float time{};
+			// The GPU time of the scope in milliseconds, smoothed over the last frames
+			float smoothedTime{};
+		};
+
+		// Measures a scope from its construction until it goes out of scope
+		class ScopedMarker final
+		{
+		public:
+			// Constructor
+			// Parameters:
+			//     pProfiler: pointer to the GPU profiler, nullptr if the scope isn't measured
+			//     commandBuffer: the current commandbuffer
+			//     name: the name of the scope
+			ScopedMarker(GPUProfiler* pProfiler, VkCommandBuffer commandBuffer, const std::string& name);
+
+			// Delete default constructor
+			ScopedMarker() = delete;
+
+			// Destructor
+			~ScopedMarker();
+
+			// Delete copy and move functions
+			ScopedMarker(ScopedMarker& other) = delete;
+			ScopedMarker(ScopedMarker&& other) = delete;
+			ScopedMarker& operator=(ScopedMarker& other) = delete;
+			ScopedMarker& operator=(ScopedMarker&& other) = delete;
+
+		private:
+			// Pointer to the GPU profiler
+			GPUProfiler* m_pProfiler{};
+
+			// The commandbuffer the scope is recorded in
+			VkCommandBuffer m_CommandBuffer{ VK_NULL_HANDLE };
+
+			// The index of the scope
+			uint32_t m_Scope{ UINT32_MAX };
+		};
+
+		// Constructor
+		// Parameters:
+		//     pGPUObject: pointer to the GPU object
+		GPUProfiler(GPUObject* pGPUObject);
+
+		// Delete default constructor
+		GPUProfiler() = delete;
+
+		// Destructor
+		~GPUProfiler();
+
+		// Delete copy and move functions
+		GPUProfiler(GPUProfiler& other) = delete;
+		GPUProfiler(GPUProfiler&& other) = delete;
+		GPUProfiler& operator=(GPUProfiler& other) = delete;
+		GPUProfiler& operator=(GPUProfiler&& other) = delete;
+
+		// Read the results of the last time this frame index was recorded, reset its queries and start counting the shader invocations
+		// Must be called at the start of the commandbuffer, outside of a renderpass, after the in flight fence of the frame was waited on
+		// Parameters:
+		//     commandBuffer: the current commandbuffer
+		//     frame: the index of the current frame
+		void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frame);
+
+		// Stop counting the shader invocations
+		// Must be called at the end of the commandbuffer, outside of a renderpass
+		// Parameters:
+		//     commandBuffer: the current commandbuffer
+		void EndFrame(VkCommandBuffer commandBuffer);
+
+		// Write the timestamp at the start of a scope, scopes can be nested
+		// Returns the index of the scope, UINT32_MAX if it isn't measured
+		// Parameters:
+		//     commandBuffer: the current commandbuffer
+		//     name: the name of the scope
+		uint32_t BeginScope(VkCommandBuffer commandBuffer, const std::string& name);
+
+		// Write the timestamp at the end of a scope
+		// Parameters:
+		//     commandBuffer: the current commandbuffer
+		//     scope: the index returned by BeginScope
+		void EndScope(VkCommandBuffer commandBuffer, uint32_t scope);
+
+		// Get the times of the scopes of the last frame that was read back, in the order the scopes began
+		const std::vector<ScopeResult>& GetResults() const { return m_Results; }
+
+		// Show the smoothed times of the scopes and the shader invocations in the GPU profiler window
+		void RenderStats() const;
+
+	private:
+		// The maximum amount of scopes in a single frame
+		static constexpr uint32_t m_sMaxScopes{ 64 };
+
+		// The weight of a new time in the smoothed time
+		static constexpr float m_sSmoothing{ 0.05f };
+
+		// The query pool with a begin and end timestamp per scope per frame
+		VkQueryPool m_QueryPool{ VK_NULL_HANDLE };
+
+		// The query pool with a pipeline statistics query per frame, VK_NULL_HANDLE if they aren't used
+		VkQueryPool m_StatisticsQueryPool{ VK_NULL_HANDLE };
+
+		// The amount of nanoseconds per timestamp tick
+		float m_TimestampPeriod{};
+
+		// The names and depths of the scopes that were recorded per frame
+		std::vector<std::vector<std::pair<std::string, uint32_t>>> m_Scopes{};
+
+		// Indicates if the pipeline statistics query of a frame was written
+		std::vector<bool> m_StatisticsWritten{};
+
+		// The index of the frame that is being recorded
+		uint32_t m_CurrentFrame{};
+
+		// The amount of scopes that are open
+		uint32_t m_CurrentDepth{};
+
+		// The times of the scopes of the last frame that was read back
+		std::vector<ScopeResult> m_Results{};
+
+		// The smoothed time of every scope name
+		std::unordered_map<std::string, float> m_SmoothedTimes{};
+
+		// The vertex and fragment shader invocations of the last frame that was read back
+		uint64_t m_VertexInvocations{};
+		uint64_t m_FragmentInvocations{};
+
+		// Read the timestamps and the pipeline statistics of a frame
+		// Parameters:
+		//     frame: the index of the frame
+		void ReadResults(uint32_t frame);
+	};
+}
+
+#endif // !GPUProfilerIncluded
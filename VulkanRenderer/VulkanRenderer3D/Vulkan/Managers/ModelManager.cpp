@@ -5,29 +5,369 @@
 
 // File includes
 #include "DataTypes/RenderClasses/Model.h"
+#include "DataTypes/RenderClasses/Mesh.h"
+#include "DataTypes/Materials/Material.h"
+
+#include "Engine/ConfigManager.h"
+#include "Engine/CPUProfiler.h"
+#include "Engine/OcclusionRasterizer.h"
+
+#include "Vulkan/Vulkan3D.h"
+#include "Vulkan/Managers/BindlessManager.h"
+#include "Vulkan/Renderers/HiZRenderer.h"
+#include "Vulkan/Wrappers/PipelineWrapper.h"
+
+// Standard library includes
+#include <algorithm>
+#include <set>
 
 DDM3::ModelManager::ModelManager()
 {
+	// Get config manager
+	auto& configManager{ ConfigManager::GetInstance() };
+
+	// Create the software occlusion rasterizer if it is enabled
+	if (configManager.GetBool("SoftwareOcclusion"))
+	{
+		m_pOcclusionRasterizer = std::make_unique<OcclusionRasterizer>(static_cast<uint32_t>(configManager.GetInt("SoftwareOcclusionWidth")),
+			static_cast<uint32_t>(configManager.GetInt("SoftwareOcclusionHeight")));
+	}
 }
 
 DDM3::ModelManager::~ModelManager()
 {
+	// The device is idle when the model manager is destroyed, so the retired batches can be destroyed right away
+	m_pRetiredInstanceBatches.clear();
 }
 
 void DDM3::ModelManager::Update()
 {
+	DDM3_PROFILE_SCOPE("ModelManager::Update");
+
+	// The render thread can't add models while they are updated
+	std::lock_guard<std::mutex> lock{ m_ModelsMutex };
+
 	for (auto& pModel : m_pModels)
 	{
 		pModel->Update();
 	}
 }
 
+void DDM3::ModelManager::AddQueuedModels(uint64_t frame)
+{
+	// Take the queued models
+	std::vector<std::unique_ptr<Model>> pQueuedModels{};
+	{
+		std::lock_guard<std::mutex> lock{ m_QueueMutex };
+		pQueuedModels.swap(m_pQueuedModels);
+	}
+
+	// Nothing to add if no models were queued
+	if (pQueuedModels.empty())
+		return;
+
+	// Create the transforms, the transform manager is only used on the simulation thread
+	for (auto& pModel : pQueuedModels)
+	{
+		pModel->CreateTransform();
+	}
+
+	// Hand the models to the render thread, their transforms are in the packet of this frame
+	std::lock_guard<std::mutex> lock{ m_ModelsMutex };
+	for (auto& pModel : pQueuedModels)
+	{
+		m_pSimulatedModels.push_back(SimulatedModel{ std::move(pModel), frame });
+	}
+}
+
+void DDM3::ModelManager::AddSimulatedModels(uint64_t frame)
+{
+	std::lock_guard<std::mutex> lock{ m_ModelsMutex };
+
+	// Add the models whose transform is in the packet of this frame, models of later frames wait until those are rendered
+	while (!m_pSimulatedModels.empty() && m_pSimulatedModels.front().frame <= frame)
+	{
+		m_pModels.push_back(std::move(m_pSimulatedModels.front().pModel));
+		m_pSimulatedModels.pop_front();
+	}
+}
+
+void DDM3::ModelManager::Render()
+{
+	// Get the bindless manager, nullptr if bindless descriptors aren't used
+	auto pBindlessManager{ Vulkan3D::GetInstance().GetRenderer().GetBindlessManager() };
+
+	// Indicates if the bindless descriptorset is currently bound
+	bool bindlessSetBound{ false };
+
+	// Prepare the bindless buffers before anything is bound
+	if (pBindlessManager != nullptr)
+	{
+		// Count the visible models that will be rendered bindless
+		uint32_t bindlessCount{};
+		for (size_t i{}; i < m_pModels.size(); ++i)
+		{
+			if (m_Visible[i] && IsBindless(m_pModels[i].get()))
+			{
+				++bindlessCount;
+			}
+		}
+
+		pBindlessManager->BeginFrame(bindlessCount);
+	}
+
+	// Destroy the batches that the frames in flight no longer use
+	ReleaseRetiredInstanceBatches();
+
+	// Clear the batches of the previous frame
+	for (auto& batch : m_pInstanceBatches)
+	{
+		batch.second->Clear();
+	}
+
+	// Resize the batch list to the amount of models
+	m_pModelBatches.resize(m_pModels.size());
+
+	// Sort all models into their batch
+	for (size_t i{}; i < m_pModels.size(); ++i)
+	{
+		auto& pModel{ m_pModels[i] };
+
+		// Initialize batch as nullptr
+		m_pModelBatches[i] = nullptr;
+
+		// Models that aren't initialized, are rendered bindless or have no instanced pipeline are rendered on their own
+		if (!pModel->IsInitialized() || IsBindless(pModel.get()) || pModel->GetMaterial()->GetInstancedPipeline() == nullptr)
+			continue;
+
+		// Get the batch for this mesh and material, occluded models keep their batch so it isn't recreated when they become visible again
+		m_pModelBatches[i] = GetInstanceBatch(pModel.get());
+
+		// Only add visible models to the batch
+		if (m_Visible[i])
+		{
+			m_pModelBatches[i]->AddModel(pModel.get());
+		}
+	}
+
+	// Remove the batches of meshes and materials that no model uses anymore
+	RemoveUnusedInstanceBatches();
+
+	// Get current commandbuffer
+	auto commandBuffer{ Vulkan3D::GetInstance().GetRenderer().GetCurrentCommandBuffer() };
+
+	// Render in the original order of the models
+	for (size_t i{}; i < m_pModels.size(); ++i)
+	{
+		// Skip occluded models
+		if (!m_Visible[i])
+			continue;
+
+		auto pBatch{ m_pModelBatches[i] };
+
+		// If the model is rendered bindless, render it with the global descriptorset
+		if (IsBindless(m_pModels[i].get()))
+		{
+			RenderBindless(m_pModels[i].get(), pBindlessManager, commandBuffer, bindlessSetBound);
+			continue;
+		}
+
+		// Any other pipeline layout disturbs the bindless descriptorset
+		bindlessSetBound = false;
+
+		// If the model isn't batched or is alone in its batch, render it on its own
+		if (pBatch == nullptr || pBatch->GetModelCount() < 2)
+		{
+			m_pModels[i]->Render();
+		}
+		// If the model is the first of its batch, render the entire batch
+		else if (pBatch->GetFirstModel() == m_pModels[i].get())
+		{
+			pBatch->Render(commandBuffer);
+		}
+	}
+}
+
+bool DDM3::ModelManager::IsVisible(size_t index) const
+{
+	// Models that weren't tested yet are visible
+	if (index >= m_Visible.size())
+		return true;
+
+	return m_Visible[index] != 0;
+}
+
+DDM3::OcclusionRasterizer* DDM3::ModelManager::GetOcclusionRasterizer() const
+{
+	// Return the software occlusion rasterizer
+	return m_pOcclusionRasterizer.get();
+}
+
 void DDM3::ModelManager::AddModel(std::unique_ptr<Model> pModel)
 {
-	m_pModels.push_back(std::move(pModel));
+	// Queue the model, the simulation thread creates its transform at the start of the next frame
+	std::lock_guard<std::mutex> lock{ m_QueueMutex };
+	m_pQueuedModels.push_back(std::move(pModel));
 }
 
 std::vector<std::unique_ptr<DDM3::Model>>& DDM3::ModelManager::GetModels()
 {
 	return m_pModels;
 }
+
+std::shared_ptr<DDM3::Mesh> DDM3::ModelManager::LoadMesh(const std::string& filePath)
+{
+	// Check if the mesh is already loaded and still alive
+	if (auto pMesh = m_pMeshes[filePath].lock())
+	{
+		// If it is, return it
+		return pMesh;
+	}
+
+	// Load the mesh
+	auto pMesh{ std::make_shared<Mesh>(filePath) };
+
+	// Store the mesh so other models can use it
+	m_pMeshes[filePath] = pMesh;
+
+	// Return the mesh
+	return pMesh;
+}
+
+DDM3::InstanceBatch* DDM3::ModelManager::GetInstanceBatch(Model* pModel)
+{
+	// Create key from mesh and material
+	auto key{ std::make_pair(pModel->GetMesh().get(), pModel->GetMaterial().get()) };
+
+	// Get the batch for this key
+	auto& pBatch{ m_pInstanceBatches[key] };
+
+	// If it doesn't exist yet, create it
+	if (pBatch == nullptr)
+	{
+		pBatch = std::make_unique<InstanceBatch>(pModel->GetMesh(), pModel->GetMaterial());
+	}
+
+	// Return the batch
+	return pBatch.get();
+}
+
+void DDM3::ModelManager::RemoveUnusedInstanceBatches()
+{
+	// Nothing to remove if there are no batches
+	if (m_pInstanceBatches.empty())
+		return;
+
+	// Collect the batches that are used by at least one model
+	std::set<InstanceBatch*> usedBatches{ m_pModelBatches.begin(), m_pModelBatches.end() };
+
+	for (auto it{ m_pInstanceBatches.begin() }; it != m_pInstanceBatches.end();)
+	{
+		// Keep the batches that are still used
+		if (usedBatches.contains(it->second.get()))
+		{
+			++it;
+			continue;
+		}
+
+		// Frames in flight might still use the batch, retire it so it is destroyed once they finished
+		m_pRetiredInstanceBatches.push_back(RetiredInstanceBatch{ std::move(it->second), Vulkan3D::GetFrameCount() });
+
+		// Remove the key, a new mesh or material at the same address gets a new batch
+		it = m_pInstanceBatches.erase(it);
+	}
+}
+
+void DDM3::ModelManager::ReleaseRetiredInstanceBatches()
+{
+	// Get the amount of frames in flight
+	auto frames{ Vulkan3D::GetMaxFrames() };
+	// Get the amount of frames that have been rendered
+	auto frameCount{ Vulkan3D::GetFrameCount() };
+
+	// Once as many frames as there are frames in flight have been rendered since retiring, the batch is no longer in use
+	while (!m_pRetiredInstanceBatches.empty() && m_pRetiredInstanceBatches.front().frame + frames <= frameCount)
+	{
+		// Destroy the batch, this releases its mesh and material
+		m_pRetiredInstanceBatches.pop_front();
+	}
+}
+
+void DDM3::ModelManager::UpdateVisibility()
+{
+	// Get the Hi-Z renderer, nullptr if occlusion culling is disabled
+	auto pHiZRenderer{ Vulkan3D::GetInstance().GetRenderer().GetHiZRenderer() };
+
+	// Resize the visibility list to the amount of models, every model is visible by default
+	m_Visible.assign(m_pModels.size(), uint8_t{ 1 });
+
+	// Without occlusion culling, every model is visible
+	if (pHiZRenderer == nullptr && m_pOcclusionRasterizer == nullptr)
+		return;
+
+	// Rasterize the occluders with the current camera
+	if (m_pOcclusionRasterizer != nullptr)
+	{
+		// Get the view and projection matrix from the camera
+		UniformBufferObject ubo{};
+		Vulkan3D::GetInstance().GetFramePacket().camera.UpdateUniformBuffer(ubo);
+
+		m_pOcclusionRasterizer->Render(m_pModels, ubo.proj * ubo.view);
+	}
+
+	for (size_t i{}; i < m_pModels.size(); ++i)
+	{
+		auto& pModel{ m_pModels[i] };
+
+		// Models without a mesh can't be tested
+		if (!pModel->IsInitialized())
+			continue;
+
+		// Get the mesh of the model
+		auto& pMesh{ pModel->GetMesh() };
+
+		// Test against the occluders of this frame first, occluders can't hide themselves
+		if (m_pOcclusionRasterizer != nullptr && !pModel->IsOccluder() &&
+			m_pOcclusionRasterizer->IsOccluded(pMesh->GetBoundsMin(), pMesh->GetBoundsMax(), pModel->GetTransform()))
+		{
+			m_Visible[i] = 0;
+			continue;
+		}
+
+		// Test the bounding box of the mesh against the depth pyramid
+		if (pHiZRenderer != nullptr && pHiZRenderer->IsOccluded(pMesh->GetBoundsMin(), pMesh->GetBoundsMax(), pModel->GetTransform()))
+		{
+			m_Visible[i] = 0;
+		}
+	}
+}
+
+bool DDM3::ModelManager::IsBindless(Model* pModel) const
+{
+	// A model is rendered bindless if it is initialized and its material has a bindless pipeline
+	return pModel->IsInitialized() && pModel->GetMaterial()->GetBindlessPipeline() != nullptr;
+}
+
+void DDM3::ModelManager::RenderBindless(Model* pModel, BindlessManager* pBindlessManager, VkCommandBuffer commandBuffer, bool& descriptorSetBound)
+{
+	// Get the material of the model
+	auto& pMaterial{ pModel->GetMaterial() };
+	// Get the bindless pipeline
+	auto pPipeline{ pMaterial->GetBindlessPipeline() };
+
+	// Add the object data, the index is used as the instance index in the shaders
+	auto objectIndex{ pBindlessManager->AddObject(pModel->GetTransform(), pMaterial->GetBindlessTextureIndices()) };
+
+	// Bind pipeline, if the depth was written in the pre-pass only fragments with equal depth are shaded
+	pPipeline->BindPipeline(commandBuffer, pMaterial->UsesDepthPrepass());
+
+	// All bindless pipelines share the same layout, so the descriptorset only has to be bound once
+	if (!descriptorSetBound)
+	{
+		pBindlessManager->BindDescriptorSet(commandBuffer, pPipeline->GetPipelineLayout());
+		descriptorSetBound = true;
+	}
+
+	// Draw a single instance starting at the index of the object
+	pModel->GetMesh()->Render(commandBuffer, 1, objectIndex);
+}
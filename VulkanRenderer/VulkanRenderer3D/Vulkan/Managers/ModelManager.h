@@ -6,13 +6,26 @@
 
 // File includes
 #include "DataTypes/RenderClasses/Model.h"
+#include "DataTypes/RenderClasses/InstanceBatch.h"
 
 // Standard library includes
 #include <vector>
 #include <memory>
+#include <map>
+#include <string>
+#include <utility>
+#include <deque>
+#include <cstdint>
+#include <mutex>
 
 namespace DDM3
 {
+	// Class forward declarations
+	class Mesh;
+	class Material;
+	class BindlessManager;
+	class OcclusionRasterizer;
+
 	class ModelManager final
 	{
 	public:
@@ -22,14 +35,121 @@ namespace DDM3
 		// Destructor
 		~ModelManager();
 		
+		// Update all models, called on the simulation thread
 		void Update();
 
+		// Create the transforms of the queued models, they are rendered from the given frame on
+		// Called at the start of every simulated frame, before the frame packet is filled
+		// Parameters:
+		//     frame: the number of the frame that is being simulated
+		void AddQueuedModels(uint64_t frame);
+
+		// Add the models that were simulated in or before the given frame to the rendered models
+		// Called on the render thread before the frame is recorded
+		// Parameters:
+		//     frame: the number of the frame that is being rendered
+		void AddSimulatedModels(uint64_t frame);
+
+		// Render all models
+		// Models with a bindless material are drawn using the global bindless descriptorset
+		// Models that share a mesh and a material with an instanced pipeline are grouped and drawn with a single instanced draw
+		void Render();
+
+		// Test every model against the occluders of the software rasterizer and the depth pyramid of the Hi-Z renderer
+		// Has to be called once per frame, before the depth pre-pass and the models are rendered
+		void UpdateVisibility();
+
+		// Check if a model passed the occlusion test of the current frame
+		// Parameters:
+		//     index: the index of the model
+		bool IsVisible(size_t index) const;
+
+		// Get the software occlusion rasterizer
+		// Returns nullptr if software occlusion is disabled
+		OcclusionRasterizer* GetOcclusionRasterizer() const;
+
+		// Queue a model, it is added at the start of the next simulated frame and rendered from that frame on
+		// Can be called from any thread, the transform of the model is created on the simulation thread
+		// Parameters:
+		//     pModel: the model to add
 		void AddModel(std::unique_ptr<Model> pModel);
 
 		std::vector<std::unique_ptr<Model>>& GetModels();
+
+		// Get the mesh for the given file, loading it if it isn't loaded yet
+		// Parameters:
+		//     filePath: the filepath to the 3D model
+		std::shared_ptr<Mesh> LoadMesh(const std::string& filePath);
 	private:
 		std::vector<std::unique_ptr<Model>> m_pModels{};
 
+		// Models that were queued but don't have a transform yet
+		std::vector<std::unique_ptr<Model>> m_pQueuedModels{};
+
+		// Protects the queued models
+		std::mutex m_QueueMutex{};
+
+		// A model that has a transform, together with the first frame its transform is in the frame packet
+		struct SimulatedModel
+		{
+			std::unique_ptr<Model> pModel{};
+			uint64_t frame{};
+		};
+
+		// Models that have a transform but aren't rendered yet, ordered by the frame they were added in
+		std::deque<SimulatedModel> m_pSimulatedModels{};
+
+		// Protects the simulated models and keeps the model list from changing while the simulation updates it
+		std::mutex m_ModelsMutex{};
+
+		// The loaded meshes, a weak pointer is used so meshes are released once no model uses them
+		std::map<std::string, std::weak_ptr<Mesh>> m_pMeshes{};
+
+		// The instance batches, one per combination of mesh and material
+		std::map<std::pair<Mesh*, Material*>, std::unique_ptr<InstanceBatch>> m_pInstanceBatches{};
+
+		// Instance batches that no model uses anymore, together with the frame they were removed in
+		struct RetiredInstanceBatch
+		{
+			std::unique_ptr<InstanceBatch> pBatch{};
+			uint64_t frame{};
+		};
+
+		// Instance batches that were removed but might still be used by frames in flight, ordered by the frame they were removed in
+		std::deque<RetiredInstanceBatch> m_pRetiredInstanceBatches{};
+
+		// The instance batch of every model for the current frame, nullptr if the model isn't batched
+		std::vector<InstanceBatch*> m_pModelBatches{};
+
+		// Indicates for every model if it passed the occlusion test of the current frame
+		std::vector<uint8_t> m_Visible{};
+
+		// The software occlusion rasterizer, nullptr if software occlusion is disabled
+		std::unique_ptr<OcclusionRasterizer> m_pOcclusionRasterizer{};
+
+		// Get the instance batch for a combination of mesh and material, creating it if it doesn't exist yet
+		// Parameters:
+		//     pModel: the model the batch is requested for
+		InstanceBatch* GetInstanceBatch(Model* pModel);
+
+		// Remove the instance batches that no model uses anymore, so their mesh and material can be released
+		void RemoveUnusedInstanceBatches();
+
+		// Destroy the removed instance batches that are no longer used by frames in flight
+		void ReleaseRetiredInstanceBatches();
+
+		// Check if a model is rendered with bindless descriptors
+		// Parameters:
+		//     pModel: the model to check
+		bool IsBindless(Model* pModel) const;
+
+		// Render a model using the global bindless descriptorset
+		// Parameters:
+		//     pModel: the model to render
+		//     pBindlessManager: the bindless manager of the renderer
+		//     commandBuffer: the commandbuffer used in this renderpass
+		//     descriptorSetBound: indicates if the bindless descriptorset is still bound, set to true after binding
+		void RenderBindless(Model* pModel, BindlessManager* pBindlessManager, VkCommandBuffer commandBuffer, bool& descriptorSetBound);
 	};
 
 }
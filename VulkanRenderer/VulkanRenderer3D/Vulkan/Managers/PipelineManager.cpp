@@ -6,9 +6,38 @@
 #include "Vulkan/Vulkan3D.h"
 #include "Vulkan/Wrappers/PipelineWrapper.h"
 #include "Vulkan/Wrappers/DescriptorPoolWrapper.h"
+#include "Vulkan/Wrappers/GPUObject.h"
+#include "Vulkan/Managers/ShaderManager.h"
+#include "Utils/Utils.h"
 
-DDM3::PipelineManager::PipelineManager()
+// Standard library includes
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <algorithm>
+
+DDM3::PipelineManager::PipelineManager(GPUObject* pGPUObject)
 {
+	// Get the properties of the GPU
+	vkGetPhysicalDeviceProperties(pGPUObject->GetPhysicalDevice(), &m_DeviceProperties);
+
+	// Get the path of the cache file
+	m_CacheFilePath = ConfigManager::GetInstance().GetString("PipelineCacheFile");
+
+	// Create the pipeline cache
+	CreatePipelineCache(pGPUObject->GetDevice());
+
+	// Create the shader manager
+	m_pShaderManager = std::make_unique<ShaderManager>();
+
+	// Get the extended dynamic state functions, nullptr if not supported
+	m_pDynamicState = pGPUObject->GetExtendedDynamicState();
+
+	// Read the config here, the worker threads don't access the config
+	m_DepthPrepass = ConfigManager::GetInstance().GetBool("DepthPrepass");
 }
 
 DDM3::PipelineManager::~PipelineManager()
@@ -18,7 +47,184 @@ DDM3::PipelineManager::~PipelineManager()
 
 void DDM3::PipelineManager::Cleanup(VkDevice device)
 {
-	
+	// Wait for all worker threads, they still use the pipeline cache
+	for (auto& worker : m_Workers)
+	{
+		worker.wait();
+	}
+	m_Workers.clear();
+
+	// Destroy the pipelines that were never requested
+	m_PendingPipelines.clear();
+	m_PendingNames.clear();
+
+	// Save the pipeline cache for the next launch
+	SaveCacheFile(device);
+
+	// Destroy the pipeline cache, pipelines created with it stay valid
+	vkDestroyPipelineCache(device, m_PipelineCache, nullptr);
+
+	// Destroy the shader modules and layouts, pipelines that were created with them stay valid
+	m_pShaderManager->Cleanup(device);
+}
+
+void DDM3::PipelineManager::CreatePipelineCache(VkDevice device)
+{
+	// Read the data of the previous launch
+	std::vector<char> data{};
+	m_CacheLoaded = ReadCacheFile(data);
+
+	// Create pipeline cache create info
+	VkPipelineCacheCreateInfo cacheInfo{};
+	// Set type to pipeline cache create info
+	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	// Give the data of the cache file, empty if it wasn't valid
+	cacheInfo.initialDataSize = data.size();
+	cacheInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+	// Create the pipeline cache
+	if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &m_PipelineCache) != VK_SUCCESS)
+	{
+		// If unsuccessful, throw runtime error
+		throw std::runtime_error("failed to create pipeline cache!");
+	}
+}
+
+bool DDM3::PipelineManager::ReadCacheFile(std::vector<char>& data) const
+{
+	// Open the file at the end to get the size
+	std::ifstream file{ m_CacheFilePath, std::ios::ate | std::ios::binary };
+
+	// Without a file, every pipeline is compiled from scratch
+	if (!file.is_open())
+	{
+		std::cout << "Pipeline cache miss: no cache file found at " << m_CacheFilePath << "\n";
+		return false;
+	}
+
+	// Get the size of the file
+	auto fileSize{ static_cast<size_t>(file.tellg()) };
+	file.seekg(0);
+
+	// Read the header
+	PipelineCacheFileHeader header{};
+	if (fileSize < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+	{
+		std::cout << "Pipeline cache miss: the cache file is too small\n";
+		return false;
+	}
+
+	// The file has to be written by this renderer, with this GPU and this driver
+	if (header.magic != m_sCacheFileMagic || header.dataSize != fileSize - sizeof(header) ||
+		header.vendorID != m_DeviceProperties.vendorID || header.deviceID != m_DeviceProperties.deviceID ||
+		header.driverVersion != m_DeviceProperties.driverVersion ||
+		std::memcmp(header.pipelineCacheUUID, m_DeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+	{
+		std::cout << "Pipeline cache miss: the cache file was written by another GPU or driver\n";
+		return false;
+	}
+
+	// Read the cache data
+	data.resize(header.dataSize);
+	if (!file.read(data.data(), data.size()))
+	{
+		std::cout << "Pipeline cache miss: failed to read the cache file\n";
+		data.clear();
+		return false;
+	}
+
+	// The data starts with the header of the driver, check it as well in case the file was altered
+	VkPipelineCacheHeaderVersionOne driverHeader{};
+	if (data.size() < sizeof(driverHeader))
+	{
+		std::cout << "Pipeline cache miss: the cache data is too small\n";
+		data.clear();
+		return false;
+	}
+
+	std::memcpy(&driverHeader, data.data(), sizeof(driverHeader));
+
+	if (driverHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+		driverHeader.vendorID != m_DeviceProperties.vendorID || driverHeader.deviceID != m_DeviceProperties.deviceID ||
+		std::memcmp(driverHeader.pipelineCacheUUID, m_DeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+	{
+		std::cout << "Pipeline cache miss: the cache data doesn't match this GPU\n";
+		data.clear();
+		return false;
+	}
+
+	std::cout << "Pipeline cache hit: loaded " << data.size() << " bytes from " << m_CacheFilePath << "\n";
+	return true;
+}
+
+void DDM3::PipelineManager::SaveCacheFile(VkDevice device) const
+{
+	// Nothing to save without a cache or a path
+	if (m_PipelineCache == VK_NULL_HANDLE || m_CacheFilePath.empty())
+		return;
+
+	// Get the size of the cache data
+	size_t dataSize{};
+	if (vkGetPipelineCacheData(device, m_PipelineCache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0)
+		return;
+
+	// Get the cache data
+	std::vector<char> data(dataSize);
+	if (vkGetPipelineCacheData(device, m_PipelineCache, &dataSize, data.data()) != VK_SUCCESS)
+		return;
+
+	// Fill in the header
+	PipelineCacheFileHeader header{};
+	header.magic = m_sCacheFileMagic;
+	header.dataSize = static_cast<uint32_t>(dataSize);
+	header.vendorID = m_DeviceProperties.vendorID;
+	header.deviceID = m_DeviceProperties.deviceID;
+	header.driverVersion = m_DeviceProperties.driverVersion;
+	std::memcpy(header.pipelineCacheUUID, m_DeviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+
+	// Write everything to a temporary file
+	const std::string temporaryPath{ m_CacheFilePath + ".tmp" };
+	{
+		std::ofstream file{ temporaryPath, std::ios::binary | std::ios::trunc };
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(data.data(), dataSize);
+
+		// If writing failed, keep the old file
+		if (!file.good())
+		{
+			std::cout << "Failed to write the pipeline cache to " << temporaryPath << "\n";
+			return;
+		}
+	}
+
+	// Replace the old file in a single step
+	std::error_code error{};
+	std::filesystem::rename(temporaryPath, m_CacheFilePath, error);
+
+	if (error)
+	{
+		std::cout << "Failed to replace the pipeline cache file: " << error.message() << "\n";
+		std::filesystem::remove(temporaryPath, error);
+	}
+}
+
+void DDM3::PipelineManager::LogStatistics() const
+{
+	std::lock_guard<std::mutex> lock{ m_StatisticsMutex };
+
+	// Log how long the pipelines took, a warm cache should be a lot faster than a cold one
+	std::cout << "Created " << m_PipelineCount << " graphics pipelines in " << m_PipelineCreationTime << " ms with a "
+		<< (m_CacheLoaded ? "warm" : "cold") << " pipeline cache\n";
+
+	// Pipelines created on worker threads may not be done yet
+	if (m_PipelineCount < m_RequestedPipelineCount)
+	{
+		std::cout << m_RequestedPipelineCount - m_PipelineCount << " graphics pipelines are still being created\n";
+	}
+
+	// Log how many pipeline names share a pipeline
+	std::cout << m_GraphicPipelines.size() + m_PendingNames.size() << " pipeline names use " << m_PipelineCount << " graphics pipelines, "
+		<< m_SharedPipelineCount << " more only differ in dynamic state and reuse one of them\n";
 }
 
 void DDM3::PipelineManager::AddDefaultPipeline(VkDevice device, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount)
@@ -36,36 +242,311 @@ void DDM3::PipelineManager::AddDefaultPipeline(VkDevice device, VkRenderPass ren
 
 }
 
-void DDM3::PipelineManager::AddGraphicsPipeline(VkDevice device, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount, const std::string& pipelineName, std::initializer_list<const std::string>&& filePaths, bool hasDepthStencil)
+void DDM3::PipelineManager::AddGraphicsPipeline(VkDevice device, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount, const std::string& pipelineName, std::initializer_list<const std::string>&& filePaths, bool hasDepthStencil,
+	VkDescriptorSetLayout descriptorSetLayout)
+{
+	AddGraphicsPipeline(device, renderPass, sampleCount, pipelineName, filePaths, hasDepthStencil, descriptorSetLayout);
+}
+
+void DDM3::PipelineManager::AddGraphicsPipeline(VkDevice device, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount, const std::string& pipelineName, std::initializer_list<const std::string>& filePaths, bool hasDepthStencil,
+	VkDescriptorSetLayout descriptorSetLayout)
+{
+	// Create the state key and add the pipeline
+	AddGraphicsPipeline(device, pipelineName, PipelineWrapper::CreateStateKey(renderPass, sampleCount,
+		std::vector<std::string>(filePaths.begin(), filePaths.end()), hasDepthStencil, descriptorSetLayout));
+}
+
+void DDM3::PipelineManager::AddGraphicsPipeline(VkDevice device, const std::string& pipelineName, const PipelineStateKey& stateKey)
 {
-	AddGraphicsPipeline(device, renderPass, sampleCount, pipelineName, filePaths, hasDepthStencil);
+	// A pipeline with the same name that wasn't requested yet is replaced
+	m_PendingNames.erase(pipelineName);
+
+	// Use the pipeline with the same state, or create it
+	m_GraphicPipelines[pipelineName] = GetOrCreatePipeline(device, stateKey);
 }
 
-void DDM3::PipelineManager::AddGraphicsPipeline(VkDevice device, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount, const std::string& pipelineName, std::initializer_list<const std::string>& filePaths, bool hasDepthStencil)
+void DDM3::PipelineManager::AddGraphicsPipelines(VkDevice device, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount,
+	const std::vector<PipelineDescription>& descriptions)
 {
-	// Check if pipeline already exists, if it does, delete it
-	if (m_GraphicPipelines.contains(pipelineName))
+	// Create the batch, it is shared with the worker threads
+	auto pBatch{ std::make_shared<PipelineBatch>() };
+
+	for (auto& description : descriptions)
 	{
-		m_GraphicPipelines[pipelineName] = nullptr;
+		// Create the state key of the pipeline
+		auto stateKey{ PipelineWrapper::CreateStateKey(renderPass, sampleCount, description.filePaths,
+			description.hasDepthStencil, description.descriptorSetLayout) };
+
+		// Replace pipelines with the same name, the pipeline is looked up by its state when it is requested
+		m_GraphicPipelines.erase(description.name);
+		m_PendingNames[description.name] = stateKey;
+
+		// Only the VkPipeline has to be created, pipelines that only differ in dynamic state are added when requested
+		auto compiledStateKey{ GetCompiledStateKey(stateKey) };
+
+		// Skip pipelines that exist, are being created or are already in this batch
+		if (m_PipelinesByState.contains(compiledStateKey) || m_PendingPipelines.contains(compiledStateKey))
+			continue;
+
+		// Add the pipeline to the batch, it can be requested trough its future
+		pBatch->stateKeys.push_back(compiledStateKey);
+		pBatch->promises.emplace_back();
+		m_PendingPipelines[compiledStateKey] = pBatch->promises.back().get_future();
 	}
 
-	// Create a new pipeline in the correct spot in the map
-	m_GraphicPipelines[pipelineName] = std::make_unique<DDM3::PipelineWrapper>
-		(device, renderPass, sampleCount, filePaths, hasDepthStencil);
-	
+	// Nothing to create
+	if (pBatch->stateKeys.empty())
+		return;
+
+	pBatch->remainingCount = pBatch->stateKeys.size();
+	pBatch->start = std::chrono::high_resolution_clock::now();
+
+	{
+		std::lock_guard<std::mutex> lock{ m_StatisticsMutex };
+		m_RequestedPipelineCount += static_cast<uint32_t>(pBatch->stateKeys.size());
+	}
+
+	// Use a worker per core, but never more workers than pipelines
+	size_t workerCount{ std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), pBatch->stateKeys.size()) };
+
+	// Start the workers
+	for (size_t i{}; i < workerCount; ++i)
+	{
+		m_Workers.push_back(std::async(std::launch::async, [this, pBatch, device]()
+			{
+				CreateBatchPipelines(pBatch, device);
+			}));
+	}
+}
+
+void DDM3::PipelineManager::CreateBatchPipelines(std::shared_ptr<PipelineBatch> pBatch, VkDevice device)
+{
+	// Take pipelines from the batch until all are taken
+	for (size_t index{ pBatch->nextIndex++ }; index < pBatch->stateKeys.size(); index = pBatch->nextIndex++)
+	{
+		const auto& stateKey{ pBatch->stateKeys[index] };
+
+		try
+		{
+			// Create the pipeline and hand it to whoever requests it
+			pBatch->promises[index].set_value(std::make_unique<DDM3::PipelineWrapper>(device, m_pShaderManager.get(), stateKey,
+				NeedsDepthEqualVariant(stateKey), m_PipelineCache, m_pDynamicState));
+		}
+		catch (...)
+		{
+			// The error is thrown again when the pipeline is requested
+			pBatch->promises[index].set_exception(std::current_exception());
+		}
+
+		// Update the statistics
+		std::lock_guard<std::mutex> lock{ m_StatisticsMutex };
+		++m_PipelineCount;
+
+		// The last pipeline of the batch adds the time the whole batch took
+		if (--pBatch->remainingCount == 0)
+		{
+			m_PipelineCreationTime += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - pBatch->start).count();
+		}
+	}
+}
+
+DDM3::PipelineWrapper* DDM3::PipelineManager::GetOrCreatePipeline(VkDevice device, const PipelineStateKey& stateKey)
+{
+	// Check if a pipeline with this state exists
+	auto it{ m_PipelinesByState.find(stateKey) };
+	if (it != m_PipelinesByState.end())
+	{
+		return it->second.get();
+	}
+
+	// Check if the pipeline is still being created
+	auto pendingIt{ m_PendingPipelines.find(stateKey) };
+	if (pendingIt != m_PendingPipelines.end())
+	{
+		// Take the future out of the pending pipelines
+		auto future{ std::move(pendingIt->second) };
+		m_PendingPipelines.erase(pendingIt);
+
+		// Wait for the pipeline and add it to the map, errors during creation are thrown here
+		auto& pPipeline{ m_PipelinesByState[stateKey] = future.get() };
+		return pPipeline.get();
+	}
+
+	// If the state only differs in dynamic state from a VkPipeline, use that VkPipeline
+	auto compiledStateKey{ GetCompiledStateKey(stateKey) };
+	if (!(compiledStateKey == stateKey))
+	{
+		// Get the pipeline without the dynamic state
+		auto pBasePipeline{ GetOrCreatePipeline(device, compiledStateKey) };
+
+		// Create a pipeline that binds the VkPipeline with the dynamic state of this key
+		auto& pPipeline{ m_PipelinesByState[stateKey] = std::make_unique<DDM3::PipelineWrapper>(*pBasePipeline, stateKey, NeedsDepthEqualVariant(stateKey)) };
+
+		std::lock_guard<std::mutex> lock{ m_StatisticsMutex };
+		++m_SharedPipelineCount;
+
+		return pPipeline.get();
+	}
+
+	// Get the start time
+	auto start{ std::chrono::high_resolution_clock::now() };
+
+	// Create a new pipeline
+	auto& pPipeline{ m_PipelinesByState[stateKey] = std::make_unique<DDM3::PipelineWrapper>(device, m_pShaderManager.get(), stateKey,
+		NeedsDepthEqualVariant(stateKey), m_PipelineCache, m_pDynamicState) };
+
+	// Add the time it took to the statistics
+	std::lock_guard<std::mutex> lock{ m_StatisticsMutex };
+	m_PipelineCreationTime += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	++m_PipelineCount;
+	++m_RequestedPipelineCount;
+
+	return pPipeline.get();
+}
+
+void DDM3::PipelineManager::RecreatePipelines(VkDevice device, VkRenderPass oldRenderPass, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount)
+{
+	// Request every pipeline name that wasn't requested yet, so every pipeline exists
+	std::vector<std::string> pendingNames{};
+	for (auto& pendingName : m_PendingNames)
+	{
+		pendingNames.push_back(pendingName.first);
+	}
+	for (auto& name : pendingNames)
+	{
+		GetPipeline(name);
+	}
+
+	// Wait for the worker threads, pipelines that were never requested are destroyed
+	for (auto& worker : m_Workers)
+	{
+		worker.wait();
+	}
+	m_Workers.clear();
+	m_PendingPipelines.clear();
+
+	// Take all pipelines out of the map, their state key changes
+	auto pipelinesByState{ std::move(m_PipelinesByState) };
+	m_PipelinesByState.clear();
+
+	// Get the start time
+	auto start{ std::chrono::high_resolution_clock::now() };
+
+	// Recreate the pipelines that own their VkPipeline first, pipelines that only differ in dynamic state need them
+	for (auto& pipeline : pipelinesByState)
+	{
+		auto stateKey{ pipeline.first };
+
+		// Pipelines of other renderpasses are kept as they are
+		if (stateKey.renderPass != oldRenderPass)
+		{
+			m_PipelinesByState[stateKey] = std::move(pipeline.second);
+			continue;
+		}
+
+		// Pipelines that only differ in dynamic state are recreated after their base pipeline
+		if (!(GetCompiledStateKey(stateKey) == stateKey))
+			continue;
+
+		pipeline.second->Recreate(device, m_pShaderManager.get(), renderPass, sampleCount, m_PipelineCache);
+		m_PipelinesByState[pipeline.second->GetStateKey()] = std::move(pipeline.second);
+	}
+
+	// Let the remaining pipelines use the VkPipeline of their recreated base pipeline
+	for (auto& pipeline : pipelinesByState)
+	{
+		if (pipeline.second == nullptr)
+			continue;
+
+		auto stateKey{ pipeline.first };
+		stateKey.renderPass = renderPass;
+		stateKey.sampleCount = sampleCount;
+
+		pipeline.second->Recreate(*m_PipelinesByState.at(GetCompiledStateKey(stateKey)));
+		m_PipelinesByState[stateKey] = std::move(pipeline.second);
+	}
+
+	// Add the time it took to the statistics
+	std::lock_guard<std::mutex> lock{ m_StatisticsMutex };
+	m_PipelineCreationTime += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+DDM3::PipelineStateKey DDM3::PipelineManager::GetCompiledStateKey(const PipelineStateKey& stateKey) const
+{
+	// Without extended dynamic state, all state is baked into the VkPipeline
+	if (m_pDynamicState == nullptr)
+		return stateKey;
+
+	// Reset the dynamic state to the default values
+	const PipelineStateKey defaultStateKey{};
+
+	PipelineStateKey compiledStateKey{ stateKey };
+	compiledStateKey.depthTest = defaultStateKey.depthTest;
+	compiledStateKey.depthWrite = defaultStateKey.depthWrite;
+	compiledStateKey.depthCompareOp = defaultStateKey.depthCompareOp;
+	compiledStateKey.cullMode = defaultStateKey.cullMode;
+
+	return compiledStateKey;
+}
+
+bool DDM3::PipelineManager::NeedsDepthEqualVariant(const PipelineStateKey& stateKey) const
+{
+	// If the depth pre-pass is enabled, pipelines that use depth also need a variant that only passes on equal depth
+	return m_DepthPrepass && stateKey.depthTest && stateKey.depthWrite;
 }
 
 DDM3::PipelineWrapper* DDM3::PipelineManager::GetPipeline(const std::string& name)
 {
+	// If the pipeline wasn't requested yet, look it up by its state, this waits if it is still being created
+	auto pendingIt{ m_PendingNames.find(name) };
+	if (pendingIt != m_PendingNames.end())
+	{
+		m_GraphicPipelines[name] = GetOrCreatePipeline(Vulkan3D::GetInstance().GetDevice(), pendingIt->second);
+		m_PendingNames.erase(pendingIt);
+	}
+
 	// Check if pipeline exists
 	if (m_GraphicPipelines.contains(name))
 	{
 		// If it exists, return the correct pipeline
-		return m_GraphicPipelines[name].get();
+		return m_GraphicPipelines[name];
 	}
 	else
 	{
 		// If not, return default pipeline
-		return m_GraphicPipelines[m_DefaultPipelineName].get();
+		return m_GraphicPipelines[m_DefaultPipelineName];
+	}
+}
+
+bool DDM3::PipelineManager::HasPipeline(const std::string& name) const
+{
+	// Check if the pipeline is in the map or wasn't requested yet
+	return m_GraphicPipelines.contains(name) || m_PendingNames.contains(name);
+}
+
+size_t DDM3::PipelineManager::PipelineStateKeyHash::operator()(const PipelineStateKey& stateKey) const
+{
+	size_t seed{};
+
+	// Combine the hashes of all shaders
+	for (auto& shader : stateKey.shaders)
+	{
+		seed = Utils::HashCombine(seed, std::hash<std::string>{}(shader));
 	}
-}
\ No newline at end of file
+
+	// Combine the hashes of the fixed function state
+	seed = Utils::HashCombine(seed, static_cast<size_t>(stateKey.vertexLayout));
+	seed = Utils::HashCombine(seed, static_cast<size_t>(stateKey.blendEnable));
+	seed = Utils::HashCombine(seed, static_cast<size_t>(stateKey.colorWrite));
+	seed = Utils::HashCombine(seed, static_cast<size_t>(stateKey.depthTest));
+	seed = Utils::HashCombine(seed, static_cast<size_t>(stateKey.depthWrite));
+	seed = Utils::HashCombine(seed, static_cast<size_t>(stateKey.depthCompareOp));
+	seed = Utils::HashCombine(seed, static_cast<size_t>(stateKey.cullMode));
+	seed = Utils::HashCombine(seed, static_cast<size_t>(stateKey.sampleCount));
+
+	// Combine the hashes of the handles
+	seed = Utils::HashCombine(seed, std::hash<VkRenderPass>{}(stateKey.renderPass));
+	seed = Utils::HashCombine(seed, std::hash<VkDescriptorSetLayout>{}(stateKey.descriptorSetLayout));
+
+	return seed;
+}
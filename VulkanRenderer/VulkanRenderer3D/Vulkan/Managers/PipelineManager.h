@@ -1,5 +1,7 @@
 // PipelineManager.h
 // This class will handle graphics pipelines
+// It also owns the pipeline cache, which is loaded from a file at startup and saved again on shutdown
+// Pipelines are stored by their state key, pipeline names with the same state share a single pipeline
 
 #ifndef PipelineManagerIncluded
 #define PipelineManagerIncluded
@@ -11,20 +13,32 @@
 // Standard library includes
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <initializer_list>
 #include <memory>
+#include <future>
+#include <atomic>
+#include <mutex>
+#include <chrono>
 
 namespace DDM3
 {
 	// Class forward declarations
 	class PipelineWrapper;
+	class GPUObject;
+	class ShaderManager;
 
 	class PipelineManager final
 	{
 	public:
 		// Constructor
-		PipelineManager();
+		// Parameters:
+		//     pGPUObject: pointer to the GPU object, used to create the pipeline cache, validate the cache file and get the extended dynamic state functions
+		PipelineManager(GPUObject* pGPUObject);
+
+		// Delete default constructor
+		PipelineManager() = delete;
 
 		// Destructor
 		~PipelineManager();
@@ -43,8 +57,10 @@ namespace DDM3
 		//     pipelineName: the name for this pipeLine
 		//     filePaths: a list of shader file names for this pipeline
 		//     isSkybox: boolean that indicates if this pipeline needs a depth stencil
+		//     descriptorSetLayout: an externally owned descriptor set layout, null handle by default
 		void AddGraphicsPipeline(VkDevice device, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount,
-			const std::string& pipelineName, std::initializer_list<const std::string>& filePaths, bool hasDepthStencil = true);
+			const std::string& pipelineName, std::initializer_list<const std::string>& filePaths, bool hasDepthStencil = true,
+			VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE);
 
 		// Add a graphics pipeline to the vector
 		// Parameters:
@@ -54,8 +70,28 @@ namespace DDM3
 		//     pipelineName: the name for this pipeLine
 		//     filePaths: a list of shader file names for this pipeline
 		//     isSkybox: boolean that indicates if this pipeline needs a depth stencil
+		//     descriptorSetLayout: an externally owned descriptor set layout, null handle by default
 		void AddGraphicsPipeline(VkDevice device, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount,
-			const std::string& pipelineName, std::initializer_list<const std::string>&& filePaths, bool hasDepthStencil = true);
+			const std::string& pipelineName, std::initializer_list<const std::string>&& filePaths, bool hasDepthStencil = true,
+			VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE);
+
+		// Add a graphics pipeline with the given state
+		// If a pipeline with the same state exists, it is used instead of creating a new one
+		// Parameters:
+		//     device: the VkDevice handle
+		//     pipelineName: the name for this pipeLine
+		//     stateKey: all state the pipeline is created with
+		void AddGraphicsPipeline(VkDevice device, const std::string& pipelineName, const PipelineStateKey& stateKey);
+
+		// Start creating multiple graphics pipelines on worker threads, all threads share the pipeline cache
+		// This function returns right away, a pipeline is only waited on when it is requested for the first time
+		// Parameters:
+		//     device: the VkDevice handle
+		//     renderPass: the handle of the VkRenderpass that will be used
+		//     sampleCount: the max useable sample count
+		//     descriptions: the descriptions of the pipelines
+		void AddGraphicsPipelines(VkDevice device, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount,
+			const std::vector<PipelineDescription>& descriptions);
 
 		// Add default pipeline to the vector
 		// Parameters:
@@ -64,21 +100,175 @@ namespace DDM3
 		//     sampleCount: the max useable sample count
 		void AddDefaultPipeline(VkDevice device, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount);
 
+		// Recreate all pipelines of a renderpass for a new renderpass, used when the amount of samples per pixel changes
+		// The pipeline objects are kept, so pointers to them and descriptorsets allocated from them stay valid
+		// All pipelines that are still being created are waited on first, the device must be idle
+		// Parameters:
+		//     device: the VkDevice handle
+		//     oldRenderPass: the renderpass the pipelines were created with
+		//     renderPass: the new renderpass
+		//     sampleCount: the new amount of samples per pixel
+		void RecreatePipelines(VkDevice device, VkRenderPass oldRenderPass, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount);
+
 		// Get a certain graphics pipeline
+		// If the pipeline is still being created, this waits until it is done
 		// Parameters:
 		//     name: the name of the requested pipeline
 		PipelineWrapper* GetPipeline(const std::string& name);
 
+		// Check if a graphics pipeline with the given name exists
+		// Parameters:
+		//     name: the name of the requested pipeline
+		bool HasPipeline(const std::string& name) const;
+
+		// Get the pipeline cache, all pipelines should be created with it
+		VkPipelineCache GetPipelineCache() const { return m_PipelineCache; }
+
+		// Get the shader manager, all pipelines should take their shader modules and layouts from it
+		ShaderManager* GetShaderManager() const { return m_pShaderManager.get(); }
+
+		// Log if the pipeline cache file was used and how long creating the graphics pipelines took
+		void LogStatistics() const;
 
 	private:
+		// Hash function of the pipeline state key
+		struct PipelineStateKeyHash
+		{
+			size_t operator()(const PipelineStateKey& stateKey) const;
+		};
+
+		// Header written in front of the cache data in the cache file
+		// The data is only used if the file was written with the same GPU and driver
+		struct PipelineCacheFileHeader
+		{
+			// Identifies the file as a pipeline cache of this renderer
+			uint32_t magic{};
+			// The size of the cache data after the header
+			uint32_t dataSize{};
+			// The vendor of the GPU
+			uint32_t vendorID{};
+			// The GPU
+			uint32_t deviceID{};
+			// The version of the driver
+			uint32_t driverVersion{};
+			// The UUID of the pipeline cache, changes when the driver changes its cache format
+			uint8_t pipelineCacheUUID[VK_UUID_SIZE]{};
+		};
+
+		// Value of the magic field of the cache file header, "DDM3"
+		static constexpr uint32_t m_sCacheFileMagic{ 0x334D4444 };
+
+		// The pipeline cache
+		VkPipelineCache m_PipelineCache{ VK_NULL_HANDLE };
+
+		// The shader manager, shared by all pipelines
+		std::unique_ptr<ShaderManager> m_pShaderManager{};
+
+		// Properties of the GPU, used to validate the cache file
+		VkPhysicalDeviceProperties m_DeviceProperties{};
+
+		// Path of the cache file
+		std::string m_CacheFilePath{};
+
+		// Indicates if valid cache data was loaded from the file
+		bool m_CacheLoaded{ false };
+
+		// The extended dynamic state functions, nullptr if extended dynamic state isn't supported
+		const ExtendedDynamicStateFunctions* m_pDynamicState{};
+
+		// Indicates if the depth pre-pass is enabled, pipelines that use depth then get a depth equal variant
+		bool m_DepthPrepass{ false };
+
+		// Pipelines that are created together on worker threads
+		struct PipelineBatch
+		{
+			// The state keys of the pipelines, every key is unique
+			std::vector<PipelineStateKey> stateKeys{};
+			// A promise per pipeline, set when the pipeline is created
+			std::vector<std::promise<std::unique_ptr<PipelineWrapper>>> promises{};
+			// The index of the next pipeline that has to be created
+			std::atomic<size_t> nextIndex{};
+			// The amount of pipelines that aren't created yet
+			std::atomic<size_t> remainingCount{};
+			// The time the batch was started
+			std::chrono::high_resolution_clock::time_point start{};
+		};
+
+		// The amount of graphics pipelines that were requested to be created
+		uint32_t m_RequestedPipelineCount{};
+
+		// The amount of graphics pipelines that were created
+		uint32_t m_PipelineCount{};
+
+		// The amount of pipelines that only differ in dynamic state from a created pipeline and use its VkPipeline
+		uint32_t m_SharedPipelineCount{};
+
+		// The total time spent creating graphics pipelines in milliseconds, a batch counts from its start until its last pipeline is done
+		float m_PipelineCreationTime{};
+
+		// Mutex for the statistics, they are updated from the worker threads
+		mutable std::mutex m_StatisticsMutex{};
+
+		// Pipelines that are still being created or weren't requested yet, by their state key
+		std::unordered_map<PipelineStateKey, std::future<std::unique_ptr<PipelineWrapper>>, PipelineStateKeyHash> m_PendingPipelines{};
+
+		// The state keys of pipeline names that weren't requested yet
+		std::map<std::string, PipelineStateKey> m_PendingNames{};
+
+		// The worker threads of all batches
+		std::vector<std::future<void>> m_Workers{};
+
+		// All graphics pipelines by their state key, this map owns the pipelines
+		std::unordered_map<PipelineStateKey, std::unique_ptr<PipelineWrapper>, PipelineStateKeyHash> m_PipelinesByState{};
+
 		// A map of all the graphics pipelines
-		// A string is used to as key for the pipelines
-		std::map<std::string, std::unique_ptr<PipelineWrapper>> m_GraphicPipelines{};
+		// A string is used to as key for the pipelines, multiple names can point to the same pipeline
+		std::map<std::string, PipelineWrapper*> m_GraphicPipelines{};
 
 		// The name of the default pipeline
 		std::string m_DefaultPipelineName{};
 		
 		
+		// Create pipelines of a batch until none are left, runs on a worker thread
+		// Parameters:
+		//     pBatch: the batch the pipelines are taken from
+		//     device: the VkDevice handle
+		void CreateBatchPipelines(std::shared_ptr<PipelineBatch> pBatch, VkDevice device);
+
+		// Get the pipeline with the given state, the pipeline is created if it doesn't exist
+		// If it is still being created, this waits until it is done
+		// Parameters:
+		//     device: the VkDevice handle
+		//     stateKey: the state of the pipeline
+		PipelineWrapper* GetOrCreatePipeline(VkDevice device, const PipelineStateKey& stateKey);
+
+		// Get the state key of the VkPipeline that is created for the given state
+		// With extended dynamic state, the dynamic state is reset so all keys that only differ in it use the same VkPipeline
+		// Parameters:
+		//     stateKey: the state of the pipeline
+		PipelineStateKey GetCompiledStateKey(const PipelineStateKey& stateKey) const;
+
+		// Check if a pipeline with the given state needs a depth equal variant
+		// Parameters:
+		//     stateKey: the state of the pipeline
+		bool NeedsDepthEqualVariant(const PipelineStateKey& stateKey) const;
+
+		// Create the pipeline cache with the data of the cache file if it is valid
+		// Parameters:
+		//     device: handle of the VkDevice
+		void CreatePipelineCache(VkDevice device);
+
+		// Read the cache file, returns false and leaves data empty if the file is missing or was written by another GPU or driver
+		// Parameters:
+		//     data: the cache data that was read
+		bool ReadCacheFile(std::vector<char>& data) const;
+
+		// Write the pipeline cache to the cache file
+		// The data is written to a temporary file first, which then replaces the cache file, so a crash never leaves a broken file
+		// Parameters:
+		//     device: handle of the VkDevice
+		void SaveCacheFile(VkDevice device) const;
+
 		// Clean up everything
 		// Parameters:
 		//     device: handle of the VkDevice
@@ -0,0 +1,178 @@
+// ResolutionManager.cpp
+
+// Header include
+#include "ResolutionManager.h"
+
+// File includes
+#include "Includes/ImGuiIncludes.h"
+
+#include "Engine/ConfigManager.h"
+
+#include "Vulkan/Vulkan3D.h"
+#include "Vulkan/VulkanUtils.h"
+#include "Vulkan/Wrappers/GPUObject.h"
+
+// Standard library includes
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+DDM3::ResolutionManager::ResolutionManager(GPUObject* pGPUObject, VkSampleCountFlagBits msaaSamples)
+	:m_MaxMsaaSamples{ VulkanUtils::GetMaxUsableSampleCount(pGPUObject->GetPhysicalDevice()) },
+	m_RequestedMsaaSamples{ msaaSamples }
+{
+	// Get config manager
+	auto& configManager{ ConfigManager::GetInstance() };
+
+	// Read the settings
+	m_Enabled = configManager.GetBool("DynamicResolution");
+	m_FrameTimeBudget = configManager.GetFloat("FrameTimeBudget");
+	m_MinRenderScale = std::clamp(configManager.GetFloat("MinRenderScale"), 0.1f, 1.0f);
+
+	// A benchmark renders at a fixed scale, otherwise the measured times would depend on how fast the GPU is
+	if (configManager.GetBool("Benchmark"))
+	{
+		m_Enabled = false;
+		m_FixedRenderScale = std::clamp(configManager.GetFloat("BenchmarkRenderScale"), 0.1f, 1.0f);
+	}
+
+	// Start at the fixed scale
+	m_RenderScale = m_FixedRenderScale;
+
+	// Get the physical device properties
+	VkPhysicalDeviceProperties properties{};
+	vkGetPhysicalDeviceProperties(pGPUObject->GetPhysicalDevice(), &properties);
+
+	// Without timestamps on the graphics queue the GPU time can't be measured
+	if (!properties.limits.timestampComputeAndGraphics)
+	{
+		m_Enabled = false;
+		return;
+	}
+
+	// Remember how long a tick takes
+	m_TimestampPeriod = properties.limits.timestampPeriod;
+
+	// Get the amount of frames
+	auto frames{ Vulkan3D::GetMaxFrames() };
+
+	// Create query pool create info with a begin and end timestamp per frame
+	VkQueryPoolCreateInfo queryPoolInfo{};
+	queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	queryPoolInfo.queryCount = 2 * frames;
+
+	// Create the query pool, if unsuccessful, throw runtime error
+	if (vkCreateQueryPool(pGPUObject->GetDevice(), &queryPoolInfo, nullptr, &m_QueryPool) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create timestamp query pool!");
+	}
+
+	// No queries were written yet
+	m_QueriesWritten.assign(frames, false);
+}
+
+DDM3::ResolutionManager::~ResolutionManager()
+{
+	// Destroy the query pool
+	vkDestroyQueryPool(Vulkan3D::GetInstance().GetDevice(), m_QueryPool, nullptr);
+}
+
+void DDM3::ResolutionManager::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frame)
+{
+	// If timestamps aren't supported, nothing can be measured
+	if (m_QueryPool == VK_NULL_HANDLE)
+		return;
+
+	// The first query of this frame
+	uint32_t firstQuery{ 2 * frame };
+
+	// The fence of this frame was waited on, so the timestamps of the last time this frame index was rendered are available
+	if (m_QueriesWritten[frame])
+	{
+		std::array<uint64_t, 2> timestamps{};
+		if (vkGetQueryPoolResults(Vulkan3D::GetInstance().GetDevice(), m_QueryPool, firstQuery, 2, sizeof(timestamps), timestamps.data(),
+			sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+		{
+			// Convert the ticks to milliseconds
+			float gpuTime{ static_cast<float>(timestamps[1] - timestamps[0]) * m_TimestampPeriod / 1'000'000.0f };
+
+			UpdateRenderScale(gpuTime);
+		}
+	}
+
+	// Reset the queries of this frame and write the first timestamp
+	vkCmdResetQueryPool(commandBuffer, m_QueryPool, firstQuery, 2);
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_QueryPool, firstQuery);
+}
+
+void DDM3::ResolutionManager::EndFrame(VkCommandBuffer commandBuffer, uint32_t frame)
+{
+	// If timestamps aren't supported, nothing can be measured
+	if (m_QueryPool == VK_NULL_HANDLE)
+		return;
+
+	// Write the last timestamp once all commands are finished
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_QueryPool, 2 * frame + 1);
+	m_QueriesWritten[frame] = true;
+}
+
+VkExtent2D DDM3::ResolutionManager::GetRenderExtent(VkExtent2D fullExtent) const
+{
+	// Scale the width and height, at least 1 pixel is rendered
+	return VkExtent2D{
+		std::max(static_cast<uint32_t>(static_cast<float>(fullExtent.width) * m_RenderScale), 1u),
+		std::max(static_cast<uint32_t>(static_cast<float>(fullExtent.height) * m_RenderScale), 1u) };
+}
+
+void DDM3::ResolutionManager::RenderStats()
+{
+	// Add the resolution to the stats window
+	ImGui::Begin("Stats");
+	ImGui::Text("GPU time: %.2f ms", m_GpuTime);
+	ImGui::Text("Render scale: %.0f%%", m_RenderScale * 100.0f);
+	ImGui::Checkbox("Dynamic resolution", &m_Enabled);
+
+	// Only offer the sample counts the GPU supports
+	constexpr std::array<VkSampleCountFlagBits, 4> sampleCounts{ VK_SAMPLE_COUNT_1_BIT, VK_SAMPLE_COUNT_2_BIT, VK_SAMPLE_COUNT_4_BIT, VK_SAMPLE_COUNT_8_BIT };
+	constexpr std::array<const char*, 4> sampleNames{ "Off", "2x", "4x", "8x" };
+
+	if (ImGui::BeginCombo("MSAA", sampleNames[static_cast<size_t>(std::log2(static_cast<float>(m_RequestedMsaaSamples)))]))
+	{
+		for (size_t i{}; i < sampleCounts.size() && sampleCounts[i] <= m_MaxMsaaSamples; ++i)
+		{
+			if (ImGui::Selectable(sampleNames[i], sampleCounts[i] == m_RequestedMsaaSamples))
+			{
+				m_RequestedMsaaSamples = sampleCounts[i];
+			}
+		}
+		ImGui::EndCombo();
+	}
+
+	ImGui::End();
+}
+
+void DDM3::ResolutionManager::UpdateRenderScale(float gpuTime)
+{
+	// Smooth the GPU time so a single slow frame doesn't change the resolution
+	constexpr float smoothing{ 0.1f };
+	m_GpuTime = m_GpuTime == 0.0f ? gpuTime : m_GpuTime + (gpuTime - m_GpuTime) * smoothing;
+
+	// If the scale isn't adjusted, render at the fixed scale
+	if (!m_Enabled)
+	{
+		m_RenderScale = m_FixedRenderScale;
+		return;
+	}
+
+	// The GPU time scales with the amount of pixels, which is the square of the scale
+	float targetScale{ std::clamp(m_RenderScale * std::sqrt(m_FrameTimeBudget / std::max(m_GpuTime, 0.01f)), m_MinRenderScale, 1.0f) };
+
+	// Only change the scale if the difference is large enough, this keeps the resolution from changing every frame
+	constexpr float threshold{ 0.05f };
+	if (std::abs(targetScale - m_RenderScale) > threshold || (targetScale == 1.0f && m_RenderScale != 1.0f && m_GpuTime < m_FrameTimeBudget))
+	{
+		m_RenderScale = targetScale;
+	}
+}
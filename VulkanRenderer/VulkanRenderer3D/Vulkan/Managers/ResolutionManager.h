@@ -0,0 +1,111 @@
+// ResolutionManager.h
+// This class measures how long the GPU takes to render a frame and scales the resolution the scene is rendered at to stay within the frame time budget
+// It also holds the amount of samples per pixel that is requested from the stats window
+
+#ifndef ResolutionManagerIncluded
+#define ResolutionManagerIncluded
+
+// File includes
+#include "Includes/VulkanIncludes.h"
+
+// Standard library includes
+#include <vector>
+
+namespace DDM3
+{
+	// Class forward declarations
+	class GPUObject;
+
+	class ResolutionManager final
+	{
+	public:
+		// Constructor
+		// Parameters:
+		//     pGPUObject: pointer to the GPU object
+		//     msaaSamples: the amount of samples per pixel the renderer starts with
+		ResolutionManager(GPUObject* pGPUObject, VkSampleCountFlagBits msaaSamples);
+
+		// Delete default constructor
+		ResolutionManager() = delete;
+
+		// Destructor
+		~ResolutionManager();
+
+		// Delete copy and move functions
+		ResolutionManager(ResolutionManager& other) = delete;
+		ResolutionManager(ResolutionManager&& other) = delete;
+		ResolutionManager& operator=(ResolutionManager& other) = delete;
+		ResolutionManager& operator=(ResolutionManager&& other) = delete;
+
+		// Read the GPU time of the last time this frame index was rendered, update the render scale and write the first timestamp
+		// Must be called at the start of the commandbuffer, after the in flight fence of the frame was waited on
+		// Parameters:
+		//     commandBuffer: the current commandbuffer
+		//     frame: the index of the current frame
+		void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frame);
+
+		// Write the last timestamp, must be called at the end of the commandbuffer
+		// Parameters:
+		//     commandBuffer: the current commandbuffer
+		//     frame: the index of the current frame
+		void EndFrame(VkCommandBuffer commandBuffer, uint32_t frame);
+
+		// Get the part of the offscreen images the scene is rendered to
+		// Parameters:
+		//     fullExtent: the extent of the offscreen images
+		VkExtent2D GetRenderExtent(VkExtent2D fullExtent) const;
+
+		// Get the factor the width and height are scaled with
+		float GetRenderScale() const { return m_RenderScale; }
+
+		// Get the smoothed GPU time of a frame in milliseconds
+		float GetGpuTime() const { return m_GpuTime; }
+
+		// Get the amount of samples per pixel selected in the stats window
+		VkSampleCountFlagBits GetRequestedMsaaSamples() const { return m_RequestedMsaaSamples; }
+
+		// Show the resolution statistics and the MSAA selection in the stats window
+		void RenderStats();
+
+	private:
+		// The query pool with 2 timestamps per frame
+		VkQueryPool m_QueryPool{ VK_NULL_HANDLE };
+
+		// The amount of nanoseconds per timestamp tick
+		float m_TimestampPeriod{};
+
+		// Indicates if the queries of a frame were written
+		std::vector<bool> m_QueriesWritten{};
+
+		// Indicates if the render scale is adjusted, if false only the GPU time is measured
+		bool m_Enabled{ true };
+
+		// The GPU time of a frame that should not be exceeded in milliseconds
+		float m_FrameTimeBudget{ 16.6f };
+
+		// The smallest factor the width and height are scaled with
+		float m_MinRenderScale{ 0.5f };
+
+		// The factor the width and height are scaled with
+		float m_RenderScale{ 1.0f };
+
+		// The factor the width and height are scaled with while the render scale isn't adjusted
+		float m_FixedRenderScale{ 1.0f };
+
+		// The smoothed GPU time of a frame in milliseconds
+		float m_GpuTime{};
+
+		// The highest amount of samples per pixel the GPU supports
+		VkSampleCountFlagBits m_MaxMsaaSamples{ VK_SAMPLE_COUNT_1_BIT };
+
+		// The amount of samples per pixel selected in the stats window
+		VkSampleCountFlagBits m_RequestedMsaaSamples{ VK_SAMPLE_COUNT_1_BIT };
+
+		// Update the render scale with the measured GPU time
+		// Parameters:
+		//     gpuTime: the GPU time of the last frame in milliseconds
+		void UpdateRenderScale(float gpuTime);
+	};
+}
+
+#endif // !ResolutionManagerIncluded
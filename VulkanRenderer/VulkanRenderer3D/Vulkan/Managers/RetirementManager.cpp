@@ -0,0 +1,47 @@
+// RetirementManager.cpp
+
+// Header include
+#include "RetirementManager.h"
+
+// File includes
+#include "Vulkan/Vulkan3D.h"
+
+DDM3::RetirementManager::~RetirementManager()
+{
+	// Destroy the objects that are still retired
+	DestroyAll(Vulkan3D::GetInstance().GetDevice());
+}
+
+void DDM3::RetirementManager::Retire(std::function<void(VkDevice device)> destroyFunction)
+{
+	// Remember the frame, every frame up to this one might still use the objects
+	m_RetiredObjects.push_back(RetiredObjects{ std::move(destroyFunction), Vulkan3D::GetFrameCount() });
+}
+
+void DDM3::RetirementManager::DestroyRetired(VkDevice device)
+{
+	// Get the amount of frames in flight
+	auto frames{ Vulkan3D::GetMaxFrames() };
+	// Get the amount of frames that have been rendered
+	auto frameCount{ Vulkan3D::GetFrameCount() };
+
+	// Once as many frames as there are frames in flight have been rendered since retiring, the fence of the last frame that used the objects was waited on
+	while (!m_RetiredObjects.empty() && m_RetiredObjects.front().frame + frames <= frameCount)
+	{
+		// Destroy the objects
+		m_RetiredObjects.front().destroyFunction(device);
+
+		// Remove them from the retired objects
+		m_RetiredObjects.pop_front();
+	}
+}
+
+void DDM3::RetirementManager::DestroyAll(VkDevice device)
+{
+	// Destroy the objects in the order they were retired
+	for (auto& retired : m_RetiredObjects)
+	{
+		retired.destroyFunction(device);
+	}
+	m_RetiredObjects.clear();
+}
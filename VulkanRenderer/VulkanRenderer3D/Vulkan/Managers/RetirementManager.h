@@ -0,0 +1,62 @@
+// RetirementManager.h
+// This class holds vulkan objects that were replaced but might still be used by frames in flight
+// Every object is destroyed once as many frames as there are frames in flight have been rendered after it was retired
+// This replaces waiting until the device is idle when objects are recreated while rendering, like on a resize
+
+#ifndef RetirementManagerIncluded
+#define RetirementManagerIncluded
+
+// File includes
+#include "Includes/VulkanIncludes.h"
+
+// Standard library includes
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace DDM3
+{
+	class RetirementManager final
+	{
+	public:
+		// Default constructor
+		RetirementManager() = default;
+
+		// Destructor, destroys the objects that are still retired
+		~RetirementManager();
+
+		// Delete copy and move functions
+		RetirementManager(RetirementManager& other) = delete;
+		RetirementManager(RetirementManager&& other) = delete;
+		RetirementManager& operator=(RetirementManager& other) = delete;
+		RetirementManager& operator=(RetirementManager&& other) = delete;
+
+		// Retire objects, they are destroyed once the frames in flight no longer use them
+		// Parameters:
+		//     destroyFunction: the function that destroys the objects
+		void Retire(std::function<void(VkDevice device)> destroyFunction);
+
+		// Destroy the retired objects that are no longer in use, must be called after the fence of the current frame was waited on
+		// Parameters:
+		//     device: handle of the VkDevice
+		void DestroyRetired(VkDevice device);
+
+		// Destroy every retired object, the device has to be idle
+		// Parameters:
+		//     device: handle of the VkDevice
+		void DestroyAll(VkDevice device);
+
+	private:
+		// Objects that were retired, together with the frame they were retired in
+		struct RetiredObjects
+		{
+			std::function<void(VkDevice device)> destroyFunction{};
+			uint64_t frame{};
+		};
+
+		// The retired objects, ordered by the frame they were retired in
+		std::deque<RetiredObjects> m_RetiredObjects{};
+	};
+}
+
+#endif // !RetirementManagerIncluded
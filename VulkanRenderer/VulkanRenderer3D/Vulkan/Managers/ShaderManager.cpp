@@ -0,0 +1,209 @@
+// ShaderManager.cpp
+
+// Header include
+#include "ShaderManager.h"
+
+// File includes
+#include "Vulkan/Wrappers/ShaderModuleWrapper.h"
+#include "Utils/Utils.h"
+
+// Standard library includes
+#include <string_view>
+#include <stdexcept>
+
+void DDM3::ShaderManager::Cleanup(VkDevice device)
+{
+	std::lock_guard<std::mutex> lock{ m_Mutex };
+
+	// Destroy all pipeline layouts
+	for (auto& pipelineLayout : m_PipelineLayouts)
+	{
+		vkDestroyPipelineLayout(device, pipelineLayout.second, nullptr);
+	}
+	m_PipelineLayouts.clear();
+
+	// Destroy all descriptor set layouts
+	for (auto& descriptorSetLayout : m_DescriptorSetLayouts)
+	{
+		vkDestroyDescriptorSetLayout(device, descriptorSetLayout.second, nullptr);
+	}
+	m_DescriptorSetLayouts.clear();
+
+	// Destroy all shader modules, every module is in the hash map exactly once
+	for (auto& shaderModule : m_ShaderModulesByHash)
+	{
+		shaderModule.second->Cleanup(device);
+	}
+	m_ShaderModulesByHash.clear();
+	m_ShaderModules.clear();
+}
+
+std::shared_ptr<DDM3::ShaderModuleWrapper> DDM3::ShaderManager::GetShaderModule(VkDevice device, const std::string& filePath)
+{
+	// If the file was loaded before, return its module
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+
+		auto it{ m_ShaderModules.find(filePath) };
+		if (it != m_ShaderModules.end())
+		{
+			return it->second;
+		}
+	}
+
+	// Read the file, this is done without holding the lock so other threads can load their shaders meanwhile
+	auto shaderCode{ Utils::readFile(filePath) };
+
+	// Hash the code
+	size_t hash{ std::hash<std::string_view>{}(std::string_view{ shaderCode.data(), shaderCode.size() }) };
+
+	// Look for a module with the same code
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+
+		if (auto pShaderModule{ FindShaderModule(hash, shaderCode) })
+		{
+			// Use the same module for this path
+			m_ShaderModules[filePath] = pShaderModule;
+			return pShaderModule;
+		}
+	}
+
+	// Create a new module without holding the lock, this reflects the shader and creates the VkShaderModule
+	auto pShaderModule{ std::make_shared<ShaderModuleWrapper>(device, std::move(shaderCode)) };
+
+	std::lock_guard<std::mutex> lock{ m_Mutex };
+
+	// Another thread might have created a module with the same code meanwhile
+	if (auto pExistingModule{ FindShaderModule(hash, pShaderModule->GetShaderCode()) })
+	{
+		// Destroy the duplicate and use the existing module
+		pShaderModule->Cleanup(device);
+
+		m_ShaderModules[filePath] = pExistingModule;
+		return pExistingModule;
+	}
+
+	// Add the module to both maps
+	m_ShaderModules[filePath] = pShaderModule;
+	m_ShaderModulesByHash.emplace(hash, pShaderModule);
+
+	return pShaderModule;
+}
+
+std::shared_ptr<DDM3::ShaderModuleWrapper> DDM3::ShaderManager::FindShaderModule(size_t hash, const std::vector<char>& shaderCode) const
+{
+	// Compare the code of every module with the same hash
+	auto range{ m_ShaderModulesByHash.equal_range(hash) };
+	for (auto module{ range.first }; module != range.second; ++module)
+	{
+		if (module->second->GetShaderCode() == shaderCode)
+		{
+			return module->second;
+		}
+	}
+
+	// No module has the same code
+	return nullptr;
+}
+
+VkDescriptorSetLayout DDM3::ShaderManager::GetDescriptorSetLayout(VkDevice device, const std::vector<std::shared_ptr<ShaderModuleWrapper>>& shaderModules)
+{
+	// Get the bindings of all shader modules
+	std::vector<VkDescriptorSetLayoutBinding> bindings{};
+	for (auto& module : shaderModules)
+	{
+		module->AddDescriptorSetLayoutBindings(bindings);
+	}
+
+	// Create the key from the bindings
+	DescriptorSetLayoutKey key{};
+	for (auto& binding : bindings)
+	{
+		key.push_back({ binding.binding, static_cast<uint32_t>(binding.descriptorType), binding.descriptorCount, binding.stageFlags });
+	}
+
+	std::lock_guard<std::mutex> lock{ m_Mutex };
+
+	// If a layout with the same bindings exists, return it
+	auto it{ m_DescriptorSetLayouts.find(key) };
+	if (it != m_DescriptorSetLayouts.end())
+	{
+		return it->second;
+	}
+
+	// Create layout info
+	VkDescriptorSetLayoutCreateInfo layoutInfo{};
+	// Set type to descriptor set layout create info
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	// Set bindingcount to the amount of bindings
+	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+	// Set bindings to the data of bindings vector
+	layoutInfo.pBindings = bindings.data();
+
+	// Create descriptorset layout
+	VkDescriptorSetLayout descriptorSetLayout{};
+	if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS)
+	{
+		// If not successfull, throw runtime error
+		throw std::runtime_error("failed to create descriptor set layout!");
+	}
+
+	// Add the layout to the map
+	m_DescriptorSetLayouts[key] = descriptorSetLayout;
+
+	return descriptorSetLayout;
+}
+
+VkPipelineLayout DDM3::ShaderManager::GetPipelineLayout(VkDevice device, VkDescriptorSetLayout descriptorSetLayout,
+	const std::vector<std::shared_ptr<ShaderModuleWrapper>>& shaderModules)
+{
+	// Get the push constants of all shader modules
+	std::vector<VkPushConstantRange> pushConstants{};
+	for (auto& module : shaderModules)
+	{
+		module->AddPushConstants(pushConstants);
+	}
+
+	// Create the key from the descriptor set layout and the push constants
+	PipelineLayoutKey key{ descriptorSetLayout, {} };
+	for (auto& pushConstant : pushConstants)
+	{
+		key.second.push_back({ pushConstant.stageFlags, pushConstant.offset, pushConstant.size });
+	}
+
+	std::lock_guard<std::mutex> lock{ m_Mutex };
+
+	// If a layout with the same interface exists, return it
+	auto it{ m_PipelineLayouts.find(key) };
+	if (it != m_PipelineLayouts.end())
+	{
+		return it->second;
+	}
+
+	// Create pipeline layout info
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+	// Set type to pipeline layout create info
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	// Set layoutcount to 1
+	pipelineLayoutInfo.setLayoutCount = 1;
+	// Give the descriptor set layout
+	pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+	// Number of push constant ranges used by the pipeline
+	pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstants.size());
+	// Array of push constant ranges used by the pipeline
+	pipelineLayoutInfo.pPushConstantRanges = pushConstants.data();
+
+	// Create pipeline layout
+	VkPipelineLayout pipelineLayout{};
+	if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+	{
+		// If unsuccessful, throw runtime error
+		throw std::runtime_error("failed to create pipeline layout!");
+	}
+
+	// Add the layout to the map
+	m_PipelineLayouts[key] = pipelineLayout;
+
+	return pipelineLayout;
+}
@@ -0,0 +1,99 @@
+// ShaderManager.h
+// This class keeps every shader module that was loaded, together with its reflected descriptor bindings and push constants
+// Descriptor set layouts and pipeline layouts are shared between all pipelines with the same interface
+// Pipelines are created on multiple threads, so all functions are thread safe
+
+#ifndef ShaderManagerIncluded
+#define ShaderManagerIncluded
+
+// File includes
+#include "Includes/VulkanIncludes.h"
+
+// Standard library includes
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <array>
+#include <memory>
+#include <mutex>
+
+namespace DDM3
+{
+	// Class forward declarations
+	class ShaderModuleWrapper;
+
+	class ShaderManager final
+	{
+	public:
+		// Default constructor
+		ShaderManager() = default;
+
+		// Default destructor
+		~ShaderManager() = default;
+
+		// Delete copy and move functions
+		ShaderManager(ShaderManager& other) = delete;
+		ShaderManager(ShaderManager&& other) = delete;
+		ShaderManager& operator=(ShaderManager& other) = delete;
+		ShaderManager& operator=(ShaderManager&& other) = delete;
+
+		// Clean up all shader modules and layouts
+		// This isn't done in the destructor as the order of objects being deleted is very important in Vulkan
+		// Parameters:
+		//     device: handle of the VkDevice
+		void Cleanup(VkDevice device);
+
+		// Get the shader module of a file, the file is only read the first time
+		// Files with the same content share a single shader module
+		// Parameters:
+		//     device: handle of the VkDevice
+		//     filePath: path to the shader file
+		std::shared_ptr<ShaderModuleWrapper> GetShaderModule(VkDevice device, const std::string& filePath);
+
+		// Get a descriptor set layout with the bindings of the given shader modules
+		// Parameters:
+		//     device: handle of the VkDevice
+		//     shaderModules: the shader modules of the pipeline
+		VkDescriptorSetLayout GetDescriptorSetLayout(VkDevice device, const std::vector<std::shared_ptr<ShaderModuleWrapper>>& shaderModules);
+
+		// Get a pipeline layout with the given descriptor set layout and the push constants of the given shader modules
+		// Parameters:
+		//     device: handle of the VkDevice
+		//     descriptorSetLayout: the descriptor set layout of the pipeline
+		//     shaderModules: the shader modules of the pipeline
+		VkPipelineLayout GetPipelineLayout(VkDevice device, VkDescriptorSetLayout descriptorSetLayout,
+			const std::vector<std::shared_ptr<ShaderModuleWrapper>>& shaderModules);
+
+	private:
+		// Key of a descriptor set layout, binding, type, count and stage flags of every binding
+		using DescriptorSetLayoutKey = std::vector<std::array<uint32_t, 4>>;
+
+		// Key of a pipeline layout, the descriptor set layout and the stage flags, offset and size of every push constant range
+		using PipelineLayoutKey = std::pair<VkDescriptorSetLayout, std::vector<std::array<uint32_t, 3>>>;
+
+		// Mutex for all maps
+		std::mutex m_Mutex{};
+
+		// Shader modules by file path
+		std::map<std::string, std::shared_ptr<ShaderModuleWrapper>> m_ShaderModules{};
+
+		// Shader modules by hash of their code, used to share modules between files with the same content
+		std::unordered_multimap<size_t, std::shared_ptr<ShaderModuleWrapper>> m_ShaderModulesByHash{};
+
+		// Descriptor set layouts by their bindings
+		std::map<DescriptorSetLayoutKey, VkDescriptorSetLayout> m_DescriptorSetLayouts{};
+
+		// Pipeline layouts by their descriptor set layout and push constants
+		std::map<PipelineLayoutKey, VkPipelineLayout> m_PipelineLayouts{};
+
+		// Find a loaded shader module with the given code, the mutex has to be locked
+		// Returns nullptr if no module has the same code
+		// Parameters:
+		//     hash: the hash of the code
+		//     shaderCode: the binary code of the shader
+		std::shared_ptr<ShaderModuleWrapper> FindShaderModule(size_t hash, const std::vector<char>& shaderCode) const;
+	};
+}
+
+#endif // !ShaderManagerIncluded
@@ -0,0 +1,82 @@
+// DepthPrepassRenderer.cpp
+
+// Header include
+#include "DepthPrepassRenderer.h"
+
+// File includes
+#include "Vulkan/Vulkan3D.h"
+#include "Vulkan/Wrappers/PipelineWrapper.h"
+#include "Vulkan/Wrappers/DescriptorPoolWrapper.h"
+#include "Vulkan/Managers/ModelManager.h"
+#include "Engine/ConfigManager.h"
+#include "DataTypes/Camera.h"
+#include "DataTypes/Materials/Material.h"
+#include "DataTypes/RenderClasses/Model.h"
+
+DDM3::DepthPrepassRenderer::DepthPrepassRenderer(VkDevice device, ShaderManager* pShaderManager, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount, VkPipelineCache pipelineCache)
+{
+	// Only a vertex shader is needed, nothing is written to the color attachments
+	std::initializer_list<const std::string> filePaths{ ConfigManager::GetInstance().GetString("DepthPrepassVert") };
+
+	// Create the depth only pipeline
+	m_pPipeline = std::make_unique<PipelineWrapper>(device, pShaderManager, renderPass, sampleCount, filePaths, true, VK_NULL_HANDLE, true, false, pipelineCache);
+
+	// Create the camera descriptor object
+	m_pCameraDescriptorObject = std::make_unique<UboDescriptorObject<UniformBufferObject>>();
+
+	// Get pointer to the descriptorpool wrapper
+	auto descriptorPool{ m_pPipeline->GetDescriptorPool() };
+
+	// Create the descriptorsets
+	descriptorPool->CreateDescriptorSets(m_pPipeline->GetDescriptorSetLayout(), m_DescriptorSets);
+
+	// Create list of descriptor objects
+	std::vector<DescriptorObject*> descriptorObjectList{ m_pCameraDescriptorObject.get() };
+
+	// Update the descriptorsets
+	descriptorPool->UpdateDescriptorSets(m_DescriptorSets, descriptorObjectList);
+}
+
+void DDM3::DepthPrepassRenderer::RecreatePipeline(VkDevice device, ShaderManager* pShaderManager, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount, VkPipelineCache pipelineCache)
+{
+	// The descriptorsets stay valid, only the pipeline itself depends on the renderpass
+	m_pPipeline->Recreate(device, pShaderManager, renderPass, sampleCount, pipelineCache);
+}
+
+void DDM3::DepthPrepassRenderer::Render(VkCommandBuffer commandBuffer, std::vector<std::unique_ptr<Model>>& pModels)
+{
+	// Get index of current frame
+	auto frame{ Vulkan3D::GetCurrentFrame() };
+
+	// Get the view and projection matrix from the camera
+	UniformBufferObject ubo{};
+	Vulkan3D::GetInstance().GetFramePacket().camera.UpdateUniformBuffer(ubo);
+
+	// Update the camera buffer of this frame
+	m_pCameraDescriptorObject->UpdateUboBuffer(ubo, frame);
+
+	// Bind pipeline
+	m_pPipeline->BindPipeline(commandBuffer);
+
+	// Bind descriptor sets
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pPipeline->GetPipelineLayout(), 0, 1, &m_DescriptorSets[frame], 0, nullptr);
+
+	// Get the model manager to check which models passed the occlusion tests
+	auto pModelManager{ Vulkan3D::GetInstance().GetModelManager() };
+
+	for (size_t i{}; i < pModels.size(); ++i)
+	{
+		auto& pModel{ pModels[i] };
+
+		// Skip models that are occluded or aren't initialized
+		if (!pModelManager->IsVisible(i) || !pModel->IsInitialized())
+			continue;
+
+		// Alpha tested models write their own depth in the main pass
+		if (!pModel->GetMaterial()->UsesDepthPrepass())
+			continue;
+
+		// Draw the depth of the model
+		pModel->RenderDepth(commandBuffer, m_pPipeline->GetPipelineLayout());
+	}
+}
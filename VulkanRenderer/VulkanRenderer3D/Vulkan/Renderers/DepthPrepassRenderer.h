@@ -0,0 +1,75 @@
+// DepthPrepassRenderer.h
+// This class renders the depth of all opaque models at the start of the main renderpass
+// The main pipelines then only shade the fragments with exactly the depth of the pre-pass, so every pixel is shaded once
+
+#ifndef DepthPrepassRendererIncluded
+#define DepthPrepassRendererIncluded
+
+// File includes
+#include "Includes/VulkanIncludes.h"
+#include "DataTypes/Structs.h"
+#include "DataTypes/DescriptorObjects/UboDescriptorObject.h"
+
+// Standard library includes
+#include <vector>
+#include <memory>
+
+namespace DDM3
+{
+	// Class forward declarations
+	class PipelineWrapper;
+	class Model;
+	class ShaderManager;
+
+	class DepthPrepassRenderer final
+	{
+	public:
+		// Constructor
+		// Parameters:
+		//     device: handle of the VkDevice
+		//     pShaderManager: the shader manager the shader module and layouts are taken from
+		//     renderPass: the main renderpass, the pre-pass is drawn in the same subpass as the models
+		//     sampleCount: the amount of samples per pixel of the depth buffer
+		//     pipelineCache: the pipeline cache the pipeline is created with
+		DepthPrepassRenderer(VkDevice device, ShaderManager* pShaderManager, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount, VkPipelineCache pipelineCache);
+
+		// Delete default constructor
+		DepthPrepassRenderer() = delete;
+
+		// Default destructor
+		~DepthPrepassRenderer() = default;
+
+		// Delete copy and move functions
+		DepthPrepassRenderer(DepthPrepassRenderer& other) = delete;
+		DepthPrepassRenderer(DepthPrepassRenderer&& other) = delete;
+		DepthPrepassRenderer& operator=(DepthPrepassRenderer& other) = delete;
+		DepthPrepassRenderer& operator=(DepthPrepassRenderer&& other) = delete;
+
+		// Render the depth of all visible models that aren't alpha tested, must be called inside the main renderpass before the models are rendered
+		// Parameters:
+		//     commandBuffer: the commandbuffer of the current frame
+		//     pModels: all models, in the same order as the model manager
+		void Render(VkCommandBuffer commandBuffer, std::vector<std::unique_ptr<Model>>& pModels);
+
+		// Recreate the pipeline after the main renderpass was recreated with another amount of samples per pixel
+		// Parameters:
+		//     device: handle of the VkDevice
+		//     pShaderManager: the shader manager the shader module and layouts are taken from
+		//     renderPass: the new main renderpass
+		//     sampleCount: the new amount of samples per pixel of the depth buffer
+		//     pipelineCache: the pipeline cache the pipeline is created with
+		void RecreatePipeline(VkDevice device, ShaderManager* pShaderManager, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount, VkPipelineCache pipelineCache);
+
+	private:
+		// The depth only pipeline
+		std::unique_ptr<PipelineWrapper> m_pPipeline{};
+
+		// Descriptor object holding the view and projection matrix of the camera
+		std::unique_ptr<UboDescriptorObject<UniformBufferObject>> m_pCameraDescriptorObject{};
+
+		// Vector of descriptorsets, one per frame in flight
+		std::vector<VkDescriptorSet> m_DescriptorSets{};
+	};
+}
+
+#endif // !DepthPrepassRendererIncluded
@@ -0,0 +1,139 @@
+// FrameCapture.cpp
+
+// Header include
+#include "FrameCapture.h"
+
+// File includes
+#include "Includes/STBIncludes.h"
+
+#include "Vulkan/Vulkan3D.h"
+#include "Vulkan/Managers/BufferManager.h"
+#include "Vulkan/Wrappers/GPUObject.h"
+
+// Standard library includes
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+DDM3::FrameCapture::FrameCapture(GPUObject* pGPUObject, BufferManager* pBufferManager, VkExtent2D extent, const std::string& outputDirectory)
+	:m_pGPUObject{ pGPUObject },
+	m_Extent{ extent },
+	m_OutputDirectory{ outputDirectory }
+{
+	// Get handle of device
+	auto device{ m_pGPUObject->GetDevice() };
+
+	// Make sure the output directory exists
+	std::filesystem::create_directories(m_OutputDirectory);
+
+	// Get the amount of frames
+	auto frames{ Vulkan3D::GetMaxFrames() };
+
+	// 4 bytes per pixel
+	VkDeviceSize readbackSize{ static_cast<VkDeviceSize>(m_Extent.width) * m_Extent.height * 4 };
+
+	// Resize the readback vectors to the amount of frames
+	m_ReadbackBuffers.resize(frames);
+	m_ReadbackBuffersMemory.resize(frames);
+	m_ReadbackBuffersMapped.resize(frames);
+	m_PendingFrameNumbers.assign(frames, UINT64_MAX);
+
+	// Create and map a readback buffer per frame
+	for (uint32_t i{}; i < frames; ++i)
+	{
+		pBufferManager->CreateBuffer(m_pGPUObject, readbackSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_ReadbackBuffers[i], m_ReadbackBuffersMemory[i]);
+
+		vkMapMemory(device, m_ReadbackBuffersMemory[i], 0, readbackSize, 0, &m_ReadbackBuffersMapped[i]);
+	}
+}
+
+DDM3::FrameCapture::~FrameCapture()
+{
+	// Get handle of device
+	auto device{ m_pGPUObject->GetDevice() };
+
+	// Destroy the readback buffers
+	for (size_t i{}; i < m_ReadbackBuffers.size(); ++i)
+	{
+		vkDestroyBuffer(device, m_ReadbackBuffers[i], nullptr);
+		vkFreeMemory(device, m_ReadbackBuffersMemory[i], nullptr);
+	}
+}
+
+void DDM3::FrameCapture::Record(VkCommandBuffer commandBuffer, VkImage image, uint32_t frame)
+{
+	// The renderpass leaves the image in transfer src layout, wait until it is written before copying
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	// Copy the whole image to the readback buffer of this frame
+	VkBufferImageCopy region{};
+	region.bufferOffset = 0;
+	region.bufferRowLength = 0;
+	region.bufferImageHeight = 0;
+	region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+	region.imageOffset = { 0, 0, 0 };
+	region.imageExtent = { m_Extent.width, m_Extent.height, 1 };
+
+	vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_ReadbackBuffers[frame], 1, &region);
+
+	// Make the copy visible to the host
+	VkBufferMemoryBarrier bufferBarrier{};
+	bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.buffer = m_ReadbackBuffers[frame];
+	bufferBarrier.offset = 0;
+	bufferBarrier.size = VK_WHOLE_SIZE;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+		0, 0, nullptr, 1, &bufferBarrier, 0, nullptr);
+
+	// Remember which frame is captured
+	m_PendingFrameNumbers[frame] = Vulkan3D::GetFrameCount();
+}
+
+void DDM3::FrameCapture::Save(uint32_t frame)
+{
+	// If there is no capture waiting, there is nothing to write
+	if (m_PendingFrameNumbers[frame] == UINT64_MAX)
+		return;
+
+	// Name the file after the number of the frame
+	char fileName[32]{};
+	std::snprintf(fileName, sizeof(fileName), "Frame%06llu.png", static_cast<unsigned long long>(m_PendingFrameNumbers[frame]));
+	std::string filePath{ (std::filesystem::path{ m_OutputDirectory } / fileName).string() };
+
+	// Write the pixels, the rows are tightly packed
+	int width{ static_cast<int>(m_Extent.width) };
+	if (stbi_write_png(filePath.c_str(), width, static_cast<int>(m_Extent.height), 4, m_ReadbackBuffersMapped[frame], width * 4) == 0)
+	{
+		std::cout << "Failed to write " << filePath << "\n";
+	}
+
+	// The capture is written
+	m_PendingFrameNumbers[frame] = UINT64_MAX;
+}
+
+void DDM3::FrameCapture::SaveAll()
+{
+	// Write the captures of every frame
+	for (uint32_t frame{}; frame < static_cast<uint32_t>(m_PendingFrameNumbers.size()); ++frame)
+	{
+		Save(frame);
+	}
+}
@@ -0,0 +1,82 @@
+// FrameCapture.h
+// This class copies the final image of a frame to the CPU and writes it to a PNG file, used in headless mode
+// The copy is recorded at the end of the commandbuffer and written to disk the next time the same frame index is rendered, so the CPU never waits on the GPU
+
+#ifndef FrameCaptureIncluded
+#define FrameCaptureIncluded
+
+// File includes
+#include "Includes/VulkanIncludes.h"
+
+// Standard library includes
+#include <string>
+#include <vector>
+
+namespace DDM3
+{
+	// Class forward declarations
+	class GPUObject;
+	class BufferManager;
+
+	class FrameCapture final
+	{
+	public:
+		// Constructor
+		// Parameters:
+		//     pGPUObject: pointer to the GPU object
+		//     pBufferManager: pointer to the buffer manager
+		//     extent: the extent of the captured images
+		//     outputDirectory: the directory the PNG files are written to
+		FrameCapture(GPUObject* pGPUObject, BufferManager* pBufferManager, VkExtent2D extent, const std::string& outputDirectory);
+
+		// Delete default constructor
+		FrameCapture() = delete;
+
+		// Destructor
+		~FrameCapture();
+
+		// Delete copy and move functions
+		FrameCapture(FrameCapture& other) = delete;
+		FrameCapture(FrameCapture&& other) = delete;
+		FrameCapture& operator=(FrameCapture& other) = delete;
+		FrameCapture& operator=(FrameCapture&& other) = delete;
+
+		// Record the copy of the image to the readback buffer of this frame, must be called after the image is in transfer src layout
+		// Parameters:
+		//     commandBuffer: the current commandbuffer
+		//     image: the image that is captured, 4 bytes per pixel in RGBA order
+		//     frame: the index of the current frame
+		void Record(VkCommandBuffer commandBuffer, VkImage image, uint32_t frame);
+
+		// Write the readback buffer of a frame to a file if it holds a capture
+		// Must be called after the in flight fence of the frame was waited on
+		// Parameters:
+		//     frame: the index of the frame
+		void Save(uint32_t frame);
+
+		// Write all captures that weren't written yet, the device must be idle
+		void SaveAll();
+
+	private:
+		// Pointer to the GPU object
+		GPUObject* m_pGPUObject{};
+
+		// The extent of the captured images
+		VkExtent2D m_Extent{};
+
+		// The directory the files are written to
+		std::string m_OutputDirectory{};
+
+		// Readback buffer per frame
+		std::vector<VkBuffer> m_ReadbackBuffers{};
+		// Memory of the readback buffers
+		std::vector<VkDeviceMemory> m_ReadbackBuffersMemory{};
+		// Pointers to the mapped readback buffers
+		std::vector<void*> m_ReadbackBuffersMapped{};
+
+		// The number of the frame captured in every readback buffer, UINT64_MAX if there is no capture waiting to be written
+		std::vector<uint64_t> m_PendingFrameNumbers{};
+	};
+}
+
+#endif // !FrameCaptureIncluded
@@ -0,0 +1,599 @@
+// HiZRenderer.cpp
+
+// Header include
+#include "HiZRenderer.h"
+
+// File includes
+#include "Includes/ImGuiIncludes.h"
+
+#include "Engine/ConfigManager.h"
+
+#include "Vulkan/Vulkan3D.h"
+#include "Vulkan/Managers/BufferManager.h"
+#include "Vulkan/Managers/ImageManager.h"
+#include "Vulkan/Managers/RetirementManager.h"
+#include "Vulkan/Wrappers/GPUObject.h"
+#include "Vulkan/Wrappers/ShaderModuleWrapper.h"
+
+// Standard library includes
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+
+DDM3::HiZRenderer::HiZRenderer(GPUObject* pGPUObject, ImageManager* pImageManager, BufferManager* pBufferManager,
+	VkExtent2D extent, VkImageView depthImageView, VkSampleCountFlagBits msaaSamples, VkPipelineCache pipelineCache)
+	:m_pGPUObject{ pGPUObject },
+	m_pImageManager{ pImageManager },
+	m_pBufferManager{ pBufferManager },
+	m_MsaaSamples{ msaaSamples },
+	m_PipelineCache{ pipelineCache },
+	m_Extent{ extent }
+{
+	// Get config manager
+	auto& configManager{ ConfigManager::GetInstance() };
+
+	// Create the sampler for the depth buffer
+	CreateSampler();
+
+	// A multisampled depth buffer needs a different shader to be read
+	const std::string depthShader{ m_MsaaSamples == VK_SAMPLE_COUNT_1_BIT ?
+		configManager.GetString("HiZDepthComp") : configManager.GetString("HiZDepthMSComp") };
+
+	// Create the compute pipelines
+	CreatePipeline(depthShader, m_DepthSetLayout, m_DepthPipelineLayout, m_DepthPipeline);
+	CreatePipeline(configManager.GetString("HiZDownsampleComp"), m_DownsampleSetLayout, m_DownsamplePipelineLayout, m_DownsamplePipeline);
+
+	// Create the depth pyramid and the readback buffers
+	CreateSizeDependentResources(depthImageView);
+}
+
+DDM3::HiZRenderer::~HiZRenderer()
+{
+	// Get handle of device
+	auto device{ m_pGPUObject->GetDevice() };
+
+	// Destroy the resources that depend on the size
+	CleanupSizeDependentResources();
+
+	// Destroy the pipelines
+	vkDestroyPipeline(device, m_DepthPipeline, nullptr);
+	vkDestroyPipelineLayout(device, m_DepthPipelineLayout, nullptr);
+	vkDestroyDescriptorSetLayout(device, m_DepthSetLayout, nullptr);
+
+	vkDestroyPipeline(device, m_DownsamplePipeline, nullptr);
+	vkDestroyPipelineLayout(device, m_DownsamplePipelineLayout, nullptr);
+	vkDestroyDescriptorSetLayout(device, m_DownsampleSetLayout, nullptr);
+
+	// Destroy the sampler
+	vkDestroySampler(device, m_DepthSampler, nullptr);
+}
+
+void DDM3::HiZRenderer::Resize(VkExtent2D extent, VkImageView depthImageView, RetirementManager* pRetirementManager)
+{
+	// Set the new extent
+	m_Extent = extent;
+
+	// Retire the old depth pyramid, the frames in flight still build it and copy it to their readback buffer
+	pRetirementManager->Retire([descriptorPool = m_DescriptorPool, levelViews = m_LevelViews, pyramid = m_Pyramid,
+		readbackBuffers = m_ReadbackBuffers, readbackBuffersMemory = m_ReadbackBuffersMemory](VkDevice device) mutable
+		{
+			vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+
+			for (auto levelView : levelViews)
+			{
+				vkDestroyImageView(device, levelView, nullptr);
+			}
+
+			pyramid.Cleanup(device);
+
+			for (size_t i{}; i < readbackBuffers.size(); ++i)
+			{
+				vkDestroyBuffer(device, readbackBuffers[i], nullptr);
+				vkFreeMemory(device, readbackBuffersMemory[i], nullptr);
+			}
+		});
+
+	// Forget the old resources, they are owned by the retirement manager now
+	m_DescriptorPool = VK_NULL_HANDLE;
+	m_DescriptorSets.clear();
+	m_LevelViews.clear();
+	m_LevelSizes.clear();
+	m_Pyramid = Texture{};
+	m_ReadbackBuffers.clear();
+	m_ReadbackBuffersMemory.clear();
+	m_ReadbackBuffersMapped.clear();
+	m_ReadbackValid.clear();
+
+	// Create the new depth pyramid, the old readbacks are no longer usable
+	CreateSizeDependentResources(depthImageView);
+}
+
+void DDM3::HiZRenderer::BeginFrame(uint32_t frame)
+{
+	// Reset the statistics
+	m_Stats = OcclusionStats{};
+
+	// If this frame index hasn't built a depth pyramid yet, nothing can be culled
+	if (!m_ReadbackValid[frame])
+	{
+		m_pCurrentDepth = nullptr;
+		return;
+	}
+
+	// The fence of this frame was waited on, so the readback buffer holds the depth pyramid of the last time this frame index was rendered
+	m_pCurrentDepth = static_cast<const float*>(m_ReadbackBuffersMapped[frame]);
+	m_CurrentViewProjection = m_ViewProjections[frame];
+	m_CurrentRenderExtent = m_RenderExtents[frame];
+}
+
+bool DDM3::HiZRenderer::IsOccluded(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& transform)
+{
+	// Count the test
+	++m_Stats.testedCount;
+
+	// If there is no depth pyramid, the model is visible
+	if (m_pCurrentDepth == nullptr)
+		return false;
+
+	// Transform from local space to the clip space of the frame the depth was rendered in
+	glm::mat4 modelViewProjection{ m_CurrentViewProjection * transform };
+
+	// Initialize the screen bounds
+	glm::vec2 ndcMin{ FLT_MAX, FLT_MAX };
+	glm::vec2 ndcMax{ -FLT_MAX, -FLT_MAX };
+	float nearestDepth{ FLT_MAX };
+
+	// Project all 8 corners of the bounding box
+	for (int i{}; i < 8; ++i)
+	{
+		// Pick the minimum or maximum for every axis
+		glm::vec3 corner{ (i & 1) ? boundsMax.x : boundsMin.x, (i & 2) ? boundsMax.y : boundsMin.y, (i & 4) ? boundsMax.z : boundsMin.z };
+
+		glm::vec4 clip{ modelViewProjection * glm::vec4(corner, 1.0f) };
+
+		// If a corner is behind the camera, the box crosses the near plane and is treated as visible
+		if (clip.w <= FLT_EPSILON)
+			return false;
+
+		// Get normalized device coordinates
+		glm::vec3 ndc{ glm::vec3(clip) / clip.w };
+
+		ndcMin = glm::min(ndcMin, glm::vec2(ndc));
+		ndcMax = glm::max(ndcMax, glm::vec2(ndc));
+		nearestDepth = std::min(nearestDepth, ndc.z);
+	}
+
+	// Boxes outside of the screen or in front of the near plane are left to the rasterizer
+	if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f || nearestDepth < 0.0f)
+		return false;
+
+	// Get the smallest level and its size
+	const auto& levelSize{ m_LevelSizes.back() };
+	const int width{ static_cast<int>(levelSize.width) };
+	const int height{ static_cast<int>(levelSize.height) };
+
+	// Every texel of level n covers 2^(n+1) pixels in both directions
+	const float pixelsPerTexel{ static_cast<float>(1u << m_LevelSizes.size()) };
+
+	// Convert the screen bounds to texels of the smallest level
+	auto toTexel = [pixelsPerTexel](float ndc, uint32_t extent, int size)
+		{
+			float pixel{ (ndc * 0.5f + 0.5f) * static_cast<float>(extent) };
+			return std::clamp(static_cast<int>(std::floor(pixel / pixelsPerTexel)), 0, size - 1);
+		};
+
+	// Only the rendered part of the depth buffer is mapped to the screen
+	int minX{ toTexel(ndcMin.x, m_CurrentRenderExtent.width, width) };
+	int maxX{ toTexel(ndcMax.x, m_CurrentRenderExtent.width, width) };
+	int minY{ toTexel(ndcMin.y, m_CurrentRenderExtent.height, height) };
+	int maxY{ toTexel(ndcMax.y, m_CurrentRenderExtent.height, height) };
+
+	// Get the farthest depth covered by the box
+	float farthestDepth{ 0.0f };
+	for (int y{ minY }; y <= maxY; ++y)
+	{
+		for (int x{ minX }; x <= maxX; ++x)
+		{
+			farthestDepth = std::max(farthestDepth, m_pCurrentDepth[y * width + x]);
+		}
+	}
+
+	// If the nearest point of the box is behind everything that was drawn there, the box is occluded
+	if (nearestDepth > farthestDepth)
+	{
+		++m_Stats.occludedCount;
+		return true;
+	}
+
+	return false;
+}
+
+void DDM3::HiZRenderer::Build(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection, VkExtent2D renderExtent, uint32_t frame)
+{
+	// Every level is rewritten, so the old contents can be discarded
+	// The readback of the previous frame still has to finish before the pyramid is written
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = m_Pyramid.image;
+	barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, m_Pyramid.mipLevels, 0, 1 };
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	// Build every level
+	for (size_t level{}; level < m_LevelSizes.size(); ++level)
+	{
+		// The first level reads from the depth buffer, the others read from the level above
+		bool isFirstLevel{ level == 0 };
+
+		if (!isFirstLevel)
+		{
+			// Wait until the level above is written
+			VkImageMemoryBarrier levelBarrier{};
+			levelBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+			levelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			levelBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+			levelBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+			levelBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			levelBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			levelBarrier.image = m_Pyramid.image;
+			levelBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, static_cast<uint32_t>(level - 1), 1, 0, 1 };
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				0, 0, nullptr, 0, nullptr, 1, &levelBarrier);
+		}
+
+		// Get the pipeline for this level
+		VkPipeline pipeline{ isFirstLevel ? m_DepthPipeline : m_DownsamplePipeline };
+		VkPipelineLayout pipelineLayout{ isFirstLevel ? m_DepthPipelineLayout : m_DownsamplePipelineLayout };
+
+		// Get the size of the source and the destination, the first level clamps to the rendered part of the depth buffer
+		VkExtent2D srcSize{ isFirstLevel ? renderExtent : m_LevelSizes[level - 1] };
+		VkExtent2D dstSize{ m_LevelSizes[level] };
+
+		// Source and destination size as push constants
+		std::array<int32_t, 4> pushConstants{ static_cast<int32_t>(srcSize.width), static_cast<int32_t>(srcSize.height),
+			static_cast<int32_t>(dstSize.width), static_cast<int32_t>(dstSize.height) };
+
+		// Bind the pipeline and the descriptorset of this level
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &m_DescriptorSets[level], 0, nullptr);
+		vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), pushConstants.data());
+
+		// Dispatch a thread per texel, the shaders use groups of 8x8
+		vkCmdDispatch(commandBuffer, (dstSize.width + 7) / 8, (dstSize.height + 7) / 8, 1);
+	}
+
+	// Wait until the smallest level is written before copying it
+	barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+	barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, m_Pyramid.mipLevels - 1, 1, 0, 1 };
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	// Copy the smallest level to the readback buffer of this frame
+	VkBufferImageCopy region{};
+	region.bufferOffset = 0;
+	region.bufferRowLength = 0;
+	region.bufferImageHeight = 0;
+	region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, m_Pyramid.mipLevels - 1, 0, 1 };
+	region.imageOffset = { 0, 0, 0 };
+	region.imageExtent = { m_LevelSizes.back().width, m_LevelSizes.back().height, 1 };
+
+	vkCmdCopyImageToBuffer(commandBuffer, m_Pyramid.image, VK_IMAGE_LAYOUT_GENERAL, m_ReadbackBuffers[frame], 1, &region);
+
+	// Make the copy visible to the host
+	VkBufferMemoryBarrier bufferBarrier{};
+	bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.buffer = m_ReadbackBuffers[frame];
+	bufferBarrier.offset = 0;
+	bufferBarrier.size = VK_WHOLE_SIZE;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+		0, 0, nullptr, 1, &bufferBarrier, 0, nullptr);
+
+	// Remember the matrix and the extent the depth was rendered with
+	m_ViewProjections[frame] = viewProjection;
+	m_RenderExtents[frame] = renderExtent;
+	m_ReadbackValid[frame] = true;
+}
+
+void DDM3::HiZRenderer::RenderStats() const
+{
+	// Add the occlusion counters to the stats window
+	ImGui::Begin("Stats");
+	ImGui::Text("Occlusion tested: %u", m_Stats.testedCount);
+	ImGui::Text("Occlusion visible: %u", m_Stats.testedCount - m_Stats.occludedCount);
+	ImGui::Text("Occlusion culled: %u", m_Stats.occludedCount);
+	ImGui::End();
+}
+
+void DDM3::HiZRenderer::CreateSampler()
+{
+	// Create sampler create info
+	VkSamplerCreateInfo samplerInfo{};
+	// Set type to sampler create info
+	samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	// Depth is read with texelFetch, so no filtering is needed
+	samplerInfo.magFilter = VK_FILTER_NEAREST;
+	samplerInfo.minFilter = VK_FILTER_NEAREST;
+	samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	// Clamp to the edge of the image
+	samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	// Set max lod to 0
+	samplerInfo.maxLod = 0.0f;
+
+	// Create the sampler, if unsuccessful, throw runtime error
+	if (vkCreateSampler(m_pGPUObject->GetDevice(), &samplerInfo, nullptr, &m_DepthSampler) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create depth pyramid sampler!");
+	}
+}
+
+void DDM3::HiZRenderer::CreatePipeline(const std::string& filePath, VkDescriptorSetLayout& descriptorSetLayout, VkPipelineLayout& pipelineLayout, VkPipeline& pipeline)
+{
+	// Get handle of device
+	auto device{ m_pGPUObject->GetDevice() };
+
+	// Load the shader, the bindings and push constants are read from the shader code
+	ShaderModuleWrapper shaderModule{ device, filePath };
+
+	// Get the descriptor set layout bindings
+	std::vector<VkDescriptorSetLayoutBinding> bindings{};
+	shaderModule.AddDescriptorSetLayoutBindings(bindings);
+
+	// Create descriptor set layout create info
+	VkDescriptorSetLayoutCreateInfo layoutInfo{};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+	layoutInfo.pBindings = bindings.data();
+
+	// Create the descriptor set layout, if unsuccessful, throw runtime error
+	if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create depth pyramid descriptor set layout!");
+	}
+
+	// Get the push constants
+	std::vector<VkPushConstantRange> pushConstants{};
+	shaderModule.AddPushConstants(pushConstants);
+
+	// Create pipeline layout create info
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 1;
+	pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+	pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstants.size());
+	pipelineLayoutInfo.pPushConstantRanges = pushConstants.data();
+
+	// Create the pipeline layout, if unsuccessful, throw runtime error
+	if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create depth pyramid pipeline layout!");
+	}
+
+	// Create compute pipeline create info
+	VkComputePipelineCreateInfo pipelineInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineInfo.stage = shaderModule.GetShaderStageCreateInfo();
+	pipelineInfo.layout = pipelineLayout;
+
+	// Create the pipeline, if unsuccessful, throw runtime error
+	if (vkCreateComputePipelines(device, m_PipelineCache, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create depth pyramid pipeline!");
+	}
+
+	// The shader module is no longer needed
+	shaderModule.Cleanup(device);
+}
+
+void DDM3::HiZRenderer::CreateSizeDependentResources(VkImageView depthImageView)
+{
+	// Get handle of device
+	auto device{ m_pGPUObject->GetDevice() };
+
+	// Calculate the size of every level, halving until the level is small enough to be read back
+	VkExtent2D levelSize{ m_Extent };
+	do
+	{
+		levelSize.width = std::max((levelSize.width + 1) / 2, 1u);
+		levelSize.height = std::max((levelSize.height + 1) / 2, 1u);
+
+		m_LevelSizes.push_back(levelSize);
+	} while (std::max(levelSize.width, levelSize.height) > m_MaxReadbackSize);
+
+	// Create the pyramid image with a mip level per pyramid level
+	m_Pyramid.mipLevels = static_cast<uint32_t>(m_LevelSizes.size());
+	m_pImageManager->CreateImage(m_pGPUObject, m_LevelSizes[0].width, m_LevelSizes[0].height, m_Pyramid.mipLevels, VK_SAMPLE_COUNT_1_BIT,
+		VK_FORMAT_R32_SFLOAT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_Pyramid);
+
+	// Create an image view per level
+	for (uint32_t level{}; level < m_Pyramid.mipLevels; ++level)
+	{
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = m_Pyramid.image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = VK_FORMAT_R32_SFLOAT;
+		viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1 };
+
+		VkImageView levelView{};
+		if (vkCreateImageView(device, &viewInfo, nullptr, &levelView) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create depth pyramid image view!");
+		}
+
+		m_LevelViews.push_back(levelView);
+	}
+
+	// Create the descriptorsets
+	CreateDescriptorSets(depthImageView);
+
+	// Get the amount of frames
+	auto frames{ Vulkan3D::GetMaxFrames() };
+
+	// Get the size of the smallest level in bytes
+	VkDeviceSize readbackSize{ static_cast<VkDeviceSize>(m_LevelSizes.back().width) * m_LevelSizes.back().height * sizeof(float) };
+
+	// Resize the readback vectors to the amount of frames
+	m_ReadbackBuffers.resize(frames);
+	m_ReadbackBuffersMemory.resize(frames);
+	m_ReadbackBuffersMapped.resize(frames);
+	m_ReadbackValid.assign(frames, false);
+	m_ViewProjections.resize(frames);
+	m_RenderExtents.resize(frames);
+
+	// Create and map a readback buffer per frame
+	for (uint32_t i{}; i < frames; ++i)
+	{
+		m_pBufferManager->CreateBuffer(m_pGPUObject, readbackSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_ReadbackBuffers[i], m_ReadbackBuffersMemory[i]);
+
+		vkMapMemory(device, m_ReadbackBuffersMemory[i], 0, readbackSize, 0, &m_ReadbackBuffersMapped[i]);
+	}
+
+	// There is no usable depth yet
+	m_pCurrentDepth = nullptr;
+}
+
+void DDM3::HiZRenderer::CreateDescriptorSets(VkImageView depthImageView)
+{
+	// Get handle of device
+	auto device{ m_pGPUObject->GetDevice() };
+
+	// Get the amount of levels
+	auto levelCount{ static_cast<uint32_t>(m_LevelSizes.size()) };
+
+	// One sampler for the depth buffer and two storage images for every level
+	std::array<VkDescriptorPoolSize, 2> poolSizes{};
+	poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	poolSizes[0].descriptorCount = 1;
+	poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+	poolSizes[1].descriptorCount = 2 * levelCount;
+
+	// Create descriptor pool create info
+	VkDescriptorPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+	poolInfo.pPoolSizes = poolSizes.data();
+	poolInfo.maxSets = levelCount;
+
+	// Create the descriptor pool, if unsuccessful, throw runtime error
+	if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_DescriptorPool) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create depth pyramid descriptor pool!");
+	}
+
+	// The first level uses the depth layout, the others the downsample layout
+	std::vector<VkDescriptorSetLayout> layouts(levelCount, m_DownsampleSetLayout);
+	layouts[0] = m_DepthSetLayout;
+
+	// Create descriptor set allocate info
+	VkDescriptorSetAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = m_DescriptorPool;
+	allocInfo.descriptorSetCount = levelCount;
+	allocInfo.pSetLayouts = layouts.data();
+
+	// Allocate the descriptorsets, if unsuccessful, throw runtime error
+	m_DescriptorSets.resize(levelCount);
+	if (vkAllocateDescriptorSets(device, &allocInfo, m_DescriptorSets.data()) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to allocate depth pyramid descriptor sets!");
+	}
+
+	// Image infos, kept alive until the descriptorsets are updated
+	std::vector<VkDescriptorImageInfo> srcInfos(levelCount);
+	std::vector<VkDescriptorImageInfo> dstInfos(levelCount);
+	std::vector<VkWriteDescriptorSet> descriptorWrites(2 * levelCount);
+
+	for (uint32_t level{}; level < levelCount; ++level)
+	{
+		// The first level reads the depth buffer, the others read the level above
+		if (level == 0)
+		{
+			srcInfos[level] = { m_DepthSampler, depthImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+		}
+		else
+		{
+			srcInfos[level] = { VK_NULL_HANDLE, m_LevelViews[level - 1], VK_IMAGE_LAYOUT_GENERAL };
+		}
+
+		// Every level writes to its own view
+		dstInfos[level] = { VK_NULL_HANDLE, m_LevelViews[level], VK_IMAGE_LAYOUT_GENERAL };
+
+		// Source at binding 0
+		auto& srcWrite{ descriptorWrites[2 * level] };
+		srcWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		srcWrite.dstSet = m_DescriptorSets[level];
+		srcWrite.dstBinding = 0;
+		srcWrite.descriptorCount = 1;
+		srcWrite.descriptorType = level == 0 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		srcWrite.pImageInfo = &srcInfos[level];
+
+		// Destination at binding 1
+		auto& dstWrite{ descriptorWrites[2 * level + 1] };
+		dstWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		dstWrite.dstSet = m_DescriptorSets[level];
+		dstWrite.dstBinding = 1;
+		dstWrite.descriptorCount = 1;
+		dstWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		dstWrite.pImageInfo = &dstInfos[level];
+	}
+
+	// Update the descriptorsets
+	vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+}
+
+void DDM3::HiZRenderer::CleanupSizeDependentResources()
+{
+	// Get handle of device
+	auto device{ m_pGPUObject->GetDevice() };
+
+	// Destroy the descriptor pool, this frees the descriptorsets
+	vkDestroyDescriptorPool(device, m_DescriptorPool, nullptr);
+	m_DescriptorPool = VK_NULL_HANDLE;
+	m_DescriptorSets.clear();
+
+	// Destroy the image views of the levels
+	for (auto& levelView : m_LevelViews)
+	{
+		vkDestroyImageView(device, levelView, nullptr);
+	}
+	m_LevelViews.clear();
+	m_LevelSizes.clear();
+
+	// Destroy the pyramid
+	m_Pyramid.Cleanup(device);
+
+	// Destroy the readback buffers
+	for (size_t i{}; i < m_ReadbackBuffers.size(); ++i)
+	{
+		vkDestroyBuffer(device, m_ReadbackBuffers[i], nullptr);
+		vkFreeMemory(device, m_ReadbackBuffersMemory[i], nullptr);
+	}
+	m_ReadbackBuffers.clear();
+	m_ReadbackBuffersMemory.clear();
+	m_ReadbackBuffersMapped.clear();
+	m_ReadbackValid.clear();
+}
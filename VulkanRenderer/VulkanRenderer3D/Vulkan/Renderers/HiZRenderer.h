@@ -0,0 +1,185 @@
+// HiZRenderer.h
+// This class builds a hierarchical depth pyramid from the depth buffer after the main renderpass
+// The smallest level is read back to the CPU and used the next time the same frame index is rendered to test if models are occluded
+
+#ifndef HiZRendererIncluded
+#define HiZRendererIncluded
+
+// File includes
+#include "Includes/VulkanIncludes.h"
+#include "Includes/GLMIncludes.h"
+#include "DataTypes/Structs.h"
+
+// Standard library includes
+#include <vector>
+#include <string>
+
+namespace DDM3
+{
+	// Class forward declarations
+	class GPUObject;
+	class ImageManager;
+	class BufferManager;
+	class RetirementManager;
+
+	class HiZRenderer final
+	{
+	public:
+		// Constructor
+		// Parameters:
+		//     pGPUObject: pointer to the GPU object
+		//     pImageManager: pointer to the image manager
+		//     pBufferManager: pointer to the buffer manager
+		//     extent: the extent of the depth buffer
+		//     depthImageView: the image view of the depth buffer
+		//     msaaSamples: the amount of samples per pixel of the depth buffer
+		//     pipelineCache: the pipeline cache the compute pipelines are created with
+		HiZRenderer(GPUObject* pGPUObject, ImageManager* pImageManager, BufferManager* pBufferManager,
+			VkExtent2D extent, VkImageView depthImageView, VkSampleCountFlagBits msaaSamples, VkPipelineCache pipelineCache);
+
+		// Delete default constructor
+		HiZRenderer() = delete;
+
+		// Destructor
+		~HiZRenderer();
+
+		// Delete copy and move functions
+		HiZRenderer(HiZRenderer& other) = delete;
+		HiZRenderer(HiZRenderer&& other) = delete;
+		HiZRenderer& operator=(HiZRenderer& other) = delete;
+		HiZRenderer& operator=(HiZRenderer&& other) = delete;
+
+		// Recreate the depth pyramid after the depth buffer was recreated, the old one is retired
+		// Parameters:
+		//     extent: the new extent of the depth buffer
+		//     depthImageView: the image view of the new depth buffer
+		//     pRetirementManager: pointer to the retirement manager, the old resources are destroyed once the frames in flight finished
+		void Resize(VkExtent2D extent, VkImageView depthImageView, RetirementManager* pRetirementManager);
+
+		// Prepare the occlusion tests for the current frame, must be called after the in flight fence of the frame was waited on
+		// Parameters:
+		//     frame: the index of the current frame
+		void BeginFrame(uint32_t frame);
+
+		// Test if a bounding box is hidden behind the depth of a previous frame
+		// Returns false if there is no depth pyramid yet or the bounding box crosses the near plane
+		// Parameters:
+		//     boundsMin: minimum corner of the bounding box in local space
+		//     boundsMax: maximum corner of the bounding box in local space
+		//     transform: the model matrix
+		bool IsOccluded(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& transform);
+
+		// Record the commands that build the depth pyramid and read back the smallest level, must be called after the main renderpass
+		// The render graph transitions the depth buffer so it can be sampled
+		// Parameters:
+		//     commandBuffer: the current commandbuffer
+		//     viewProjection: the view projection matrix used to render the depth buffer
+		//     renderExtent: the part of the depth buffer that was rendered to
+		//     frame: the index of the current frame
+		void Build(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection, VkExtent2D renderExtent, uint32_t frame);
+
+		// Get the occlusion statistics of the current frame
+		const OcclusionStats& GetStats() const { return m_Stats; }
+
+		// Show the occlusion statistics in the stats window
+		void RenderStats() const;
+
+	private:
+		// Pointer to the GPU object
+		GPUObject* m_pGPUObject{};
+		// Pointer to the image manager
+		ImageManager* m_pImageManager{};
+		// Pointer to the buffer manager
+		BufferManager* m_pBufferManager{};
+
+		// The amount of samples per pixel of the depth buffer
+		VkSampleCountFlagBits m_MsaaSamples{ VK_SAMPLE_COUNT_1_BIT };
+
+		// The pipeline cache the compute pipelines are created with
+		VkPipelineCache m_PipelineCache{ VK_NULL_HANDLE };
+
+		// The extent of the depth buffer
+		VkExtent2D m_Extent{};
+
+		// The largest width or height the smallest level may have, this level is read back to the CPU
+		const uint32_t m_MaxReadbackSize{ 128 };
+
+		// The depth pyramid, every level holds the farthest depth of 2x2 texels of the level above
+		Texture m_Pyramid{};
+		// Image view per level
+		std::vector<VkImageView> m_LevelViews{};
+		// Size of every level
+		std::vector<VkExtent2D> m_LevelSizes{};
+
+		// Sampler used to read the depth buffer
+		VkSampler m_DepthSampler{ VK_NULL_HANDLE };
+
+		// Descriptor set layout of the pipeline reading the depth buffer
+		VkDescriptorSetLayout m_DepthSetLayout{ VK_NULL_HANDLE };
+		// Pipeline layout of the pipeline reading the depth buffer
+		VkPipelineLayout m_DepthPipelineLayout{ VK_NULL_HANDLE };
+		// Pipeline that builds the first level from the depth buffer
+		VkPipeline m_DepthPipeline{ VK_NULL_HANDLE };
+
+		// Descriptor set layout of the downsample pipeline
+		VkDescriptorSetLayout m_DownsampleSetLayout{ VK_NULL_HANDLE };
+		// Pipeline layout of the downsample pipeline
+		VkPipelineLayout m_DownsamplePipelineLayout{ VK_NULL_HANDLE };
+		// Pipeline that builds a level from the level above
+		VkPipeline m_DownsamplePipeline{ VK_NULL_HANDLE };
+
+		// Descriptor pool for the descriptorsets of every level
+		VkDescriptorPool m_DescriptorPool{ VK_NULL_HANDLE };
+		// Descriptorset per level, the first one reads from the depth buffer
+		std::vector<VkDescriptorSet> m_DescriptorSets{};
+
+		// Readback buffer per frame
+		std::vector<VkBuffer> m_ReadbackBuffers{};
+		// Memory of the readback buffers
+		std::vector<VkDeviceMemory> m_ReadbackBuffersMemory{};
+		// Pointers to the mapped readback buffers
+		std::vector<void*> m_ReadbackBuffersMapped{};
+		// Indicates if the readback buffer of a frame holds a depth pyramid
+		std::vector<bool> m_ReadbackValid{};
+		// The view projection matrix used to render the depth of every readback buffer
+		std::vector<glm::mat4> m_ViewProjections{};
+		// The part of the depth buffer that was rendered to for every readback buffer
+		std::vector<VkExtent2D> m_RenderExtents{};
+
+		// The depth of the smallest level read back for the current frame, nullptr if there is none
+		const float* m_pCurrentDepth{ nullptr };
+		// The view projection matrix belonging to the current depth
+		glm::mat4 m_CurrentViewProjection{};
+		// The render extent belonging to the current depth
+		VkExtent2D m_CurrentRenderExtent{};
+
+		// Occlusion statistics of the current frame
+		OcclusionStats m_Stats{};
+
+		// Create the sampler used to read the depth buffer
+		void CreateSampler();
+
+		// Create a compute pipeline from a shader file
+		// Parameters:
+		//     filePath: the path to the compute shader
+		//     descriptorSetLayout: the layout that will be created
+		//     pipelineLayout: the pipeline layout that will be created
+		//     pipeline: the pipeline that will be created
+		void CreatePipeline(const std::string& filePath, VkDescriptorSetLayout& descriptorSetLayout, VkPipelineLayout& pipelineLayout, VkPipeline& pipeline);
+
+		// Create the depth pyramid, the descriptorsets and the readback buffers for the current extent
+		// Parameters:
+		//     depthImageView: the image view of the depth buffer
+		void CreateSizeDependentResources(VkImageView depthImageView);
+
+		// Create the descriptorsets of every level
+		// Parameters:
+		//     depthImageView: the image view of the depth buffer
+		void CreateDescriptorSets(VkImageView depthImageView);
+
+		// Destroy the depth pyramid, the descriptorsets and the readback buffers
+		void CleanupSizeDependentResources();
+	};
+}
+
+#endif // !HiZRendererIncluded
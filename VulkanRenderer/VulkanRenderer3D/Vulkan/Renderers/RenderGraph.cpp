@@ -0,0 +1,469 @@
+// RenderGraph.cpp
+
+// Header include
+#include "RenderGraph.h"
+
+// File includes
+#include "Vulkan/Vulkan3D.h"
+#include "Vulkan/VulkanUtils.h"
+#include "Vulkan/Managers/GPUProfiler.h"
+#include "Vulkan/Wrappers/GPUObject.h"
+
+// Standard library includes
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+DDM3::RenderGraph::~RenderGraph()
+{
+	Cleanup(Vulkan3D::GetInstance().GetDevice());
+}
+
+void DDM3::RenderGraph::Cleanup(VkDevice device)
+{
+	// Destroy the transient images, imported images are destroyed by their owner
+	for (auto& image : m_Images)
+	{
+		if (!image.isTransient)
+			continue;
+
+		vkDestroyImageView(device, image.imageView, nullptr);
+		vkDestroyImage(device, image.image, nullptr);
+
+		image.imageView = VK_NULL_HANDLE;
+		image.image = VK_NULL_HANDLE;
+	}
+
+	// Free the memory of the transient images
+	for (auto& memoryBlock : m_MemoryBlocks)
+	{
+		vkFreeMemory(device, memoryBlock.memory, nullptr);
+	}
+	m_MemoryBlocks.clear();
+}
+
+DDM3::RenderGraph::ResourceHandle DDM3::RenderGraph::ImportImage(const std::string& name, VkImage image, VkImageAspectFlags aspectMask, VkImageLayout layout)
+{
+	ImageResource resource{};
+	resource.name = name;
+	resource.image = image;
+	resource.aspectMask = aspectMask;
+	resource.layout = layout;
+
+	m_Images.push_back(resource);
+
+	return static_cast<ResourceHandle>(m_Images.size() - 1);
+}
+
+DDM3::RenderGraph::ResourceHandle DDM3::RenderGraph::CreateTransientImage(const std::string& name, VkFormat format, VkExtent2D extent,
+	VkSampleCountFlagBits samples, VkImageUsageFlags usage, VkImageAspectFlags aspectMask)
+{
+	ImageResource resource{};
+	resource.name = name;
+	resource.format = format;
+	resource.extent = extent;
+	resource.samples = samples;
+	resource.usage = usage;
+	resource.aspectMask = aspectMask;
+	resource.isTransient = true;
+
+	m_Images.push_back(resource);
+
+	return static_cast<ResourceHandle>(m_Images.size() - 1);
+}
+
+DDM3::RenderGraph::PassHandle DDM3::RenderGraph::AddPass(const std::string& name, std::function<void(VkCommandBuffer)> execute, bool hasSideEffects)
+{
+	Pass pass{};
+	pass.name = name;
+	pass.execute = std::move(execute);
+	pass.hasSideEffects = hasSideEffects;
+
+	m_Passes.push_back(std::move(pass));
+
+	return static_cast<PassHandle>(m_Passes.size() - 1);
+}
+
+void DDM3::RenderGraph::UseImage(PassHandle pass, ResourceHandle image, VkPipelineStageFlags stageMask, VkAccessFlags accessMask,
+	VkImageLayout layout, VkImageLayout finalLayout)
+{
+	m_Passes[pass].uses.push_back(ImageUse{ image, stageMask, accessMask, layout, finalLayout });
+}
+
+void DDM3::RenderGraph::Compile(GPUObject* pGPUObject)
+{
+	// Cull the passes nobody needs
+	CullPasses();
+
+	// Find the first and last pass that use every image
+	for (uint32_t passIndex{}; passIndex < m_Passes.size(); ++passIndex)
+	{
+		if (m_Passes[passIndex].isCulled)
+			continue;
+
+		for (auto& use : m_Passes[passIndex].uses)
+		{
+			auto& image{ m_Images[use.image] };
+			image.firstPass = std::min(image.firstPass, passIndex);
+			image.lastPass = std::max(image.lastPass, passIndex);
+		}
+	}
+
+	// Create the transient images
+	CreateTransientImages(pGPUObject);
+}
+
+void DDM3::RenderGraph::CullPasses()
+{
+	// Indicates for every image if a later pass reads its current contents
+	std::vector<bool> isRead(m_Images.size(), false);
+
+	// Walk back from the last pass, a pass is needed if it has side effects or writes an image a needed pass reads
+	for (auto pass{ m_Passes.rbegin() }; pass != m_Passes.rend(); ++pass)
+	{
+		bool isNeeded{ pass->hasSideEffects };
+
+		for (auto& use : pass->uses)
+		{
+			if ((use.accessMask & m_sWriteAccessMask) && isRead[use.image])
+			{
+				isNeeded = true;
+			}
+		}
+
+		pass->isCulled = !isNeeded;
+
+		if (!isNeeded)
+			continue;
+
+		for (auto& use : pass->uses)
+		{
+			// An image that is only written is overwritten, earlier passes don't have to write it
+			bool isWrittenOnly{ (use.accessMask & ~m_sWriteAccessMask) == 0 };
+
+			isRead[use.image] = !isWrittenOnly;
+		}
+	}
+}
+
+void DDM3::RenderGraph::CreateTransientImages(GPUObject* pGPUObject)
+{
+	auto device{ pGPUObject->GetDevice() };
+
+	// The memory requirements of every image
+	std::vector<VkMemoryRequirements> memoryRequirements(m_Images.size());
+
+	// The transient images that are used
+	std::vector<ResourceHandle> transientImages{};
+
+	for (ResourceHandle handle{}; handle < m_Images.size(); ++handle)
+	{
+		auto& image{ m_Images[handle] };
+
+		// Images of culled passes aren't created
+		if (!image.isTransient || image.firstPass == UINT32_MAX)
+			continue;
+
+		// Create image create info
+		VkImageCreateInfo imageInfo{};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.extent = { image.extent.width, image.extent.height, 1 };
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.format = image.format;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		imageInfo.usage = image.usage;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageInfo.samples = image.samples;
+
+		// Create the image, the memory is bound later
+		if (vkCreateImage(device, &imageInfo, nullptr, &image.image) != VK_SUCCESS)
+		{
+			// If unsuccessful, throw runtime error
+			throw std::runtime_error("failed to create transient image!");
+		}
+
+		vkGetImageMemoryRequirements(device, image.image, &memoryRequirements[handle]);
+
+		transientImages.push_back(handle);
+	}
+
+	// Place the largest images first, smaller images can then share their memory
+	std::sort(transientImages.begin(), transientImages.end(), [&](ResourceHandle a, ResourceHandle b)
+		{
+			return memoryRequirements[a].size > memoryRequirements[b].size;
+		});
+
+	for (auto handle : transientImages)
+	{
+		auto& image{ m_Images[handle] };
+		const auto& requirements{ memoryRequirements[handle] };
+
+		// Find a block with a compatible memory type whose images are never used at the same time as this image
+		for (uint32_t blockIndex{}; blockIndex < m_MemoryBlocks.size(); ++blockIndex)
+		{
+			auto& memoryBlock{ m_MemoryBlocks[blockIndex] };
+
+			if ((memoryBlock.memoryTypeBits & requirements.memoryTypeBits) == 0)
+				continue;
+
+			bool overlaps{ std::any_of(memoryBlock.images.begin(), memoryBlock.images.end(), [&](ResourceHandle other)
+				{
+					return image.firstPass <= m_Images[other].lastPass && m_Images[other].firstPass <= image.lastPass;
+				}) };
+
+			if (overlaps)
+				continue;
+
+			memoryBlock.memoryTypeBits &= requirements.memoryTypeBits;
+			image.memoryBlock = blockIndex;
+			break;
+		}
+
+		// Create a new block if no block can be shared
+		if (image.memoryBlock == UINT32_MAX)
+		{
+			m_MemoryBlocks.emplace_back();
+			m_MemoryBlocks.back().memoryTypeBits = requirements.memoryTypeBits;
+			image.memoryBlock = static_cast<uint32_t>(m_MemoryBlocks.size() - 1);
+		}
+
+		// Add the image to the block
+		auto& memoryBlock{ m_MemoryBlocks[image.memoryBlock] };
+		memoryBlock.images.push_back(handle);
+		memoryBlock.size = std::max(memoryBlock.size, requirements.size);
+		memoryBlock.isTransientAttachment = memoryBlock.isTransientAttachment && (image.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT);
+	}
+
+	for (auto& memoryBlock : m_MemoryBlocks)
+	{
+		// Create allocation info
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = memoryBlock.size;
+
+		// Memory of transient attachments doesn't have to be backed on tiled GPUs, use lazily allocated memory if there is any
+		try
+		{
+			VkMemoryPropertyFlags properties{ VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+			if (memoryBlock.isTransientAttachment)
+			{
+				properties |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+			}
+
+			allocInfo.memoryTypeIndex = VulkanUtils::FindMemoryType(memoryBlock.memoryTypeBits, properties);
+		}
+		catch (const std::runtime_error&)
+		{
+			allocInfo.memoryTypeIndex = VulkanUtils::FindMemoryType(memoryBlock.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		}
+
+		// Allocate the memory
+		if (vkAllocateMemory(device, &allocInfo, nullptr, &memoryBlock.memory) != VK_SUCCESS)
+		{
+			// If unsuccessful, throw runtime error
+			throw std::runtime_error("failed to allocate transient image memory!");
+		}
+
+		// Bind every image of the block to the start of the memory
+		for (auto handle : memoryBlock.images)
+		{
+			vkBindImageMemory(device, m_Images[handle].image, memoryBlock.memory, 0);
+		}
+	}
+
+	// Create the image views, the views only show the depth of depth stencil images
+	for (auto handle : transientImages)
+	{
+		auto& image{ m_Images[handle] };
+
+		// Create image view create info
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = image.image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = image.format;
+		viewInfo.subresourceRange = { image.aspectMask & ~VK_IMAGE_ASPECT_STENCIL_BIT, 0, 1, 0, 1 };
+
+		// Create the image view
+		if (vkCreateImageView(device, &viewInfo, nullptr, &image.imageView) != VK_SUCCESS)
+		{
+			// If unsuccessful, throw runtime error
+			throw std::runtime_error("failed to create transient image view!");
+		}
+	}
+}
+
+void DDM3::RenderGraph::Execute(VkCommandBuffer commandBuffer, GPUProfiler* pProfiler)
+{
+	m_BarrierCount = 0;
+
+	// The barriers of a pass are reused for every pass
+	std::vector<VkImageMemoryBarrier> imageBarriers{};
+
+	for (auto& pass : m_Passes)
+	{
+		if (pass.isCulled)
+			continue;
+
+		// Gather the barriers of all images the pass uses
+		imageBarriers.clear();
+		VkMemoryBarrier memoryBarrier{};
+		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		VkPipelineStageFlags srcStageMask{};
+		VkPipelineStageFlags dstStageMask{};
+
+		for (auto& use : pass.uses)
+		{
+			AddBarrier(use, imageBarriers, memoryBarrier, srcStageMask, dstStageMask);
+		}
+
+		// Record all barriers of the pass at once
+		if (dstStageMask != 0)
+		{
+			// Nothing happened before the first use of an image in this command buffer
+			if (srcStageMask == 0)
+			{
+				srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			}
+
+			// Only add the memory barrier if it makes something visible
+			bool hasMemoryBarrier{ memoryBarrier.srcAccessMask != 0 };
+
+			vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0,
+				hasMemoryBarrier ? 1 : 0, hasMemoryBarrier ? &memoryBarrier : nullptr,
+				0, nullptr,
+				static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+
+			++m_BarrierCount;
+		}
+
+		// Record the pass, the barriers in front of it aren't part of its time
+		{
+			GPUProfiler::ScopedMarker marker{ pProfiler, commandBuffer, pass.name };
+			pass.execute(commandBuffer);
+		}
+
+		// Renderpasses can leave images in another layout
+		for (auto& use : pass.uses)
+		{
+			if (use.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED)
+			{
+				m_Images[use.image].layout = use.finalLayout;
+			}
+		}
+	}
+}
+
+void DDM3::RenderGraph::AddBarrier(const ImageUse& use, std::vector<VkImageMemoryBarrier>& imageBarriers, VkMemoryBarrier& memoryBarrier,
+	VkPipelineStageFlags& srcStageMask, VkPipelineStageFlags& dstStageMask)
+{
+	auto& image{ m_Images[use.image] };
+
+	// If the memory of the image was used by another image, its contents and layout are gone
+	// The image has to wait until the other image is done with the memory
+	if (image.isTransient)
+	{
+		auto& memoryBlock{ m_MemoryBlocks[image.memoryBlock] };
+
+		if (memoryBlock.owner != use.image)
+		{
+			if (memoryBlock.owner != UINT32_MAX)
+			{
+				const auto& previousImage{ m_Images[memoryBlock.owner] };
+				image.writeStageMask = previousImage.writeStageMask | previousImage.readStageMask;
+				image.writeAccessMask = previousImage.writeAccessMask;
+			}
+
+			image.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+			image.readStageMask = 0;
+			image.visibleStageMask = 0;
+			memoryBlock.owner = use.image;
+		}
+	}
+
+	bool isWrite{ (use.accessMask & m_sWriteAccessMask) != 0 };
+	bool isRead{ (use.accessMask & ~m_sWriteAccessMask) != 0 };
+
+	if (use.layout != VK_IMAGE_LAYOUT_UNDEFINED && use.layout != image.layout)
+	{
+		// The layout has to change, wait for all earlier reads and writes
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = image.writeAccessMask;
+		barrier.dstAccessMask = use.accessMask;
+		barrier.oldLayout = image.layout;
+		barrier.newLayout = use.layout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image.image;
+		barrier.subresourceRange = { image.aspectMask, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+
+		imageBarriers.push_back(barrier);
+		srcStageMask |= image.writeStageMask | image.readStageMask;
+		dstStageMask |= use.stageMask;
+
+		// The layout transition is a write that is visible to this use
+		image.layout = use.layout;
+		image.writeStageMask = use.stageMask;
+		image.writeAccessMask = 0;
+		image.readStageMask = 0;
+		image.visibleStageMask = use.stageMask;
+	}
+	else if (isWrite && (image.writeStageMask | image.readStageMask) != 0)
+	{
+		// Writes have to wait for all earlier reads and writes
+		memoryBarrier.srcAccessMask |= image.writeAccessMask;
+		memoryBarrier.dstAccessMask |= use.accessMask;
+		srcStageMask |= image.writeStageMask | image.readStageMask;
+		dstStageMask |= use.stageMask;
+	}
+	else if (isRead && image.writeStageMask != 0 && (use.stageMask & ~image.visibleStageMask) != 0)
+	{
+		// Reads have to wait for the last write, unless it is already visible to these stages
+		memoryBarrier.srcAccessMask |= image.writeAccessMask;
+		memoryBarrier.dstAccessMask |= use.accessMask;
+		srcStageMask |= image.writeStageMask;
+		dstStageMask |= use.stageMask;
+		image.visibleStageMask |= use.stageMask;
+	}
+
+	// Remember how the image was used
+	if (isWrite)
+	{
+		image.writeStageMask = use.stageMask;
+		image.writeAccessMask = use.accessMask & m_sWriteAccessMask;
+		image.readStageMask = 0;
+		image.visibleStageMask = 0;
+	}
+	else
+	{
+		image.readStageMask |= use.stageMask;
+	}
+}
+
+void DDM3::RenderGraph::LogStatistics() const
+{
+	// Log the passes that were culled
+	for (auto& pass : m_Passes)
+	{
+		if (pass.isCulled)
+		{
+			std::cout << "Render graph: culled pass " << pass.name << "\n";
+		}
+	}
+
+	// Add up the memory of all blocks
+	VkDeviceSize blockMemory{};
+	size_t transientCount{};
+	for (auto& memoryBlock : m_MemoryBlocks)
+	{
+		blockMemory += memoryBlock.size;
+		transientCount += memoryBlock.images.size();
+	}
+
+	std::cout << "Render graph: " << transientCount << " transient images share " << m_MemoryBlocks.size() << " memory blocks of "
+		<< blockMemory / 1024 << " KB in total, " << m_BarrierCount << " barriers in the last frame\n";
+}
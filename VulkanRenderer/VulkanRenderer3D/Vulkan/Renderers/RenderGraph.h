@@ -0,0 +1,234 @@
+// RenderGraph.h
+// This class orders the passes of a frame and synchronizes them
+// Passes declare which images they use and how, the graph culls passes whose results aren't used and records the barriers between passes
+// Transient images are owned by the graph, images whose lifetimes don't overlap share the same memory
+
+#ifndef RenderGraphIncluded
+#define RenderGraphIncluded
+
+// File includes
+#include "Includes/VulkanIncludes.h"
+
+// Standard library includes
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace DDM3
+{
+	// Class forward declarations
+	class GPUObject;
+	class GPUProfiler;
+
+	class RenderGraph final
+	{
+	public:
+		// Handle of an image in the render graph
+		using ResourceHandle = uint32_t;
+
+		// Handle of a pass in the render graph
+		using PassHandle = uint32_t;
+
+		// Default constructor
+		RenderGraph() = default;
+
+		// Destructor
+		~RenderGraph();
+
+		// Delete copy and move functions
+		RenderGraph(RenderGraph& other) = delete;
+		RenderGraph(RenderGraph&& other) = delete;
+		RenderGraph& operator=(RenderGraph& other) = delete;
+		RenderGraph& operator=(RenderGraph&& other) = delete;
+
+		// Add an image that is owned by someone else
+		// Parameters:
+		//     name: the name of the image, used in the statistics
+		//     image: handle of the VkImage
+		//     aspectMask: the aspects of the image
+		//     layout: the layout the image is in before the first frame
+		ResourceHandle ImportImage(const std::string& name, VkImage image, VkImageAspectFlags aspectMask, VkImageLayout layout);
+
+		// Add an image that is created by the graph when it is compiled
+		// Parameters:
+		//     name: the name of the image, used in the statistics
+		//     format: the format of the image
+		//     extent: the size of the image
+		//     samples: the amount of samples per pixel
+		//     usage: the usage flags of the image
+		//     aspectMask: the aspects of the image
+		ResourceHandle CreateTransientImage(const std::string& name, VkFormat format, VkExtent2D extent, VkSampleCountFlagBits samples,
+			VkImageUsageFlags usage, VkImageAspectFlags aspectMask);
+
+		// Add a pass, passes are executed in the order they are added
+		// Parameters:
+		//     name: the name of the pass, used in the statistics
+		//     execute: function that records the commands of the pass
+		//     hasSideEffects: boolean that indicates if the pass does more than write images of the graph, these passes are never culled
+		PassHandle AddPass(const std::string& name, std::function<void(VkCommandBuffer)> execute, bool hasSideEffects = false);
+
+		// Declare that a pass uses an image
+		// The access mask decides if the image is read, written or both
+		// Parameters:
+		//     pass: the pass that uses the image
+		//     image: the image that is used
+		//     stageMask: the pipeline stages the image is used in
+		//     accessMask: the way the image is accessed
+		//     layout: the layout the image has to be in, undefined if the pass discards the contents and handles the layout itself
+		//     finalLayout: the layout a renderpass leaves the image in, undefined if it stays in layout
+		void UseImage(PassHandle pass, ResourceHandle image, VkPipelineStageFlags stageMask, VkAccessFlags accessMask,
+			VkImageLayout layout, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED);
+
+		// Cull unused passes and create the transient images
+		// Parameters:
+		//     pGPUObject: pointer to the GPU object
+		void Compile(GPUObject* pGPUObject);
+
+		// Record all passes that weren't culled, with a single batched barrier in front of every pass that needs one
+		// Parameters:
+		//     commandBuffer: the current commandbuffer
+		//     pProfiler: pointer to the GPU profiler every pass is measured with, nullptr if the passes aren't measured
+		void Execute(VkCommandBuffer commandBuffer, GPUProfiler* pProfiler = nullptr);
+
+		// Get the image of a resource
+		// Parameters:
+		//     image: handle of the image
+		VkImage GetImage(ResourceHandle image) const { return m_Images[image].image; }
+
+		// Get the image view of a transient image
+		// Parameters:
+		//     image: handle of the image
+		VkImageView GetImageView(ResourceHandle image) const { return m_Images[image].imageView; }
+
+		// Log the culled passes and the memory the transient images share
+		void LogStatistics() const;
+
+		// Clean up the transient images and their memory
+		// This isn't done in the destructor as the order of objects being deleted is very important in Vulkan
+		// Parameters:
+		//     device: handle of the VkDevice
+		void Cleanup(VkDevice device);
+
+	private:
+		// An image in the graph
+		struct ImageResource
+		{
+			// The name of the image
+			std::string name{};
+			// Handle of the image
+			VkImage image{ VK_NULL_HANDLE };
+			// Handle of the image view, only for transient images
+			VkImageView imageView{ VK_NULL_HANDLE };
+			// The format of the image
+			VkFormat format{};
+			// The size of the image
+			VkExtent2D extent{};
+			// The amount of samples per pixel
+			VkSampleCountFlagBits samples{ VK_SAMPLE_COUNT_1_BIT };
+			// The usage flags of the image
+			VkImageUsageFlags usage{};
+			// The aspects of the image
+			VkImageAspectFlags aspectMask{};
+			// Indicates if the image is created by the graph
+			bool isTransient{ false };
+			// The first and last pass that use the image, after culling
+			uint32_t firstPass{ UINT32_MAX };
+			uint32_t lastPass{};
+			// The memory block the image is bound to, only for transient images
+			uint32_t memoryBlock{ UINT32_MAX };
+
+			// The current layout of the image
+			VkImageLayout layout{ VK_IMAGE_LAYOUT_UNDEFINED };
+			// The stages and accesses of the last write, a layout transition counts as a write
+			VkPipelineStageFlags writeStageMask{};
+			VkAccessFlags writeAccessMask{};
+			// The stages that read the image since the last write
+			VkPipelineStageFlags readStageMask{};
+			// The stages the last write is visible to
+			VkPipelineStageFlags visibleStageMask{};
+		};
+
+		// The way a pass uses an image
+		struct ImageUse
+		{
+			// The image that is used
+			ResourceHandle image{};
+			// The pipeline stages the image is used in
+			VkPipelineStageFlags stageMask{};
+			// The way the image is accessed
+			VkAccessFlags accessMask{};
+			// The layout the image has to be in
+			VkImageLayout layout{ VK_IMAGE_LAYOUT_UNDEFINED };
+			// The layout the pass leaves the image in
+			VkImageLayout finalLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
+		};
+
+		// A pass in the graph
+		struct Pass
+		{
+			// The name of the pass
+			std::string name{};
+			// Function that records the commands of the pass
+			std::function<void(VkCommandBuffer)> execute{};
+			// Indicates if the pass is never culled
+			bool hasSideEffects{ false };
+			// The images the pass uses
+			std::vector<ImageUse> uses{};
+			// Indicates if the results of the pass aren't used
+			bool isCulled{ false };
+		};
+
+		// Memory shared by transient images that are never used at the same time
+		struct MemoryBlock
+		{
+			// Handle of the memory
+			VkDeviceMemory memory{ VK_NULL_HANDLE };
+			// The size of the memory
+			VkDeviceSize size{};
+			// The memory types all images in the block support
+			uint32_t memoryTypeBits{};
+			// Indicates if only transient attachments use the block, the memory can then be lazily allocated
+			bool isTransientAttachment{ true };
+			// The images bound to the block
+			std::vector<ResourceHandle> images{};
+			// The image that used the block last
+			ResourceHandle owner{ UINT32_MAX };
+		};
+
+		// All accesses that write
+		static constexpr VkAccessFlags m_sWriteAccessMask{ VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+			VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT };
+
+		// All images
+		std::vector<ImageResource> m_Images{};
+
+		// All passes in order of execution
+		std::vector<Pass> m_Passes{};
+
+		// The memory blocks of the transient images
+		std::vector<MemoryBlock> m_MemoryBlocks{};
+
+		// The amount of barriers recorded in the last frame
+		uint32_t m_BarrierCount{};
+
+		// Cull the passes whose results are never read
+		void CullPasses();
+
+		// Create the transient images and bind images whose lifetimes don't overlap to the same memory
+		// Parameters:
+		//     pGPUObject: pointer to the GPU object
+		void CreateTransientImages(GPUObject* pGPUObject);
+
+		// Add the barrier an image needs before it is used to the batch of the pass
+		// Parameters:
+		//     use: the way the pass uses the image
+		//     imageBarriers: the image barriers of the pass, layout transitions are added here
+		//     memoryBarrier: the global memory barrier of the pass, other hazards are added here
+		//     srcStageMask: the source stages of the batch
+		//     dstStageMask: the destination stages of the batch
+		void AddBarrier(const ImageUse& use, std::vector<VkImageMemoryBarrier>& imageBarriers, VkMemoryBarrier& memoryBarrier,
+			VkPipelineStageFlags& srcStageMask, VkPipelineStageFlags& dstStageMask);
+	};
+}
+
+#endif // !RenderGraphIncluded
@@ -11,10 +11,22 @@
 #include "DataTypes/DirectionalLightObject.h"
 #include "DataTypes/RenderClasses/Model.h"
 #include "Vulkan/Wrappers/Viewport.h"
+#include "DataTypes/RenderClasses/Mesh.h"
+
+// Standard library includes
+#include <algorithm>
+#include <cfloat>
 
 DDM3::ShadowRenderer::ShadowRenderer()
 	:m_ShadowMapSize{static_cast<uint16_t>(ConfigManager::GetInstance().GetInt("ShadowMapSize"))}
 {
+	// Get the amount of cascades, the same clamp is used by the global light
+	m_CascadeCount = static_cast<uint32_t>(std::clamp(ConfigManager::GetInstance().GetInt("ShadowCascadeCount"), 1, static_cast<int>(ShadowCascadesStruct::maxCascades)));
+
+	// No cascade has been rendered yet
+	m_RenderedCascadeHashes.resize(m_CascadeCount);
+	m_CascadeValid.resize(m_CascadeCount);
+
 	// Set amount of samples
 	m_MsaaSamples = VK_SAMPLE_COUNT_1_BIT;
 
@@ -42,7 +54,17 @@ void DDM3::ShadowRenderer::Cleanup(VkDevice device)
 
 	vkDestroyRenderPass(device, m_ShadowRenderpass, nullptr);
 
-	vkDestroyFramebuffer(device, m_ShadowFrameBuffer, nullptr);
+	// Destroy the framebuffers
+	for (auto& frameBuffer : m_ShadowFrameBuffers)
+	{
+		vkDestroyFramebuffer(device, frameBuffer, nullptr);
+	}
+
+	// Destroy the image views of the single layers, the array view is destroyed with the texture
+	for (auto& imageView : m_CascadeImageViews)
+	{
+		vkDestroyImageView(device, imageView, nullptr);
+	}
 }
 
 void DDM3::ShadowRenderer::CreateDepthImage()
@@ -58,7 +80,7 @@ void DDM3::ShadowRenderer::CreateDepthImage()
 	imageInfo.extent.height = m_ShadowMapSize;
 	imageInfo.extent.depth = 1;
 	imageInfo.mipLevels = 1;
-	imageInfo.arrayLayers = 1;
+	imageInfo.arrayLayers = m_CascadeCount;
 	imageInfo.format = VulkanUtils::FindDepthFormat();
 	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
 	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -79,33 +101,51 @@ void DDM3::ShadowRenderer::CreateDepthImage()
 	vkAllocateMemory(device, &allocInfo, nullptr, &m_ShadowTexture.imageMemory);
 	vkBindImageMemory(device, m_ShadowTexture.image, m_ShadowTexture.imageMemory, 0);
 
-	// Create ImageView for depth attachment
+	// Create ImageView of all layers for sampling in the shaders
 	VkImageViewCreateInfo viewInfo = {};
 	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
 	viewInfo.image = m_ShadowTexture.image;
-	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
 	viewInfo.format = VulkanUtils::FindDepthFormat();
 	viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
 	viewInfo.subresourceRange.baseMipLevel = 0;
 	viewInfo.subresourceRange.levelCount = 1;
 	viewInfo.subresourceRange.baseArrayLayer = 0;
-	viewInfo.subresourceRange.layerCount = 1;
+	viewInfo.subresourceRange.layerCount = m_CascadeCount;
 
 	vkCreateImageView(device, &viewInfo, nullptr, &m_ShadowTexture.imageView);
+
+	// Create an ImageView per layer for the depth attachments
+	m_CascadeImageViews.resize(m_CascadeCount);
+	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	viewInfo.subresourceRange.layerCount = 1;
+
+	for (uint32_t cascade{}; cascade < m_CascadeCount; ++cascade)
+	{
+		viewInfo.subresourceRange.baseArrayLayer = cascade;
+
+		vkCreateImageView(device, &viewInfo, nullptr, &m_CascadeImageViews[cascade]);
+	}
 }
 
 void DDM3::ShadowRenderer::CreateFramebuffers(VkDevice device)
 {
-	VkFramebufferCreateInfo framebufferInfo = {};
-	framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-	framebufferInfo.renderPass = m_ShadowRenderpass; // Render pass created in the next step
-	framebufferInfo.attachmentCount = 1;
-	framebufferInfo.pAttachments = &m_ShadowTexture.imageView;
-	framebufferInfo.width = m_ShadowMapSize;
-	framebufferInfo.height = m_ShadowMapSize;
-	framebufferInfo.layers = 1;
-
-	vkCreateFramebuffer(device, &framebufferInfo, nullptr, &m_ShadowFrameBuffer);
+	// Create a framebuffer per cascade, each one renders into a single layer
+	m_ShadowFrameBuffers.resize(m_CascadeCount);
+
+	for (uint32_t cascade{}; cascade < m_CascadeCount; ++cascade)
+	{
+		VkFramebufferCreateInfo framebufferInfo = {};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = m_ShadowRenderpass;
+		framebufferInfo.attachmentCount = 1;
+		framebufferInfo.pAttachments = &m_CascadeImageViews[cascade];
+		framebufferInfo.width = m_ShadowMapSize;
+		framebufferInfo.height = m_ShadowMapSize;
+		framebufferInfo.layers = 1;
+
+		vkCreateFramebuffer(device, &framebufferInfo, nullptr, &m_ShadowFrameBuffers[cascade]);
+	}
 }
 
 void DDM3::ShadowRenderer::CreateRenderPass(VkDevice device)
@@ -199,16 +239,16 @@ void DDM3::ShadowRenderer::RecreateFrameBuffer()
 
 }
 
-void DDM3::ShadowRenderer::CreatePipeline(VkDevice device)
+void DDM3::ShadowRenderer::CreatePipeline(VkDevice device, ShaderManager* pShaderManager, VkPipelineCache pipelineCache)
 {
 
 	auto& configManager{ ConfigManager::GetInstance() };
 
-	std::initializer_list<const std::string> filePaths{ configManager.GetString("ShadowVertName"),
-		configManager.GetString("ShadowFragName") };
+	// Only a vertex shader is needed, the renderpass has no color attachments
+	std::initializer_list<const std::string> filePaths{ configManager.GetString("ShadowVertName") };
 
 	m_pShadowPipeline = std::make_unique<DDM3::PipelineWrapper>
-		(device, m_ShadowRenderpass, m_MsaaSamples, filePaths);
+		(device, pShaderManager, m_ShadowRenderpass, m_MsaaSamples, filePaths, true, VK_NULL_HANDLE, true, false, pipelineCache);
 
 
 	m_pShadowTextureObject = std::make_unique<TextureDescriptorObject>(m_ShadowTexture);
@@ -237,30 +277,156 @@ void DDM3::ShadowRenderer::Render(std::vector<std::unique_ptr<Model>>& pModels)
 
 	m_pViewport->SetViewport(commandBuffer);
 
+	// Get the light transforms of the cascades
+	const auto& cascades{ renderer.GetGlobalLight()->GetCascades() };
+
+	// A bit for every cascade that has to be rendered again
+	uint8_t dirtyCascades{};
+
+	// Cascades that moved or were never rendered are dirty
+	for (uint32_t cascade{}; cascade < m_CascadeCount; ++cascade)
+	{
+		size_t cascadeHash{ std::hash<glm::mat4>()(cascades.transforms[cascade]) };
+
+		if (!m_CascadeValid[cascade] || m_RenderedCascadeHashes[cascade] != cascadeHash)
+		{
+			dirtyCascades |= static_cast<uint8_t>(1 << cascade);
+		}
+
+		// Remember what this cascade is rendered with
+		m_RenderedCascadeHashes[cascade] = cascadeHash;
+	}
+
+	// Get the frame packet that is being rendered
+	auto& framePacket{ Vulkan3D::GetInstance().GetFramePacket() };
+
+	// Check if any transform changed, if not the per model checks can be skipped
+	bool transformsChanged{ framePacket.anyTransformChanged };
+
+	// If models were added or removed, a reused transform id might still hold the bits of a removed model
+	// Forget every cached bit and render every cascade again
+	if (pModels.size() != m_CasterModelCount)
+	{
+		dirtyCascades = static_cast<uint8_t>((1 << m_CascadeCount) - 1);
+		m_CasterCascades.assign(framePacket.worldMatrices.size(), uint8_t{});
+		m_CasterModelCount = pModels.size();
+	}
+
+	// The bits are stored per transform id, new transforms haven't been rendered into any cascade yet
+	m_CasterCascades.resize(framePacket.worldMatrices.size());
+
+	for (size_t i{}; i < pModels.size(); ++i)
+	{
+		auto& pModel{ pModels[i] };
+
+		// Get the cached bits of this model
+		auto& previousCascades{ m_CasterCascades[pModel->GetTransformId()] };
+
+		// Find the cascades the caster overlaps
+		uint8_t casterCascades{};
+		if (pModel->CastsShadow())
+		{
+			for (uint32_t cascade{}; cascade < m_CascadeCount; ++cascade)
+			{
+				if (IsInCascade(pModel.get(), cascades.transforms[cascade]))
+				{
+					casterCascades |= static_cast<uint8_t>(1 << cascade);
+				}
+			}
+		}
+
+		// A caster that entered or left a cascade changes its depth
+		dirtyCascades |= casterCascades ^ previousCascades;
+
+		// A caster that moved changes the depth of the cascades it was and is in
+		if (transformsChanged && pModel->HasTransformChanged())
+		{
+			dirtyCascades |= casterCascades | previousCascades;
+		}
+
+		previousCascades = casterCascades;
+	}
+
 	VkClearValue clearValue = {};
 	clearValue.depthStencil = { 1.0f, 0 };
 
-	VkRenderPassBeginInfo renderPassInfo = {};
-	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-	renderPassInfo.renderPass = m_ShadowRenderpass;
-	renderPassInfo.framebuffer = m_ShadowFrameBuffer;
-	renderPassInfo.renderArea.offset = { 0, 0 };
-	renderPassInfo.renderArea.extent = extent;
-	renderPassInfo.clearValueCount = 1;
-	renderPassInfo.pClearValues = &clearValue;
+	for (uint32_t cascade{}; cascade < m_CascadeCount; ++cascade)
+	{
+		// Get the bit of this cascade
+		uint8_t cascadeBit{ static_cast<uint8_t>(1 << cascade) };
+
+		// Skip cascades that still hold the depth of the current scene
+		if (!(dirtyCascades & cascadeBit))
+			continue;
+
+		// This cascade holds valid depth after this pass
+		m_CascadeValid[cascade] = 1;
+
+		VkRenderPassBeginInfo renderPassInfo = {};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		renderPassInfo.renderPass = m_ShadowRenderpass;
+		renderPassInfo.framebuffer = m_ShadowFrameBuffers[cascade];
+		renderPassInfo.renderArea.offset = { 0, 0 };
+		renderPassInfo.renderArea.extent = extent;
+		renderPassInfo.clearValueCount = 1;
+		renderPassInfo.pClearValues = &clearValue;
+
+		vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+		// Bind pipeline and descriptor sets, draw your scene from the light's perspective here
+		m_pShadowPipeline->BindPipeline(commandBuffer);
 
-	// Bind pipeline and descriptor sets, draw your scene from the light's perspective here
-	m_pShadowPipeline->BindPipeline(commandBuffer);
+		// Bind descriptor sets
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pShadowPipeline->GetPipelineLayout(), 0, 1, &m_DescriptorSets[frame], 0, nullptr);
 
-	// Bind descriptor sets
-	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pShadowPipeline->GetPipelineLayout(), 0, 1, &m_DescriptorSets[frame], 0, nullptr);
+		// Push the index of the cascade, it is placed after the transform of the model
+		int32_t cascadeIndex{ static_cast<int32_t>(cascade) };
+		vkCmdPushConstants(commandBuffer, m_pShadowPipeline->GetPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, sizeof(glm::mat4), sizeof(int32_t), &cascadeIndex);
 
-	for (auto& model : pModels)
+		for (size_t i{}; i < pModels.size(); ++i)
+		{
+			// Only render casters that overlap this cascade
+			if (!(m_CasterCascades[pModels[i]->GetTransformId()] & cascadeBit))
+				continue;
+
+			pModels[i]->RenderShadow(commandBuffer, m_pShadowPipeline->GetPipelineLayout());
+		}
+
+		vkCmdEndRenderPass(commandBuffer);
+	}
+}
+
+bool DDM3::ShadowRenderer::IsInCascade(Model* pModel, const glm::mat4& cascadeTransform) const
+{
+	// Models without a mesh have nothing to render
+	if (!pModel->IsInitialized())
+		return false;
+
+	// Get the mesh of the model
+	auto& pMesh{ pModel->GetMesh() };
+	const auto& boundsMin{ pMesh->GetBoundsMin() };
+	const auto& boundsMax{ pMesh->GetBoundsMax() };
+
+	// Transform from local space to the clip space of the cascade
+	glm::mat4 transform{ cascadeTransform * pModel->GetTransform() };
+
+	// Get the bounds of the box in clip space, the projection is orthographic so w stays 1
+	glm::vec3 clipMin{ FLT_MAX };
+	glm::vec3 clipMax{ -FLT_MAX };
+
+	for (int i{}; i < 8; ++i)
 	{
-		model->RenderShadow(commandBuffer, m_pShadowPipeline->GetPipelineLayout());
+		// Pick the minimum or maximum for every axis
+		glm::vec3 corner{ (i & 1) ? boundsMax.x : boundsMin.x, (i & 2) ? boundsMax.y : boundsMin.y, (i & 4) ? boundsMax.z : boundsMin.z };
+
+		glm::vec3 clip{ transform * glm::vec4(corner, 1.0f) };
+
+		clipMin = glm::min(clipMin, clip);
+		clipMax = glm::max(clipMax, clip);
 	}
 
-	vkCmdEndRenderPass(commandBuffer);
-}
\ No newline at end of file
+	// The box overlaps the cascade if it overlaps the clip volume on every axis
+	return clipMax.x >= -1.f && clipMin.x <= 1.f &&
+		clipMax.y >= -1.f && clipMin.y <= 1.f &&
+		clipMax.z >= 0.f && clipMin.z <= 1.f;
+}
@@ -8,6 +8,7 @@
 
 // Standard library includes
 #include <memory>
+#include <vector>
 
 namespace DDM3
 {
@@ -16,6 +17,7 @@ namespace DDM3
 	class PipelineWrapper;
 	class Model;
 	class Viewport;
+	class ShaderManager;
 
 	class ShadowRenderer final
 	{
@@ -33,21 +35,53 @@ namespace DDM3
 		ShadowRenderer& operator=(ShadowRenderer& other) = delete;
 		ShadowRenderer& operator=(ShadowRenderer&& other) = delete;
 
+		// Render every shadow cascade into its own layer of the shadow map
+		// A cascade is only rendered again if it moved, or if a caster inside it moved, was added or stopped casting
+		// Parameters:
+		//     pModels: all models, only models that overlap a cascade are rendered into it
 		void Render(std::vector<std::unique_ptr<Model>>& pModels);
 
-		void CreatePipeline(VkDevice device);
+		// Create the shadow pipeline
+		// Parameters:
+		//     device: handle of the VkDevice
+		//     pShaderManager: the shader manager the shader module and layouts are taken from
+		//     pipelineCache: the pipeline cache the pipeline is created with
+		void CreatePipeline(VkDevice device, ShaderManager* pShaderManager, VkPipelineCache pipelineCache);
 
 		TextureDescriptorObject* GetTextureDescriptorObject();
 
+		// Get the layered shadow map
+		const Texture& GetShadowTexture() const { return m_ShadowTexture; }
+
 	private:
 		// Max amount of samples per pixel, initialize as 1
 		VkSampleCountFlagBits m_MsaaSamples = VK_SAMPLE_COUNT_1_BIT;
 
+		// The layered shadow map, the image view views all layers as an array
 		Texture m_ShadowTexture{};
 
+		// The amount of cascades, one layer of the shadow map per cascade
+		uint32_t m_CascadeCount{};
+
+		// Image views of the single layers, used as attachments of the framebuffers
+		std::vector<VkImageView> m_CascadeImageViews{};
+
+		// Hashes of the light transforms the cascades were last rendered with
+		std::vector<size_t> m_RenderedCascadeHashes{};
+
+		// For every transform id, a bit per cascade its model was rendered into last frame
+		std::vector<uint8_t> m_CasterCascades{};
+
+		// The amount of models the cascades were last rendered with
+		size_t m_CasterModelCount{};
+
+		// Indicates for every cascade if its layer holds valid depth
+		std::vector<uint8_t> m_CascadeValid{};
+
 		std::unique_ptr<DDM3::TextureDescriptorObject> m_pShadowTextureObject{};
 
-		VkFramebuffer m_ShadowFrameBuffer{};
+		// A framebuffer per cascade
+		std::vector<VkFramebuffer> m_ShadowFrameBuffers{};
 
 		VkRenderPass m_ShadowRenderpass{};
 
@@ -66,6 +100,12 @@ namespace DDM3
 		// Initialize the depth image for the swapchain
 		void CreateDepthImage();
 
+		// Check if the bounding box of a model overlaps a cascade
+		// Parameters:
+		//     pModel: the model to check
+		//     cascadeTransform: the light transform of the cascade
+		bool IsInCascade(Model* pModel, const glm::mat4& cascadeTransform) const;
+
 
 		// Create the frame buffers
 		// Parameters:
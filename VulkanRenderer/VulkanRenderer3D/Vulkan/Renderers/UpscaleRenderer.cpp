@@ -0,0 +1,214 @@
+// UpscaleRenderer.cpp
+
+// Header include
+#include "UpscaleRenderer.h"
+
+// File includes
+#include "Engine/ConfigManager.h"
+
+#include "Vulkan/Vulkan3D.h"
+#include "Vulkan/Wrappers/PipelineWrapper.h"
+#include "Vulkan/Wrappers/DescriptorPoolWrapper.h"
+
+// Standard library includes
+#include <algorithm>
+#include <stdexcept>
+
+DDM3::UpscaleRenderer::UpscaleRenderer(VkDevice device, ShaderManager* pShaderManager, VkFormat swapchainImageFormat, VkImageLayout finalLayout, VkPipelineCache pipelineCache)
+{
+	// Get config manager
+	auto& configManager{ ConfigManager::GetInstance() };
+
+	// Create the renderpass and the sampler
+	CreateRenderPass(device, swapchainImageFormat, finalLayout);
+	CreateSampler(device);
+
+	// The fullscreen triangle is generated in the vertex shader, no depth is used and the whole image is overwritten
+	PipelineStateKey stateKey{};
+	stateKey.shaders = { configManager.GetString("UpscaleVert"), configManager.GetString("UpscaleFrag") };
+	stateKey.vertexLayout = VertexLayout::None;
+	stateKey.blendEnable = false;
+	stateKey.depthTest = false;
+	stateKey.depthWrite = false;
+	stateKey.renderPass = m_RenderPass;
+
+	// Create the pipeline
+	m_pPipeline = std::make_unique<PipelineWrapper>(device, pShaderManager, stateKey, false, pipelineCache);
+
+	// Create the descriptorsets
+	m_pPipeline->GetDescriptorPool()->CreateDescriptorSets(m_pPipeline->GetDescriptorSetLayout(), m_DescriptorSets);
+
+	// No descriptorset has a scene image yet
+	m_WrittenSceneImageViews.resize(m_DescriptorSets.size(), VK_NULL_HANDLE);
+}
+
+DDM3::UpscaleRenderer::~UpscaleRenderer()
+{
+	// Get handle of device
+	auto device{ Vulkan3D::GetInstance().GetDevice() };
+
+	// Destroy the sampler
+	vkDestroySampler(device, m_Sampler, nullptr);
+
+	// Destroy the renderpass
+	vkDestroyRenderPass(device, m_RenderPass, nullptr);
+}
+
+void DDM3::UpscaleRenderer::SetSceneImage(VkImageView sceneImageView)
+{
+	// The descriptorsets are updated when their frame is rendered
+	m_SceneImageView = sceneImageView;
+	std::fill(m_WrittenSceneImageViews.begin(), m_WrittenSceneImageViews.end(), VK_NULL_HANDLE);
+}
+
+void DDM3::UpscaleRenderer::UpdateDescriptorSet(VkDevice device, uint32_t frame)
+{
+	// If the descriptorset already has the scene image, nothing has to be written
+	if (m_WrittenSceneImageViews[frame] == m_SceneImageView)
+		return;
+
+	// The scene image is sampled after the scene renderpass
+	VkDescriptorImageInfo imageInfo{};
+	imageInfo.sampler = m_Sampler;
+	imageInfo.imageView = m_SceneImageView;
+	imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	// Write the image to the descriptorset of this frame
+	VkWriteDescriptorSet descriptorWrite{};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = m_DescriptorSets[frame];
+	descriptorWrite.dstBinding = 0;
+	descriptorWrite.dstArrayElement = 0;
+	descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.pImageInfo = &imageInfo;
+
+	vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+
+	m_WrittenSceneImageViews[frame] = m_SceneImageView;
+}
+
+void DDM3::UpscaleRenderer::Render(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer, VkExtent2D swapchainExtent, const glm::vec2& uvScale)
+{
+	// Create renderpass begin info, every pixel is overwritten so nothing has to be cleared
+	VkRenderPassBeginInfo renderPassInfo{};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassInfo.renderPass = m_RenderPass;
+	renderPassInfo.framebuffer = framebuffer;
+	renderPassInfo.renderArea.offset = { 0, 0 };
+	renderPassInfo.renderArea.extent = swapchainExtent;
+
+	// Begin the renderpass
+	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+	// Cover the whole swapchain image
+	VkViewport viewport{ 0.0f, 0.0f, static_cast<float>(swapchainExtent.width), static_cast<float>(swapchainExtent.height), 0.0f, 1.0f };
+	VkRect2D scissor{ { 0, 0 }, swapchainExtent };
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+	// Write the current scene image to the descriptorset of this frame
+	UpdateDescriptorSet(Vulkan3D::GetInstance().GetDevice(), Vulkan3D::GetCurrentFrame());
+
+	// Bind the pipeline and the descriptorset of this frame
+	m_pPipeline->BindPipeline(commandBuffer);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pPipeline->GetPipelineLayout(), 0, 1,
+		&m_DescriptorSets[Vulkan3D::GetCurrentFrame()], 0, nullptr);
+
+	// Give the part of the scene image that was rendered to
+	vkCmdPushConstants(commandBuffer, m_pPipeline->GetPipelineLayout(), VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uvScale), &uvScale);
+
+	// Draw the fullscreen triangle
+	vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+}
+
+void DDM3::UpscaleRenderer::CreateRenderPass(VkDevice device, VkFormat swapchainImageFormat, VkImageLayout finalLayout)
+{
+	// Create attachment description
+	VkAttachmentDescription colorAttachment{};
+	// Set format to swapchain format
+	colorAttachment.format = swapchainImageFormat;
+	// Set samples to 1
+	colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+	// Every pixel is overwritten, so the old contents can be discarded
+	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	// Set storeOp function to store op store
+	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	// Set stencil load and store op to don't care
+	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	// Set initial layout to undefined
+	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	// Set final layout to the requested layout
+	colorAttachment.finalLayout = finalLayout;
+
+	// Create attachment reference
+	VkAttachmentReference colorAttachmentRef{};
+	// Set attachment to 0
+	colorAttachmentRef.attachment = 0;
+	// Set layout to color attachment optimal
+	colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+	// Create subpass description
+	VkSubpassDescription subpass{};
+	// Set pipeline bind point to graphics
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	// Set color attachment count to 1
+	subpass.colorAttachmentCount = 1;
+	// Give pointer to color attachment reference
+	subpass.pColorAttachments = &colorAttachmentRef;
+
+	// The swapchain image is acquired at color attachment output, wait for it before the layout transition
+	VkSubpassDependency dependency{};
+	dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependency.dstSubpass = 0;
+	dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependency.srcAccessMask = 0;
+	dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+	// Create render pass create info
+	VkRenderPassCreateInfo renderPassInfo{};
+	// Set type to render pass create info
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	// Give the attachment
+	renderPassInfo.attachmentCount = 1;
+	renderPassInfo.pAttachments = &colorAttachment;
+	// Give the subpass
+	renderPassInfo.subpassCount = 1;
+	renderPassInfo.pSubpasses = &subpass;
+	// Give the dependency
+	renderPassInfo.dependencyCount = 1;
+	renderPassInfo.pDependencies = &dependency;
+
+	// Create the renderpass
+	if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &m_RenderPass) != VK_SUCCESS)
+	{
+		// If unsuccessful, throw runtime error
+		throw std::runtime_error("failed to create upscale render pass!");
+	}
+}
+
+void DDM3::UpscaleRenderer::CreateSampler(VkDevice device)
+{
+	// Create sampler create info
+	VkSamplerCreateInfo samplerInfo{};
+	// Set type to sampler create info
+	samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	// Filter bilinearly when upscaling
+	samplerInfo.magFilter = VK_FILTER_LINEAR;
+	samplerInfo.minFilter = VK_FILTER_LINEAR;
+	samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	// Clamp to the edge of the image
+	samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	// Set max lod to 0
+	samplerInfo.maxLod = 0.0f;
+
+	// Create the sampler, if unsuccessful, throw runtime error
+	if (vkCreateSampler(device, &samplerInfo, nullptr, &m_Sampler) != VK_SUCCESS)
+	{
+		throw std::runtime_error("failed to create upscale sampler!");
+	}
+}
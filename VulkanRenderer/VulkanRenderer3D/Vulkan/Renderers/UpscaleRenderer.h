@@ -0,0 +1,103 @@
+// UpscaleRenderer.h
+// This class upscales the scene image into the swapchain image with bilinear filtering
+// The renderpass stays open afterwards, so the ImGui is drawn on top at the resolution of the swapchain
+
+#ifndef UpscaleRendererIncluded
+#define UpscaleRendererIncluded
+
+// File includes
+#include "Includes/VulkanIncludes.h"
+#include "Includes/GLMIncludes.h"
+
+// Standard library includes
+#include <vector>
+#include <memory>
+
+namespace DDM3
+{
+	// Class forward declarations
+	class PipelineWrapper;
+	class ShaderManager;
+
+	class UpscaleRenderer final
+	{
+	public:
+		// Constructor
+		// Parameters:
+		//     device: handle of the VkDevice
+		//     pShaderManager: the shader manager the shader modules and layouts are taken from
+		//     swapchainImageFormat: the format of the swapchain images
+		//     finalLayout: the layout the swapchain images are left in, present src or transfer src in headless mode
+		//     pipelineCache: the pipeline cache the pipeline is created with
+		UpscaleRenderer(VkDevice device, ShaderManager* pShaderManager, VkFormat swapchainImageFormat, VkImageLayout finalLayout, VkPipelineCache pipelineCache);
+
+		// Delete default constructor
+		UpscaleRenderer() = delete;
+
+		// Destructor
+		~UpscaleRenderer();
+
+		// Delete copy and move functions
+		UpscaleRenderer(UpscaleRenderer& other) = delete;
+		UpscaleRenderer(UpscaleRenderer&& other) = delete;
+		UpscaleRenderer& operator=(UpscaleRenderer& other) = delete;
+		UpscaleRenderer& operator=(UpscaleRenderer&& other) = delete;
+
+		// Get the handle of the renderpass, the swapchain framebuffers are created with it
+		VkRenderPass GetRenderpass() const { return m_RenderPass; }
+
+		// Set the scene image that is upscaled, must be called again after the scene image is recreated
+		// The descriptorset of a frame is only updated once that frame is rendered again, the frames in flight still use the old image
+		// Parameters:
+		//     sceneImageView: the image view of the scene image
+		void SetSceneImage(VkImageView sceneImageView);
+
+		// Begin the renderpass and draw the scene image over the whole swapchain image
+		// The renderpass has to be ended by the caller, after the ImGui is drawn
+		// Parameters:
+		//     commandBuffer: the current commandbuffer
+		//     framebuffer: the framebuffer of the current swapchain image
+		//     swapchainExtent: the extent of the swapchain
+		//     uvScale: the part of the scene image that was rendered to
+		void Render(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer, VkExtent2D swapchainExtent, const glm::vec2& uvScale);
+
+	private:
+		// The renderpass with the swapchain image as only attachment
+		VkRenderPass m_RenderPass{ VK_NULL_HANDLE };
+
+		// Sampler with bilinear filtering
+		VkSampler m_Sampler{ VK_NULL_HANDLE };
+
+		// The pipeline that draws a fullscreen triangle
+		std::unique_ptr<PipelineWrapper> m_pPipeline{};
+
+		// Vector of descriptorsets, one per frame in flight
+		std::vector<VkDescriptorSet> m_DescriptorSets{};
+
+		// The image view of the scene image
+		VkImageView m_SceneImageView{ VK_NULL_HANDLE };
+
+		// The image view written to the descriptorset of every frame, null handle if the descriptorset has to be written
+		std::vector<VkImageView> m_WrittenSceneImageViews{};
+
+		// Write the scene image to the descriptorset of a frame, if it isn't written yet
+		// Parameters:
+		//     device: handle of the VkDevice
+		//     frame: the index of the frame, its fence has to be waited on
+		void UpdateDescriptorSet(VkDevice device, uint32_t frame);
+
+		// Create the renderpass
+		// Parameters:
+		//     device: handle of the VkDevice
+		//     swapchainImageFormat: the format of the swapchain images
+		//     finalLayout: the layout the swapchain images are left in
+		void CreateRenderPass(VkDevice device, VkFormat swapchainImageFormat, VkImageLayout finalLayout);
+
+		// Create the sampler
+		// Parameters:
+		//     device: handle of the VkDevice
+		void CreateSampler(VkDevice device);
+	};
+}
+
+#endif // !UpscaleRendererIncluded
@@ -5,6 +5,8 @@
 
 #include "Vulkan/Vulkan3D.h"
 #include "Engine/ConfigManager.h"
+#include "Engine/CPUProfiler.h"
+#include "Engine/FramePacer.h"
 
 #include "Vulkan/Managers/DispatchableManager.h"
 #include "Vulkan/Wrappers/GPUObject.h"
@@ -25,7 +27,18 @@
 #include "Vulkan/Wrappers/SurfaceWrapper.h"
 #include "Vulkan/Wrappers/Viewport.h"
 #include "Vulkan/Managers/CameraManager.h"
+#include "Vulkan/Managers/ModelManager.h"
+#include "Vulkan/Managers/BindlessManager.h"
+#include "Vulkan/Managers/ResolutionManager.h"
+#include "Vulkan/Managers/GPUProfiler.h"
+#include "Vulkan/Managers/RetirementManager.h"
 #include "ShadowRenderer.h"
+#include "HiZRenderer.h"
+#include "DepthPrepassRenderer.h"
+#include "RenderGraph.h"
+#include "UpscaleRenderer.h"
+#include "FrameCapture.h"
+#include "Engine/OcclusionRasterizer.h"
 
 #include "DataTypes/DirectionalLightObject.h"
 #include "DataTypes/RenderClasses/SkyBox.h"
@@ -40,22 +53,47 @@ DDM3::VulkanRenderer3D::VulkanRenderer3D()
 	// Initialize vulkan objects
 	InitVulkan();
 
-	// Initialize ImGui
-	InitImGui();
+	// Initialize ImGui, without a window there is nothing to draw it on
+	if (!Vulkan3D::IsHeadless())
+	{
+		InitImGui();
+	}
 }
 
 DDM3::VulkanRenderer3D::~VulkanRenderer3D()
 {
 	// Waint until the logical device isn't doing anything
 	vkDeviceWaitIdle(Vulkan3D::GetInstance().GetDevice());
+
+	// Destroy the objects that were retired during the last frames
+	m_pRetirementManager->DestroyAll(Vulkan3D::GetInstance().GetDevice());
+
+	// Write the captures of the last frames
+	if (m_pFrameCapture != nullptr)
+	{
+		m_pFrameCapture->SaveAll();
+	}
 }
 
 void DDM3::VulkanRenderer3D::SetupSkybox()
 {
 	// Get config manager
 	auto& configManager{ ConfigManager::GetInstance() };
+
+	// The skybox is a fullscreen triangle on the far plane, drawn after the models
+	// Only pixels that still have the cleared depth pass the test, depth isn't written
+	PipelineStateKey stateKey{};
+	stateKey.shaders = { configManager.GetString("SkyboxVert"), configManager.GetString("SkyboxFrag") };
+	stateKey.vertexLayout = VertexLayout::None;
+	stateKey.blendEnable = false;
+	stateKey.depthTest = true;
+	stateKey.depthWrite = false;
+	stateKey.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+	stateKey.sampleCount = m_pRenderpassWrapper->GetMsaaSamples();
+	stateKey.renderPass = m_pRenderpassWrapper->GetRenderpass();
+
 	// Create the graphics pipeline for the skybox
-	AddGraphicsPipeline("Skybox", { configManager.GetString("SkyboxVert"), configManager.GetString("SkyboxFrag")}, false);
+	m_pPipelineManager->AddGraphicsPipeline(Vulkan3D::GetInstance().GetDevice(), "Skybox", stateKey);
 }
 
 void DDM3::VulkanRenderer3D::SetupLight()
@@ -70,13 +108,32 @@ void DDM3::VulkanRenderer3D::SetupLight()
 	m_pGlobalLight->SetIntensity(1.f);
 }
 
+void DDM3::VulkanRenderer3D::SetupBindless()
+{
+	// Get pointer to gpu object
+	GPUObject* pGPUObject{ Vulkan3D::GetInstance().GetGPUObject() };
+
+	// Only create the bindless manager if bindless descriptors are enabled and supported
+	if (pGPUObject->IsBindlessSupported())
+	{
+		m_pBindlessManager = std::make_unique<BindlessManager>(pGPUObject->GetDevice(), pGPUObject->GetMaxBindlessTextures());
+	}
+}
+
 void DDM3::VulkanRenderer3D::SetupDefaultPipeline()
 {
 	auto device{ Vulkan3D::GetInstance().GetDevice() };
 
-	m_pShadowRenderer->CreatePipeline(device);
+	m_pShadowRenderer->CreatePipeline(device, m_pPipelineManager->GetShaderManager(), m_pPipelineManager->GetPipelineCache());
 	// Add the default pipeline
-	m_pPipelineManager->AddDefaultPipeline(device, m_pRenderpassWrapper->GetRenderpass(), m_pSwapchainWrapper->GetMsaaSamples());
+	m_pPipelineManager->AddDefaultPipeline(device, m_pRenderpassWrapper->GetRenderpass(), m_pRenderpassWrapper->GetMsaaSamples());
+
+	// Only create the depth pre-pass renderer if the depth pre-pass is enabled
+	if (ConfigManager::GetInstance().GetBool("DepthPrepass"))
+	{
+		m_pDepthPrepassRenderer = std::make_unique<DepthPrepassRenderer>(device, m_pPipelineManager->GetShaderManager(), m_pRenderpassWrapper->GetRenderpass(), m_pRenderpassWrapper->GetMsaaSamples(),
+			m_pPipelineManager->GetPipelineCache());
+	}
 }
 
 DDM3::TextureDescriptorObject* DDM3::VulkanRenderer3D::GetShadowMapDescriptorObject()
@@ -116,27 +173,257 @@ void DDM3::VulkanRenderer3D::InitVulkan()
 	auto msaaSamples = VulkanUtils::GetMaxUsableSampleCount(pGPUObject->GetPhysicalDevice());
 
 	// Initialize the swapchain
-	m_pSwapchainWrapper = std::make_unique<SwapchainWrapper>(pGPUObject, surface,	m_pImageManager.get(), msaaSamples);
+	m_pSwapchainWrapper = std::make_unique<SwapchainWrapper>(pGPUObject, surface,	m_pImageManager.get());
 
 	// Initialize the renderpass
 	m_pRenderpassWrapper = std::make_unique<RenderpassWrapper>(pGPUObject->GetDevice(), m_pSwapchainWrapper->GetFormat(), VulkanUtils::FindDepthFormat(), msaaSamples);
 
-	// Create a single time command buffer
-	auto commandBuffer{ BeginSingleTimeCommands()};
-	// Initialize swapchain
-	m_pSwapchainWrapper->SetupImageViews(pGPUObject, m_pImageManager.get(),commandBuffer, m_pRenderpassWrapper->GetRenderpass());
-	// End the single time command buffer
-	EndSingleTimeCommands(commandBuffer);
-
 	// Initialize graphics pipeline manager
-	m_pPipelineManager = std::make_unique<PipelineManager>();
+	m_pPipelineManager = std::make_unique<PipelineManager>(pGPUObject);
+
+	// Initialize the upscale renderer, it draws the scene image into the swapchain image
+	// In headless mode the image is copied to the CPU instead of presented
+	m_pUpscaleRenderer = std::make_unique<UpscaleRenderer>(pGPUObject->GetDevice(), m_pPipelineManager->GetShaderManager(),
+		m_pSwapchainWrapper->GetFormat(), Vulkan3D::IsHeadless() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+		m_pPipelineManager->GetPipelineCache());
+
+	// In headless mode, write the frames to the capture directory if one is given
+	auto captureDirectory{ ConfigManager::GetInstance().GetString("HeadlessCaptureDirectory") };
+	if (Vulkan3D::IsHeadless() && !captureDirectory.empty())
+	{
+		m_pFrameCapture = std::make_unique<FrameCapture>(pGPUObject, m_pBufferManager.get(), m_pSwapchainWrapper->GetExtent(), captureDirectory);
+	}
+
+	// Initialize the resolution manager, it decides at which resolution the scene is rendered
+	m_pResolutionManager = std::make_unique<ResolutionManager>(pGPUObject, msaaSamples);
+
+	// Initialize the GPU profiler
+	m_pGPUProfiler = std::make_unique<GPUProfiler>(pGPUObject);
 
 	// Initialize the sync objects
 	m_pSyncObjectManager = std::make_unique<SyncObjectManager>(pGPUObject->GetDevice());
 
+	// Initialize the retirement manager
+	m_pRetirementManager = std::make_unique<RetirementManager>();
+
 	m_pViewport = std::make_unique<Viewport>(m_pSwapchainWrapper->GetExtent());
 
 	m_pShadowRenderer = std::make_unique<ShadowRenderer>();
+
+	// Build the render graph, this creates the color and depth images and the frame buffer of the scene
+	BuildRenderGraph();
+
+	// Create the frame buffers of the swapchain images
+	m_pSwapchainWrapper->CreateFramebuffers(pGPUObject->GetDevice(), m_pUpscaleRenderer->GetRenderpass());
+
+	// Create the Hi-Z renderer if occlusion culling is enabled
+	if (ConfigManager::GetInstance().GetBool("OcclusionCulling"))
+	{
+		m_pHiZRenderer = std::make_unique<HiZRenderer>(pGPUObject, m_pImageManager.get(), m_pBufferManager.get(),
+			m_pSwapchainWrapper->GetExtent(), m_pRenderGraph->GetImageView(m_DepthImage), msaaSamples, m_pPipelineManager->GetPipelineCache());
+	}
+}
+
+void DDM3::VulkanRenderer3D::BuildRenderGraph()
+{
+	// Get pointer to gpu object
+	GPUObject* pGPUObject{ Vulkan3D::GetInstance().GetGPUObject() };
+
+	// Retire the previous graph, the frames in flight still use its images
+	if (m_pRenderGraph != nullptr)
+	{
+		std::shared_ptr<RenderGraph> pOldRenderGraph{ std::move(m_pRenderGraph) };
+		m_pRetirementManager->Retire([pOldRenderGraph](VkDevice device)
+			{
+				pOldRenderGraph->Cleanup(device);
+			});
+	}
+	m_pRenderGraph = std::make_unique<RenderGraph>();
+
+	// Get the extent of the swapchain and the amount of samples per pixel of the renderpass
+	// The offscreen images have the size of the swapchain, the scene is rendered to a scaled part of them
+	auto extent{ m_pSwapchainWrapper->GetExtent() };
+	auto msaaSamples{ m_pRenderpassWrapper->GetMsaaSamples() };
+
+	// The Hi-Z renderer samples the depth buffer
+	bool occlusionCulling{ ConfigManager::GetInstance().GetBool("OcclusionCulling") };
+
+	// Get the depth format, formats with stencil have both aspects
+	auto depthFormat{ VulkanUtils::FindDepthFormat() };
+	VkImageAspectFlags depthAspect{ VK_IMAGE_ASPECT_DEPTH_BIT };
+	if (depthFormat == VK_FORMAT_D32_SFLOAT_S8_UINT || depthFormat == VK_FORMAT_D24_UNORM_S8_UINT)
+	{
+		depthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+	}
+
+	// The multisampled color image is resolved into the scene image at the end of the renderpass, without MSAA it isn't needed
+	bool useMsaa{ msaaSamples != VK_SAMPLE_COUNT_1_BIT };
+	if (useMsaa)
+	{
+		m_MsaaColorImage = m_pRenderGraph->CreateTransientImage("MsaaColor", m_pSwapchainWrapper->GetFormat(), extent, msaaSamples,
+			VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+	}
+
+	// The scene image is sampled when it is upscaled into the swapchain image
+	m_SceneColorImage = m_pRenderGraph->CreateTransientImage("SceneColor", m_pSwapchainWrapper->GetFormat(), extent, VK_SAMPLE_COUNT_1_BIT,
+		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+
+	// The depth image is only sampled if the depth pyramid is built from it
+	VkImageUsageFlags depthUsage{ VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT };
+	if (occlusionCulling)
+	{
+		depthUsage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+	}
+	m_DepthImage = m_pRenderGraph->CreateTransientImage("Depth", depthFormat, extent, msaaSamples, depthUsage, depthAspect);
+
+	// The shadow map is owned by the shadow renderer
+	m_ShadowMapImage = m_pRenderGraph->ImportImage("ShadowMap", m_pShadowRenderer->GetShadowTexture().image,
+		VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_LAYOUT_UNDEFINED);
+
+	// Render the shadow cascades, the renderpass leaves the shadow map read only
+	auto shadowPass{ m_pRenderGraph->AddPass("Shadow", [this](VkCommandBuffer)
+		{
+			m_pShadowRenderer->Render(*m_pCurrentModels);
+		}) };
+	m_pRenderGraph->UseImage(shadowPass, m_ShadowMapImage, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+		VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+		VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+
+	// Render the scene into the scaled part of the scene image
+	auto mainPass{ m_pRenderGraph->AddPass("Main", [this](VkCommandBuffer commandBuffer)
+		{
+			m_pViewport->SetViewportAndScissor(m_RenderExtent);
+			m_pViewport->SetViewport(commandBuffer);
+
+			m_pRenderpassWrapper->BeginRenderPass(commandBuffer, m_RenderExtent);
+
+			// Render the depth of the opaque models, the models are shaded afterwards with an equal depth test
+			if (m_pDepthPrepassRenderer != nullptr)
+			{
+				GPUProfiler::ScopedMarker marker{ m_pGPUProfiler.get(), commandBuffer, "Depth prepass" };
+				m_pDepthPrepassRenderer->Render(commandBuffer, *m_pCurrentModels);
+			}
+
+			// Render the models, models sharing a mesh and material are drawn instanced
+			{
+				GPUProfiler::ScopedMarker marker{ m_pGPUProfiler.get(), commandBuffer, "Models" };
+				Vulkan3D::GetInstance().GetModelManager()->Render();
+			}
+
+			// Render the skybox last, it only shades the pixels no model was drawn to
+			{
+				GPUProfiler::ScopedMarker marker{ m_pGPUProfiler.get(), commandBuffer, "Skybox" };
+				Vulkan3D::GetInstance().GetCameraManager()->RenderSkybox();
+			}
+
+			// End the render pass
+			vkCmdEndRenderPass(commandBuffer);
+		}) };
+	m_pRenderGraph->UseImage(mainPass, m_ShadowMapImage, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+		VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+	if (useMsaa)
+	{
+		m_pRenderGraph->UseImage(mainPass, m_MsaaColorImage, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+			VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+	}
+	m_pRenderGraph->UseImage(mainPass, m_SceneColorImage, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+		VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	m_pRenderGraph->UseImage(mainPass, m_DepthImage, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+		VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+		VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+
+	// Upscale the scene image into the swapchain image and draw the ImGui on top at full resolution, presenting is a side effect
+	auto upscalePass{ m_pRenderGraph->AddPass("Upscale", [this](VkCommandBuffer commandBuffer)
+		{
+			// Get the extent of the swapchain
+			auto swapchainExtent{ m_pSwapchainWrapper->GetExtent() };
+
+			// Only the scaled part of the scene image was rendered to
+			glm::vec2 uvScale{ static_cast<float>(m_RenderExtent.width) / static_cast<float>(swapchainExtent.width),
+				static_cast<float>(m_RenderExtent.height) / static_cast<float>(swapchainExtent.height) };
+
+			m_pUpscaleRenderer->Render(commandBuffer, m_pSwapchainWrapper->GetFrameBuffer(m_CurrentImageIndex), swapchainExtent, uvScale);
+
+			// Render the ImGui, in headless mode there is none
+			if (m_pImGuiWrapper != nullptr)
+			{
+				GPUProfiler::ScopedMarker marker{ m_pGPUProfiler.get(), commandBuffer, "ImGui" };
+
+				m_pImGuiWrapper->StartRender();
+
+				// Show the GPU times of the passes
+				m_pGPUProfiler->RenderStats();
+
+#ifdef DDM3_CPU_PROFILER
+				// Show the CPU capture button
+				CPUProfiler::GetInstance().RenderStats();
+#endif
+
+				// Show the resolution statistics
+				m_pResolutionManager->RenderStats();
+
+				// Show the frame pacing statistics
+				FramePacer::GetInstance().RenderStats();
+
+				// Show the occlusion statistics
+				if (m_pHiZRenderer != nullptr)
+				{
+					m_pHiZRenderer->RenderStats();
+				}
+
+				// Show the software occlusion statistics
+				if (auto pOcclusionRasterizer{ Vulkan3D::GetInstance().GetModelManager()->GetOcclusionRasterizer() })
+				{
+					pOcclusionRasterizer->RenderStats();
+				}
+
+				m_pImGuiWrapper->EndRender(commandBuffer);
+			}
+
+			// End the render pass
+			vkCmdEndRenderPass(commandBuffer);
+		}, true) };
+	m_pRenderGraph->UseImage(upscalePass, m_SceneColorImage, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+		VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+	// Build the depth pyramid used for the occlusion tests of a later frame, the readback is a side effect
+	if (occlusionCulling)
+	{
+		auto hiZPass{ m_pRenderGraph->AddPass("HiZ", [this](VkCommandBuffer commandBuffer)
+			{
+				// Get the view and projection matrix the depth was rendered with
+				UniformBufferObject ubo{};
+				Vulkan3D::GetInstance().GetFramePacket().camera.UpdateUniformBuffer(ubo);
+
+				m_pHiZRenderer->Build(commandBuffer, ubo.proj * ubo.view, m_RenderExtent, Vulkan3D::GetCurrentFrame());
+			}, true) };
+		m_pRenderGraph->UseImage(hiZPass, m_DepthImage, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	}
+
+	// Cull the unused passes and create the transient images
+	m_pRenderGraph->Compile(pGPUObject);
+
+	// Create the frame buffer of the scene with the images of the graph
+	m_pRenderpassWrapper->CreateFramebuffer(pGPUObject->GetDevice(), useMsaa ? m_pRenderGraph->GetImageView(m_MsaaColorImage) : VK_NULL_HANDLE,
+		m_pRenderGraph->GetImageView(m_DepthImage), m_pRenderGraph->GetImageView(m_SceneColorImage), extent, m_pRetirementManager.get());
+
+	// Upscale the new scene image
+	m_pUpscaleRenderer->SetSceneImage(m_pRenderGraph->GetImageView(m_SceneColorImage));
+}
+
+void DDM3::VulkanRenderer3D::RecreateRenderTargets()
+{
+	// Rebuild the render graph for the new extent, this recreates the color and depth images
+	BuildRenderGraph();
+
+	// Recreate the depth pyramid for the new depth buffer
+	if (m_pHiZRenderer != nullptr)
+	{
+		m_pHiZRenderer->Resize(m_pSwapchainWrapper->GetExtent(), m_pRenderGraph->GetImageView(m_DepthImage), m_pRetirementManager.get());
+	}
+
+	m_RenderTargetsOutdated = false;
 }
 
 void DDM3::VulkanRenderer3D::InitImGui()
@@ -156,8 +443,8 @@ void DDM3::VulkanRenderer3D::InitImGui()
 	init_info.QueueFamily = pGPUObject->GetQueueObject().graphicsQueueIndex;
 	// Give the graphics queue
 	init_info.Queue = pGPUObject->GetQueueObject().graphicsQueue;
-	// Set pipeline cache to null handle
-	init_info.PipelineCache = VK_NULL_HANDLE;
+	// Give the pipeline cache
+	init_info.PipelineCache = m_pPipelineManager->GetPipelineCache();
 	// Set Allocator to null handle
 	init_info.Allocator = VK_NULL_HANDLE;
 	// Set min image count to the minimum image count of the swapchain
@@ -166,10 +453,10 @@ void DDM3::VulkanRenderer3D::InitImGui()
 	init_info.ImageCount = Vulkan3D::GetMaxFrames();
 	// Give functoin for error handling
 	init_info.CheckVkResultFn = [](VkResult /*err*/) { /* error handling */ };
-	// Give the max amount of samples per mixel
-	init_info.MSAASamples = m_pSwapchainWrapper->GetMsaaSamples();
+	// The ImGui is drawn in the upscale renderpass, which has a single sample per pixel
+	init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
 	// Set renderpass
-	init_info.RenderPass = m_pRenderpassWrapper->GetRenderpass();
+	init_info.RenderPass = m_pUpscaleRenderer->GetRenderpass();
 
 	// Initialize ImGui
 	m_pImGuiWrapper = std::make_unique<DDM3::ImGuiWrapper>(init_info, pGPUObject->GetDevice());
@@ -179,18 +466,147 @@ void DDM3::VulkanRenderer3D::AddGraphicsPipeline(const std::string& pipelineName
 {
 	// Add a graphics pipeline trough the pipeline manager
 	m_pPipelineManager->AddGraphicsPipeline(DDM3::Vulkan3D::GetInstance().GetDevice(), m_pRenderpassWrapper->GetRenderpass(),
-		m_pSwapchainWrapper->GetMsaaSamples(), pipelineName, filePaths, hasDepthStencil);
+		m_pRenderpassWrapper->GetMsaaSamples(), pipelineName, filePaths, hasDepthStencil);
+}
+
+void DDM3::VulkanRenderer3D::AddBindlessGraphicsPipeline(const std::string& pipelineName, std::initializer_list<const std::string>&& filePaths)
+{
+	// If bindless descriptors aren't used, don't create the pipeline
+	if (m_pBindlessManager == nullptr)
+		return;
+
+	// Add a graphics pipeline using the bindless descriptor set layout trough the pipeline manager
+	m_pPipelineManager->AddGraphicsPipeline(DDM3::Vulkan3D::GetInstance().GetDevice(), m_pRenderpassWrapper->GetRenderpass(),
+		m_pRenderpassWrapper->GetMsaaSamples(), pipelineName, filePaths, true, m_pBindlessManager->GetDescriptorSetLayout());
+}
+
+void DDM3::VulkanRenderer3D::AddGraphicsPipelines(std::vector<PipelineDescription> descriptions)
+{
+	// Bindless pipelines can only be created if bindless descriptors are used
+	if (m_pBindlessManager == nullptr)
+	{
+		std::erase_if(descriptions, [](const PipelineDescription& description) { return description.bindless; });
+	}
+
+	// Give bindless pipelines the bindless descriptor set layout
+	for (auto& description : descriptions)
+	{
+		if (description.bindless)
+		{
+			description.descriptorSetLayout = m_pBindlessManager->GetDescriptorSetLayout();
+		}
+	}
+
+	// Add the graphics pipelines trough the pipeline manager
+	m_pPipelineManager->AddGraphicsPipelines(DDM3::Vulkan3D::GetInstance().GetDevice(), m_pRenderpassWrapper->GetRenderpass(),
+		m_pRenderpassWrapper->GetMsaaSamples(), descriptions);
+}
+
+DDM3::BindlessManager* DDM3::VulkanRenderer3D::GetBindlessManager() const
+{
+	// Return the bindless manager
+	return m_pBindlessManager.get();
+}
+
+DDM3::HiZRenderer* DDM3::VulkanRenderer3D::GetHiZRenderer() const
+{
+	// Return the Hi-Z renderer
+	return m_pHiZRenderer.get();
+}
+
+DDM3::DepthPrepassRenderer* DDM3::VulkanRenderer3D::GetDepthPrepassRenderer() const
+{
+	// Return the depth pre-pass renderer
+	return m_pDepthPrepassRenderer.get();
+}
+
+VkSampleCountFlagBits DDM3::VulkanRenderer3D::GetMsaaSamples() const
+{
+	// Return the sample count of the renderpass
+	return m_pRenderpassWrapper->GetMsaaSamples();
+}
+
+float DDM3::VulkanRenderer3D::GetRenderScale() const
+{
+	// Return the scale of the resolution manager
+	return m_pResolutionManager->GetRenderScale();
+}
+
+void DDM3::VulkanRenderer3D::SetMsaaSamples(VkSampleCountFlagBits msaaSamples)
+{
+	// Get pointer to gpu object
+	GPUObject* pGPUObject{ Vulkan3D::GetInstance().GetGPUObject() };
+
+	// Get handle of device
+	auto device{ pGPUObject->GetDevice() };
+
+	// Don't use more samples than the GPU supports
+	msaaSamples = std::min(msaaSamples, VulkanUtils::GetMaxUsableSampleCount(pGPUObject->GetPhysicalDevice()));
+
+	// If the amount doesn't change, nothing has to be recreated
+	if (msaaSamples == m_pRenderpassWrapper->GetMsaaSamples())
+		return;
+
+	// Wait until the device is idle, the renderpass and the pipelines are still in use
+	vkDeviceWaitIdle(device);
+
+	// Create the renderpass for the new amount of samples, the old one is destroyed once the pipelines are recreated
+	auto pOldRenderpassWrapper{ std::move(m_pRenderpassWrapper) };
+	m_pRenderpassWrapper = std::make_unique<RenderpassWrapper>(device, m_pSwapchainWrapper->GetFormat(), VulkanUtils::FindDepthFormat(), msaaSamples);
+
+	// Recreate the pipelines of the main renderpass, the pipeline objects are kept so materials don't have to be updated
+	m_pPipelineManager->RecreatePipelines(device, pOldRenderpassWrapper->GetRenderpass(), m_pRenderpassWrapper->GetRenderpass(), msaaSamples);
+
+	if (m_pDepthPrepassRenderer != nullptr)
+	{
+		m_pDepthPrepassRenderer->RecreatePipeline(device, m_pPipelineManager->GetShaderManager(), m_pRenderpassWrapper->GetRenderpass(),
+			msaaSamples, m_pPipelineManager->GetPipelineCache());
+	}
+
+	// Destroy the old renderpass and its framebuffer
+	pOldRenderpassWrapper = nullptr;
+
+	// Rebuild the render graph for the new amount of samples, this recreates the frame buffers
+	BuildRenderGraph();
+
+	// The depth pyramid reads the depth buffer with a different shader, so the Hi-Z renderer is recreated
+	if (m_pHiZRenderer != nullptr)
+	{
+		m_pHiZRenderer = nullptr;
+		m_pHiZRenderer = std::make_unique<HiZRenderer>(pGPUObject, m_pImageManager.get(), m_pBufferManager.get(),
+			m_pSwapchainWrapper->GetExtent(), m_pRenderGraph->GetImageView(m_DepthImage), msaaSamples, m_pPipelineManager->GetPipelineCache());
+	}
 }
 
 void DDM3::VulkanRenderer3D::Render(std::vector<std::unique_ptr<Model>>& pModels)
 {
+	// Apply the amount of samples per pixel selected in the stats window
+	SetMsaaSamples(m_pResolutionManager->GetRequestedMsaaSamples());
+
 	// Wait for the in flight fence of the current frame
-	vkWaitForFences(DDM3::Vulkan3D::GetInstance().GetDevice(), 1, &m_pSyncObjectManager->GetInFlightFence(Vulkan3D::GetCurrentFrame()), VK_TRUE, UINT64_MAX);
+	{
+		DDM3_PROFILE_SCOPE("Wait for fence");
+		vkWaitForFences(DDM3::Vulkan3D::GetInstance().GetDevice(), 1, &m_pSyncObjectManager->GetInFlightFence(Vulkan3D::GetCurrentFrame()), VK_TRUE, UINT64_MAX);
+	}
+
+	// The frame that used this fence before finished, destroy the objects that were retired before it
+	m_pRetirementManager->DestroyRetired(DDM3::Vulkan3D::GetInstance().GetDevice());
+
+	// Without a swapchain, render to the offscreen image of this frame
+	if (Vulkan3D::IsHeadless())
+	{
+		RenderHeadless(pModels);
+		return;
+	}
 
 	// Create image index uint
 	uint32_t imageIndex{};
 	// Get the index of the next image
-	VkResult result = vkAcquireNextImageKHR(DDM3::Vulkan3D::GetInstance().GetDevice(), m_pSwapchainWrapper->GetSwapchain(), UINT64_MAX, m_pSyncObjectManager->GetImageAvailableSemaphore(Vulkan3D::GetCurrentFrame()), VK_NULL_HANDLE, &imageIndex);
+	VkResult result{};
+	{
+		DDM3_PROFILE_SCOPE("Acquire image");
+		result = vkAcquireNextImageKHR(DDM3::Vulkan3D::GetInstance().GetDevice(), m_pSwapchainWrapper->GetSwapchain(), UINT64_MAX, m_pSyncObjectManager->GetImageAvailableSemaphore(Vulkan3D::GetCurrentFrame()), VK_NULL_HANDLE, &imageIndex);
+	}
 
 	// Check if window is out of date
 	if (result == VK_ERROR_OUT_OF_DATE_KHR)
@@ -208,6 +624,12 @@ void DDM3::VulkanRenderer3D::Render(std::vector<std::unique_ptr<Model>>& pModels
 	// Reset the in flight fences
 	vkResetFences(DDM3::Vulkan3D::GetInstance().GetDevice(), 1, &m_pSyncObjectManager->GetInFlightFence(Vulkan3D::GetCurrentFrame()));
 
+	// If the swapchain was recreated, create the color and depth images for its new extent now that an image will be rendered
+	if (m_RenderTargetsOutdated)
+	{
+		RecreateRenderTargets();
+	}
+
 	// Get the current command buffer
 	auto commandBuffer{GetCurrentCommandBuffer()};
 
@@ -245,10 +667,13 @@ void DDM3::VulkanRenderer3D::Render(std::vector<std::unique_ptr<Model>>& pModels
 	submitInfo.pSignalSemaphores = signalSemaphores;
 
 	// Submit the command buffers
-	if (vkQueueSubmit(DDM3::Vulkan3D::GetInstance().GetGPUObject()->GetQueueObject().graphicsQueue, 1, &submitInfo, m_pSyncObjectManager->GetInFlightFence(Vulkan3D::GetCurrentFrame())) != VK_SUCCESS)
 	{
-		// If unsuccessful, throw runtime error
-		throw std::runtime_error("failed to submit draw command buffer!");
+		DDM3_PROFILE_SCOPE("Submit");
+		if (vkQueueSubmit(DDM3::Vulkan3D::GetInstance().GetGPUObject()->GetQueueObject().graphicsQueue, 1, &submitInfo, m_pSyncObjectManager->GetInFlightFence(Vulkan3D::GetCurrentFrame())) != VK_SUCCESS)
+		{
+			// If unsuccessful, throw runtime error
+			throw std::runtime_error("failed to submit draw command buffer!");
+		}
 	}
 
 	// Create present info object
@@ -272,7 +697,10 @@ void DDM3::VulkanRenderer3D::Render(std::vector<std::unique_ptr<Model>>& pModels
 	presentInfo.pResults = nullptr;
 
 	// Present the swapchain
-	result = vkQueuePresentKHR(DDM3::Vulkan3D::GetInstance().GetGPUObject()->GetQueueObject().presentQueue, &presentInfo);
+	{
+		DDM3_PROFILE_SCOPE("Present");
+		result = vkQueuePresentKHR(DDM3::Vulkan3D::GetInstance().GetGPUObject()->GetQueueObject().presentQueue, &presentInfo);
+	}
 
 	// Check if window was resized and is out of date
 	if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || Window::GetInstance().GetWindowStruct().FrameBufferResized)
@@ -280,8 +708,6 @@ void DDM3::VulkanRenderer3D::Render(std::vector<std::unique_ptr<Model>>& pModels
 		// If necesarry, resize swapchain
 		RecreateSwapChain();
 
-		m_pViewport->SetViewportAndScissor(m_pSwapchainWrapper->GetExtent());
-
 		// Reset FrameBufferResized flag
 		Window::GetInstance().SetFrameBufferResized(false);
 	}
@@ -293,10 +719,47 @@ void DDM3::VulkanRenderer3D::Render(std::vector<std::unique_ptr<Model>>& pModels
 	}
 }
 
+void DDM3::VulkanRenderer3D::RenderHeadless(std::vector<std::unique_ptr<Model>>& pModels)
+{
+	// Every frame in flight has its own offscreen image, so the frame index is the image index
+	uint32_t imageIndex{ Vulkan3D::GetCurrentFrame() };
+
+	// The fence of this frame was waited on, write the capture of the last time this image was rendered
+	if (m_pFrameCapture != nullptr)
+	{
+		m_pFrameCapture->Save(imageIndex);
+	}
+
+	// Reset the in flight fences
+	vkResetFences(DDM3::Vulkan3D::GetInstance().GetDevice(), 1, &m_pSyncObjectManager->GetInFlightFence(Vulkan3D::GetCurrentFrame()));
+
+	// Get the current command buffer
+	auto commandBuffer{ GetCurrentCommandBuffer() };
+
+	// Reset the command buffer
+	vkResetCommandBuffer(commandBuffer, 0);
+
+	// Record the command buffer the same way as with a swapchain
+	RecordCommandBuffer(commandBuffer, imageIndex, pModels);
+
+	// Create submit info object, there is no image to acquire or present so no semaphores are used
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+
+	// Submit the command buffers
+	DDM3_PROFILE_SCOPE("Submit");
+	if (vkQueueSubmit(DDM3::Vulkan3D::GetInstance().GetGPUObject()->GetQueueObject().graphicsQueue, 1, &submitInfo, m_pSyncObjectManager->GetInFlightFence(Vulkan3D::GetCurrentFrame())) != VK_SUCCESS)
+	{
+		// If unsuccessful, throw runtime error
+		throw std::runtime_error("failed to submit draw command buffer!");
+	}
+}
+
 void DDM3::VulkanRenderer3D::RecordCommandBuffer(VkCommandBuffer& commandBuffer, uint32_t imageIndex, std::vector<std::unique_ptr<Model>>& pModels)
 {
-	// Get the swapchain extent
-	auto swapchainExtent{ m_pSwapchainWrapper->GetExtent() };
+	DDM3_PROFILE_SCOPE("Record commands");
 
 	// Create command buffer begin info object
 	VkCommandBufferBeginInfo beginInfo{};
@@ -314,33 +777,46 @@ void DDM3::VulkanRenderer3D::RecordCommandBuffer(VkCommandBuffer& commandBuffer,
 		throw std::runtime_error("failed to begin recording command buffer!");
 	}
 
+	// Measure the GPU time and decide at which resolution this frame is rendered, the fence of this frame was waited on so its timestamps are available
+	m_pResolutionManager->BeginFrame(commandBuffer, Vulkan3D::GetCurrentFrame());
+	m_RenderExtent = m_pResolutionManager->GetRenderExtent(m_pSwapchainWrapper->GetExtent());
 
-	m_pShadowRenderer->Render(pModels);
+	// Read the pass times of the last time this frame index was rendered
+	m_pGPUProfiler->BeginFrame(commandBuffer, Vulkan3D::GetCurrentFrame());
 
-	m_pViewport->SetViewport(commandBuffer);
+	// Prepare the occlusion tests, the fence of this frame was waited on so its readback is complete
+	if (m_pHiZRenderer != nullptr)
+	{
+		m_pHiZRenderer->BeginFrame(Vulkan3D::GetCurrentFrame());
+	}
 
-	m_pRenderpassWrapper->BeginRenderPass(commandBuffer, m_pSwapchainWrapper->GetFrameBuffer(imageIndex), swapchainExtent);
+	// Test which models are occluded, both the depth pre-pass and the main pass skip them
+	Vulkan3D::GetInstance().GetModelManager()->UpdateVisibility();
 
-	// Update the buffer of the global light
+	// Update the buffer of the global light, the shadow cascades are fitted to the camera of this frame
 	m_pGlobalLight->UpdateBuffer(Vulkan3D::GetCurrentFrame());
 
+	// Store the swapchain image and the models for the passes
+	m_CurrentImageIndex = imageIndex;
+	m_pCurrentModels = &pModels;
 
-	Vulkan3D::GetInstance().GetCameraManager()->RenderSkybox();
-
-	// Loop trough the amount of models
-	for (size_t i = 0; i < pModels.size(); ++i)
+	// Record the passes of the render graph with the barriers between them, every pass is measured
 	{
-		// Render the current model
-		pModels[i]->Render();
+		GPUProfiler::ScopedMarker marker{ m_pGPUProfiler.get(), commandBuffer, "Frame" };
+		m_pRenderGraph->Execute(commandBuffer, m_pGPUProfiler.get());
 	}
 
-	// Render the ImGui
-	m_pImGuiWrapper->StartRender();
+	// Stop counting the shader invocations
+	m_pGPUProfiler->EndFrame(commandBuffer);
 
-	m_pImGuiWrapper->EndRender(commandBuffer);
+	// Copy the final image to the CPU
+	if (m_pFrameCapture != nullptr)
+	{
+		m_pFrameCapture->Record(commandBuffer, m_pSwapchainWrapper->GetImage(imageIndex), Vulkan3D::GetCurrentFrame());
+	}
 
-	// End the render pass
-	vkCmdEndRenderPass(commandBuffer);
+	// Write the timestamp at the end of the frame
+	m_pResolutionManager->EndFrame(commandBuffer, Vulkan3D::GetCurrentFrame());
 
 	// End the command buffer
 	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
@@ -368,6 +844,21 @@ DDM3::PipelineWrapper* DDM3::VulkanRenderer3D::GetPipeline(const std::string& na
 	return m_pPipelineManager->GetPipeline(name);
 }
 
+bool DDM3::VulkanRenderer3D::HasPipeline(const std::string& name) const
+{
+	// Check trough the pipeline manager if the pipeline exists
+	return m_pPipelineManager->HasPipeline(name);
+}
+
+void DDM3::VulkanRenderer3D::LogPipelineStatistics() const
+{
+	// Log the statistics trough the pipeline manager
+	m_pPipelineManager->LogStatistics();
+
+	// Log the culled passes and the memory of the transient images
+	m_pRenderGraph->LogStatistics();
+}
+
 VkCommandBuffer& DDM3::VulkanRenderer3D::GetCurrentCommandBuffer()
 {
 	// Return the requested command buffer trough the commandpool manager
@@ -400,18 +891,15 @@ void DDM3::VulkanRenderer3D::RecreateSwapChain()
 		glfwWaitEvents();
 	}
 
-	// Wait until the device is idle
-	vkDeviceWaitIdle(DDM3::Vulkan3D::GetInstance().GetDevice());
-	
-	// Create a single time command
-	auto commandBuffer{ BeginSingleTimeCommands() };
+	// Recreate the swapchain, the old one keeps presenting and is destroyed with its frame buffers once the frames in flight finished
+	m_pSwapchainWrapper->RecreateSwapChain(DDM3::Vulkan3D::GetInstance().GetGPUObject(), DDM3::Vulkan3D::GetInstance().GetSurface(),
+		m_pImageManager.get(), m_pRetirementManager.get());
 
-	// Recreate the swapchain
-	m_pSwapchainWrapper->RecreateSwapChain(DDM3::Vulkan3D::GetInstance().GetGPUObject(), DDM3::Vulkan3D::GetInstance().GetSurface(), m_pImageManager.get(),
-		commandBuffer, m_pRenderpassWrapper->GetRenderpass());
+	// Create the frame buffers of the new swapchain images
+	m_pSwapchainWrapper->CreateFramebuffers(DDM3::Vulkan3D::GetInstance().GetDevice(), m_pUpscaleRenderer->GetRenderpass());
 
-	// End single time command
-	EndSingleTimeCommands(commandBuffer);
+	// The color and depth images are recreated once the next image is rendered, a swapchain that is recreated again before that doesn't recreate them
+	m_RenderTargetsOutdated = true;
 }
 
 
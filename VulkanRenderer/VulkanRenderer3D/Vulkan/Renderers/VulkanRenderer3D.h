@@ -9,6 +9,7 @@
 #include "DataTypes/Structs.h"
 
 // Standard library includes
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <map>
@@ -36,6 +37,15 @@ namespace DDM3
     class Viewport;
     class ShadowRenderer;
     class TextureDescriptorObject;
+    class BindlessManager;
+    class HiZRenderer;
+    class DepthPrepassRenderer;
+    class RenderGraph;
+    class UpscaleRenderer;
+    class ResolutionManager;
+    class FrameCapture;
+    class GPUProfiler;
+    class RetirementManager;
 
     // Inherit from singleton
     class VulkanRenderer3D final
@@ -62,6 +72,32 @@ namespace DDM3
         void AddGraphicsPipeline(const std::string& pipelineName, std::initializer_list<const std::string>&& filePaths,
             bool hasDepthStencil = true);
 
+        // Add a new graphics pipeline that uses the bindless descriptor set layout
+        // Does nothing if bindless descriptors are disabled or not supported
+        // Parameters:
+        //     pipelineName: the name of the new pipeline
+        //     filePaths: a list of shader file names for this pipeline
+        void AddBindlessGraphicsPipeline(const std::string& pipelineName, std::initializer_list<const std::string>&& filePaths);
+
+        // Start creating multiple graphics pipelines at once on worker threads
+        // A pipeline is only waited on when it is requested for the first time
+        // Bindless pipelines are skipped if bindless descriptors are disabled or not supported
+        // Parameters:
+        //     descriptions: the descriptions of the pipelines
+        void AddGraphicsPipelines(std::vector<PipelineDescription> descriptions);
+
+        // Get the bindless manager
+        // Returns nullptr if bindless descriptors are disabled or not supported
+        BindlessManager* GetBindlessManager() const;
+
+        // Get the Hi-Z renderer
+        // Returns nullptr if occlusion culling is disabled
+        HiZRenderer* GetHiZRenderer() const;
+
+        // Get the depth pre-pass renderer
+        // Returns nullptr if the depth pre-pass is disabled
+        DepthPrepassRenderer* GetDepthPrepassRenderer() const;
+
         //Get the default image view
         VkImageView& GetDefaultImageView();
 
@@ -73,6 +109,26 @@ namespace DDM3
         //     name: the name of the requested pipeline, "Default" by default
         PipelineWrapper* GetPipeline(const std::string& name = "Default");
 
+        // Check if a pipeline with the given name exists
+        // Parameters:
+        //     name: the name of the requested pipeline
+        bool HasPipeline(const std::string& name) const;
+
+        // Log how long creating the graphics pipelines took and if the pipeline cache file was used
+        void LogPipelineStatistics() const;
+
+        // Change the amount of samples per pixel of the scene
+        // Waits until the device is idle, then recreates the renderpass, the pipelines using it and the render graph
+        // Parameters:
+        //     msaaSamples: the new amount of samples per pixel, clamped to the maximum the GPU supports
+        void SetMsaaSamples(VkSampleCountFlagBits msaaSamples);
+
+        // Get the amount of samples per pixel the scene is rendered with
+        VkSampleCountFlagBits GetMsaaSamples() const;
+
+        // Get the factor the width and height of the scene are scaled with
+        float GetRenderScale() const;
+
         // Get the commandbuffer currently in use
         VkCommandBuffer& GetCurrentCommandBuffer();
 
@@ -131,6 +187,9 @@ namespace DDM3
         // Set up the global light
         void SetupLight();
 
+        // Set up the bindless descriptors if they are enabled and supported, must be called after the global light is set up
+        void SetupBindless();
+
         // Initialize the default pipeline
         void SetupDefaultPipeline();
 
@@ -148,6 +207,9 @@ namespace DDM3
             VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels, uint32_t layerCount = 1);
 
         VkExtent2D GetSwapchainExtent() const;
+
+        // Get a pointer to the GPU profiler
+        GPUProfiler* GetGPUProfiler() const { return m_pGPUProfiler.get(); }
     private:
         std::unique_ptr<ShadowRenderer> m_pShadowRenderer{};
 
@@ -163,6 +225,18 @@ namespace DDM3
         // Pointer to thep pipeline manager
         std::unique_ptr<PipelineManager> m_pPipelineManager{};
 
+        // Pointer to the upscale renderer, it draws the scene image into the swapchain image
+        std::unique_ptr<UpscaleRenderer> m_pUpscaleRenderer{};
+
+        // Pointer to the resolution manager, it decides at which resolution the scene is rendered
+        std::unique_ptr<ResolutionManager> m_pResolutionManager{};
+
+        // Pointer to the frame capture, only used in headless mode when a capture directory is given
+        std::unique_ptr<FrameCapture> m_pFrameCapture{};
+
+        // Pointer to the GPU profiler, it measures every pass of the render graph
+        std::unique_ptr<GPUProfiler> m_pGPUProfiler{};
+
         // Pointer to the image manager
         std::unique_ptr<ImageManager> m_pImageManager{};
 
@@ -178,9 +252,40 @@ namespace DDM3
         // Pointer to the sync object manager
         std::unique_ptr<SyncObjectManager> m_pSyncObjectManager{};
 
+        // Pointer to the retirement manager, objects replaced while rendering are destroyed once the frames in flight finished
+        std::unique_ptr<RetirementManager> m_pRetirementManager{};
+
         // Pointer to the global light object
         std::unique_ptr<DirectionalLightObject> m_pGlobalLight{};
 
+        // Pointer to the bindless manager, nullptr if bindless descriptors aren't used
+        std::unique_ptr<BindlessManager> m_pBindlessManager{};
+
+        // Pointer to the Hi-Z renderer, nullptr if occlusion culling is disabled
+        std::unique_ptr<HiZRenderer> m_pHiZRenderer{};
+
+        // Pointer to the depth pre-pass renderer, nullptr if the depth pre-pass is disabled
+        std::unique_ptr<DepthPrepassRenderer> m_pDepthPrepassRenderer{};
+
+        // Pointer to the render graph, rebuilt when the swapchain is recreated
+        std::unique_ptr<RenderGraph> m_pRenderGraph{};
+
+        // Indicates if the render graph and the depth pyramid still have the size of the previous swapchain
+        bool m_RenderTargetsOutdated{};
+
+        // Handles of the images in the render graph
+        uint32_t m_MsaaColorImage{};
+        uint32_t m_SceneColorImage{};
+        uint32_t m_DepthImage{};
+        uint32_t m_ShadowMapImage{};
+
+        // The swapchain image and the models of the frame being recorded, used by the passes of the render graph
+        uint32_t m_CurrentImageIndex{};
+        std::vector<std::unique_ptr<Model>>* m_pCurrentModels{};
+
+        // The part of the offscreen images the scene of the current frame is rendered to
+        VkExtent2D m_RenderExtent{};
+
         // Initialize vulkan objects
         void InitVulkan();
 
@@ -192,9 +297,21 @@ namespace DDM3
         //     pModels: list of models that have to be rendered
         void Render(std::vector<std::unique_ptr<Model>>& pModels);
 
+        // Render all the given models to the offscreen image of the current frame, used in headless mode
+        // Parameters:
+        //     pModels: list of models that have to be rendered
+        void RenderHeadless(std::vector<std::unique_ptr<Model>>& pModels);
+
         // Recreate the swapchain
         void RecreateSwapChain();
 
+        // Build and compile the render graph for the current swapchain extent and create the frame buffer of the scene with its images
+        // The previous render graph is retired
+        void BuildRenderGraph();
+
+        // Rebuild the render graph and resize the depth pyramid after the swapchain was recreated
+        void RecreateRenderTargets();
+
         // Record the command buffer
         // Parameter:
         //     commandBuffer: the current commandBuffer
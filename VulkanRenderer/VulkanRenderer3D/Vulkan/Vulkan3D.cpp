@@ -14,11 +14,16 @@
 uint32_t DDM3::Vulkan3D::m_sMaxFramesInFlight = 1;
 
 uint32_t DDM3::Vulkan3D::m_sCurrentFrame = 0;
+uint64_t DDM3::Vulkan3D::m_sFrameCount = 0;
+bool DDM3::Vulkan3D::m_sHeadless = false;
 
 DDM3::Vulkan3D::Vulkan3D()
 {
 	m_sMaxFramesInFlight = ConfigManager::GetInstance().GetInt("MaxFramesInFlight");
 
+	// Must be known before the instance is created, headless mode doesn't need the window extensions
+	m_sHeadless = ConfigManager::GetInstance().GetBool("Headless");
+
 	m_pDispatchableManager = std::make_unique<DDM3::DispatchableManager>();
 }
 
@@ -35,6 +40,7 @@ void DDM3::Vulkan3D::Init()
 
 	m_pRenderer->SetupDefaultPipeline();
 	m_pRenderer->SetupLight();
+	m_pRenderer->SetupBindless();
 	m_pRenderer->SetupSkybox();
 
 	m_pModelManager = std::make_unique<DDM3::ModelManager>();
@@ -43,8 +49,12 @@ void DDM3::Vulkan3D::Init()
 
 void DDM3::Vulkan3D::Terminate()
 {
-	m_pRenderer = nullptr;
+	// Wait until the frames in flight finished, the models and their resources are destroyed without waiting
+	m_pDispatchableManager->WaitIdle();
+
+	// Destroy the models first, their materials still use the renderer
 	m_pModelManager = nullptr;
+	m_pRenderer = nullptr;
 }
 
 VkInstance DDM3::Vulkan3D::GetVulkanInstance() const
@@ -77,12 +87,21 @@ DDM3::VulkanRenderer3D& DDM3::Vulkan3D::GetRenderer()
 	return *m_pRenderer.get();
 }
 
-void DDM3::Vulkan3D::Render()
+void DDM3::Vulkan3D::Render(const FramePacket& packet)
 {
+	// Everything that is recorded reads the camera, transforms and light from this packet
+	m_pFramePacket = &packet;
+
+	// Render the models that were added in this frame or before
+	m_pModelManager->AddSimulatedModels(packet.frame);
+
 	m_pRenderer->Render(m_pModelManager->GetModels());
 
+	m_pFramePacket = nullptr;
+
 	// Go to the next frame
 	++m_sCurrentFrame %= m_sMaxFramesInFlight;
+	++m_sFrameCount;
 }
 
 DDM3::ModelManager* DDM3::Vulkan3D::GetModelManager()
@@ -7,6 +7,7 @@
 #include "Includes/VulkanIncludes.h"
 
 #include "Engine/Singleton.h"
+#include "Engine/FramePacket.h"
 
 #include "Vulkan/Renderers/VulkanRenderer3D.h"
 
@@ -38,6 +39,10 @@ namespace DDM3
 
 		static uint32_t GetMaxFrames() { return m_sMaxFramesInFlight; }
 		static uint32_t GetCurrentFrame() { return m_sCurrentFrame; }
+		static uint64_t GetFrameCount() { return m_sFrameCount; }
+
+		// Check if the renderer runs without a window, surface and swapchain
+		static bool IsHeadless() { return m_sHeadless; }
 
 		// Initialize the renderer, must be called at start of program
 		void Init();
@@ -63,7 +68,12 @@ namespace DDM3
 		VulkanRenderer3D& GetRenderer();
 
 		// Main render function
-		void Render();
+		// Parameters:
+		//     packet: the simulated state of the frame, has to stay unchanged until the function returns
+		void Render(const FramePacket& packet);
+
+		// Get the frame packet that is being rendered, only valid during Render
+		const FramePacket& GetFramePacket() const { return *m_pFramePacket; }
 
 		// Get model manager
 		ModelManager* GetModelManager();
@@ -84,6 +94,12 @@ namespace DDM3
 		// The current frame
 		static uint32_t m_sCurrentFrame;
 
+		// The amount of frames that have been rendered
+		static uint64_t m_sFrameCount;
+
+		// Indicates if the renderer runs without a window, surface and swapchain
+		static bool m_sHeadless;
+
 		// Dispatchable manager
 		std::unique_ptr<DDM3::DispatchableManager> m_pDispatchableManager{};
 
@@ -95,6 +111,9 @@ namespace DDM3
 
 		// Camera Manager
 		std::unique_ptr<DDM3::CameraManager> m_pCameraManager{};
+
+		// The frame packet that is being rendered
+		const FramePacket* m_pFramePacket{};
 	};
 
 }
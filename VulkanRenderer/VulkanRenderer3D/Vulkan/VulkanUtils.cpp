@@ -100,8 +100,16 @@ DDM3::QueueFamilyIndices VulkanUtils::FindQueueFamilies(VkPhysicalDevice physica
 		}
 
 		VkBool32 presentSupport = false;
-		// Check if the graphics family index is supported
-		vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
+		// Without a surface nothing is presented, so the graphics family is used
+		if (surface == VK_NULL_HANDLE)
+		{
+			presentSupport = indices.graphicsFamily == i;
+		}
+		else
+		{
+			// Check if the graphics family index is supported
+			vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
+		}
 
 		// If it is supported
 		if (presentSupport)
@@ -3,56 +3,58 @@
 // File includes
 #include "DescriptorPoolWrapper.h"
 #include "Vulkan/Vulkan3D.h"
-#include "DataTypes/RenderClasses/Model.h" 
 #include "DataTypes/DescriptorObjects/DescriptorObject.h"
 #include "ShaderModuleWrapper.h"
 
+// Standard library includes
+#include <stdexcept>
 
-DDM3::DescriptorPoolWrapper::DescriptorPoolWrapper(std::vector<std::unique_ptr<DDM3::ShaderModuleWrapper>>& shaderModules)
+
+DDM3::DescriptorPoolWrapper::DescriptorPoolWrapper(const std::vector<std::shared_ptr<DDM3::ShaderModuleWrapper>>& shaderModules)
 {
 	// Read the number of bindings per type
 	ReadDescriptorTypeCount(shaderModules);
 
-	// Initialize the descriptor pool
-	InitDescriptorPool();
+	// Create the first descriptor pool
+	AddDescriptorPool();
 }
 
 
 void DDM3::DescriptorPoolWrapper::Cleanup(VkDevice device)
 {
-	// Destroy the descriptorPool
-	vkDestroyDescriptorPool(device, m_DescriptorPool, nullptr);
-
-	// Clear the vector of moddels
-	m_pModels.clear();
-}
-
-void DDM3::DescriptorPoolWrapper::AddModel(Model* pModel)
-{
-	// Check if the model is already in the vector, if not add it
-	if (std::find(m_pModels.begin(), m_pModels.end(), pModel) == m_pModels.end())
+	// Destroy all the descriptorPools, this also frees all their descriptorsets
+	for (auto& descriptorPool : m_DescriptorPools)
 	{
-		m_pModels.push_back(pModel);
+		vkDestroyDescriptorPool(device, descriptorPool, nullptr);
 	}
-}
 
-void DDM3::DescriptorPoolWrapper::RemoveModel(Model* pModel)
-{
-	// Remove model from vector
-	m_pModels.erase(std::remove(m_pModels.begin(), m_pModels.end(), pModel), m_pModels.end());
+	// Clear the pools and the recycled descriptorsets
+	m_DescriptorPools.clear();
+	m_FreeDescriptorSets.clear();
+	m_RetiredDescriptorSets.clear();
 }
 
 void DDM3::DescriptorPoolWrapper::CreateDescriptorSets(VkDescriptorSetLayout layout, std::vector<VkDescriptorSet>& descriptorSets)
 {
-	// Check if the amount of already allocated descriptorsets is larger or equal to the max amoount, if it is, resize and return
-	if (m_AllocatedDescriptorSets >= m_MaxDescriptorSets)
+	// Make the descriptorsets that are no longer in use available
+	ReleaseRetiredDescriptorSets();
+
+	// Get the free descriptorsets for this layout
+	auto& freeDescriptorSets{ m_FreeDescriptorSets[layout] };
+
+	// If there are free descriptorsets, reuse them
+	if (!freeDescriptorSets.empty())
 	{
-		ResizeDescriptorPool();
+		descriptorSets = std::move(freeDescriptorSets.back());
+		freeDescriptorSets.pop_back();
 		return;
 	}
 
-	// Get a reference to the renderer for later use
-	auto& renderer{ Vulkan3D::GetInstance().GetRenderer()};
+	// Check if the amount of already allocated descriptorsets is larger or equal to the max amount, if it is, add a new pool
+	if (m_AllocatedDescriptorSets >= m_MaxDescriptorSets)
+	{
+		AddDescriptorPool();
+	}
 
 	// Get the amount of frames in flight
 	auto maxFrames = Vulkan3D::GetMaxFrames();
@@ -61,8 +63,8 @@ void DDM3::DescriptorPoolWrapper::CreateDescriptorSets(VkDescriptorSetLayout lay
 	VkDescriptorSetAllocateInfo allocInfo{};
 	// Set type to descriptor set allocate info
 	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-	// Give the right descriptorpool
-	allocInfo.descriptorPool = m_DescriptorPool;
+	// Give the newest descriptorpool
+	allocInfo.descriptorPool = m_DescriptorPools.back();
 	// Give the amount of descriptorsets to be allocated
 	allocInfo.descriptorSetCount = static_cast<uint32_t>(maxFrames);
 	// Create vector of descriptorsets the size of maxFrames and fill with layout
@@ -72,8 +74,19 @@ void DDM3::DescriptorPoolWrapper::CreateDescriptorSets(VkDescriptorSetLayout lay
 	// Resize descriptorsets to right amount
 	descriptorSets.resize(maxFrames);
 
-	// Allocate descriptorsets, if not succeeded, throw runtime error
-	if (vkAllocateDescriptorSets(Vulkan3D::GetInstance().GetDevice(), &allocInfo, descriptorSets.data()) != VK_SUCCESS)
+	// Allocate descriptorsets
+	auto result{ vkAllocateDescriptorSets(Vulkan3D::GetInstance().GetDevice(), &allocInfo, descriptorSets.data()) };
+
+	// If the pool ran out of memory, add a new pool and try again
+	if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+	{
+		AddDescriptorPool();
+		allocInfo.descriptorPool = m_DescriptorPools.back();
+		result = vkAllocateDescriptorSets(Vulkan3D::GetInstance().GetDevice(), &allocInfo, descriptorSets.data());
+	}
+
+	// If not succeeded, throw runtime error
+	if (result != VK_SUCCESS)
 	{
 		throw std::runtime_error("failed to allocate descriptor sets!");
 	}
@@ -82,6 +95,19 @@ void DDM3::DescriptorPoolWrapper::CreateDescriptorSets(VkDescriptorSetLayout lay
 	m_AllocatedDescriptorSets++;
 }
 
+void DDM3::DescriptorPoolWrapper::FreeDescriptorSets(VkDescriptorSetLayout layout, std::vector<VkDescriptorSet>& descriptorSets)
+{
+	// If there are no descriptorsets, there is nothing to free
+	if (descriptorSets.empty())
+		return;
+
+	// Retire the descriptorsets, frames in flight might still use them
+	m_RetiredDescriptorSets.push_back(RetiredDescriptorSets{ layout, std::move(descriptorSets), Vulkan3D::GetFrameCount() });
+
+	// Clear the given vector
+	descriptorSets.clear();
+}
+
 void DDM3::DescriptorPoolWrapper::UpdateDescriptorSets(std::vector<VkDescriptorSet>& descriptorSets, std::vector<DescriptorObject*>& descriptorObjects)
 {
 	// Loop trough all the descriptor sets
@@ -105,39 +131,17 @@ void DDM3::DescriptorPoolWrapper::UpdateDescriptorSets(std::vector<VkDescriptorS
 	}
 }
 
-void DDM3::DescriptorPoolWrapper::ResizeDescriptorPool()
+void DDM3::DescriptorPoolWrapper::AddDescriptorPool()
 {
-	// Destroy current descriptorpool
-	vkDestroyDescriptorPool(Vulkan3D::GetInstance().GetDevice(), m_DescriptorPool, nullptr);
-
-	// Multiply max amount of descriptorsets by increaseFactor
-	m_MaxDescriptorSets *= m_IncreaseFactor;
-	// Reset amount of allocated descriptorsets to 0
-	m_AllocatedDescriptorSets = 0;
-
-	// Initialize the descriptorPool again
-	InitDescriptorPool();
-
-	// Create new descriptorsets for all models boudn to this descriptorpool
-	for (auto& pModel : m_pModels)
+	// Every new pool is larger than the previous one, the first pool keeps the starting size
+	if (!m_DescriptorPools.empty())
 	{
-		pModel->CreateDescriptorSets();
+		// Multiply max amount of descriptorsets by increaseFactor
+		m_MaxDescriptorSets *= m_IncreaseFactor;
 	}
-}
 
-void DDM3::DescriptorPoolWrapper::ReadDescriptorTypeCount(std::vector<std::unique_ptr<DDM3::ShaderModuleWrapper>>& shaderModules)
-{
-	// Loop trough all shader modules and add the descriptor count
-	for (auto& shaderModule : shaderModules)
-	{
-		shaderModule->AddDescriptorTypeCount(m_DescriptorTypeCount);
-	}
-}
-
-void DDM3::DescriptorPoolWrapper::InitDescriptorPool()
-{
-	// Get a reference to the renderer
-	auto& renderer{ Vulkan3D::GetInstance().GetRenderer()};
+	// Reset amount of allocated descriptorsets to 0
+	m_AllocatedDescriptorSets = 0;
 
 	// Get the amount of frames in flight
 	auto frames{ Vulkan3D::GetMaxFrames() };
@@ -169,10 +173,42 @@ void DDM3::DescriptorPoolWrapper::InitDescriptorPool()
 	// Give max sets
 	poolInfo.maxSets = static_cast<uint32_t>(frames * m_MaxDescriptorSets);
 
+	// Create descriptorpool
+	VkDescriptorPool descriptorPool{};
+
 	// Created descriptorpool, if not successful, throw runtime error
-	if (vkCreateDescriptorPool(Vulkan3D::GetInstance().GetDevice(), &poolInfo, nullptr, &m_DescriptorPool) != VK_SUCCESS) {
+	if (vkCreateDescriptorPool(Vulkan3D::GetInstance().GetDevice(), &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS) {
 		throw std::runtime_error("failed to create descriptor pool!");
 	}
+
+	// Add the new pool to the chain
+	m_DescriptorPools.push_back(descriptorPool);
 }
 
+void DDM3::DescriptorPoolWrapper::ReleaseRetiredDescriptorSets()
+{
+	// Get the amount of frames in flight
+	auto frames{ Vulkan3D::GetMaxFrames() };
+	// Get the amount of frames that have been rendered
+	auto frameCount{ Vulkan3D::GetFrameCount() };
+
+	// Once as many frames as there are frames in flight have been rendered since retiring, the descriptorsets are no longer in use
+	while (!m_RetiredDescriptorSets.empty() && m_RetiredDescriptorSets.front().frame + frames <= frameCount)
+	{
+		// Move the descriptorsets to the free list of their layout
+		auto& retired{ m_RetiredDescriptorSets.front() };
+		m_FreeDescriptorSets[retired.layout].push_back(std::move(retired.descriptorSets));
+
+		// Remove them from the retired descriptorsets
+		m_RetiredDescriptorSets.pop_front();
+	}
+}
 
+void DDM3::DescriptorPoolWrapper::ReadDescriptorTypeCount(const std::vector<std::shared_ptr<DDM3::ShaderModuleWrapper>>& shaderModules)
+{
+	// Loop trough all shader modules and add the descriptor count
+	for (auto& shaderModule : shaderModules)
+	{
+		shaderModule->AddDescriptorTypeCount(m_DescriptorTypeCount);
+	}
+}
@@ -1,5 +1,6 @@
 // DescriptorPoolWrapper.h
-// This class manages a single descriptor pool, it updates descriptorsets and resizes the pool when necesarry
+// This class manages a chain of descriptor pools, it allocates, recycles and updates descriptorsets
+// When a pool is full a new, larger pool is added to the chain, existing descriptorsets are never invalidated
 // Because of the way descriptorpools work, every wrapper will work for a specific amount of ubos and textures
 
 #ifndef DescriptorPoolWrapperIncluded
@@ -12,12 +13,12 @@
 // Standard library includes
 #include <vector>
 #include <map>
+#include <deque>
 #include <memory>
 
 namespace DDM3
 {
 	// Class forward declarations
-	class Model;
 	class DescriptorObject;
 	class ShaderModuleWrapper;
 
@@ -27,7 +28,7 @@ namespace DDM3
 		// Constructor
 		// Parameters:
 		//     shaderModules: a vector of shaderModules of the different requested shader files
-		DescriptorPoolWrapper(std::vector<std::unique_ptr<DDM3::ShaderModuleWrapper>>& shaderModules);
+		DescriptorPoolWrapper(const std::vector<std::shared_ptr<DDM3::ShaderModuleWrapper>>& shaderModules);
 
 		// Delete default constructor
 		DescriptorPoolWrapper() = delete;
@@ -47,21 +48,19 @@ namespace DDM3
 		//     device: the vulkan logical device
 		void Cleanup(VkDevice device);
 
-		// This function adds a model to the vector of models
-		// Parameters:
-		//     pModel: the model to add
-		void AddModel(Model* pModel);
-
-		// This function removes a model from the vector of models
-		// Parameters:
-		//     pModel: the model to remove
-		void RemoveModel(Model* pModel);
-
 		// This function will create a descriptorset with the given layout
+		// Recycled descriptorsets with the same layout are reused first, if the current pool is full a new pool is added
 		// Parameters:
 		//     layout: the layout of the descriprot set
 		//     descriptorSets: the vector of descriptor sets that should be created in this function
 		void CreateDescriptorSets(VkDescriptorSetLayout layouts, std::vector<VkDescriptorSet>& descriptorSets);
+
+		// This function will return descriptorsets so they can be reused
+		// The descriptorsets are only reused once the frames in flight that might still use them are finished
+		// Parameters:
+		//     layout: the layout the descriptorsets were created with
+		//     descriptorSets: the descriptorsets to return, the vector will be cleared
+		void FreeDescriptorSets(VkDescriptorSetLayout layout, std::vector<VkDescriptorSet>& descriptorSets);
 		
 		// This function will update the given descriptorsets
 		// Parameters:
@@ -70,31 +69,42 @@ namespace DDM3
 		// The amount of bindings per descriptor set type
 		std::map<VkDescriptorType, int> m_DescriptorTypeCount{};
 
-		// The max amount of descriptorsets that can be allocated with this pool
+		// Descriptorsets that were freed, together with their layout and the frame they were freed in
+		struct RetiredDescriptorSets
+		{
+			VkDescriptorSetLayout layout{};
+			std::vector<VkDescriptorSet> descriptorSets{};
+			uint64_t frame{};
+		};
+
+		// The max amount of descriptorsets that can be allocated with the newest pool
 		int m_MaxDescriptorSets{ 8 };
 
-		// The factor with what the pool increases in size when full
+		// The factor with what every new pool increases in size
 		int m_IncreaseFactor{ 2 };
 
-		// The amount of already allocated descriptorsets
+		// The amount of already allocated descriptorsets in the newest pool
 		int m_AllocatedDescriptorSets{};
 
-		// The current descriptorpool
-		VkDescriptorPool m_DescriptorPool{};
-		
-		// The models to which the allocated descriptorsets belong, needed when resizing the pool
-		std::vector<Model*> m_pModels{};
+		// The chain of descriptorpools, descriptorsets are allocated from the last one
+		std::vector<VkDescriptorPool> m_DescriptorPools{};
+
+		// Descriptorsets that are free to be reused, per layout
+		std::map<VkDescriptorSetLayout, std::vector<std::vector<VkDescriptorSet>>> m_FreeDescriptorSets{};
+
+		// Descriptorsets that were freed but might still be used by frames in flight, ordered by the frame they were freed in
+		std::deque<RetiredDescriptorSets> m_RetiredDescriptorSets{};
 
-		// Initialization of the descriptorpool
-		void InitDescriptorPool();
+		// Add a new descriptorpool to the chain
+		void AddDescriptorPool();
 
-		// Resizing of descriptorPool
-		void ResizeDescriptorPool();
+		// Move the retired descriptorsets that are no longer in use to the free lists
+		void ReleaseRetiredDescriptorSets();
 
 		// Read the amount of bindings per type from the shader modules
 		// Parameters:
 		//     shaderModules: a vector of shaderModules of the different requested shader files
-		void ReadDescriptorTypeCount(std::vector<std::unique_ptr<DDM3::ShaderModuleWrapper>>& shaderModules);
+		void ReadDescriptorTypeCount(const std::vector<std::shared_ptr<DDM3::ShaderModuleWrapper>>& shaderModules);
 	};
 }
 
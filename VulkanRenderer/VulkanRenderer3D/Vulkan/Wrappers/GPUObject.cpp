@@ -4,14 +4,23 @@
 #include "GPUObject.h"
 #include "Vulkan/VulkanUtils.h"
 #include "InstanceWrapper.h"
+#include "Engine/ConfigManager.h"
 
 // Standard library includes
 #include <stdexcept>
+#include <iostream>
+#include <algorithm>
 #include <map>
 #include <set>
 
 DDM3::GPUObject::GPUObject(InstanceWrapper* pInstanceWrapper, VkSurfaceKHR surface)
 {
+	// Without a surface there is no swapchain, so the swapchain extension isn't needed
+	if (surface == VK_NULL_HANDLE)
+	{
+		std::erase_if(m_DeviceExtensions, [](const char* extension) { return std::string{ extension } == VK_KHR_SWAPCHAIN_EXTENSION_NAME; });
+	}
+
 	// Pick the physical device
 	PickPhysicalDevice(pInstanceWrapper, surface);
 
@@ -73,6 +82,47 @@ void DDM3::GPUObject::PickPhysicalDevice(InstanceWrapper* pInstanceWrapper, VkSu
 		// If null handle, throw runtime error
 		throw std::runtime_error("failed to find a suitable GPU!");
 	}
+
+	// Check if bindless descriptors are requested
+	if (ConfigManager::GetInstance().GetBool("BindlessDescriptors"))
+	{
+		// Check if the physical device supports them
+		m_BindlessSupported = CheckBindlessSupport(m_PhysicalDevice);
+
+		// If not supported, fall back to descriptorsets per model
+		if (!m_BindlessSupported)
+		{
+			std::cout << "Bindless descriptors are not supported by this GPU, falling back to descriptorsets per model\n";
+		}
+	}
+
+	// Check if extended dynamic state is requested
+	if (ConfigManager::GetInstance().GetBool("ExtendedDynamicState"))
+	{
+		// Check if the physical device supports it
+		m_ExtendedDynamicStateSupported = CheckExtendedDynamicStateSupport(m_PhysicalDevice);
+
+		// If not supported, cull mode and depth state are baked into the pipelines
+		if (!m_ExtendedDynamicStateSupported)
+		{
+			std::cout << "Extended dynamic state is not supported by this GPU, falling back to static pipeline state\n";
+		}
+	}
+
+	// Check if pipeline statistics are requested
+	if (ConfigManager::GetInstance().GetBool("PipelineStatistics"))
+	{
+		// Check if the physical device supports them
+		VkPhysicalDeviceFeatures supportedFeatures{};
+		vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &supportedFeatures);
+		m_PipelineStatisticsSupported = supportedFeatures.pipelineStatisticsQuery == VK_TRUE;
+
+		// If not supported, only the timestamps are measured
+		if (!m_PipelineStatisticsSupported)
+		{
+			std::cout << "Pipeline statistics queries are not supported by this GPU, only GPU times are measured\n";
+		}
+	}
 }
 
 bool DDM3::GPUObject::IsDeviceSuitable(VkPhysicalDevice device, VkSurfaceKHR surface)
@@ -86,8 +136,13 @@ bool DDM3::GPUObject::IsDeviceSuitable(VkPhysicalDevice device, VkSurfaceKHR sur
 	// Boolean for adequaty of the swapchain
 	bool swapChainAdequate = false;
 
+	// Without a surface no swapchain is created
+	if (surface == VK_NULL_HANDLE)
+	{
+		swapChainAdequate = extensionsSupported;
+	}
 	// If the extensions are supported
-	if (extensionsSupported)
+	else if (extensionsSupported)
 	{
 		// Get the swapchain support details
 		SwapChainSupportDetails swapChainSupport = VulkanUtils::QuerySwapChainSupport(device, surface);
@@ -133,6 +188,116 @@ bool DDM3::GPUObject::CheckDeviceExtensionSupport(VkPhysicalDevice device)
 	return requiredExtensions.empty();
 }
 
+bool DDM3::GPUObject::CheckBindlessSupport(VkPhysicalDevice device)
+{
+	// Get the physical device properties
+	VkPhysicalDeviceProperties properties{};
+	vkGetPhysicalDeviceProperties(device, &properties);
+
+	// Descriptor indexing is core since Vulkan 1.2
+	if (properties.apiVersion < VK_API_VERSION_1_2)
+	{
+		return false;
+	}
+
+	// Create descriptor indexing properties object
+	VkPhysicalDeviceDescriptorIndexingProperties indexingProperties{};
+	// Set type to descriptor indexing properties
+	indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+
+	// Create properties 2 object and chain the descriptor indexing properties
+	VkPhysicalDeviceProperties2 properties2{};
+	// Set type to physical device properties 2
+	properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	// Chain the descriptor indexing properties
+	properties2.pNext = &indexingProperties;
+
+	// Get the properties
+	vkGetPhysicalDeviceProperties2(device, &properties2);
+
+	// Create descriptor indexing features object
+	VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{};
+	// Set type to descriptor indexing features
+	indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+
+	// Create features 2 object and chain the descriptor indexing features
+	VkPhysicalDeviceFeatures2 features2{};
+	// Set type to physical device features 2
+	features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	// Chain the descriptor indexing features
+	features2.pNext = &indexingFeatures;
+
+	// Get the features
+	vkGetPhysicalDeviceFeatures2(device, &features2);
+
+	// Clamp the requested amount of textures to the limit of the device
+	m_MaxBindlessTextures = std::min(static_cast<uint32_t>(ConfigManager::GetInstance().GetInt("MaxBindlessTextures")),
+		indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages);
+
+	// Return true if:
+	// At least one texture fits in the texture array
+	// Arrays of textures without a fixed size are supported
+	// Textures can be indexed with a non uniform index
+	// Not every texture in the array has to be written
+	// Textures can be written after the descriptorset is bound
+	// Unused textures can be written while the descriptorset is in use
+	// The size of the texture array can be chosen at allocation
+	return m_MaxBindlessTextures > 0 && indexingFeatures.runtimeDescriptorArray
+		&& indexingFeatures.shaderSampledImageArrayNonUniformIndexing
+		&& indexingFeatures.descriptorBindingPartiallyBound
+		&& indexingFeatures.descriptorBindingSampledImageUpdateAfterBind
+		&& indexingFeatures.descriptorBindingUpdateUnusedWhilePending
+		&& indexingFeatures.descriptorBindingVariableDescriptorCount;
+}
+
+bool DDM3::GPUObject::CheckExtendedDynamicStateSupport(VkPhysicalDevice device)
+{
+	// Get the physical device properties
+	VkPhysicalDeviceProperties properties{};
+	vkGetPhysicalDeviceProperties(device, &properties);
+
+	// The features are queried with vkGetPhysicalDeviceFeatures2, which is core since Vulkan 1.1
+	if (properties.apiVersion < VK_API_VERSION_1_1)
+	{
+		return false;
+	}
+
+	// Get the amount of extensions
+	uint32_t extensionCount{};
+	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+	// Get the extensions
+	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+	// Check if the extension is available
+	bool extensionAvailable{ std::any_of(availableExtensions.begin(), availableExtensions.end(), [](const VkExtensionProperties& extension)
+		{
+			return std::string{ extension.extensionName } == VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME;
+		}) };
+
+	if (!extensionAvailable)
+	{
+		return false;
+	}
+
+	// Create extended dynamic state features object
+	VkPhysicalDeviceExtendedDynamicStateFeaturesEXT dynamicStateFeatures{};
+	// Set type to extended dynamic state features
+	dynamicStateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+
+	// Create features 2 object and chain the extended dynamic state features
+	VkPhysicalDeviceFeatures2 features2{};
+	// Set type to physical device features 2
+	features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	// Chain the extended dynamic state features
+	features2.pNext = &dynamicStateFeatures;
+
+	// Get the features
+	vkGetPhysicalDeviceFeatures2(device, &features2);
+
+	return dynamicStateFeatures.extendedDynamicState == VK_TRUE;
+}
 
 void DDM3::GPUObject::CreateLogicalDevice(InstanceWrapper* pInstanceWrapper, VkSurfaceKHR surface)
 {
@@ -171,6 +336,8 @@ void DDM3::GPUObject::CreateLogicalDevice(InstanceWrapper* pInstanceWrapper, VkS
 	deviceFeatures.samplerAnisotropy = VK_TRUE;
 	// Enable sampler rate shading
 	deviceFeatures.sampleRateShading = VK_TRUE;
+	// Enable pipeline statistics queries if they are used
+	deviceFeatures.pipelineStatisticsQuery = m_PipelineStatisticsSupported ? VK_TRUE : VK_FALSE;
 
 	// Create device create info
 	VkDeviceCreateInfo createInfo{};
@@ -182,10 +349,59 @@ void DDM3::GPUObject::CreateLogicalDevice(InstanceWrapper* pInstanceWrapper, VkS
 	createInfo.pQueueCreateInfos = queueCreateInfos.data();
 	// Give the requested device features
 	createInfo.pEnabledFeatures = &deviceFeatures;
+	// Get the requested extensions and add the optional ones that are supported
+	std::vector<const char*> extensions{ m_DeviceExtensions };
+	if (m_ExtendedDynamicStateSupported)
+	{
+		extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+	}
+
 	// Set amount of extensions to the size of the extensions vector
-	createInfo.enabledExtensionCount = static_cast<uint32_t>(m_DeviceExtensions.size());
+	createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
 	// Give pointer to data of extensions vector
-	createInfo.ppEnabledExtensionNames = m_DeviceExtensions.data();
+	createInfo.ppEnabledExtensionNames = extensions.data();
+
+	// Create extended dynamic state features object
+	VkPhysicalDeviceExtendedDynamicStateFeaturesEXT dynamicStateFeatures{};
+	// Set type to extended dynamic state features
+	dynamicStateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+
+	// If extended dynamic state is supported, enable it
+	if (m_ExtendedDynamicStateSupported)
+	{
+		// Enable setting cull mode and depth state while recording
+		dynamicStateFeatures.extendedDynamicState = VK_TRUE;
+
+		// Chain the extended dynamic state features
+		dynamicStateFeatures.pNext = const_cast<void*>(createInfo.pNext);
+		createInfo.pNext = &dynamicStateFeatures;
+	}
+
+	// Create descriptor indexing features object
+	VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{};
+	// Set type to descriptor indexing features
+	indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+
+	// If bindless descriptors are supported, enable the needed descriptor indexing features
+	if (m_BindlessSupported)
+	{
+		// Enable arrays without a fixed size
+		indexingFeatures.runtimeDescriptorArray = VK_TRUE;
+		// Enable non uniform indexing of texture arrays
+		indexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		// Enable partially written texture arrays
+		indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+		// Enable writing textures after the descriptorset is bound
+		indexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		// Enable writing unused textures while the descriptorset is in use
+		indexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+		// Enable choosing the size of the texture array at allocation
+		indexingFeatures.descriptorBindingVariableDescriptorCount = VK_TRUE;
+
+		// Chain the descriptor indexing features
+		indexingFeatures.pNext = const_cast<void*>(createInfo.pNext);
+		createInfo.pNext = &indexingFeatures;
+	}
 
 	// Check if validation layers are enabled
 	if (pInstanceWrapper->ValidationLayersEnabled())
@@ -212,4 +428,17 @@ void DDM3::GPUObject::CreateLogicalDevice(InstanceWrapper* pInstanceWrapper, VkS
 	vkGetDeviceQueue(m_Device, indices.graphicsFamily.value(), 0, &m_QueueObject.graphicsQueue);
 	// Get the present queue
 	vkGetDeviceQueue(m_Device, indices.presentFamily.value(), 0, &m_QueueObject.presentQueue);
+
+	// Load the functions of the extended dynamic state extension
+	if (m_ExtendedDynamicStateSupported)
+	{
+		m_ExtendedDynamicStateFunctions.vkCmdSetCullMode =
+			reinterpret_cast<PFN_vkCmdSetCullModeEXT>(vkGetDeviceProcAddr(m_Device, "vkCmdSetCullModeEXT"));
+		m_ExtendedDynamicStateFunctions.vkCmdSetDepthTestEnable =
+			reinterpret_cast<PFN_vkCmdSetDepthTestEnableEXT>(vkGetDeviceProcAddr(m_Device, "vkCmdSetDepthTestEnableEXT"));
+		m_ExtendedDynamicStateFunctions.vkCmdSetDepthWriteEnable =
+			reinterpret_cast<PFN_vkCmdSetDepthWriteEnableEXT>(vkGetDeviceProcAddr(m_Device, "vkCmdSetDepthWriteEnableEXT"));
+		m_ExtendedDynamicStateFunctions.vkCmdSetDepthCompareOp =
+			reinterpret_cast<PFN_vkCmdSetDepthCompareOpEXT>(vkGetDeviceProcAddr(m_Device, "vkCmdSetDepthCompareOpEXT"));
+	}
 }
\ No newline at end of file
@@ -48,13 +48,29 @@ namespace DDM3
 		// Get eh object holding information about graphics- and present queues
 		const QueueObject& GetQueueObject() const { return m_QueueObject; }
 
+		// Check if bindless descriptors were requested and are supported by the physical device
+		bool IsBindlessSupported() const { return m_BindlessSupported; }
+
+		// Check if pipeline statistics queries were requested and are supported by the physical device
+		bool IsPipelineStatisticsSupported() const { return m_PipelineStatisticsSupported; }
+
+		// Get the maximum amount of textures that can be bound in the bindless texture array
+		uint32_t GetMaxBindlessTextures() const { return m_MaxBindlessTextures; }
+
+		// Get the functions of the extended dynamic state extension
+		// Returns nullptr if extended dynamic state wasn't requested or isn't supported
+		const ExtendedDynamicStateFunctions* GetExtendedDynamicState() const
+		{
+			return m_ExtendedDynamicStateSupported ? &m_ExtendedDynamicStateFunctions : nullptr;
+		}
+
 
 	private:
 		// Handle of the VkPhysicalDevice
 		VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
 
-		// Vector of requested device extensions
-		const std::vector<const char*> m_DeviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+		// Vector of requested device extensions, the swapchain extension is removed without a surface
+		std::vector<const char*> m_DeviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME,
 		VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME };
 
 		// Handle of the logical device
@@ -63,6 +79,21 @@ namespace DDM3
 		// Object that holds the graphics and present family queues
 		QueueObject m_QueueObject{};
 
+		// Indicates if the descriptor indexing features needed for bindless descriptors are enabled
+		bool m_BindlessSupported{ false };
+
+		// The maximum amount of textures in the bindless texture array
+		uint32_t m_MaxBindlessTextures{};
+
+		// Indicates if the extended dynamic state extension is enabled
+		bool m_ExtendedDynamicStateSupported{ false };
+
+		// The functions of the extended dynamic state extension
+		ExtendedDynamicStateFunctions m_ExtendedDynamicStateFunctions{};
+
+		// Indicates if the pipeline statistics query feature is enabled
+		bool m_PipelineStatisticsSupported{ false };
+
 
 		// Pick the physical device
 		void PickPhysicalDevice(InstanceWrapper* pInstanceWrapper, VkSurfaceKHR surface);
@@ -77,6 +108,16 @@ namespace DDM3
 		//     device: the device to be checked
 		bool CheckDeviceExtensionSupport(VkPhysicalDevice device);
 
+		// Check if the physical device supports the descriptor indexing features needed for bindless descriptors
+		// Parameters:
+		//     device: the device to be checked
+		bool CheckBindlessSupport(VkPhysicalDevice device);
+
+		// Check if the physical device supports the extended dynamic state extension
+		// Parameters:
+		//     device: the device to be checked
+		bool CheckExtendedDynamicStateSupport(VkPhysicalDevice device);
+
 		// Initialize the logical device
 		void CreateLogicalDevice(InstanceWrapper* pInstanceWrapper, VkSurfaceKHR surface);
 	};
@@ -59,11 +59,6 @@ void DDM3::ImGuiWrapper::StartRender()
 	ImGui_ImplVulkan_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
 	ImGui::NewFrame();
-
-	// Show the demo window
-	ImGui::ShowDemoWindow();
-
-	
 }
 
 void DDM3::ImGuiWrapper::EndRender(VkCommandBuffer commandBuffer)
@@ -5,6 +5,7 @@
 #include "Includes/GLFWIncludes.h"
 #include "Vulkan/VulkanUtils.h"
 #include "Engine/ConfigManager.h"
+#include "Vulkan/Vulkan3D.h"
 
 // Standard library includes
 #include <stdexcept>
@@ -114,8 +115,10 @@ void DDM3::InstanceWrapper::SetupApplicationInfo(VkApplicationInfo& appInfo, std
 	appInfo.engineVersion = VK_MAKE_VERSION(configManager.GetInt("EngineVersionMajor"),
 		configManager.GetInt("EngineVersionMinor"),
 		configManager.GetInt("EngineVersionPatch"));
-	// Set version of api
-	appInfo.apiVersion = VK_API_VERSION_1_0;
+	// Set version of api, bindless descriptors need descriptor indexing which is core since Vulkan 1.2
+	// Extended dynamic state is checked with vkGetPhysicalDeviceFeatures2, which is core since Vulkan 1.1
+	appInfo.apiVersion = configManager.GetBool("BindlessDescriptors") ? VK_API_VERSION_1_2 :
+		configManager.GetBool("ExtendedDynamicState") ? VK_API_VERSION_1_1 : VK_API_VERSION_1_0;
 }
 
 bool DDM3::InstanceWrapper::CheckValidationLayerSupport(const std::vector<const char *> validationLayers)
@@ -161,16 +164,23 @@ bool DDM3::InstanceWrapper::CheckValidationLayerSupport(const std::vector<const
 
 std::vector<const char*> DDM3::InstanceWrapper::GetRequiredExtensions(bool enableValidationLayers)
 {
-	// Crate uint fro the amount of glfw extensions
-	uint32_t glfwExtensionCount = 0;
-	// Create char** for the names of the glfw estensions
-	const char** glfwExtensions;
+	// Create a vector to hold the extensions
+	std::vector<const char*> extensions{};
 
-	// Get the glfw extensions and their count
-	glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+	// Headless mode has no window, so the surface extensions aren't needed
+	if (!Vulkan3D::IsHeadless())
+	{
+		// Crate uint fro the amount of glfw extensions
+		uint32_t glfwExtensionCount = 0;
+		// Create char** for the names of the glfw estensions
+		const char** glfwExtensions;
+
+		// Get the glfw extensions and their count
+		glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
 
-	// Create a vector to hold the extensions, starting from the address of glfwExtensions and ending at glfwExtensions + the amount of extensions
-	std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+		// Add the extensions, starting from the address of glfwExtensions and ending at glfwExtensions + the amount of extensions
+		extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+	}
 
 	// If the validation layers are enabled
 	if (enableValidationLayers)
@@ -5,16 +5,72 @@
 #include "Vulkan/Vulkan3D.h"
 #include "ShaderModuleWrapper.h"
 #include "DescriptorPoolWrapper.h"
+#include "Vulkan/Managers/ShaderManager.h"
 
 // Standard library include
 #include <stdexcept>
 
-DDM3::PipelineWrapper::PipelineWrapper(VkDevice device, VkRenderPass renderPass,
+DDM3::PipelineWrapper::PipelineWrapper(VkDevice device, ShaderManager* pShaderManager, VkRenderPass renderPass,
 	VkSampleCountFlagBits sampleCount,
-	std::initializer_list<const std::string>& filePaths, bool hasDepthStencil)
+	std::initializer_list<const std::string>& filePaths, bool hasDepthStencil,
+	VkDescriptorSetLayout descriptorSetLayout, bool depthOnly, bool createDepthEqualVariant, VkPipelineCache pipelineCache)
+	:PipelineWrapper(device, pShaderManager, renderPass, sampleCount, std::vector<std::string>(filePaths.begin(), filePaths.end()), hasDepthStencil,
+		descriptorSetLayout, depthOnly, createDepthEqualVariant, pipelineCache)
+{
+}
+
+DDM3::PipelineWrapper::PipelineWrapper(VkDevice device, ShaderManager* pShaderManager, VkRenderPass renderPass,
+	VkSampleCountFlagBits sampleCount,
+	const std::vector<std::string>& filePaths, bool hasDepthStencil,
+	VkDescriptorSetLayout descriptorSetLayout, bool depthOnly, bool createDepthEqualVariant, VkPipelineCache pipelineCache)
+	:PipelineWrapper(device, pShaderManager, CreateStateKey(renderPass, sampleCount, filePaths, hasDepthStencil, descriptorSetLayout, depthOnly),
+		createDepthEqualVariant, pipelineCache)
+{
+}
+
+DDM3::PipelineWrapper::PipelineWrapper(VkDevice device, ShaderManager* pShaderManager, const PipelineStateKey& stateKey, bool createDepthEqualVariant,
+	VkPipelineCache pipelineCache, const ExtendedDynamicStateFunctions* pDynamicState)
+	:m_StateKey{ stateKey }, m_pDynamicState{ pDynamicState }
 {
 	// Create the pipeline
-	CreatePipeline(device, renderPass, sampleCount, filePaths, hasDepthStencil);
+	CreatePipeline(device, pShaderManager, createDepthEqualVariant, pipelineCache);
+}
+
+DDM3::PipelineWrapper::PipelineWrapper(const PipelineWrapper& basePipeline, const PipelineStateKey& stateKey, bool createDepthEqualVariant)
+	:m_Pipeline{ basePipeline.m_Pipeline },
+	m_PipelineLayout{ basePipeline.m_PipelineLayout },
+	m_DescriptorSetLayout{ basePipeline.m_DescriptorSetLayout },
+	m_pDescriptorPool{ basePipeline.m_pDescriptorPool },
+	m_StateKey{ stateKey },
+	m_pDynamicState{ basePipeline.m_pDynamicState },
+	m_HasDepthEqualVariant{ createDepthEqualVariant },
+	m_OwnsPipeline{ false }
+{
+	// Only a pipeline with extended dynamic state can be shared, otherwise the state is baked into it
+	if (m_pDynamicState == nullptr)
+	{
+		throw std::runtime_error("failed to share a graphics pipeline without extended dynamic state!");
+	}
+}
+
+DDM3::PipelineStateKey DDM3::PipelineWrapper::CreateStateKey(VkRenderPass renderPass, VkSampleCountFlagBits sampleCount,
+	const std::vector<std::string>& filePaths, bool hasDepthStencil, VkDescriptorSetLayout descriptorSetLayout, bool depthOnly)
+{
+	PipelineStateKey stateKey{};
+	stateKey.shaders = filePaths;
+	stateKey.renderPass = renderPass;
+	stateKey.sampleCount = sampleCount;
+	stateKey.descriptorSetLayout = descriptorSetLayout;
+
+	// Pipelines without depth stencil neither test nor write depth
+	stateKey.depthTest = hasDepthStencil;
+	stateKey.depthWrite = hasDepthStencil;
+
+	// Depth only pipelines have no fragment output, so nothing may be written to the color attachment
+	stateKey.colorWrite = !depthOnly;
+	stateKey.blendEnable = !depthOnly;
+
+	return stateKey;
 }
 
 DDM3::PipelineWrapper::~PipelineWrapper()
@@ -24,19 +80,73 @@ DDM3::PipelineWrapper::~PipelineWrapper()
 
 void DDM3::PipelineWrapper::Cleanup(VkDevice device)
 {
-	// Clean up the descriptor pool
-	m_pDescriptorPool->Cleanup(device);
+	// The pipeline and descriptor pool are borrowed from another pipeline, it destroys them
+	if (!m_OwnsPipeline)
+		return;
+
+	// Clean up the descriptor pool if this pipeline has one
+	if (m_pDescriptorPool != nullptr)
+	{
+		m_pDescriptorPool->Cleanup(device);
+	}
 	// Destroy the pipeline
 	vkDestroyPipeline(device, m_Pipeline, nullptr);
-	//Destroy the pipeline layout
-	vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
-	// Destroy the descriptor layout
-	vkDestroyDescriptorSetLayout(device, m_DescriptorSetLayout, nullptr);
+	// Destroy the depth equal variant
+	vkDestroyPipeline(device, m_DepthEqualPipeline, nullptr);
+	// The layouts are shared with other pipelines, they are destroyed by their owner
 }
 
-void DDM3::PipelineWrapper::BindPipeline(VkCommandBuffer commandBuffer)
+void DDM3::PipelineWrapper::Recreate(VkDevice device, ShaderManager* pShaderManager, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount,
+	VkPipelineCache pipelineCache)
 {
+	// Pipelines that borrow their VkPipeline are recreated from their base pipeline
+	if (!m_OwnsPipeline)
+	{
+		throw std::runtime_error("failed to recreate a shared graphics pipeline!");
+	}
+
+	// Destroy the pipeline and its depth equal variant, the descriptor pool is kept
+	vkDestroyPipeline(device, m_Pipeline, nullptr);
+	vkDestroyPipeline(device, m_DepthEqualPipeline, nullptr);
+	m_Pipeline = VK_NULL_HANDLE;
+	m_DepthEqualPipeline = VK_NULL_HANDLE;
+
+	// Update the state
+	m_StateKey.renderPass = renderPass;
+	m_StateKey.sampleCount = sampleCount;
+
+	// Create the pipeline with the new state
+	CreatePipeline(device, pShaderManager, m_HasDepthEqualVariant, pipelineCache);
+}
+
+void DDM3::PipelineWrapper::Recreate(const PipelineWrapper& basePipeline)
+{
+	// Take the new VkPipeline and the state that isn't dynamic from the base pipeline
+	m_Pipeline = basePipeline.m_Pipeline;
+	m_StateKey.renderPass = basePipeline.m_StateKey.renderPass;
+	m_StateKey.sampleCount = basePipeline.m_StateKey.sampleCount;
+}
+
+void DDM3::PipelineWrapper::BindPipeline(VkCommandBuffer commandBuffer, bool depthEqual)
+{
+	// Use the depth equal variant if it was requested and exists
+	bool useDepthEqual{ depthEqual && m_HasDepthEqualVariant };
+
+	// Without extended dynamic state, the depth equal variant is a seperate pipeline
+	if (m_pDynamicState == nullptr)
+	{
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, useDepthEqual ? m_DepthEqualPipeline : m_Pipeline);
+		return;
+	}
+
 	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
+
+	// Set the state that isn't baked into the pipeline
+	m_pDynamicState->vkCmdSetCullMode(commandBuffer, m_StateKey.cullMode);
+	m_pDynamicState->vkCmdSetDepthTestEnable(commandBuffer, m_StateKey.depthTest ? VK_TRUE : VK_FALSE);
+	// The depth equal variant doesn't write depth, it is already written by the pre-pass
+	m_pDynamicState->vkCmdSetDepthWriteEnable(commandBuffer, m_StateKey.depthWrite && !useDepthEqual ? VK_TRUE : VK_FALSE);
+	m_pDynamicState->vkCmdSetDepthCompareOp(commandBuffer, useDepthEqual ? VK_COMPARE_OP_EQUAL : m_StateKey.depthCompareOp);
 }
 
 DDM3::DescriptorPoolWrapper* DDM3::PipelineWrapper::GetDescriptorPool()
@@ -45,28 +155,34 @@ DDM3::DescriptorPoolWrapper* DDM3::PipelineWrapper::GetDescriptorPool()
 	return m_pDescriptorPool.get();
 }
 
-void DDM3::PipelineWrapper::CreatePipeline(VkDevice device, VkRenderPass renderPass,
-	VkSampleCountFlagBits sampleCount,
-	std::initializer_list<const std::string>& filePaths, bool hasDepthStencil)
+void DDM3::PipelineWrapper::CreatePipeline(VkDevice device, ShaderManager* pShaderManager, bool createDepthEqualVariant, VkPipelineCache pipelineCache)
 {
-	// Create a vector of shader modules the size of the filepaths list
-	std::vector<std::unique_ptr<DDM3::ShaderModuleWrapper>> shaderModuleWrappers(filePaths.size());
+	// Create a vector of shader modules
+	std::vector<std::shared_ptr<DDM3::ShaderModuleWrapper>> shaderModuleWrappers{};
 
-	int index{};
-	
-	// Loop trough the file paths and create a shader module for it
-	for (auto& filePath : filePaths)
+	// Loop trough the file paths and get the shader module for it, shaders used by other pipelines aren't loaded again
+	for (auto& filePath : m_StateKey.shaders)
 	{
-		shaderModuleWrappers[index] = std::make_unique<DDM3::ShaderModuleWrapper>(device, filePath);
-
-		index++;
+		shaderModuleWrappers.push_back(pShaderManager->GetShaderModule(device, filePath));
 	}
 
-	// Create hte descriptor set layout
-	CreateDescriptorSetLayout(device, shaderModuleWrappers);
-
-	// Create the descriptor pool
-	m_pDescriptorPool = std::make_unique<DescriptorPoolWrapper>(shaderModuleWrappers);
+	// Check if an external descriptor set layout was given
+	if (m_StateKey.descriptorSetLayout != VK_NULL_HANDLE)
+	{
+		// Use the external layout, descriptorsets are then allocated by the owner of the layout
+		m_DescriptorSetLayout = m_StateKey.descriptorSetLayout;
+	}
+	else
+	{
+		// Get the descriptor set layout, pipelines with the same bindings share it
+		m_DescriptorSetLayout = pShaderManager->GetDescriptorSetLayout(device, shaderModuleWrappers);
+
+		// Create the descriptor pool, a recreated pipeline keeps its pool
+		if (m_pDescriptorPool == nullptr)
+		{
+			m_pDescriptorPool = std::make_shared<DescriptorPoolWrapper>(shaderModuleWrappers);
+		}
+	}
 
 	// Create a vector of shader stages the size of shader module wrappers
 	std::vector<VkPipelineShaderStageCreateInfo> shaderStages(shaderModuleWrappers.size());
@@ -87,6 +203,13 @@ void DDM3::PipelineWrapper::CreatePipeline(VkDevice device, VkRenderPass renderP
 	// Setup vertex input info
 	SetupVertexInputState(vertexInputInfo, &bindingDescription, attributeDescription);
 
+	// Pipelines that generate their vertices in the vertex shader have no vertex input
+	if (m_StateKey.vertexLayout == VertexLayout::None)
+	{
+		vertexInputInfo.vertexBindingDescriptionCount = 0;
+		vertexInputInfo.vertexAttributeDescriptionCount = 0;
+	}
+
 	// Create input assembly state create info
 	VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
 	// Set type to pipeline input assembly state create info
@@ -103,6 +226,15 @@ void DDM3::PipelineWrapper::CreatePipeline(VkDevice device, VkRenderPass renderP
 		VK_DYNAMIC_STATE_SCISSOR
 	};
 
+	// With extended dynamic state, the cull mode and depth state are set when binding, so one pipeline covers all of them
+	if (m_pDynamicState != nullptr)
+	{
+		dynamicStates.push_back(VK_DYNAMIC_STATE_CULL_MODE_EXT);
+		dynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT);
+		dynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT);
+		dynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT);
+	}
+
 	// Create dynamic state create info
 	VkPipelineDynamicStateCreateInfo dynamicState{};
 	// Set type to dynamic state create info
@@ -120,41 +252,39 @@ void DDM3::PipelineWrapper::CreatePipeline(VkDevice device, VkRenderPass renderP
 	// Create rasterization state create info
 	VkPipelineRasterizationStateCreateInfo rasterizer{};
 	// Set up rasterization state create info
-	SetupRasterizer(rasterizer);
+	SetupRasterizer(rasterizer, m_StateKey.cullMode);
 
 	// Create multisample state create info
 	VkPipelineMultisampleStateCreateInfo multisampling{};
 	// Set multisample state create info
-	SetMultisampleStateCreateInfo(multisampling, sampleCount);
+	SetMultisampleStateCreateInfo(multisampling, m_StateKey.sampleCount);
 
 	// Create depth stencil state create info
 	VkPipelineDepthStencilStateCreateInfo depthStencil{};
 	// Set depth stencil state create info
-	SetDepthStencilStateCreateInfo(depthStencil, hasDepthStencil);
+	SetDepthStencilStateCreateInfo(depthStencil, m_StateKey);
 
 	// Create color blend attachment state
 	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
 	// Set color blend attachment state
 	SetColorBlendAttachmentState(colorBlendAttachment);
 
+	// Set blending
+	colorBlendAttachment.blendEnable = m_StateKey.blendEnable ? VK_TRUE : VK_FALSE;
+
+	// Depth only pipelines have no fragment output, so nothing may be written to the color attachment
+	if (!m_StateKey.colorWrite)
+	{
+		colorBlendAttachment.colorWriteMask = 0;
+	}
+
 	// Create color blending create info
 	VkPipelineColorBlendStateCreateInfo colorBlending{};
 	// Set color blend state create info
 	SetColorblendStateCreateInfo(colorBlending, &colorBlendAttachment);
 
-	// Create pipeline layout info
-	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-	// Create vector of pushconstant ranges and add them by looping trough the shader modules
-	std::vector<VkPushConstantRange> pushConstants{};
-	// Set pipeline layout info
-	SetPipelineLayoutCreateInfo(pipelineLayoutInfo, shaderModuleWrappers, pushConstants);
-
-	// Create pipeline layout
-	if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
-	{
-		// If unsuccessful, throw runtime error
-		throw std::runtime_error("failed to create pipeline layout!");
-	}
+	// Get the pipeline layout, pipelines with the same descriptor set layout and push constants share it
+	m_PipelineLayout = pShaderManager->GetPipelineLayout(device, m_DescriptorSetLayout, shaderModuleWrappers);
 
 	// Create pipeline create info
 	VkGraphicsPipelineCreateInfo pipelineInfo{};
@@ -183,53 +313,39 @@ void DDM3::PipelineWrapper::CreatePipeline(VkDevice device, VkRenderPass renderP
 	// Give pipeline layout
 	pipelineInfo.layout = m_PipelineLayout;
 	// Give renderpass
-	pipelineInfo.renderPass = renderPass;
+	pipelineInfo.renderPass = m_StateKey.renderPass;
 	// Set subpass to 0
 	pipelineInfo.subpass = 0;
 	// Set basepipeline to null handle
 	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
 	// Create graphics pipeline
-	if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline) != VK_SUCCESS)
+	if (vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineInfo, nullptr, &m_Pipeline) != VK_SUCCESS)
 	{
 		// If unsuccessful, throw runtime error
 		throw std::runtime_error("failed to create graphics pipeline!");
 	}
 
-	// Delete all shader modules
-	for (auto& shaderModule : shaderModuleWrappers)
-	{
-		shaderModule->Cleanup(device);
-	}
+	m_HasDepthEqualVariant = createDepthEqualVariant;
 
-}
-
-void DDM3::PipelineWrapper::CreateDescriptorSetLayout(VkDevice device, std::vector<std::unique_ptr<DDM3::ShaderModuleWrapper>>& shaderModules)
-{
-	// Create vector of descriptorsetlayoutbindings the size of the sum of vertexUbos, fragmentUbos and textureamount;
-	std::vector<VkDescriptorSetLayoutBinding> bindings{};
-
-	// Add the descriptor layout bindings for each shader module
-	for (auto& module : shaderModules)
+	// Create the variant used after the depth pre-pass, only fragments on the surface of the pre-pass depth are shaded
+	// With extended dynamic state the compare op and depth writes are set when binding instead
+	if (createDepthEqualVariant && m_pDynamicState == nullptr)
 	{
-		module->AddDescriptorSetLayoutBindings(bindings);
-	}
+		// Set compare op to equal
+		depthStencil.depthCompareOp = VK_COMPARE_OP_EQUAL;
+		// The depth is already written by the pre-pass
+		depthStencil.depthWriteEnable = VK_FALSE;
 
-	// Create layout info
-	VkDescriptorSetLayoutCreateInfo layoutInfo{};
-	// Set type to descriptor set layout create info
-	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-	// Set bindingcount to the amount of bindings
-	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-	// Set bindings to the data of bindings vector
-	layoutInfo.pBindings = bindings.data();
-
-	// Create descriptorset layout
-	if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_DescriptorSetLayout) != VK_SUCCESS)
-	{
-		// If not successfull, throw runtime error
-		throw std::runtime_error("failed to create descriptor set layout!");
+		// Create the depth equal pipeline
+		if (vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineInfo, nullptr, &m_DepthEqualPipeline) != VK_SUCCESS)
+		{
+			// If unsuccessful, throw runtime error
+			throw std::runtime_error("failed to create depth equal graphics pipeline!");
+		}
 	}
+
+	// The shader modules are kept by the shader manager for other pipelines
 }
 
 void DDM3::PipelineWrapper::SetupVertexInputState(VkPipelineVertexInputStateCreateInfo& vertexInputInfo, VkVertexInputBindingDescription* bindingDescription, std::vector<VkVertexInputAttributeDescription>& attributeDescriptions)
@@ -246,7 +362,7 @@ void DDM3::PipelineWrapper::SetupVertexInputState(VkPipelineVertexInputStateCrea
 	vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
 }
 
-void DDM3::PipelineWrapper::SetupRasterizer(VkPipelineRasterizationStateCreateInfo& rasterizer)
+void DDM3::PipelineWrapper::SetupRasterizer(VkPipelineRasterizationStateCreateInfo& rasterizer, VkCullModeFlags cullMode)
 {
 	// Set type to rasterization state create info
 	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
@@ -258,8 +374,8 @@ void DDM3::PipelineWrapper::SetupRasterizer(VkPipelineRasterizationStateCreateIn
 	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
 	// Set line width to 1
 	rasterizer.lineWidth = 1.0f;
-	// Set cullmode to none
-	rasterizer.cullMode = VK_CULL_MODE_NONE;
+	// Give cullmode
+	rasterizer.cullMode = cullMode;
 	// Set front face to counter clockwise
 	rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
 	// Disable depth bias
@@ -291,31 +407,16 @@ void DDM3::PipelineWrapper::SetMultisampleStateCreateInfo(VkPipelineMultisampleS
 }
 
 void DDM3::PipelineWrapper::SetDepthStencilStateCreateInfo(VkPipelineDepthStencilStateCreateInfo& depthStencil,
-	bool hasDepthStencil)
+	const PipelineStateKey& stateKey)
 {
 	// Set type to depth stencil state create info
 	depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-	
-	// Check if this pipeline needs the depth stencil
-	if (hasDepthStencil)
-	{
-		// If it is not:
-		// Set depth test enable to true
-		depthStencil.depthTestEnable = VK_TRUE;
-		// Set depth write enable to true
-		depthStencil.depthWriteEnable = VK_TRUE;
-	}
-	else
-	{
-		// If it is:
-		// Set depth test enable to false
-		depthStencil.depthTestEnable = VK_FALSE;
-		// Set depth write enable to false
-		depthStencil.depthWriteEnable = VK_FALSE;
-	}
-
-	// Set compare op to compare op less
-	depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+	// Set depth test enable
+	depthStencil.depthTestEnable = stateKey.depthTest ? VK_TRUE : VK_FALSE;
+	// Set depth write enable
+	depthStencil.depthWriteEnable = stateKey.depthWrite ? VK_TRUE : VK_FALSE;
+	// Give compare op
+	depthStencil.depthCompareOp = stateKey.depthCompareOp;
 	// Set depth bounds test enable to false
 	depthStencil.depthBoundsTestEnable = VK_FALSE;
 	// Set min depth bounds to 0
@@ -368,26 +469,3 @@ void DDM3::PipelineWrapper::SetColorblendStateCreateInfo(VkPipelineColorBlendSta
 	colorBlending.blendConstants[2] = 0.0f;
 	colorBlending.blendConstants[3] = 0.0f;
 }
-
-void DDM3::PipelineWrapper::SetPipelineLayoutCreateInfo(VkPipelineLayoutCreateInfo& pipelineLayoutInfo,
-	std::vector<std::unique_ptr<DDM3::ShaderModuleWrapper>>& shaderModules,
-	std::vector<VkPushConstantRange>& pushConstants)
-{
-	// Set type to pipeline layout create info
-	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	// Set layoutcount to 1
-	pipelineLayoutInfo.setLayoutCount = 1;
-	// Get the correct layout
-	pipelineLayoutInfo.pSetLayouts = &m_DescriptorSetLayout;
-
-	
-	for (auto& module : shaderModules)
-	{
-		module->AddPushConstants(pushConstants);
-	}
-
-	// Number of push constant ranges used by the pipeline
-	pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstants.size());
-	// Array of push constant ranges used by the pipeline
-	pipelineLayoutInfo.pPushConstantRanges = pushConstants.data();
-}
\ No newline at end of file
@@ -19,6 +19,7 @@ namespace DDM3
 	// Class forward declarations
 	class ShaderModuleWrapper;
 	class DescriptorPoolWrapper;
+	class ShaderManager;
 
 	class PipelineWrapper
 	{
@@ -29,12 +30,55 @@ namespace DDM3
 		// Constructor
 		// Parameters:
 		//     device: handle of the logical device
+		//     pShaderManager: the shader manager the shader modules and layouts are taken from
 		//     renerPass: handle of the renderpass
 		//     sampleCount: the amount of samples per pixel
 		//     filePaths: the filepaths to the shader objects
 		//     hasDepthStencil: boolean that indicates if this pipeline needs a depth stencil
-		PipelineWrapper(VkDevice device, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount,
-			std::initializer_list<const std::string>& filePaths, bool hasDepthStencil = true);
+		//     descriptorSetLayout: an externally owned descriptor set layout, if null handle the layout is reflected from the shaders
+		//     depthOnly: boolean that indicates if this pipeline only writes depth, color writes are disabled
+		//     createDepthEqualVariant: boolean that indicates if a variant that only passes on equal depth without writing depth should be created
+		//     pipelineCache: the pipeline cache used to speed up creation, null handle by default
+		PipelineWrapper(VkDevice device, ShaderManager* pShaderManager, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount,
+			std::initializer_list<const std::string>& filePaths, bool hasDepthStencil = true,
+			VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE, bool depthOnly = false, bool createDepthEqualVariant = false,
+			VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+
+		// Constructor
+		// Parameters:
+		//     device: handle of the logical device
+		//     pShaderManager: the shader manager the shader modules and layouts are taken from
+		//     renerPass: handle of the renderpass
+		//     sampleCount: the amount of samples per pixel
+		//     filePaths: the filepaths to the shader objects
+		//     hasDepthStencil: boolean that indicates if this pipeline needs a depth stencil
+		//     descriptorSetLayout: an externally owned descriptor set layout, if null handle the layout is reflected from the shaders
+		//     depthOnly: boolean that indicates if this pipeline only writes depth, color writes are disabled
+		//     createDepthEqualVariant: boolean that indicates if a variant that only passes on equal depth without writing depth should be created
+		//     pipelineCache: the pipeline cache used to speed up creation, null handle by default
+		PipelineWrapper(VkDevice device, ShaderManager* pShaderManager, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount,
+			const std::vector<std::string>& filePaths, bool hasDepthStencil = true,
+			VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE, bool depthOnly = false, bool createDepthEqualVariant = false,
+			VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+
+		// Constructor
+		// Parameters:
+		//     device: handle of the logical device
+		//     pShaderManager: the shader manager the shader modules and layouts are taken from
+		//     stateKey: all state the pipeline is created with
+		//     createDepthEqualVariant: boolean that indicates if a variant that only passes on equal depth without writing depth should be created
+		//     pipelineCache: the pipeline cache used to speed up creation, null handle by default
+		//     pDynamicState: the extended dynamic state functions, if given the depth and cull state of the key is set when binding, nullptr by default
+		PipelineWrapper(VkDevice device, ShaderManager* pShaderManager, const PipelineStateKey& stateKey, bool createDepthEqualVariant = false,
+			VkPipelineCache pipelineCache = VK_NULL_HANDLE, const ExtendedDynamicStateFunctions* pDynamicState = nullptr);
+
+		// Constructor for a pipeline that only differs from another pipeline in dynamic state
+		// The VkPipeline and descriptor pool of the base pipeline are used, they are destroyed by the base pipeline
+		// Parameters:
+		//     basePipeline: the pipeline that was created with extended dynamic state
+		//     stateKey: the state of this pipeline, only the dynamic state may differ from the key of the base pipeline
+		//     createDepthEqualVariant: boolean that indicates if binding with depth equal is allowed
+		PipelineWrapper(const PipelineWrapper& basePipeline, const PipelineStateKey& stateKey, bool createDepthEqualVariant = false);
 
 		// Destructor
 		~PipelineWrapper();
@@ -45,10 +89,41 @@ namespace DDM3
 		PipelineWrapper& operator=(PipelineWrapper& other) = delete;
 		PipelineWrapper& operator=(PipelineWrapper&& other) = delete;
 
+		// Create the pipeline again for another renderpass or sample count
+		// The layouts and the descriptor pool are kept, so descriptorsets allocated from the pipeline stay valid
+		// Parameters:
+		//     device: handle of the logical device
+		//     pShaderManager: the shader manager the shader modules and layouts are taken from
+		//     renderPass: handle of the new renderpass
+		//     sampleCount: the new amount of samples per pixel
+		//     pipelineCache: the pipeline cache used to speed up creation, null handle by default
+		void Recreate(VkDevice device, ShaderManager* pShaderManager, VkRenderPass renderPass, VkSampleCountFlagBits sampleCount,
+			VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+
+		// Use the VkPipeline of the base pipeline again after the base pipeline was recreated
+		// Parameters:
+		//     basePipeline: the pipeline this pipeline was created from
+		void Recreate(const PipelineWrapper& basePipeline);
+
 		// Bind the pipeline
 		// Parameters:
 		//     commandBuffer: the commandbuffer to be used
-		void BindPipeline(VkCommandBuffer commandBuffer);
+		//     depthEqual: bind the depth equal variant if it exists, used after the depth pre-pass, false by default
+		void BindPipeline(VkCommandBuffer commandBuffer, bool depthEqual = false);
+
+		// Create a state key from the arguments of the file path constructors
+		// Parameters:
+		//     renderPass: handle of the renderpass
+		//     sampleCount: the amount of samples per pixel
+		//     filePaths: the filepaths to the shader objects
+		//     hasDepthStencil: boolean that indicates if this pipeline needs a depth stencil
+		//     descriptorSetLayout: an externally owned descriptor set layout
+		//     depthOnly: boolean that indicates if this pipeline only writes depth
+		static PipelineStateKey CreateStateKey(VkRenderPass renderPass, VkSampleCountFlagBits sampleCount,
+			const std::vector<std::string>& filePaths, bool hasDepthStencil, VkDescriptorSetLayout descriptorSetLayout, bool depthOnly = false);
+
+		// Get the state the pipeline was created with
+		const PipelineStateKey& GetStateKey() const { return m_StateKey; }
 
 		// Get a the handle of the pipeline
 		VkPipeline GetPipeline() const { return m_Pipeline; }
@@ -60,41 +135,47 @@ namespace DDM3
 		VkDescriptorSetLayout GetDescriptorSetLayout() const { return m_DescriptorSetLayout; }
 
 		// Get a pointer to the descriptor pool wrapper
+		// Returns nullptr if the pipeline uses an external descriptor set layout
 		DDM3::DescriptorPoolWrapper* GetDescriptorPool();
 
 	private:
 		// Pipeline
 		VkPipeline m_Pipeline{};
-		// Pipeline layout
+		// Variant of the pipeline that tests depth with equal and doesn't write depth, null handle if it wasn't requested
+		VkPipeline m_DepthEqualPipeline{ VK_NULL_HANDLE };
+		// Pipeline layout, owned by the shader manager
 		VkPipelineLayout m_PipelineLayout{};
-		// Descriptor set layout
+		// Descriptor set layout, owned by the shader manager or externally
 		VkDescriptorSetLayout m_DescriptorSetLayout{};
 
-		// Pointer to the descriptor pool wrapper
-		std::unique_ptr<DescriptorPoolWrapper> m_pDescriptorPool{};
+		// Pointer to the descriptor pool wrapper, shared with pipelines that only differ in dynamic state
+		std::shared_ptr<DescriptorPoolWrapper> m_pDescriptorPool{};
+
+		// The state the pipeline was created with
+		PipelineStateKey m_StateKey{};
+
+		// The extended dynamic state functions, nullptr if the state is baked into the pipeline
+		const ExtendedDynamicStateFunctions* m_pDynamicState{};
+
+		// Indicates if binding with depth equal is allowed
+		bool m_HasDepthEqualVariant{ false };
+
+		// Indicates if this object created the VkPipeline and has to destroy it
+		bool m_OwnsPipeline{ true };
 
 		// Clean up all allocated objects
 		// Parameters:
 		//     device: handle of the logical device
 		void Cleanup(VkDevice device);
 
-		// Create the graphics pipeline
+		// Create the graphics pipeline with the state of m_StateKey
 		// Parameters:
 		//     device: handle of the VkDevice
-		//     renderPass: handle of the VkRenderpass that will be used
-		//     sampleCount: max amount of samples per pixel
-		//     filePaths: filepaths to all the shader files
-		//     hasDepthStencil: boolean that indicates if this pipeline needs a depth stencil
-		void CreatePipeline(VkDevice device, VkRenderPass renderPass,
-			VkSampleCountFlagBits sampleCount,
-			std::initializer_list<const std::string>& filePaths,
-			bool hasDepthStencil = true);
+		//     pShaderManager: the shader manager the shader modules and layouts are taken from
+		//     createDepthEqualVariant: boolean that indicates if the depth equal variant should be created
+		//     pipelineCache: the pipeline cache used to speed up creation
+		void CreatePipeline(VkDevice device, ShaderManager* pShaderManager, bool createDepthEqualVariant, VkPipelineCache pipelineCache);
 
-		// Create a new descriptor layout
-		// Parameters:
-		//     device: handle of the VkDevice
-		//    shaderModules: vector of shader modules that hold information on shader stages
-		void CreateDescriptorSetLayout(VkDevice device, std::vector<std::unique_ptr<DDM3::ShaderModuleWrapper>>& shaderModules);
 
 		// Set up vertex input state create info
 		// Parameters:
@@ -106,7 +187,8 @@ namespace DDM3
 		// Set up the rasterizer
 		// Parameters:
 		//     rasterizer: a reference to the rasterization state create info to avoid creating a new one in the the function
-		void SetupRasterizer(VkPipelineRasterizationStateCreateInfo& rasterizer);
+		//     cullMode: the faces that are culled
+		void SetupRasterizer(VkPipelineRasterizationStateCreateInfo& rasterizer, VkCullModeFlags cullMode);
 
 		// Set the values of the sample state create info
 		// Parameters:
@@ -118,9 +200,9 @@ namespace DDM3
 		// Set the values of the depth stencil state create info
 		// Parameters:
 		//     depthStencil: a reference to the septh stencil state create info to avoid creating a new one in the function
-		//     hasDepthStencil: boolean that indicates is this pipeline needs a depthStencil or not
+		//     stateKey: the state key with the depth state of the pipeline
 		void SetDepthStencilStateCreateInfo(VkPipelineDepthStencilStateCreateInfo& depthStencil,
-			bool hasDepthStencil);
+			const PipelineStateKey& stateKey);
 
 		// Set the values of the color blend attachment state
 		// Parameters:
@@ -133,13 +215,6 @@ namespace DDM3
 		//     colorBlendAttachment: a pointer to the color blend attachment needed in the color blend state create info
 		void SetColorblendStateCreateInfo(VkPipelineColorBlendStateCreateInfo& colorBlending,
 			VkPipelineColorBlendAttachmentState* colorBlendAttachment);
-
-		// Create pipeline layout create info
-		// Parameters:
-		//     pipelineLayoutInfo: a reference to the layout create info to avoid creating a new one in the function
-		void SetPipelineLayoutCreateInfo(VkPipelineLayoutCreateInfo& pipelineLayoutInfo,
-			std::vector<std::unique_ptr<DDM3::ShaderModuleWrapper>>& shaderModules,
-			std::vector<VkPushConstantRange>& pushConstants);
 	};
 }
 
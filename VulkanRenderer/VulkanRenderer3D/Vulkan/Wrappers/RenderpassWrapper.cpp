@@ -3,12 +3,16 @@
 // File includes
 #include "RenderpassWrapper.h"
 #include "Vulkan/Vulkan3D.h"
+#include "Engine/ConfigManager.h"
+#include "Vulkan/Managers/RetirementManager.h"
 
 // Standard library includes
 #include <array>
+#include <vector>
 #include <stdexcept>
 
 DDM3::RenderpassWrapper::RenderpassWrapper(VkDevice device, VkFormat swapchainImageFormat, VkFormat depthFormat, VkSampleCountFlagBits msaaSamples)
+	:m_MsaaSamples{ msaaSamples }
 {
 	// Initialize renderpass
 	CreateRenderPass(device, swapchainImageFormat, depthFormat, msaaSamples);
@@ -21,11 +25,62 @@ DDM3::RenderpassWrapper::~RenderpassWrapper()
 
 void DDM3::RenderpassWrapper::Cleanup(VkDevice device)
 {
+	// Destroy the framebuffer
+	vkDestroyFramebuffer(device, m_Framebuffer, nullptr);
+	m_Framebuffer = VK_NULL_HANDLE;
+
 	// Destroy the renderpass
 	vkDestroyRenderPass(device, m_RenderPass, nullptr);
 }
 
-void DDM3::RenderpassWrapper::BeginRenderPass(VkCommandBuffer commandBuffer, VkFramebuffer frameBuffer, VkExtent2D swapchainExtent)
+void DDM3::RenderpassWrapper::CreateFramebuffer(VkDevice device, VkImageView colorImageView, VkImageView depthImageView, VkImageView sceneImageView, VkExtent2D extent,
+	RetirementManager* pRetirementManager)
+{
+	// Retire the framebuffer of the previous images, the frames in flight still use it
+	if (m_Framebuffer != VK_NULL_HANDLE)
+	{
+		pRetirementManager->Retire([oldFramebuffer = m_Framebuffer](VkDevice retiredDevice)
+			{
+				vkDestroyFramebuffer(retiredDevice, oldFramebuffer, nullptr);
+			});
+		m_Framebuffer = VK_NULL_HANDLE;
+	}
+
+	// Without multisampling the scene is rendered directly into the scene image
+	std::vector<VkImageView> attachments{};
+	if (m_MsaaSamples == VK_SAMPLE_COUNT_1_BIT)
+	{
+		attachments = { sceneImageView, depthImageView };
+	}
+	else
+	{
+		attachments = { colorImageView, depthImageView, sceneImageView };
+	}
+
+	// Create framebuffer create info
+	VkFramebufferCreateInfo framebufferInfo{};
+	// Set type to framebuffer create info
+	framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	// Give the renderpass
+	framebufferInfo.renderPass = m_RenderPass;
+	// Give the attachments
+	framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+	framebufferInfo.pAttachments = attachments.data();
+	// Give the extent of the images
+	framebufferInfo.width = extent.width;
+	framebufferInfo.height = extent.height;
+	// Set layers to 1
+	framebufferInfo.layers = 1;
+
+	// Create the framebuffer
+	if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &m_Framebuffer) != VK_SUCCESS)
+	{
+		// If unsuccessful, throw runtime error
+		throw std::runtime_error("failed to create framebuffer!");
+	}
+}
+
+void DDM3::RenderpassWrapper::BeginRenderPass(VkCommandBuffer commandBuffer, VkExtent2D renderExtent)
 {
 	// Create renderpass begin info object
 	VkRenderPassBeginInfo renderPassInfo{};
@@ -33,12 +88,12 @@ void DDM3::RenderpassWrapper::BeginRenderPass(VkCommandBuffer commandBuffer, VkF
 	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 	// Give handle of renderpass
 	renderPassInfo.renderPass = m_RenderPass;
-	// Give the current frame buffer
-	renderPassInfo.framebuffer = frameBuffer;
+	// Give the frame buffer
+	renderPassInfo.framebuffer = m_Framebuffer;
 	// Set offset of render area to 0, 0
 	renderPassInfo.renderArea.offset = { 0, 0 };
-	// Set extent of render area to the extent of the swapchain
-	renderPassInfo.renderArea.extent = swapchainExtent;
+	// Set extent of render area to the part of the images that is rendered to
+	renderPassInfo.renderArea.extent = renderExtent;
 
 	// Create an array for the clear values
 	std::array<VkClearValue, 2> clearValues{};
@@ -88,8 +143,8 @@ void DDM3::RenderpassWrapper::CreateRenderPass(VkDevice device, VkFormat swapcha
 	depthAttachment.samples = msaaSamples;
 	// Set loadOp function to load op clear
 	depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-	// Set storeOp function to store op don't care
-	depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	// Store the depth if it is used to build the depth pyramid for occlusion culling, otherwise set storeOp to don't care
+	depthAttachment.storeOp = ConfigManager::GetInstance().GetBool("OcclusionCulling") ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	// Set stencilLoadOp function to load op don't care
 	depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 	// Set store op function to store op don't care
@@ -107,6 +162,7 @@ void DDM3::RenderpassWrapper::CreateRenderPass(VkDevice device, VkFormat swapcha
 	depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
 	// Create attachment description
+	// The scene image is sampled when it is upscaled into the swapchain
 	VkAttachmentDescription colorAttachmentResolve{};
 	// Set format to swapchain format
 	colorAttachmentResolve.format = swapchainImageFormat;
@@ -122,8 +178,8 @@ void DDM3::RenderpassWrapper::CreateRenderPass(VkDevice device, VkFormat swapcha
 	colorAttachmentResolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	// Set initial layout to undefined
 	colorAttachmentResolve.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	// Set final layout to present src khr
-	colorAttachmentResolve.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	// Set final layout to shader read only optimal
+	colorAttachmentResolve.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
 	// Create attachment reference
 	VkAttachmentReference colorAttachmentResolveRef{};
@@ -160,8 +216,16 @@ void DDM3::RenderpassWrapper::CreateRenderPass(VkDevice device, VkFormat swapcha
 	// Set destination access mask to color attachment write and depth stencil attachment write
 	dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 
-	// Create array the size of all attachments
-	std::array<VkAttachmentDescription, 3> attachments = { colorAttachment, depthAttachment, colorAttachmentResolve };
+	// Create a vector of all attachments
+	std::vector<VkAttachmentDescription> attachments = { colorAttachment, depthAttachment, colorAttachmentResolve };
+
+	// Without multisampling there is nothing to resolve, the scene image is the color attachment
+	if (msaaSamples == VK_SAMPLE_COUNT_1_BIT)
+	{
+		colorAttachmentResolve.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		attachments = { colorAttachmentResolve, depthAttachment };
+		subpass.pResolveAttachments = nullptr;
+	}
 	// Create rander pass create info
 	VkRenderPassCreateInfo renderPassInfo{};
 	// Set type to render pass create info
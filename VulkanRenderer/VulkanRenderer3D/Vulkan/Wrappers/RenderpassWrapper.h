@@ -1,5 +1,6 @@
 // RenerpassWrapper.h
 // This class will serve as a wrapper for the VkRenderPass object
+// The scene is rendered into an offscreen image that is upscaled into the swapchain afterwards, this class also owns its framebuffer
 
 #ifndef RenderpassWrapperIncluded
 #define RenderpassWrapperIncluded
@@ -9,6 +10,9 @@
 
 namespace DDM3
 {
+	// Class forward declarations
+	class RetirementManager;
+
 	class RenderpassWrapper final
 	{
 	public:
@@ -17,7 +21,7 @@ namespace DDM3
 		//     device: handle of the VkDevice
 		//     swapchainImageFormat: the format that the swapchain color image is in
 		//     depthFormat: the format that the swapchain depth image is in
-		//     msaaSamples: the max amount of samples per pixels
+		//     msaaSamples: the amount of samples per pixels, the color is resolved into a single sampled image if this is more than 1
 		RenderpassWrapper(VkDevice device, VkFormat swapchainImageFormat, VkFormat depthFormat,
 			VkSampleCountFlagBits msaaSamples);
 
@@ -36,13 +40,37 @@ namespace DDM3
 		// Get the handle of the renderpass
 		VkRenderPass GetRenderpass() const { return m_RenderPass; }
 
-		void BeginRenderPass(VkCommandBuffer commandBuffer, VkFramebuffer frameBuffer, VkExtent2D swapchainExtent);
+		// Get the amount of samples per pixel
+		VkSampleCountFlagBits GetMsaaSamples() const { return m_MsaaSamples; }
+
+		// Create the framebuffer, the old one is retired
+		// Parameters:
+		//     device: handle of the VkDevice
+		//     colorImageView: the image view of the multisampled color image, unused if there is 1 sample per pixel
+		//     depthImageView: the image view of the depth image
+		//     sceneImageView: the image view of the single sampled image the scene ends up in
+		//     extent: the extent of the images
+		//     pRetirementManager: pointer to the retirement manager, the old framebuffer is destroyed once the frames in flight finished
+		void CreateFramebuffer(VkDevice device, VkImageView colorImageView, VkImageView depthImageView, VkImageView sceneImageView, VkExtent2D extent,
+			RetirementManager* pRetirementManager);
+
+		// Begin the renderpass
+		// Parameters:
+		//     commandBuffer: the current commandbuffer
+		//     renderExtent: the part of the images that is rendered to, starting in the top left corner
+		void BeginRenderPass(VkCommandBuffer commandBuffer, VkExtent2D renderExtent);
 
 	private:
 
 		//Renderpass
 		VkRenderPass m_RenderPass{};
 
+		// The framebuffer
+		VkFramebuffer m_Framebuffer{ VK_NULL_HANDLE };
+
+		// The amount of samples per pixel
+		VkSampleCountFlagBits m_MsaaSamples{ VK_SAMPLE_COUNT_1_BIT };
+
 		//RenderpassInfo
 		VkRenderPassBeginInfo m_RenderpassInfo{};
 
@@ -8,10 +8,14 @@
 #include <stdexcept>
 
 DDM3::ShaderModuleWrapper::ShaderModuleWrapper(VkDevice device, const std::string& filePath)
-{
 	// Read the file into the shader code
-	m_ShaderCode = Utils::readFile(filePath);
+	:ShaderModuleWrapper(device, Utils::readFile(filePath))
+{
+}
 
+DDM3::ShaderModuleWrapper::ShaderModuleWrapper(VkDevice device, std::vector<char>&& shaderCode)
+	:m_ShaderCode{ std::move(shaderCode) }
+{
 	// Create the shader module
 	CreateShaderModule(device);
 
@@ -30,7 +34,7 @@ void DDM3::ShaderModuleWrapper::Cleanup(VkDevice device)
 	vkDestroyShaderModule(device, m_ShaderModule, nullptr);
 }
 
-void DDM3::ShaderModuleWrapper::AddDescriptorSetLayoutBindings(std::vector<VkDescriptorSetLayoutBinding>& bindings)
+void DDM3::ShaderModuleWrapper::AddDescriptorSetLayoutBindings(std::vector<VkDescriptorSetLayoutBinding>& bindings) const
 {
 	// Read the shader stage from the shader module
 	auto stage{ static_cast<VkShaderStageFlagBits>(m_ReflectShaderModule.shader_stage) };
@@ -57,7 +61,7 @@ void DDM3::ShaderModuleWrapper::AddDescriptorSetLayoutBindings(std::vector<VkDes
 	}
 }
 
-void DDM3::ShaderModuleWrapper::AddDescriptorTypeCount(std::map<VkDescriptorType, int>& typeCount)
+void DDM3::ShaderModuleWrapper::AddDescriptorTypeCount(std::map<VkDescriptorType, int>& typeCount) const
 {
 	// Get the amount of descriptor bindings
 	auto amount{ m_ReflectShaderModule.descriptor_binding_count };
@@ -83,7 +87,7 @@ void DDM3::ShaderModuleWrapper::AddDescriptorTypeCount(std::map<VkDescriptorType
 	}
 }
 
-void DDM3::ShaderModuleWrapper::AddPushConstants(std::vector<VkPushConstantRange>& pushConstants)
+void DDM3::ShaderModuleWrapper::AddPushConstants(std::vector<VkPushConstantRange>& pushConstants) const
 {
 	uint32_t pushConstantAmount{ m_ReflectShaderModule.push_constant_block_count };
 
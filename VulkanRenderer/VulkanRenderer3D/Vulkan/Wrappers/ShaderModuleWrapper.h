@@ -28,6 +28,12 @@ namespace DDM3
 		//     filePath: path to the shader file
 		ShaderModuleWrapper(VkDevice device, const std::string& filePath);
 
+		// Constructor
+		// Parameters:
+		//     device: handle of the logical device
+		//     shaderCode: the binary code of the shader
+		ShaderModuleWrapper(VkDevice device, std::vector<char>&& shaderCode);
+
 		// Default destructor
 		~ShaderModuleWrapper() = default;
 
@@ -45,16 +51,19 @@ namespace DDM3
 		// Return the create info for the shader stage
 		VkPipelineShaderStageCreateInfo GetShaderStageCreateInfo() const { return m_ShaderstageCreateInfo; }
 
+		// Return the binary code of the shader
+		const std::vector<char>& GetShaderCode() const { return m_ShaderCode; }
+
 		// Add the descriptor set layout bindings
 		// Parameters:
 		//     bindings: vector of bindings that this function will add to
-		void AddDescriptorSetLayoutBindings(std::vector<VkDescriptorSetLayoutBinding>& bindings);
+		void AddDescriptorSetLayoutBindings(std::vector<VkDescriptorSetLayoutBinding>& bindings) const;
 
 		// Add the amount of each descriptor type
-		void AddDescriptorTypeCount(std::map<VkDescriptorType, int>& typeCount);
+		void AddDescriptorTypeCount(std::map<VkDescriptorType, int>& typeCount) const;
 
 		// Add push constants to pipeline layout create info
-		void AddPushConstants(std::vector<VkPushConstantRange>& pushConstants);
+		void AddPushConstants(std::vector<VkPushConstantRange>& pushConstants) const;
 
 	private:
 		// The binary code from the shader
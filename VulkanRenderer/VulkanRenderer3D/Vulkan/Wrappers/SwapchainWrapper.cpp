@@ -4,23 +4,29 @@
 #include "Vulkan/Vulkan3D.h"
 #include "SwapchainWrapper.h"
 #include "GPUObject.h"
-#include "Vulkan/Managers/ImageViewManager.h"
 #include "Engine/Window.h"
 #include "Vulkan/Managers/ImageManager.h"
+#include "Vulkan/Managers/RetirementManager.h"
 #include "Vulkan/VulkanUtils.h"
+#include "Engine/ConfigManager.h"
 
 // Standard library includes
 #include <stdexcept>
 #include <algorithm>
+#include <iostream>
 
-DDM3::SwapchainWrapper::SwapchainWrapper(GPUObject* pGPUObject, VkSurfaceKHR surface,
-	DDM3::ImageManager* pImageManager, VkSampleCountFlagBits msaaSamples)
+DDM3::SwapchainWrapper::SwapchainWrapper(GPUObject* pGPUObject, VkSurfaceKHR surface, DDM3::ImageManager* pImageManager)
 {
-	// Create image view manager
-	m_pImageViewManager = std::make_unique<ImageViewManager>(msaaSamples);
-
-	// Initialize the swapchain
-	CreateSwapChain(pGPUObject, surface);
+	// Without a surface, render to offscreen images
+	if (surface == VK_NULL_HANDLE)
+	{
+		CreateHeadlessImages(pGPUObject, pImageManager);
+	}
+	else
+	{
+		// Initialize the swapchain
+		CreateSwapChain(pGPUObject, surface);
+	}
 	// Initialize the image views
 	CreateSwapchainImageViews(pGPUObject->GetDevice(), pImageManager);
 }
@@ -30,29 +36,7 @@ DDM3::SwapchainWrapper::~SwapchainWrapper()
 	Cleanup(Vulkan3D::GetInstance().GetDevice());
 }
 
-void DDM3::SwapchainWrapper::SetupImageViews(GPUObject* pGPUObject, DDM3::ImageManager* pImageManager,
-	 VkCommandBuffer commandBuffer, VkRenderPass renderPass)
-{
-	// Creat the color image
-	m_pImageViewManager->CreateColorResources(pGPUObject, m_SwapChainImageFormat, m_SwapChainExtent, pImageManager);
-	// Create depth image
-	m_pImageViewManager->CreateDepthResources(pGPUObject, m_SwapChainExtent, pImageManager, commandBuffer);
-	// Initialize frame buffers
-	CreateFramebuffers(pGPUObject->GetDevice(), renderPass);
-}
-
-void DDM3::SwapchainWrapper::SetupSwapchain(GPUObject* pGPUObject, VkSurfaceKHR surface,
-	DDM3::ImageManager* pImageManager, VkCommandBuffer commandBuffer, VkRenderPass renderpass)
-{
-	// Initalize the swapchain
-	CreateSwapChain(pGPUObject, surface);
-	// Initialize swapchain image views
-	CreateSwapchainImageViews(pGPUObject->GetDevice(), pImageManager);
-	// Setup color and depth resources
-	SetupImageViews(pGPUObject, pImageManager, commandBuffer, renderpass);
-}
-
-void DDM3::SwapchainWrapper::CreateSwapChain(GPUObject* pGPUObject, VkSurfaceKHR surface)
+void DDM3::SwapchainWrapper::CreateSwapChain(GPUObject* pGPUObject, VkSurfaceKHR surface, VkSwapchainKHR oldSwapchain)
 {
 	// Get device
 	auto device{ pGPUObject->GetDevice() };
@@ -132,8 +116,8 @@ void DDM3::SwapchainWrapper::CreateSwapChain(GPUObject* pGPUObject, VkSurfaceKHR
 	createInfo.presentMode = presentMode;
 	// Set clipped to 2
 	createInfo.clipped = VK_TRUE;
-	// Set old swapchain to null handle
-	createInfo.oldSwapchain = VK_NULL_HANDLE;
+	// Give the swapchain that is replaced, its images that are still being presented stay valid and resources can be reused
+	createInfo.oldSwapchain = oldSwapchain;
 
 	// Create the swapchain
 	if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &m_SwapChain) != VK_SUCCESS)
@@ -155,6 +139,33 @@ void DDM3::SwapchainWrapper::CreateSwapChain(GPUObject* pGPUObject, VkSurfaceKHR
 	m_SwapChainExtent = extent;
 }
 
+void DDM3::SwapchainWrapper::CreateHeadlessImages(GPUObject* pGPUObject, ImageManager* pImageManager)
+{
+	// Get config manager
+	auto& configManager{ ConfigManager::GetInstance() };
+
+	// Use the size of the window that would have been created
+	m_SwapChainExtent = { static_cast<uint32_t>(configManager.GetInt("WindowWidth")), static_cast<uint32_t>(configManager.GetInt("WindowHeight")) };
+	// RGBA can be written to a file without swizzling
+	m_SwapChainImageFormat = VK_FORMAT_R8G8B8A8_SRGB;
+
+	// Every frame in flight gets its own image, the index of the frame is used as image index
+	auto frames{ Vulkan3D::GetMaxFrames() };
+	m_MinImageCount = frames;
+	m_HeadlessImages.resize(frames);
+	m_SwapChainImages.resize(frames);
+
+	for (uint32_t i{}; i < frames; ++i)
+	{
+		// The images are rendered to and copied to the CPU
+		pImageManager->CreateImage(pGPUObject, m_SwapChainExtent.width, m_SwapChainExtent.height, 1, VK_SAMPLE_COUNT_1_BIT,
+			m_SwapChainImageFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_HeadlessImages[i]);
+
+		m_SwapChainImages[i] = m_HeadlessImages[i].image;
+	}
+}
+
 void DDM3::SwapchainWrapper::CreateSwapchainImageViews(VkDevice device, DDM3::ImageManager* pImageManager)
 {
 	// Resize image views to the size of images
@@ -176,6 +187,7 @@ void DDM3::SwapchainWrapper::Cleanup(VkDevice device)
 		// Delete the framebuffer
 		vkDestroyFramebuffer(device, m_SwapChainFramebuffers[i], nullptr);
 	}
+	m_SwapChainFramebuffers.clear();
 
 	// Loop trough the amount of image views
 	for (size_t i = 0; i < m_SwapChainImageViews.size(); ++i)
@@ -183,32 +195,52 @@ void DDM3::SwapchainWrapper::Cleanup(VkDevice device)
 		// Destroy the image view
 		vkDestroyImageView(device, m_SwapChainImageViews[i], nullptr);
 	}
+	m_SwapChainImageViews.clear();
 
 	// Destroy the swapchain
-	vkDestroySwapchainKHR(device, m_SwapChain, nullptr);
+	if (m_SwapChain != VK_NULL_HANDLE)
+	{
+		vkDestroySwapchainKHR(device, m_SwapChain, nullptr);
+	}
 
-	// Clean up image view manager
-	m_pImageViewManager->Cleanup(device);
+	// Destroy the headless images
+	for (auto& image : m_HeadlessImages)
+	{
+		image.Cleanup(device);
+	}
+	m_HeadlessImages.clear();
 }
 
-void DDM3::SwapchainWrapper::RecreateSwapChain(GPUObject* pGPUObject, VkSurfaceKHR surface,
-	DDM3::ImageManager* pImageManager, VkCommandBuffer commandBuffer, VkRenderPass renderpass)
+void DDM3::SwapchainWrapper::RecreateSwapChain(GPUObject* pGPUObject, VkSurfaceKHR surface, DDM3::ImageManager* pImageManager, RetirementManager* pRetirementManager)
 {
-	// Call cleanup function to destroy all allocated objects
-	Cleanup(pGPUObject->GetDevice());
-	
-	// Set swapchain again
-	SetupSwapchain(pGPUObject, surface, pImageManager, commandBuffer, renderpass);
-}
+	// Take the old objects, the frames in flight still use them
+	auto oldSwapchain{ m_SwapChain };
+	auto oldImageViews{ std::move(m_SwapChainImageViews) };
+	auto oldFramebuffers{ std::move(m_SwapChainFramebuffers) };
+	m_SwapChainImageViews.clear();
+	m_SwapChainFramebuffers.clear();
+
+	// Initalize the swapchain, the old swapchain is retired by this
+	CreateSwapChain(pGPUObject, surface, oldSwapchain);
+
+	// Destroy the old objects once the frames in flight finished, the views and framebuffers before the swapchain that owns the images
+	pRetirementManager->Retire([oldSwapchain, oldImageViews, oldFramebuffers](VkDevice device)
+		{
+			for (auto framebuffer : oldFramebuffers)
+			{
+				vkDestroyFramebuffer(device, framebuffer, nullptr);
+			}
 
-VkSampleCountFlagBits DDM3::SwapchainWrapper::GetMsaaSamples() const
-{
-	return m_pImageViewManager->GetMsaaSamples();
-}
+			for (auto imageView : oldImageViews)
+			{
+				vkDestroyImageView(device, imageView, nullptr);
+			}
 
-VkImageView DDM3::SwapchainWrapper::GetDepthImage() const
-{
-	return m_pImageViewManager->GetDepthImageView();
+			vkDestroySwapchainKHR(device, oldSwapchain, nullptr);
+		});
+
+	// Initialize swapchain image views
+	CreateSwapchainImageViews(pGPUObject->GetDevice(), pImageManager);
 }
 
 
@@ -245,6 +277,12 @@ VkExtent2D DDM3::SwapchainWrapper::ChooseSwapExtent(const VkSurfaceCapabilitiesK
 
 void DDM3::SwapchainWrapper::CreateFramebuffers(VkDevice device, VkRenderPass renderpass)
 {
+	// Destroy the framebuffers of the previous render graph
+	for (auto& framebuffer : m_SwapChainFramebuffers)
+	{
+		vkDestroyFramebuffer(device, framebuffer, nullptr);
+	}
+
 	// Resize framebuffers to size of imageviews
 	m_SwapChainFramebuffers.resize(m_SwapChainImageViews.size());
 
@@ -252,10 +290,8 @@ void DDM3::SwapchainWrapper::CreateFramebuffers(VkDevice device, VkRenderPass re
 	for (size_t i = 0; i < m_SwapChainImageViews.size(); ++i)
 	{
 		// Create array for image views
-		std::array<VkImageView, 3> attachments =
+		std::array<VkImageView, 1> attachments =
 		{
-			m_pImageViewManager->GetColorImageView(),
-			m_pImageViewManager->GetDepthImageView(),
 			m_SwapChainImageViews[i]
 		};
 
@@ -303,16 +339,31 @@ VkSurfaceFormatKHR DDM3::SwapchainWrapper::ChooseSwapSurfaceFormat(const std::ve
 
 VkPresentModeKHR DDM3::SwapchainWrapper::ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes)
 {
-	// Loop trough the available presentModes
-	for (const auto& availablePresentMode : availablePresentModes)
+	// Get the requested presentmode from the config file
+	auto presentModeName{ ConfigManager::GetInstance().GetString("PresentMode") };
+
+	// Fifo waits for vertical blank, mailbox replaces the waiting image with newer ones, immediate doesn't wait and can tear
+	VkPresentModeKHR requestedPresentMode{ VK_PRESENT_MODE_FIFO_KHR };
+	if (presentModeName == "Mailbox")
 	{
-		// If current presentmode is mailbox, return it
-		if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
-		{
-			return availablePresentMode;
-		}
+		requestedPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+	}
+	else if (presentModeName == "Immediate")
+	{
+		requestedPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+	}
+	else if (presentModeName != "Fifo")
+	{
+		std::cout << "Unknown present mode " << presentModeName << ", using Fifo\n";
+	}
+
+	// If the requested presentmode is available, return it
+	if (std::find(availablePresentModes.begin(), availablePresentModes.end(), requestedPresentMode) != availablePresentModes.end())
+	{
+		return requestedPresentMode;
 	}
 
-	// If no suitable format was found, return fifo mode
+	// Fifo is always available
+	std::cout << "Present mode " << presentModeName << " is not available, using Fifo\n";
 	return VK_PRESENT_MODE_FIFO_KHR;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 // SwapchainWrapper.h
 // This class will serve as a wrapper for the vulkan swapchain
+// In headless mode there is no surface, offscreen images take the place of the swapchain images
 
 #ifndef SwapchainWrapperIncluded
 #define SwapchainWrapperIncluded
@@ -15,8 +16,8 @@ namespace DDM3
 {
 	// Class forward declarations
 	class ImageManager;
-	class ImageViewManager;
 	class GPUObject;
+	class RetirementManager;
 
 	class SwapchainWrapper final
 	{
@@ -24,10 +25,9 @@ namespace DDM3
 		// Constructor
 		// Parameter:
 		//     pGPUObject: pointer to the GPUObject
-		//     surface: handle of the VkSurfaceKHR
+		//     surface: handle of the VkSurfaceKHR, null handle in headless mode
 		//     pImageManager: pointer to the image manager
-		//     msaaSamples: max amount of samples per pixel
-		SwapchainWrapper(GPUObject* pGPUObject, VkSurfaceKHR surface, DDM3::ImageManager* pImageManager, VkSampleCountFlagBits msaaSamples);
+		SwapchainWrapper(GPUObject* pGPUObject, VkSurfaceKHR surface, DDM3::ImageManager* pImageManager);
 
 		// Delete default constructor
 		SwapchainWrapper() = delete;
@@ -41,29 +41,29 @@ namespace DDM3
 		SwapchainWrapper& operator=(SwapchainWrapper& other) = delete;
 		SwapchainWrapper& operator=(SwapchainWrapper&& other) = delete;
 
-		// Set up the color and depth image views
+		// Create the frame buffers, the swapchain image is the only attachment
 		// Parameters:
-		//     pGPUObject: pointer to the GPUObject
-		//     pImageManager: pointer to the image manager
-		//     commandBuffer: commandbuffer that will be used to create depth image
-		//     renderPass: the renderpass that will be used with this swapchain
-		void SetupImageViews(GPUObject* pGPUObject, DDM3::ImageManager* pImageManager,
-			VkCommandBuffer commandBuffer, VkRenderPass renderPass);
-
+		//     device: handle of the VkDevice
+		//     renderpass: handle of the render pass the scene is upscaled in
+		void CreateFramebuffers(VkDevice device, VkRenderPass renderpass);
 
-		// Delete and recreate the swapchain
+		// Recreate the swapchain, the frame buffers have to be created again afterwards
+		// The old swapchain is handed to the new one, so presenting can continue, and is retired together with its image views and frame buffers
 		// Parameters:
 		//     pGPUObject: pointer to the GPUObject
 		//     surface: handle of the VkSurfaceKHR
 		//     pImageManager: pointer to the image manager
-		//     commandBuffer: commandbuffer that will be used to create depth image
-		//     renderpass: the renderpass that will be used with this swapchain
-		void RecreateSwapChain(GPUObject* pGPUObject, VkSurfaceKHR surface,
-			DDM3::ImageManager* pImageManager, VkCommandBuffer commandBuffer, VkRenderPass renderpass);
+		//     pRetirementManager: pointer to the retirement manager, the old objects are destroyed once the frames in flight finished
+		void RecreateSwapChain(GPUObject* pGPUObject, VkSurfaceKHR surface, DDM3::ImageManager* pImageManager, RetirementManager* pRetirementManager);
 
-		// Get the swapchain
+		// Get the swapchain, null handle in headless mode
 		VkSwapchainKHR GetSwapchain() const { return m_SwapChain; }
 
+		// Get the requested image
+		// Parameters:
+		//     index: the index of the image
+		VkImage GetImage(uint32_t index) const { return m_SwapChainImages[index]; }
+
 		// Get the format of the swapchain
 		VkFormat GetFormat() const { return m_SwapChainImageFormat; }
 
@@ -78,15 +78,7 @@ namespace DDM3
 		//     index: the index of the frame buffer
 		VkFramebuffer GetFrameBuffer(uint32_t index) const { return m_SwapChainFramebuffers[index]; }
 
-		// Get the amound of samples per pixel
-		VkSampleCountFlagBits GetMsaaSamples() const;
-
-		// Temp
-		VkImageView GetDepthImage() const;
 	private:
-		// The image view manager that hold the color and depth image
-		std::unique_ptr<ImageViewManager> m_pImageViewManager{};
-
 		// Handle of the swapchaint
 		VkSwapchainKHR m_SwapChain = VK_NULL_HANDLE;
 
@@ -108,21 +100,21 @@ namespace DDM3
 		// Vector of frameBuffers
 		std::vector<VkFramebuffer> m_SwapChainFramebuffers{};
 
-		// Initialize the swapchain and other components
-		// Parameters:
-		//     pGPUObject: pointer to the GPUObject
-		//     surface: Handle of the VkSurfaceKHR
-		//     pImageManager: pointer to the image manager
-		//     commandBuffer: commandbuffer needed for creation of depth image
-		//     renderpass: the renderpass used with this swapchain
-		void SetupSwapchain(GPUObject* pGPUObject, VkSurfaceKHR surface,
-			DDM3::ImageManager* pImageManager, VkCommandBuffer commandBuffer, VkRenderPass renderpass);
+		// The offscreen images used instead of the swapchain images in headless mode
+		std::vector<Texture> m_HeadlessImages{};
 
 		// Create the swapchain
 		// Parameters:
 		//     pGPUObject: pointer to the GPUObject
 		//     surface: handle of the VkSurfaceKHR
-		void CreateSwapChain(GPUObject* pGPUObject, VkSurfaceKHR surface);
+		//     oldSwapchain: handle of the swapchain that is replaced, null handle if there is none
+		void CreateSwapChain(GPUObject* pGPUObject, VkSurfaceKHR surface, VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
+
+		// Create an offscreen image per frame in flight instead of a swapchain, the size is read from the config
+		// Parameters:
+		//     pGPUObject: pointer to the GPUObject
+		//     pImageManager: pointer to the image manager
+		void CreateHeadlessImages(GPUObject* pGPUObject, ImageManager* pImageManager);
 
 		// Create the color and depth image views
 		// Parameters:
@@ -130,12 +122,6 @@ namespace DDM3
 		//     pImageManager: handle of the image manager
 		void CreateSwapchainImageViews(VkDevice device, ImageManager* pImageManager);
 
-		// Create the frame buffers
-		// Parameters:
-		//     device: handle of the VkDevice
-		//     renderpass: handle of the render pass
-		void CreateFramebuffers(VkDevice device, VkRenderPass renderpass);
-
 		// Get the format for the swapchain surface
 		// Parameters:
 		//     availableFormats: list of candidate formats for the swapchain